@@ -0,0 +1,31 @@
+# This module provides a CMake configuration variable to set the size
+# of the normalized key prefix stored in memtx tree index elements when
+# the index is created with the inline_key option. The size is given
+# in bytes, must be a positive multiple of 8 and defaults to 16, which
+# keeps a tree element at 24 bytes. The value is propagated to the
+# sources.
+
+set(MEMTX_TREE_INLINE_KEY_SIZE "16" CACHE STRING
+    "Size of the key prefix inlined into memtx tree index elements")
+
+if(NOT MEMTX_TREE_INLINE_KEY_SIZE MATCHES "^[0-9]+$")
+    message(FATAL_ERROR "Invalid memtx tree inline key size")
+endif()
+
+math(EXPR MEMTX_TREE_INLINE_KEY_SIZE_REM "${MEMTX_TREE_INLINE_KEY_SIZE} % 8")
+if(MEMTX_TREE_INLINE_KEY_SIZE EQUAL 0 OR
+   NOT MEMTX_TREE_INLINE_KEY_SIZE_REM EQUAL 0)
+    message(FATAL_ERROR "[SetMemtxTreeInlineKeySize] Memtx tree inline key"
+        " size must be a positive multiple of 8, but"
+        " ${MEMTX_TREE_INLINE_KEY_SIZE} is given")
+else()
+    message(STATUS "[SetMemtxTreeInlineKeySize] Memtx tree inline key size: "
+        "${MEMTX_TREE_INLINE_KEY_SIZE} bytes")
+endif()
+
+# Propagate the value to the sources.
+add_definitions(-DMEMTX_TREE_INLINE_KEY_SIZE=${MEMTX_TREE_INLINE_KEY_SIZE})
+
+# XXX: Unset variables to avoid spoiling CMake environment.
+unset(MEMTX_TREE_INLINE_KEY_SIZE_REM)
+unset(MEMTX_TREE_INLINE_KEY_SIZE)
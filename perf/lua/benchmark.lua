@@ -0,0 +1,212 @@
+-- Helpers for Lua performance tests.
+--
+-- A test creates a benchmark object from the script arguments, runs
+-- measured functions with bench:run() and prints the results with
+-- bench:dump_results(). The results are printed in a human readable
+-- form or, with --output_format=json, in the format of the Google
+-- Benchmark JSON reporter, so results of Lua and C benchmarks can be
+-- stored and compared across commits with the same tools (for example,
+-- tools/compare.py from Google Benchmark).
+--
+-- Supported options:
+--   --output=<file>        write the results to the file instead of
+--                          the standard output;
+--   --output_format=<fmt>  "console" (default) or "json";
+--   --filter=<pattern>     run only benchmarks with names matching the
+--                          Lua pattern.
+--
+-- The module is loaded from the script directory, so run the tests from
+-- perf/lua or set LUA_PATH accordingly:
+--   taskset -c 1 tarantool memtx_ops.lua --output_format=json
+
+local clock = require("clock")
+local fio = require("fio")
+local json = require("json")
+local tarantool = require("tarantool")
+local argparse = require("internal.argparse").parse
+
+local M = {}
+
+local OUTPUT_FORMATS = {console = true, json = true}
+
+local bench_mt = {}
+bench_mt.__index = bench_mt
+
+-- Returns true if the benchmark with the given name must be run.
+function bench_mt:is_enabled(name)
+    return self.filter == nil or string.find(name, self.filter) ~= nil
+end
+
+-- Adds a result of a benchmark.
+--   name - benchmark name, e.g. "tree/insert";
+--   result.items - number of processed items (operations);
+--   result.real_time - wall clock time, in seconds;
+--   result.cpu_time - CPU time, in seconds (defaults to real_time);
+--   result.bytes - number of processed bytes, optional;
+--   result.counters - map of additional named values, e.g. the memory
+--     used by an index, optional.
+function bench_mt:add_result(name, result)
+    assert(type(name) == "string")
+    assert(type(result.items) == "number" and result.items > 0)
+    assert(type(result.real_time) == "number")
+    table.insert(self.results, {
+        name = name,
+        items = result.items,
+        real_time = result.real_time,
+        cpu_time = result.cpu_time or result.real_time,
+        bytes = result.bytes,
+        counters = result.counters,
+    })
+end
+
+-- Sets additional named values of the last added result with the given
+-- name. Does nothing if the benchmark is filtered out.
+function bench_mt:set_counters(name, counters)
+    for i = #self.results, 1, -1 do
+        local r = self.results[i]
+        if r.name == name then
+            r.counters = r.counters or {}
+            for k, v in pairs(counters) do
+                r.counters[k] = v
+            end
+            return
+        end
+    end
+end
+
+-- Runs the function processing the given number of items, measures its
+-- wall clock and CPU time and adds the result. Returns the value returned
+-- by the function. If the number of items is nil, the function must
+-- return it. Does nothing if the benchmark is filtered out.
+function bench_mt:run(name, items, fn, ...)
+    if not self:is_enabled(name) then
+        return
+    end
+    collectgarbage()
+    local real_start = clock.monotonic()
+    local cpu_start = clock.proc()
+    local ret = fn(...)
+    local cpu_time = clock.proc() - cpu_start
+    local real_time = clock.monotonic() - real_start
+    self:add_result(name, {
+        items = items or ret,
+        real_time = real_time,
+        cpu_time = cpu_time,
+    })
+    return ret
+end
+
+local function format_console(results)
+    local lines = {}
+    table.insert(lines, ("%-40s %14s %14s %16s"):format(
+        "Benchmark", "Time (ns/op)", "CPU (ns/op)", "Items/s"))
+    for _, r in ipairs(results) do
+        local line = ("%-40s %14.2f %14.2f %16.2f"):format(
+            r.name, r.real_time * 1e9 / r.items, r.cpu_time * 1e9 / r.items,
+            r.items / r.real_time)
+        if r.counters ~= nil then
+            local names = {}
+            for k in pairs(r.counters) do
+                table.insert(names, k)
+            end
+            table.sort(names)
+            for _, k in ipairs(names) do
+                line = line .. (" %s=%s"):format(k, r.counters[k])
+            end
+        end
+        table.insert(lines, line)
+    end
+    return table.concat(lines, "\n") .. "\n"
+end
+
+local function format_json(self)
+    local _, _, build_type = string.match(tarantool.build.target,
+                                          "^(.+)-(.+)-(.+)$")
+    local benchmarks = {}
+    for _, r in ipairs(self.results) do
+        local benchmark = {
+            name = r.name,
+            run_name = r.name,
+            run_type = "iteration",
+            repetitions = 1,
+            repetition_index = 0,
+            threads = 1,
+            iterations = r.items,
+            real_time = r.real_time * 1e9 / r.items,
+            cpu_time = r.cpu_time * 1e9 / r.items,
+            time_unit = "ns",
+            items_per_second = r.items / r.real_time,
+            bytes_per_second = r.bytes and r.bytes / r.real_time or nil,
+        }
+        -- Google Benchmark reports user counters as extra fields.
+        for k, v in pairs(r.counters or {}) do
+            benchmark[k] = v
+        end
+        table.insert(benchmarks, benchmark)
+    end
+    return json.encode({
+        context = {
+            date = os.date("%Y-%m-%dT%H:%M:%S%z"),
+            executable = self.name,
+            tarantool_version = tarantool.version,
+            library_build_type = build_type == "Debug" and "debug" or
+                                 "release",
+        },
+        benchmarks = benchmarks,
+    }) .. "\n"
+end
+
+-- Prints the results in the requested format.
+function bench_mt:dump_results()
+    local text = self.output_format == "json" and format_json(self) or
+                 format_console(self.results)
+    if self.output == nil then
+        io.stdout:write(text)
+        io.stdout:flush()
+        return
+    end
+    local f, err = fio.open(self.output, {"O_WRONLY", "O_CREAT", "O_TRUNC"},
+                            tonumber("644", 8))
+    if f == nil then
+        error(("Failed to open %s: %s"):format(self.output, err))
+    end
+    f:write(text)
+    f:close()
+end
+
+-- Creates a benchmark object from the script arguments. The options
+-- argument may contain additional {name, type} argparse options; their
+-- values are returned as the second value.
+function M.new(args, options)
+    args = args or {}
+    options = options or {}
+    local all_options = {
+        {"output", "string"},
+        {"output_format", "string"},
+        {"filter", "string"},
+    }
+    for _, opt in ipairs(options) do
+        table.insert(all_options, opt)
+    end
+    local params = argparse(args, all_options)
+    local output_format = params.output_format or "console"
+    if not OUTPUT_FORMATS[output_format] then
+        error(("Unknown output format: %s"):format(output_format))
+    end
+    local _, _, build_type = string.match(tarantool.build.target,
+                                          "^(.+)-(.+)-(.+)$")
+    if build_type == "Debug" then
+        io.stderr:write("WARNING: tarantool has built with enabled " ..
+                        "debug mode\n")
+    end
+    local bench = setmetatable({
+        name = fio.basename(args[0] or "benchmark"),
+        output = params.output,
+        output_format = output_format,
+        filter = params.filter,
+        results = {},
+    }, bench_mt)
+    return bench, params
+end
+
+return M
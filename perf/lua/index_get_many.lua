@@ -0,0 +1,74 @@
+-- Compares point lookups done one by one with index:get() and in batches
+-- with index:get_many() for memtx HASH and TREE indexes.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool index_get_many.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+
+local bench = benchmark.new(arg)
+
+box.cfg({memtx_memory = 2 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = 4 * 10^6
+local BATCH = 64
+
+local keys = {}
+for i = 1, ROWS do
+    keys[i] = {i}
+end
+-- Shuffle keys so that lookups hit random memory.
+math.randomseed(42)
+for i = ROWS, 2, -1 do
+    local j = math.random(i)
+    keys[i], keys[j] = keys[j], keys[i]
+end
+
+local batches = {}
+for i = 1, ROWS, BATCH do
+    local batch = {}
+    for j = i, math.min(i + BATCH - 1, ROWS) do
+        table.insert(batch, keys[j])
+    end
+    table.insert(batches, batch)
+end
+
+-- See perf/lua/uri_escape_unescape.lua.
+jit.opt.start("hotloop=1", "hotexit=1")
+
+local function run(name, opts)
+    if not bench:is_enabled(name .. "/get") and
+       not bench:is_enabled(name .. "/get_many") then
+        return
+    end
+    local s = box.schema.space.create("test")
+    s:create_index("pk", opts)
+    box.begin()
+    for i = 1, ROWS do
+        s:insert({i})
+        if i % 1000 == 0 then
+            box.commit()
+            box.begin()
+        end
+    end
+    box.commit()
+
+    bench:run(name .. "/get", ROWS, function()
+        for i = 1, ROWS do
+            s:get(keys[i])
+        end
+    end)
+    bench:run(name .. "/get_many", ROWS, function()
+        for i = 1, #batches do
+            s:get_many(batches[i])
+        end
+    end)
+    s:drop()
+end
+
+run("hash", {type = "hash"})
+run("tree", {type = "tree"})
+run("inline_key", {type = "tree", inline_key = true})
+
+bench:dump_results()
+os.exit()
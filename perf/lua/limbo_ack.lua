@@ -0,0 +1,66 @@
+-- Measures processing of synchronous transaction ACKs when the limbo
+-- queue is deep. Every sync transaction is ACKed by the instance itself
+-- after its WAL write, but the quorum is 2, so the transactions pile up
+-- in the limbo queue until the quorum is lowered and all of them are
+-- confirmed at once. ACK processing mustn't depend on the queue length,
+-- so the time per transaction should stay the same for all the depths.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1,2 tarantool limbo_ack.lua --dir=/dev/shm --output_format=json
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+local fiber = require("fiber")
+local fio = require("fio")
+local uuid = require("uuid")
+
+local bench, params = benchmark.new(arg, {
+    {"dir", "string"},
+})
+
+local QUEUE_DEPTHS = {100, 1000, 10000, 50000}
+
+local dir = params.dir or "/dev/shm"
+if not fio.path.is_dir(dir) then
+    dir = fio.tempdir()
+end
+local work_dir = fio.pathjoin(dir, "limbo_ack_" .. uuid.str())
+assert(fio.mktree(work_dir))
+
+box.cfg({
+    work_dir = work_dir,
+    memtx_memory = 2 * 1024^3,
+    wal_mode = "write",
+    checkpoint_count = 1,
+    replication_synchro_quorum = 1,
+    replication_synchro_timeout = 1000,
+    log_level = 2,
+})
+box.ctl.promote()
+
+local s = box.schema.space.create("test", {is_sync = true})
+s:create_index("pk")
+
+for _, depth in ipairs(QUEUE_DEPTHS) do
+    s:truncate()
+    bench:run(("limbo/ack/queue=%d"):format(depth), depth, function()
+        box.cfg({replication_synchro_quorum = 2})
+        local lsn = box.info.lsn
+        local fibers = {}
+        for i = 1, depth do
+            fibers[i] = fiber.new(s.replace, s, {i})
+            fibers[i]:set_joinable(true)
+        end
+        -- Wait until all the transactions are written and ACKed.
+        while box.info.lsn < lsn + depth do
+            fiber.sleep(0.001)
+        end
+        box.cfg({replication_synchro_quorum = 1})
+        for i = 1, depth do
+            assert(fibers[i]:join())
+        end
+    end)
+end
+
+bench:dump_results()
+fio.rmtree(work_dir)
+os.exit()
@@ -0,0 +1,83 @@
+-- Compares TREE and ART memtx indexes on string keys with long common
+-- prefixes, e.g. URLs.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool memtx_art.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+
+local bench = benchmark.new(arg)
+
+box.cfg({memtx_memory = 2 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = 10^6
+
+local keys = {}
+for i = 1, ROWS do
+    keys[i] = ("https://example.com/catalog/category-%d/item-%d?ref=%d")
+              :format(i % 100, i, i % 7)
+end
+-- Shuffle keys so that they are inserted in random order.
+math.randomseed(42)
+for i = ROWS, 2, -1 do
+    local j = math.random(i)
+    keys[i], keys[j] = keys[j], keys[i]
+end
+
+-- See perf/lua/uri_escape_unescape.lua.
+jit.opt.start("hotloop=1", "hotexit=1")
+
+local function run(index_type)
+    local s = box.schema.space.create("test_" .. index_type)
+    s:create_index("pk", {type = index_type, parts = {{1, "string"}}})
+
+    bench:run(index_type .. "/insert", ROWS, function()
+        box.begin()
+        for i = 1, ROWS do
+            s:insert({keys[i]})
+            if i % 1000 == 0 then
+                box.commit()
+                box.begin()
+            end
+        end
+        box.commit()
+    end)
+    if s:len() ~= ROWS then
+        -- The insert benchmark was filtered out.
+        for i = 1, ROWS do
+            s:replace({keys[i]})
+        end
+    end
+    bench:set_counters(index_type .. "/insert",
+                       {index_size = s.index.pk:bsize()})
+
+    bench:run(index_type .. "/get", ROWS, function()
+        for i = 1, ROWS do
+            s:get(keys[i])
+        end
+    end)
+
+    -- Scans stop early at the end of the index, so the number of
+    -- scanned tuples is returned by the function.
+    bench:run(index_type .. "/scan", nil, function()
+        local count = 0
+        for i = 1, ROWS, 100 do
+            local n = 0
+            for _ in s:pairs(keys[i], {iterator = "ge"}) do
+                n = n + 1
+                if n == 100 then
+                    break
+                end
+            end
+            count = count + n
+        end
+        return count
+    end)
+    s:drop()
+end
+
+run("tree")
+run("art")
+
+bench:dump_results()
+os.exit()
@@ -0,0 +1,63 @@
+-- Compares memtx HASH indexes with the default (murmur3) and xxh3 hash
+-- functions on string keys of different length.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool memtx_hash_func.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+
+local bench = benchmark.new(arg)
+
+box.cfg({memtx_memory = 4 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = 10^6
+
+-- See perf/lua/uri_escape_unescape.lua.
+jit.opt.start("hotloop=1", "hotexit=1")
+
+local function run(hash_func, key_len)
+    local name = ("%s/key_len:%d"):format(hash_func, key_len)
+    local s = box.schema.space.create("test")
+    s:create_index("pk", {type = "hash", parts = {{1, "string"}},
+                          hash_func = hash_func})
+
+    local prefix = string.rep("x", key_len - 8)
+    local keys = {}
+    for i = 1, ROWS do
+        keys[i] = ("%s%08d"):format(prefix, i)
+    end
+
+    bench:run(name .. "/insert", ROWS, function()
+        box.begin()
+        for i = 1, ROWS do
+            s:insert({keys[i]})
+            if i % 1000 == 0 then
+                box.commit()
+                box.begin()
+            end
+        end
+        box.commit()
+    end)
+    if s:len() ~= ROWS then
+        -- The insert benchmark was filtered out.
+        for i = 1, ROWS do
+            s:replace({keys[i]})
+        end
+    end
+
+    local pk = s.index.pk
+    bench:run(name .. "/get", ROWS, function()
+        for i = 1, ROWS do
+            pk:get({keys[i]})
+        end
+    end)
+    s:drop()
+end
+
+for _, key_len in ipairs({16, 64, 256, 1024}) do
+    run("murmur3", key_len)
+    run("xxh3", key_len)
+end
+
+bench:dump_results()
+os.exit()
@@ -0,0 +1,94 @@
+-- Measures basic memtx operations for TREE and HASH indexes: insert,
+-- get by the primary key, range scan (TREE only) and delete.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool memtx_ops.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+
+local bench, params = benchmark.new(arg, {{"rows", "number"}})
+
+box.cfg({memtx_memory = 2 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = params.rows or 10^6
+local SCAN_LIMIT = 100
+
+-- See perf/lua/uri_escape_unescape.lua.
+jit.opt.start("hotloop=1", "hotexit=1")
+
+-- Keys are inserted in random order.
+local keys = {}
+for i = 1, ROWS do
+    keys[i] = i
+end
+math.randomseed(42)
+for i = ROWS, 2, -1 do
+    local j = math.random(i)
+    keys[i], keys[j] = keys[j], keys[i]
+end
+
+local function run(index_type)
+    local s = box.schema.space.create("test")
+    s:create_index("pk", {type = index_type})
+    local prefix = index_type:lower() .. "/"
+
+    bench:run(prefix .. "insert", ROWS, function()
+        box.begin()
+        for i = 1, ROWS do
+            s:insert({keys[i], "name", i})
+            if i % 1000 == 0 then
+                box.commit()
+                box.begin()
+            end
+        end
+        box.commit()
+    end)
+    if s:len() ~= ROWS then
+        -- The insert benchmark was filtered out.
+        s:truncate()
+        for i = 1, ROWS do
+            s:insert({keys[i], "name", i})
+        end
+    end
+
+    bench:run(prefix .. "get", ROWS, function()
+        local pk = s.index.pk
+        for i = 1, ROWS do
+            pk:get(keys[i])
+        end
+    end)
+
+    if index_type == "TREE" then
+        local count = math.floor(ROWS / SCAN_LIMIT)
+        bench:run(prefix .. "range_scan", count * SCAN_LIMIT, function()
+            local pk = s.index.pk
+            local opts = {iterator = "GE", limit = SCAN_LIMIT}
+            for i = 1, count do
+                pk:select((i - 1) * SCAN_LIMIT + 1, opts)
+            end
+        end)
+        bench:run(prefix .. "pairs", ROWS, function()
+            for _ in s.index.pk:pairs() do -- luacheck: ignore
+            end
+        end)
+    end
+
+    bench:run(prefix .. "delete", ROWS, function()
+        box.begin()
+        for i = 1, ROWS do
+            s:delete(keys[i])
+            if i % 1000 == 0 then
+                box.commit()
+                box.begin()
+            end
+        end
+        box.commit()
+    end)
+    s:drop()
+end
+
+run("TREE")
+run("HASH")
+
+bench:dump_results()
+os.exit()
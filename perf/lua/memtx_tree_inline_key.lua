@@ -0,0 +1,92 @@
+-- Compares memtx TREE indexes with and without the inline_key option on
+-- composite keys: unsigned, unsigned, string.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool memtx_tree_inline_key.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+
+local bench = benchmark.new(arg)
+
+box.cfg({memtx_memory = 2 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = 10^6
+
+local keys = {}
+for i = 1, ROWS do
+    keys[i] = {i % 1000, i % 997, ("name-%d"):format(i)}
+end
+-- Shuffle keys so that they are inserted in random order.
+math.randomseed(42)
+for i = ROWS, 2, -1 do
+    local j = math.random(i)
+    keys[i], keys[j] = keys[j], keys[i]
+end
+
+-- See perf/lua/uri_escape_unescape.lua.
+jit.opt.start("hotloop=1", "hotexit=1")
+
+local function run(name, opts)
+    local s = box.schema.space.create("test")
+    s:create_index("pk")
+    opts.parts = {{2, "unsigned"}, {3, "unsigned"}, {4, "string"}}
+    s:create_index("sk", opts)
+
+    local function tuple(i)
+        local key = keys[i]
+        return {i, key[1], key[2], key[3]}
+    end
+    bench:run(name .. "/insert", ROWS, function()
+        box.begin()
+        for i = 1, ROWS do
+            s:insert(tuple(i))
+            if i % 1000 == 0 then
+                box.commit()
+                box.begin()
+            end
+        end
+        box.commit()
+    end)
+    if s:len() ~= ROWS then
+        -- The insert benchmark was filtered out.
+        for i = 1, ROWS do
+            s:replace(tuple(i))
+        end
+    end
+
+    local sk = s.index.sk
+    bench:run(name .. "/get", ROWS, function()
+        for i = 1, ROWS do
+            sk:get(keys[i])
+        end
+    end)
+
+    -- Scans stop early at the end of the index, so the number of
+    -- scanned tuples is returned by the function.
+    bench:run(name .. "/scan", nil, function()
+        local count = 0
+        for i = 1, ROWS, 100 do
+            local n = 0
+            for _ in sk:pairs({keys[i][1]}, {iterator = "ge"}) do
+                n = n + 1
+                if n == 100 then
+                    break
+                end
+            end
+            count = count + n
+        end
+        return count
+    end)
+
+    sk:drop()
+    bench:run(name .. "/build", ROWS, function()
+        s:create_index("sk", opts)
+    end)
+    s:drop()
+end
+
+run("hint", {})
+run("inline_key", {inline_key = true})
+
+bench:dump_results()
+os.exit()
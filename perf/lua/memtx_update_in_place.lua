@@ -0,0 +1,51 @@
+-- Measures updates of a non-indexed counter field, which are applied to
+-- memtx tuples in place, and compares them with updates that have to
+-- replace the tuple in all indexes, because an on_replace trigger is set.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool memtx_update_in_place.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+
+local bench = benchmark.new(arg)
+
+box.cfg({memtx_memory = 2 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = 10^5
+local LOOPS = 20
+local BATCH = 100
+
+local function run(name, in_place)
+    if not bench:is_enabled(name) then
+        return
+    end
+    local s = box.schema.space.create("test")
+    s:create_index("pk")
+    s:create_index("sk", {parts = {2, "string"}})
+    for i = 1, ROWS do
+        s:insert({i, ("name%d"):format(i), 0, "payload"})
+    end
+    if not in_place then
+        s:on_replace(function() end)
+    end
+    local ops = {{"+", 3, 1}}
+
+    bench:run(name, ROWS * LOOPS, function()
+        for _ = 1, LOOPS do
+            for i = 1, ROWS, BATCH do
+                box.begin()
+                for j = i, i + BATCH - 1 do
+                    s:update(j, ops)
+                end
+                box.commit()
+            end
+        end
+    end)
+    s:drop()
+end
+
+run("replace", false)
+run("in-place", true)
+
+bench:dump_results()
+os.exit()
@@ -0,0 +1,119 @@
+-- Measures memtx TREE index performance for different key shapes. Hints
+-- are disabled so that the time is dominated by tuple comparators.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool tuple_compare.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+local key_def = require("key_def")
+local uuid = require("uuid")
+
+local bench = benchmark.new(arg)
+
+box.cfg({memtx_memory = 2 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = 10^6
+
+local uuids = {}
+for i = 1, 1000 do
+    uuids[i] = uuid.new()
+end
+
+-- Each key shape is an index definition plus a function that generates
+-- a tuple given its number. The first field is always a unique unsigned.
+local shapes = {
+    {
+        name = "unsigned",
+        parts = {{1, "unsigned"}},
+        tuple = function(i) return {i} end,
+    },
+    {
+        name = "integer",
+        parts = {{2, "integer"}},
+        tuple = function(i) return {i, i % 2 == 0 and i or -i} end,
+    },
+    {
+        name = "double",
+        parts = {{2, "double"}},
+        tuple = function(i) return {i, i / 3} end,
+    },
+    {
+        name = "uuid",
+        parts = {{2, "uuid"}},
+        unique = false,
+        tuple = function(i) return {i, uuids[i % 1000 + 1]} end,
+    },
+    {
+        name = "integer,uuid",
+        parts = {{2, "integer"}, {3, "uuid"}},
+        unique = false,
+        tuple = function(i) return {i, i % 1000, uuids[i % 997 + 1]} end,
+    },
+    {
+        name = "nullable integer",
+        parts = {{2, "integer", is_nullable = true}},
+        unique = false,
+        tuple = function(i)
+            return {i, i % 5 ~= 0 and i % 10000 or box.NULL}
+        end,
+    },
+}
+
+-- See perf/lua/uri_escape_unescape.lua.
+jit.opt.start("hotloop=1", "hotexit=1")
+
+local function run(shape)
+    local s = box.schema.space.create("test")
+    s:create_index("pk", {hint = false})
+    local sk = shape.name ~= "unsigned" and s:create_index("sk", {
+        parts = shape.parts, unique = shape.unique, hint = false,
+    }) or s.index.pk
+
+    local tuples = {}
+    for i = 1, ROWS do
+        tuples[i] = shape.tuple(i)
+    end
+    -- Shuffle tuples so that they are inserted in random order.
+    math.randomseed(42)
+    for i = ROWS, 2, -1 do
+        local j = math.random(i)
+        tuples[i], tuples[j] = tuples[j], tuples[i]
+    end
+
+    bench:run(shape.name .. "/insert", ROWS, function()
+        box.begin()
+        for i = 1, ROWS do
+            s:insert(tuples[i])
+            if i % 1000 == 0 then
+                box.commit()
+                box.begin()
+            end
+        end
+        box.commit()
+    end)
+    if s:len() ~= ROWS then
+        -- The insert benchmark was filtered out.
+        for i = 1, ROWS do
+            s:replace(tuples[i])
+        end
+    end
+
+    local kd = key_def.new(sk.parts)
+    local keys = {}
+    for i = 1, ROWS do
+        keys[i] = kd:extract_key(tuples[i])
+    end
+    bench:run(shape.name .. "/select", ROWS, function()
+        for i = 1, ROWS do
+            sk:select(keys[i], {limit = 1})
+        end
+    end)
+    s:drop()
+end
+
+for _, shape in ipairs(shapes) do
+    run(shape)
+end
+
+bench:dump_results()
+os.exit()
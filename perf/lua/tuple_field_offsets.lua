@@ -0,0 +1,60 @@
+-- Measures access to non-indexed fields of wide tuples with and without
+-- the field_offsets space option.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1 tarantool tuple_field_offsets.lua [--output_format=json]
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+
+local bench = benchmark.new(arg)
+
+box.cfg({memtx_memory = 2 * 1024^3, wal_mode = "none", log_level = 2})
+
+local ROWS = 10^5
+local FIELDS = 80
+local LOOPS = 10
+
+-- See perf/lua/uri_escape_unescape.lua.
+jit.opt.start("hotloop=1", "hotexit=1")
+
+local function run(field_offsets)
+    local name = ("field_offsets:%d"):format(field_offsets)
+    if not bench:is_enabled(name) then
+        return
+    end
+    local s = box.schema.space.create("test", {field_offsets = field_offsets})
+    s:create_index("pk")
+    for i = 1, ROWS do
+        local tuple = {i}
+        for j = 2, FIELDS do
+            tuple[j] = j % 2 == 0 and i * j or ("str%d"):format(j)
+        end
+        s:insert(tuple)
+    end
+    local tuples = s:select()
+
+    bench:run(name, nil, function()
+        local count = 0
+        for _ = 1, LOOPS do
+            for i = 1, ROWS do
+                local tuple = tuples[i]
+                for j = 2, FIELDS, 7 do
+                    if tuple[j] ~= nil then
+                        count = count + 1
+                    end
+                end
+            end
+        end
+        return count
+    end)
+    bench:set_counters(name, {
+        field_offsets_size = s:stat().field_offsets.size,
+    })
+    s:drop()
+end
+
+run(0)
+run(FIELDS)
+
+bench:dump_results()
+os.exit()
@@ -0,0 +1,77 @@
+-- Measures WAL write throughput depending on how rows are batched:
+-- by the transaction size and by the number of fibers committing
+-- single-row transactions concurrently (the WAL thread writes all
+-- transactions ready by the time it starts a write in one batch).
+-- The WAL is written to a temporary directory created in --dir, which
+-- defaults to /dev/shm so that the results don't depend on the disk.
+-- It is recommended to run benchmark using taskset for stable results.
+-- taskset -c 1,2 tarantool wal_write.lua --dir=/dev/shm --output_format=json
+-- See perf/lua/benchmark.lua for the supported options.
+
+local benchmark = require("benchmark")
+local fiber = require("fiber")
+local fio = require("fio")
+local uuid = require("uuid")
+
+local bench, params = benchmark.new(arg, {
+    {"dir", "string"},
+    {"rows", "number"},
+})
+
+local ROWS = params.rows or 10^5
+local TXN_SIZES = {1, 10, 100, 1000}
+local FIBER_COUNTS = {10, 100, 1000}
+
+local dir = params.dir or "/dev/shm"
+if not fio.path.is_dir(dir) then
+    dir = fio.tempdir()
+end
+local work_dir = fio.pathjoin(dir, "wal_write_" .. uuid.str())
+assert(fio.mktree(work_dir))
+
+box.cfg({
+    work_dir = work_dir,
+    memtx_memory = 2 * 1024^3,
+    wal_mode = "write",
+    checkpoint_count = 1,
+    log_level = 2,
+})
+
+local s = box.schema.space.create("test")
+s:create_index("pk")
+local payload = string.rep("x", 100)
+
+for _, txn_size in ipairs(TXN_SIZES) do
+    local rows = ROWS - ROWS % txn_size
+    bench:run(("wal/txn_size=%d"):format(txn_size), rows, function()
+        for i = 1, rows, txn_size do
+            box.begin()
+            for j = i, i + txn_size - 1 do
+                s:replace({j, payload})
+            end
+            box.commit()
+        end
+    end)
+end
+
+for _, fiber_count in ipairs(FIBER_COUNTS) do
+    local rows = ROWS - ROWS % fiber_count
+    bench:run(("wal/fibers=%d"):format(fiber_count), rows, function()
+        local fibers = {}
+        for f = 1, fiber_count do
+            fibers[f] = fiber.new(function()
+                for i = f, rows, fiber_count do
+                    s:replace({i, payload})
+                end
+            end)
+            fibers[f]:set_joinable(true)
+        end
+        for f = 1, fiber_count do
+            fibers[f]:join()
+        end
+    end)
+end
+
+bench:dump_results()
+fio.rmtree(work_dir)
+os.exit()
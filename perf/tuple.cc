@@ -2,6 +2,7 @@
 #include "fiber.h"
 #include "tuple.h"
 #include "memtx_engine.h"
+#include "mp_check_fast.h"
 #include <allocator.h>
 
 #include <benchmark/benchmark.h>
@@ -432,6 +433,100 @@ tuple_tuple_compare_hint(benchmark::State& state)
 
 BENCHMARK(tuple_tuple_compare_hint);
 
+// Generator of a set of wide msgpack arrays of small integers with
+// an occasional string, which is a common shape of wide tuples.
+class MpWideDataSet {
+public:
+	static MpWideDataSet &instance()
+	{
+		static MpWideDataSet instance;
+		return instance;
+	}
+	const char *begin(size_t i) const { return data[i]; }
+	const char *end(size_t i) const { return data_end[i]; }
+private:
+	MpWideDataSet()
+	{
+		const uint32_t field_count = MAX_TUPLE_DATA_SIZE / 8;
+		for (size_t i = 0; i < NUM_TEST_TUPLES; i++) {
+			char *pos = data[i];
+			pos = mp_encode_array(pos, field_count);
+			for (uint32_t j = 0; j < field_count; j++) {
+				if (rand() % 16 == 0)
+					pos = mp_encode_str0(pos, "abc");
+				else
+					pos = mp_encode_uint(pos, rand() % 128);
+			}
+			if (pos - data[i] > MAX_TUPLE_DATA_SIZE)
+				abort();
+			data_end[i] = pos;
+		}
+	}
+	char data[NUM_TEST_TUPLES][MAX_TUPLE_DATA_SIZE];
+	const char *data_end[NUM_TEST_TUPLES];
+};
+
+// Msgpack validation benchmark, the argument selects the dataset:
+// 0 - random tuples, 1 - wide tuples of small integers.
+template <class Check>
+static void
+mp_check_helper(benchmark::State& state, Check check)
+{
+	MpDataSet &dataset = MpDataSet::instance();
+	MpWideDataSet &wide = MpWideDataSet::instance();
+	bool is_wide = state.range(0) != 0;
+	size_t i = 0;
+	size_t total_count = 0;
+	size_t total_bytes = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		const char *begin = is_wide ? wide.begin(i) :
+					      dataset[i].begin();
+		const char *end = is_wide ? wide.end(i) : dataset[i].end();
+		const char *pos = begin;
+		if (check(&pos, end) != 0 || pos != end)
+			abort();
+		total_bytes += end - begin;
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	state.SetBytesProcessed(total_bytes);
+}
+
+// msgpuck mp_check() benchmark.
+static void
+bench_mp_check(benchmark::State& state)
+{
+	mp_check_helper(state, [](const char **data, const char *end) {
+		return mp_check(data, end);
+	});
+}
+
+BENCHMARK(bench_mp_check)->Arg(0)->Arg(1);
+
+// mp_check_fast() benchmark, scalar implementation.
+static void
+bench_mp_check_fast_scalar(benchmark::State& state)
+{
+	mp_check_helper(state, mp_check_fast_scalar);
+}
+
+BENCHMARK(bench_mp_check_fast_scalar)->Arg(0)->Arg(1);
+
+// mp_check_fast() benchmark, the best implementation for the CPU.
+static void
+bench_mp_check_fast(benchmark::State& state)
+{
+	mp_check_fast_init();
+	mp_check_helper(state, mp_check_fast);
+}
+
+BENCHMARK(bench_mp_check_fast)->Arg(0)->Arg(1);
+
 BENCHMARK_MAIN();
 
 #include "debug_warning.h"
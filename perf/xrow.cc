@@ -0,0 +1,361 @@
+#include "memory.h"
+#include "fiber.h"
+#include "tuple.h"
+#include "xrow.h"
+#include "xrow_update.h"
+#include "iproto_constants.h"
+#include "msgpuck.h"
+#include "trivia/util.h"
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+const size_t NUM_TEST_REQUESTS = 1024;
+const size_t MAX_REQUEST_SIZE = 256;
+const uint32_t TEST_SPACE_ID = 512;
+
+// Initializes and frees the runtime used by xrow and xrow_update.
+class Runtime {
+public:
+	static Runtime &instance()
+	{
+		static Runtime instance;
+		return instance;
+	}
+private:
+	Runtime()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		tuple_init(NULL);
+	}
+	~Runtime()
+	{
+		tuple_free();
+		fiber_free();
+		memory_free();
+	}
+};
+
+// Request types used by the benchmarks, selected by the argument.
+static const uint16_t request_types[] = {
+	IPROTO_SELECT, IPROTO_INSERT, IPROTO_UPDATE, IPROTO_DELETE,
+};
+
+// Encoded key, tuple and update operations of a DML request.
+class DmlData {
+public:
+	void create(size_t i)
+	{
+		char *pos = key;
+		pos = mp_encode_array(pos, 1);
+		pos = mp_encode_uint(pos, i);
+		key_end = pos;
+
+		pos = tuple;
+		pos = mp_encode_array(pos, 5);
+		pos = mp_encode_uint(pos, i);
+		pos = mp_encode_str0(pos, "name");
+		pos = mp_encode_uint(pos, i * 100);
+		pos = mp_encode_double(pos, i / 3.0);
+		pos = mp_encode_str0(pos, "some payload of a tuple");
+		tuple_end = pos;
+
+		pos = ops;
+		pos = mp_encode_array(pos, 2);
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_str0(pos, "+");
+		pos = mp_encode_uint(pos, 3);
+		pos = mp_encode_uint(pos, 1);
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_str0(pos, "=");
+		pos = mp_encode_uint(pos, 2);
+		pos = mp_encode_str0(pos, "new name");
+		ops_end = pos;
+	}
+	// Fills the request of the given type.
+	void request(uint16_t type, struct request *request) const
+	{
+		memset(request, 0, sizeof(*request));
+		request->type = type;
+		request->space_id = TEST_SPACE_ID;
+		request->index_base = 1;
+		switch (type) {
+		case IPROTO_SELECT:
+			request->limit = 1;
+			request->iterator = ITER_EQ;
+			FALLTHROUGH;
+		case IPROTO_DELETE:
+			request->key = key;
+			request->key_end = key_end;
+			break;
+		case IPROTO_INSERT:
+			request->tuple = tuple;
+			request->tuple_end = tuple_end;
+			break;
+		case IPROTO_UPDATE:
+			request->key = key;
+			request->key_end = key_end;
+			request->tuple = ops;
+			request->tuple_end = ops_end;
+			break;
+		default:
+			abort();
+		}
+	}
+	const char *tuple_begin() const { return tuple; }
+	const char *tuple_finish() const { return tuple_end; }
+private:
+	char key[16];
+	const char *key_end;
+	char tuple[MAX_REQUEST_SIZE];
+	const char *tuple_end;
+	char ops[MAX_REQUEST_SIZE];
+	const char *ops_end;
+};
+
+// Set of DML request data.
+class DmlDataSet {
+public:
+	static DmlDataSet &instance()
+	{
+		static DmlDataSet instance;
+		return instance;
+	}
+	const DmlData &operator[](size_t i) const { return data[i]; }
+private:
+	DmlDataSet()
+	{
+		for (size_t i = 0; i < NUM_TEST_REQUESTS; i++)
+			data[i].create(i);
+	}
+	DmlData data[NUM_TEST_REQUESTS];
+};
+
+// Encoded requests of the same type, as they are read from a socket.
+class Packets {
+public:
+	explicit Packets(uint16_t type)
+	{
+		Runtime::instance();
+		DmlDataSet &dataset = DmlDataSet::instance();
+		struct region *region = &fiber()->gc;
+		for (size_t i = 0; i < NUM_TEST_REQUESTS; i++) {
+			struct request request;
+			dataset[i].request(type, &request);
+			struct xrow_header row;
+			memset(&row, 0, sizeof(row));
+			row.type = type;
+			row.sync = i;
+			xrow_encode_dml(&request, region, row.body,
+					&row.bodycnt);
+			struct iovec iov[XROW_IOVMAX];
+			int iovcnt;
+			xrow_to_iovec(&row, iov, &iovcnt);
+			char *pos = data[i];
+			for (int k = 0; k < iovcnt; k++) {
+				if (pos + iov[k].iov_len >
+				    data[i] + MAX_REQUEST_SIZE)
+					abort();
+				memcpy(pos, iov[k].iov_base, iov[k].iov_len);
+				pos += iov[k].iov_len;
+			}
+			data_end[i] = pos;
+			region_truncate(region, 0);
+		}
+	}
+	const char *begin(size_t i) const { return data[i]; }
+	const char *end(size_t i) const { return data_end[i]; }
+private:
+	char data[NUM_TEST_REQUESTS][MAX_REQUEST_SIZE];
+	const char *data_end[NUM_TEST_REQUESTS];
+};
+
+// xrow_encode_dml() benchmark, the argument selects the request type.
+static void
+bench_xrow_encode_dml(benchmark::State& state)
+{
+	Runtime::instance();
+	DmlDataSet &dataset = DmlDataSet::instance();
+	uint16_t type = request_types[state.range(0)];
+	struct region *region = &fiber()->gc;
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_REQUESTS) {
+			region_truncate(region, 0);
+			total_count += i;
+			i = 0;
+		}
+		struct request request;
+		dataset[i].request(type, &request);
+		struct iovec iov[XROW_BODY_IOVMAX];
+		int iovcnt;
+		xrow_encode_dml(&request, region, iov, &iovcnt);
+		benchmark::DoNotOptimize(iov[0].iov_base);
+		++i;
+	}
+	total_count += i;
+	region_truncate(region, 0);
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(bench_xrow_encode_dml)
+	->DenseRange(0, lengthof(request_types) - 1);
+
+// xrow_decode_dml() benchmark, the argument selects the request type.
+static void
+bench_xrow_decode_dml(benchmark::State& state)
+{
+	uint16_t type = request_types[state.range(0)];
+	std::unique_ptr<Packets> packets(new Packets(type));
+	std::vector<struct xrow_header> rows(NUM_TEST_REQUESTS);
+	for (size_t k = 0; k < NUM_TEST_REQUESTS; k++) {
+		const char *pos = packets->begin(k);
+		mp_decode_uint(&pos);
+		if (xrow_header_decode(&rows[k], &pos, packets->end(k),
+				       true) != 0)
+			abort();
+	}
+	uint64_t key_map = dml_request_key_map(type);
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_REQUESTS) {
+			total_count += i;
+			i = 0;
+		}
+		struct request request;
+		if (xrow_decode_dml(&rows[i], &request, key_map) != 0)
+			abort();
+		benchmark::DoNotOptimize(request.key);
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(bench_xrow_decode_dml)
+	->DenseRange(0, lengthof(request_types) - 1);
+
+// Decoding of IPROTO requests the way the network thread and the tx
+// thread do it: the packet length, the header, and the DML body.
+// The argument selects the request type.
+static void
+bench_iproto_request_decode(benchmark::State& state)
+{
+	uint16_t type = request_types[state.range(0)];
+	std::unique_ptr<Packets> packets(new Packets(type));
+	uint64_t key_map = dml_request_key_map(type);
+	size_t i = 0;
+	size_t total_count = 0;
+	size_t total_bytes = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_REQUESTS) {
+			total_count += i;
+			i = 0;
+		}
+		const char *pos = packets->begin(i);
+		const char *end = packets->end(i);
+		if (mp_check_uint(pos, end) > 0)
+			abort();
+		uint64_t len = mp_decode_uint(&pos);
+		if (pos + len != end)
+			abort();
+		struct xrow_header row;
+		if (xrow_header_decode(&row, &pos, end, true) != 0)
+			abort();
+		struct request request;
+		if (xrow_decode_dml_iproto(&row, &request, key_map) != 0)
+			abort();
+		benchmark::DoNotOptimize(request.key);
+		total_bytes += end - packets->begin(i);
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	state.SetBytesProcessed(total_bytes);
+}
+
+BENCHMARK(bench_iproto_request_decode)
+	->DenseRange(0, lengthof(request_types) - 1);
+
+// Update operations used by the xrow_update benchmark, selected by
+// the argument. Tuples are {unsigned, string, unsigned, double, string}.
+static char *
+encode_update_op(char *pos, int op)
+{
+	switch (op) {
+	case 0:
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_str0(pos, "+");
+		pos = mp_encode_uint(pos, 3);
+		return mp_encode_uint(pos, 1);
+	case 1:
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_str0(pos, "=");
+		pos = mp_encode_uint(pos, 2);
+		return mp_encode_str0(pos, "new name");
+	case 2:
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_str0(pos, "!");
+		pos = mp_encode_uint(pos, 2);
+		return mp_encode_uint(pos, 42);
+	case 3:
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_str0(pos, "#");
+		pos = mp_encode_uint(pos, 4);
+		return mp_encode_uint(pos, 1);
+	case 4:
+		pos = mp_encode_array(pos, 5);
+		pos = mp_encode_str0(pos, ":");
+		pos = mp_encode_uint(pos, 5);
+		pos = mp_encode_uint(pos, 6);
+		pos = mp_encode_uint(pos, 7);
+		return mp_encode_str0(pos, "spliced");
+	default:
+		abort();
+	}
+}
+
+// xrow_update_execute() benchmark. The argument selects the operation:
+// 0 - '+', 1 - '=', 2 - '!', 3 - '#', 4 - ':'.
+static void
+bench_xrow_update(benchmark::State& state)
+{
+	Runtime::instance();
+	DmlDataSet &dataset = DmlDataSet::instance();
+	char ops[MAX_REQUEST_SIZE];
+	char *ops_end = mp_encode_array(ops, 1);
+	ops_end = encode_update_op(ops_end, state.range(0));
+	struct region *region = &fiber()->gc;
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_REQUESTS) {
+			region_truncate(region, 0);
+			total_count += i;
+			i = 0;
+		}
+		uint32_t size;
+		const char *data = xrow_update_execute(
+			ops, ops_end, dataset[i].tuple_begin(),
+			dataset[i].tuple_finish(), tuple_format_runtime,
+			&size, 1, NULL);
+		if (data == NULL)
+			abort();
+		benchmark::DoNotOptimize(data);
+		++i;
+	}
+	total_count += i;
+	region_truncate(region, 0);
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(bench_xrow_update)->DenseRange(0, 4);
+
+BENCHMARK_MAIN();
+
+#include "debug_warning.h"
@@ -223,6 +223,11 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "distance must be either 'euclid' or 'manhattan'");
 		return -1;
 	}
+	if (opts->hash_func == index_hash_func_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "hash_func must be either 'murmur3' or 'xxh3'");
+		return -1;
+	}
 	if (opts->page_size <= 0 || (opts->range_size > 0 &&
 				     opts->page_size > opts->range_size)) {
 		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
@@ -533,6 +538,14 @@ space_def_new_from_tuple(struct tuple *tuple, uint32_t errcode,
 			 "local space can't be synchronous");
 		return NULL;
 	}
+	/* The field map size is limited, see tuple_format_create(). */
+	const uint32_t field_offset_count_max = INT16_MAX / sizeof(uint32_t);
+	if (opts.field_offset_count > field_offset_count_max) {
+		diag_set(ClientError, errcode, tt_cstr(name, name_len),
+			 tt_sprintf("field_offsets must be less than or "
+				    "equal to %u", field_offset_count_max));
+		return NULL;
+	}
 	struct space_def *def =
 		space_def_new(id, uid, exact_field_count, name, name_len,
 			      engine_name, engine_name_len, &opts, fields,
@@ -30,6 +30,7 @@
  */
 #include "applier.h"
 
+#include <fcntl.h>
 #include <msgpuck.h>
 
 #include "authentication.h"
@@ -62,6 +63,13 @@
 #include "tt_static.h"
 #include "memory.h"
 #include "ssl_error.h"
+#include "zstd_iostream.h"
+#include "memtx_engine.h"
+#include "engine.h"
+#include "coio_file.h"
+#include "memtx_tx.h"
+#include "space_cache.h"
+#include "index.h"
 
 STRS(applier_state, applier_STATE);
 
@@ -72,6 +80,10 @@ enum {
 	ROWS_PER_LOG = 100000,
 	/** A maximal batch size carried between applier thread and tx. */
 	APPLIER_THREAD_TX_MAX = 100,
+	/** Max size of checkpoint file data received at once on join. */
+	APPLIER_FILE_CHUNK_SIZE = 1024 * 1024,
+	/** Max number of transactions of a batch applied concurrently. */
+	APPLIER_TX_WORKER_MAX = 32,
 };
 
 static inline void
@@ -757,6 +769,90 @@ applier_connect(struct applier *applier)
 	applier_set_state(applier, APPLIER_READY);
 }
 
+/**
+ * Receive the raw data of a checkpoint file following IPROTO_JOIN_FILE
+ * and write it to a file.
+ */
+static void
+applier_receive_file(struct applier *applier, int fd, const char *path,
+		     uint64_t size)
+{
+	struct ibuf *ibuf = &applier->ibuf;
+	char *buf = (char *)xmalloc(APPLIER_FILE_CHUNK_SIZE);
+	auto buf_guard = make_scoped_guard([=] { free(buf); });
+	uint64_t offset = 0;
+	while (offset < size) {
+		const char *data;
+		size_t count;
+		if (ibuf_used(ibuf) > 0) {
+			/* Data read ahead along with the header. */
+			data = ibuf->rpos;
+			count = MIN(ibuf_used(ibuf), size - offset);
+			ibuf->rpos += count;
+		} else {
+			/* Don't read beyond the file data. */
+			size_t bufsiz = MIN(APPLIER_FILE_CHUNK_SIZE,
+					    size - offset);
+			ssize_t rc = coio_readn_ahead(&applier->io, buf, 1,
+						      bufsiz);
+			if (rc < 0)
+				diag_raise();
+			data = buf;
+			count = rc;
+		}
+		if (coio_pwrite(fd, data, count, offset) < 0) {
+			diag_set(SystemError, "failed to write `%s'", path);
+			diag_raise();
+		}
+		offset += count;
+		applier->last_row_time = ev_monotonic_now(loop());
+	}
+}
+
+/**
+ * Receive a checkpoint file sent by the master in reply to JOIN with
+ * IPROTO_JOIN_FILES and recover the data from it. The per-block
+ * checksums and the end marker of the file are verified by recovery.
+ */
+static void
+applier_recover_join_file(struct applier *applier,
+			  const struct xrow_header *row)
+{
+	struct join_file file;
+	xrow_decode_join_file_xc(row, &file);
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)engine_by_name("memtx");
+	/*
+	 * The file is removed after recovery, the replica makes its own
+	 * checkpoint after bootstrap. The .inprogress files are removed
+	 * on restart in case the replica fails before that.
+	 */
+	char path[PATH_MAX];
+	strlcpy(path, xdir_format_filename(&memtx->snap_dir,
+					   vclock_sum(&file.vclock),
+					   INPROGRESS), sizeof(path));
+	say_info("receiving `%s', %llu bytes", path,
+		 (unsigned long long)file.size);
+	int fd = coio_file_open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to create `%s'", path);
+		diag_raise();
+	}
+	auto file_guard = make_scoped_guard([&] {
+		if (fd >= 0)
+			coio_file_close(fd);
+		coio_unlink(path);
+	});
+	applier_receive_file(applier, fd, path, file.size);
+	if (coio_file_close(fd) != 0) {
+		fd = -1;
+		diag_set(SystemError, "failed to close `%s'", path);
+		diag_raise();
+	}
+	fd = -1;
+	memtx_engine_recover_snapshot_file_xc(memtx, path, &file.vclock);
+}
+
 static uint64_t
 applier_wait_snapshot(struct applier *applier)
 {
@@ -814,6 +910,11 @@ applier_wait_snapshot(struct applier *applier)
 
 	applier_set_state(applier, APPLIER_FETCH_SNAPSHOT);
 
+	if (row.type == IPROTO_JOIN_FILE) {
+		applier_recover_join_file(applier, &row);
+		coio_read_xrow(io, ibuf, &row);
+	}
+
 	/*
 	 * Receive initial data.
 	 */
@@ -1003,6 +1104,33 @@ applier_wait_register(struct applier *applier, uint64_t row_count)
 	return row_count;
 }
 
+/**
+ * Returns the compression level of the replication stream to request
+ * from the master or 0 if the stream shouldn't be compressed.
+ */
+static uint32_t
+applier_compression_level(struct applier *applier)
+{
+	if (!iproto_features_test(&applier->features,
+				  IPROTO_FEATURE_REPLICATION_COMPRESSION))
+		return 0;
+	return replication_compression_level;
+}
+
+/**
+ * Start decompressing the data received from the master after sending
+ * a request with a non-zero compression level. The master compresses
+ * the connection until it's closed, see box_process_join().
+ */
+static void
+applier_start_compression(struct applier *applier, uint32_t level)
+{
+	if (level == 0 || zstd_iostream_is_wrapped(&applier->io))
+		return;
+	if (zstd_iostream_wrap(&applier->io, 0, true) != 0)
+		diag_raise();
+}
+
 static void
 applier_register(struct applier *applier, bool was_anon)
 {
@@ -1047,9 +1175,12 @@ applier_join(struct applier *applier)
 	req.instance_uuid = INSTANCE_UUID;
 	strlcpy(req.instance_name, cfg_instance_name, NODE_NAME_SIZE_MAX);
 	req.version_id = tarantool_version_id();
+	req.compression_level = applier_compression_level(applier);
+	req.join_files = replication_join_files;
 	RegionGuard region_guard(&fiber()->gc);
 	xrow_encode_join(&row, &req);
 	coio_write_xrow(io, &row);
+	applier_start_compression(applier, req.compression_level);
 
 	applier_set_state(applier, APPLIER_WAIT_SNAPSHOT);
 
@@ -1224,9 +1355,13 @@ applier_txn_rollback_cb(struct trigger *trigger, void *event)
 	/*
 	 * Synchronous transaction rollback due to receiving a
 	 * ROLLBACK entry is a normal event and requires no
-	 * special handling.
+	 * special handling. A transaction aborted before it's
+	 * submitted to the journal, e.g. on a conflict, doesn't
+	 * affect the transactions submitted after it. The error
+	 * is handled by the fiber that applied the transaction.
 	 */
-	if (txn->signature != TXN_SIGNATURE_SYNC_ROLLBACK)
+	if (txn->signature != TXN_SIGNATURE_SYNC_ROLLBACK &&
+	    txn->signature != TXN_SIGNATURE_ABORT)
 		applier_rollback_by_wal_io(txn->signature);
 	return 0;
 }
@@ -1240,6 +1375,8 @@ struct replica_cb_data {
 	 * a transaction.
 	 */
 	double txn_last_tm;
+	/** Time when the transaction started to be applied. */
+	double apply_start_time;
 };
 
 /** Update replica associated data once write is complete. */
@@ -1259,6 +1396,12 @@ applier_txn_wal_write_cb(struct trigger *trigger, void *event)
 	struct replica_cb_data *rcb =
 		(struct replica_cb_data *)trigger->data;
 	replica_txn_wal_write_cb(rcb);
+	struct replica *r = replica_by_id(rcb->replica_id);
+	if (r != NULL && r->applier != NULL) {
+		latency_collect(&r->applier->hist.latency,
+				ev_monotonic_now(loop()) -
+				rcb->apply_start_time);
+	}
 
 	/* Broadcast the WAL write across all appliers. */
 	trigger_run(&replicaset.applier.on_wal_write, NULL);
@@ -1375,9 +1518,13 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows,
-	       bool skip_conflict, bool use_triggers)
+/**
+ * Begin a transaction and apply all the rows of the given transactions
+ * to it. Returns the transaction ready to be committed or NULL on error.
+ */
+static struct txn *
+apply_plain_tx_rows(uint32_t replica_id, struct stailq **txs, int tx_count,
+		    bool skip_conflict, bool use_triggers)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1385,34 +1532,42 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	 * conflict safely access failed xrow object and allocate
 	 * IPROTO_NOP on gc.
 	 */
+	double apply_start_time = ev_monotonic_now(loop());
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 	txn->isolation = TXN_ISOLATION_READ_COMMITTED;
 
-	stailq_foreach_entry(item, rows, next) {
-		struct xrow_header *row = &item->row;
-		int res = apply_request(&item->req.dml);
-		if (res != 0 && skip_conflict) {
-			struct error *e = diag_last_error(diag_get());
-			/*
-			 * In case of ER_TUPLE_FOUND error and enabled
-			 * replication_skip_conflict configuration
-			 * option, skip applying the foreign row and
-			 * replace it with NOP in the local write ahead
-			 * log.
-			 */
-			if (e->type == &type_ClientError &&
-			    box_error_code(e) == ER_TUPLE_FOUND) {
-				diag_clear(diag_get());
-				row->type = IPROTO_NOP;
-				row->bodycnt = 0;
-				res = apply_nop(row);
+	for (int i = 0; i < tx_count; i++) {
+		stailq_foreach_entry(item, txs[i], next) {
+			struct xrow_header *row = &item->row;
+			int res = apply_request(&item->req.dml);
+			if (res != 0 && skip_conflict) {
+				struct error *e = diag_last_error(diag_get());
+				/*
+				 * In case of ER_TUPLE_FOUND error and enabled
+				 * replication_skip_conflict configuration
+				 * option, skip applying the foreign row and
+				 * replace it with NOP in the local write ahead
+				 * log. The request is replaced too, in case
+				 * the row is applied again.
+				 */
+				if (e->type == &type_ClientError &&
+				    box_error_code(e) == ER_TUPLE_FOUND) {
+					diag_clear(diag_get());
+					row->type = IPROTO_NOP;
+					row->bodycnt = 0;
+					memset(&item->req.dml, 0,
+					       sizeof(item->req.dml));
+					item->req.dml.header = row;
+					item->req.dml.type = IPROTO_NOP;
+					res = apply_nop(row);
+				}
 			}
+			if (res != 0)
+				goto fail;
 		}
-		if (res != 0)
-			goto fail;
 	}
 
 	/*
@@ -1463,18 +1618,30 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		 * transaction traversed network + remote WAL bundle before
 		 * ack get received.
 		 */
-		item = stailq_last_entry(rows, struct applier_tx_row, next);
+		item = stailq_last_entry(txs[tx_count - 1],
+					 struct applier_tx_row, next);
 		rcb->replica_id = replica_id;
 		rcb->txn_last_tm = item->row.tm;
+		rcb->apply_start_time = apply_start_time;
 
 		trigger_create(on_wal_write, applier_txn_wal_write_cb, rcb, NULL);
 		txn_on_wal_write(txn, on_wal_write);
 	}
-
-	return txn_commit_try_async(txn);
+	return txn;
 fail:
 	txn_abort(txn);
-	return -1;
+	return NULL;
+}
+
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows,
+	       bool skip_conflict, bool use_triggers)
+{
+	struct txn *txn = apply_plain_tx_rows(replica_id, &rows, 1,
+					      skip_conflict, use_triggers);
+	if (txn == NULL)
+		return -1;
+	return txn_commit_try_async(txn);
 }
 
 /** A simpler version of applier_apply_tx() for final join stage. */
@@ -1581,13 +1748,588 @@ applier_process_heartbeat(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+/** How a transaction may be applied relative to the other transactions. */
+enum applier_tx_order {
+	/**
+	 * The transaction may be applied concurrently with the transactions
+	 * it doesn't conflict with.
+	 */
+	APPLIER_TX_CONCURRENT,
+	/**
+	 * The transaction must not yield before it's submitted to the
+	 * journal, so it's applied after all the transactions received
+	 * before it are submitted. E.g. it modifies a memtx space while
+	 * the memtx transaction manager is disabled.
+	 */
+	APPLIER_TX_SERIAL,
+	/**
+	 * The transaction may affect applying of any other transaction,
+	 * e.g. it modifies the schema, so it's applied alone.
+	 */
+	APPLIER_TX_EXCLUSIVE,
+};
+
+/**
+ * Find the slot in applier::tx_key_seq of the key modified by a DML request.
+ * Returns the order the request's transaction may be applied in.
+ */
+static enum applier_tx_order
+applier_tx_row_slot(struct request *request, uint32_t *slot)
+{
+	struct space *space = space_by_id(request->space_id);
+	if (space == NULL || space_is_system(space))
+		return APPLIER_TX_EXCLUSIVE;
+	/* Foreign keys make rows of different spaces depend on each other. */
+	enum space_cache_holder_type pin_type;
+	if (space->has_foreign_keys || space_cache_is_pinned(space, &pin_type))
+		return APPLIER_TX_EXCLUSIVE;
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL)
+		return APPLIER_TX_EXCLUSIVE;
+	enum applier_tx_order order = APPLIER_TX_CONCURRENT;
+	if (space_is_memtx(space) && !memtx_tx_manager_use_mvcc_engine)
+		order = APPLIER_TX_SERIAL;
+	uint32_t hash = request->space_id * 2654435761u;
+	/*
+	 * Rows with different primary keys may conflict in a unique
+	 * secondary index, so all rows of such a space conflict.
+	 */
+	for (uint32_t i = 1; i < space->index_count; i++) {
+		if (space->index[i]->def->opts.is_unique) {
+			*slot = hash % APPLIER_TX_KEY_SLOTS;
+			return order;
+		}
+	}
+	struct key_def *key_def = pk->def->key_def;
+	const char *key;
+	switch (request->type) {
+	case IPROTO_INSERT:
+	case IPROTO_REPLACE:
+	case IPROTO_UPSERT:
+		if (request->tuple == NULL ||
+		    mp_typeof(*request->tuple) != MP_ARRAY)
+			return APPLIER_TX_EXCLUSIVE;
+		key = tuple_extract_key_raw(request->tuple, request->tuple_end,
+					    key_def, MULTIKEY_NONE, NULL);
+		if (key == NULL) {
+			diag_clear(diag_get());
+			return APPLIER_TX_EXCLUSIVE;
+		}
+		break;
+	case IPROTO_UPDATE:
+	case IPROTO_DELETE:
+		key = request->key;
+		if (key == NULL || mp_typeof(*key) != MP_ARRAY)
+			return APPLIER_TX_EXCLUSIVE;
+		break;
+	default:
+		return APPLIER_TX_EXCLUSIVE;
+	}
+	/*
+	 * The key is validated, because hashing relies on the key parts
+	 * having the types of the key definition. An invalid row will
+	 * fail to apply anyway.
+	 */
+	const char *key_end;
+	uint32_t part_count = mp_decode_array(&key);
+	if (part_count != key_def->part_count ||
+	    key_validate_parts(key_def, key, part_count, false,
+			       &key_end) != 0) {
+		diag_clear(diag_get());
+		return APPLIER_TX_EXCLUSIVE;
+	}
+	hash ^= key_hash(key, key_def);
+	*slot = hash % APPLIER_TX_KEY_SLOTS;
+	return order;
+}
+
+/**
+ * Find the order a transaction may be applied in and the sequence number
+ * of the last transaction it conflicts with, and account the keys modified
+ * by the transaction.
+ */
+static enum applier_tx_order
+applier_tx_deps(struct applier *applier, struct stailq *rows, int64_t seq,
+		int64_t *dep_seq)
+{
+	enum applier_tx_order order = APPLIER_TX_CONCURRENT;
+	*dep_seq = 0;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		struct request *request = &item->req.dml;
+		if (request->type == IPROTO_NOP)
+			continue;
+		uint32_t slot;
+		enum applier_tx_order row_order =
+			applier_tx_row_slot(request, &slot);
+		if (row_order == APPLIER_TX_EXCLUSIVE) {
+			order = row_order;
+			break;
+		}
+		order = MAX(order, row_order);
+		/* A group of transactions shares the sequence number. */
+		if (applier->tx_key_seq[slot] < seq)
+			*dep_seq = MAX(*dep_seq, applier->tx_key_seq[slot]);
+		applier->tx_key_seq[slot] = seq;
+	}
+	region_truncate(region, region_svp);
+	if (order != APPLIER_TX_CONCURRENT)
+		*dep_seq = seq - 1;
+	return order;
+}
+
+/**
+ * Return the engine of the spaces modified by a transaction or NULL if it
+ * doesn't modify any spaces.
+ */
+static struct engine *
+applier_tx_engine(struct stailq *rows)
+{
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		struct request *request = &item->req.dml;
+		if (request->type == IPROTO_NOP)
+			continue;
+		struct space *space = space_by_id(request->space_id);
+		if (space != NULL)
+			return space->engine;
+	}
+	return NULL;
+}
+
+/**
+ * Transactions of a batch received by an applier. The transactions are
+ * applied by worker fibers, so that a transaction doesn't have to wait
+ * for the transactions received before it unless it conflicts with them,
+ * e.g. while they read vinyl data from disk. The transactions are still
+ * submitted to the journal in the order of receipt, because it must
+ * follow the LSN order of each origin.
+ *
+ * Consecutive asynchronous transactions may be grouped, see
+ * replication_txn_group_size. A group is applied as one transaction
+ * and submitted to the journal as one entry. The rows keep their LSNs
+ * and transaction boundaries.
+ */
+struct applier_tx_batch {
+	/** The applier that received the batch. */
+	struct applier *applier;
+	/** Session of the applier fiber inherited by the workers. */
+	struct session *session;
+	/** Number of worker fibers that haven't finished yet. */
+	int worker_count;
+	/**
+	 * Signalled when a transaction is submitted to the journal or
+	 * fails and when a worker fiber finishes.
+	 */
+	struct fiber_cond cond;
+	/**
+	 * Set if a transaction failed. The transactions received after
+	 * it are aborted.
+	 */
+	bool is_failed;
+	/** The error of the failed transaction. */
+	struct diag diag;
+	/**
+	 * Order latches of the transaction origins held until all
+	 * the transactions of the batch are submitted or another
+	 * applier waits for one of them, see applier_tx_batch_lock().
+	 */
+	struct latch *latches[VCLOCK_MAX + 1];
+	/** Number of the held latches. */
+	int latch_count;
+	/**
+	 * Rows of the transactions of the group being accumulated, one
+	 * list per transaction. Allocated on the fiber region.
+	 */
+	struct stailq **group;
+	/** Number of the transactions in the group. */
+	int group_count;
+	/** Max number of the transactions in the group. */
+	int group_size;
+	/** Sequence number shared by the transactions of the group. */
+	int64_t group_seq;
+	/** Sequence number of the last transaction the group conflicts with. */
+	int64_t group_dep_seq;
+	/** How the group may be applied. */
+	enum applier_tx_order group_order;
+	/** Engine of the spaces modified by the group or NULL. */
+	struct engine *group_engine;
+};
+
+/** Transactions applied by a worker fiber. */
+struct applier_tx_work {
+	/** The batch the transactions belong to. */
+	struct applier_tx_batch *batch;
+	/** Rows of the transactions, one list per transaction. */
+	struct stailq **txs;
+	/** Number of the transactions. */
+	int tx_count;
+	/** Sequence number of the transactions. */
+	int64_t seq;
+	/** Sequence number of the last transaction they conflict with. */
+	int64_t dep_seq;
+};
+
+static void
+applier_tx_batch_create(struct applier_tx_batch *batch,
+			struct applier *applier)
+{
+	batch->applier = applier;
+	batch->session = current_session();
+	batch->worker_count = 0;
+	fiber_cond_create(&batch->cond);
+	batch->is_failed = false;
+	diag_create(&batch->diag);
+	batch->latch_count = 0;
+	batch->group = NULL;
+	batch->group_count = 0;
+	batch->group_size = 0;
+}
+
+static void
+applier_tx_batch_flush(struct applier_tx_batch *batch);
+
+/**
+ * Apply the accumulated group and wait until all the worker fibers
+ * of a batch finish.
+ */
+static void
+applier_tx_batch_drain(struct applier_tx_batch *batch)
+{
+	applier_tx_batch_flush(batch);
+	while (batch->worker_count > 0)
+		fiber_cond_wait(&batch->cond);
+}
+
+static void
+applier_tx_batch_unlock(struct applier_tx_batch *batch)
+{
+	for (int i = 0; i < batch->latch_count; i++)
+		latch_unlock(batch->latches[i]);
+	batch->latch_count = 0;
+}
+
+/**
+ * Wait for the workers of a batch and release the latches. Returns -1
+ * and sets diag if a transaction of the batch failed.
+ */
+static int
+applier_tx_batch_destroy(struct applier_tx_batch *batch)
+{
+	applier_tx_batch_drain(batch);
+	applier_tx_batch_unlock(batch);
+	/* Aborted transactions must not block the ones received later. */
+	struct applier *applier = batch->applier;
+	applier->tx_submitted_seq = applier->tx_seq;
+	fiber_cond_destroy(&batch->cond);
+	int rc = 0;
+	if (batch->is_failed) {
+		diag_move(&batch->diag, diag_get());
+		rc = -1;
+	}
+	diag_destroy(&batch->diag);
+	return rc;
+}
+
+/** Check if another fiber waits for a latch held by a batch. */
+static bool
+applier_tx_batch_has_waiters(struct applier_tx_batch *batch)
+{
+	for (int i = 0; i < batch->latch_count; i++) {
+		if (!rlist_empty(&batch->latches[i]->queue))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Lock the order latch of a transaction origin for the rest of a batch.
+ * The latches already held are released before waiting for a busy one,
+ * otherwise appliers receiving the same origins could deadlock.
+ *
+ * The latches are also released if another applier waits for one of
+ * them, after the transactions in flight are submitted. So the other
+ * appliers wait only for the transactions applied by at most
+ * APPLIER_TX_WORKER_MAX worker fibers rather than for the whole batch.
+ */
+static void
+applier_tx_batch_lock(struct applier_tx_batch *batch, struct latch *latch)
+{
+	if (applier_tx_batch_has_waiters(batch)) {
+		applier_tx_batch_drain(batch);
+		applier_tx_batch_unlock(batch);
+	}
+	if (latch_owner(latch) == fiber())
+		return;
+	if (latch_trylock(latch) != 0) {
+		applier_tx_batch_drain(batch);
+		applier_tx_batch_unlock(batch);
+		latch_lock(latch);
+	}
+	assert(batch->latch_count < (int)lengthof(batch->latches));
+	batch->latches[batch->latch_count++] = latch;
+}
+
+/**
+ * Wait until the transaction with the given sequence number is submitted.
+ * Returns false if a transaction of the batch fails.
+ */
+static bool
+applier_tx_batch_wait(struct applier_tx_batch *batch, int64_t seq)
+{
+	while (!batch->is_failed && batch->applier->tx_submitted_seq < seq)
+		fiber_cond_wait(&batch->cond);
+	return !batch->is_failed;
+}
+
+/** Fail a batch with the current diag. */
+static void
+applier_tx_batch_fail(struct applier_tx_batch *batch)
+{
+	if (!batch->is_failed) {
+		batch->is_failed = true;
+		diag_move(diag_get(), &batch->diag);
+	}
+	fiber_cond_broadcast(&batch->cond);
+}
+
+/** Promote the applier vclock to a transaction submitted to the journal. */
+static void
+applier_tx_follow(struct stailq *rows)
+{
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	vclock_follow(&replicaset.applier.vclock, last_row->replica_id,
+		      last_row->lsn);
+}
+
+/**
+ * Account the transactions with the given sequence number submitted
+ * to the journal.
+ */
+static void
+applier_tx_batch_submit(struct applier_tx_batch *batch, int64_t seq)
+{
+	assert(batch->applier->tx_submitted_seq == seq - 1);
+	batch->applier->tx_submitted_seq = seq;
+	fiber_cond_broadcast(&batch->cond);
+}
+
+/**
+ * Apply transactions as one and submit them to the journal after the
+ * transactions received before them. If that fails, only the first of
+ * the transactions is applied, so that the transactions preceding the
+ * failed one are still committed, like without grouping. Returns the
+ * number of the submitted transactions or -1 and sets diag on error.
+ */
+static int
+applier_tx_batch_commit(struct applier_tx_batch *batch, struct stailq **txs,
+			int count, int64_t seq)
+{
+	uint32_t replica_id = batch->applier->instance_id;
+	struct txn *txn = apply_plain_tx_rows(replica_id, txs, count,
+					      replication_skip_conflict, true);
+	if (txn == NULL && count > 1) {
+		/* Find the failed transaction. */
+		diag_clear(diag_get());
+		count = 1;
+		txn = apply_plain_tx_rows(replica_id, txs, count,
+					  replication_skip_conflict, true);
+	}
+	if (txn == NULL)
+		return -1;
+	if (!applier_tx_batch_wait(batch, seq - 1)) {
+		diag_set(ClientError, ER_CASCADE_ROLLBACK);
+		txn_abort(txn);
+		return -1;
+	}
+	if (txn_commit_try_async(txn) != 0)
+		return -1;
+	return count;
+}
+
+/**
+ * A transaction applied concurrently with the transactions received
+ * before it may be aborted by a conflict with them in the engine, e.g.
+ * if it read a key they modified. Wait until they are submitted so that
+ * the transaction may be applied again without conflicts. Returns false
+ * if the transaction failed for another reason or the batch failed.
+ */
+static bool
+applier_tx_batch_can_retry(struct applier_tx_batch *batch, int64_t seq)
+{
+	struct error *e = diag_last_error(diag_get());
+	if (e == NULL || e->type != &type_ClientError ||
+	    box_error_code(e) != ER_TRANSACTION_CONFLICT)
+		return false;
+	if (!applier_tx_batch_wait(batch, seq - 1))
+		return false;
+	diag_clear(diag_get());
+	return true;
+}
+
+/**
+ * Apply transactions with the given sequence number and submit them to
+ * the journal after the transactions received before them. Several
+ * transactions are applied as one, see applier_tx_batch_commit(). Fails
+ * the batch on error.
+ */
+static void
+applier_tx_batch_apply(struct applier_tx_batch *batch, struct stailq **txs,
+		       int tx_count, int64_t seq)
+{
+	int count = tx_count;
+	for (int i = 0; i < tx_count; i += count) {
+		int rc = applier_tx_batch_commit(batch, &txs[i], count, seq);
+		/* Retry only once, nothing can conflict with it then. */
+		if (rc < 0 && applier_tx_batch_can_retry(batch, seq))
+			rc = applier_tx_batch_commit(batch, &txs[i], count, seq);
+		if (rc < 0) {
+			applier_tx_batch_fail(batch);
+			return;
+		}
+		count = rc;
+		for (int j = i; j < i + count; j++)
+			applier_tx_follow(txs[j]);
+	}
+	applier_tx_batch_submit(batch, seq);
+}
+
+static int
+applier_tx_worker_f(va_list ap)
+{
+	struct applier_tx_work *work = va_arg(ap, struct applier_tx_work *);
+	struct applier_tx_batch *batch = work->batch;
+	fiber_set_session(fiber(), batch->session);
+	fiber_set_user(fiber(), &batch->session->credentials);
+	if (applier_tx_batch_wait(batch, work->dep_seq)) {
+		applier_tx_batch_apply(batch, work->txs, work->tx_count,
+				       work->seq);
+	}
+	batch->worker_count--;
+	fiber_cond_broadcast(&batch->cond);
+	return 0;
+}
+
+/** Start applying transactions in a worker fiber. */
+static int
+applier_tx_batch_dispatch(struct applier_tx_batch *batch, struct stailq **txs,
+			  int tx_count, int64_t seq, int64_t dep_seq)
+{
+	while (batch->worker_count >= APPLIER_TX_WORKER_MAX)
+		fiber_cond_wait(&batch->cond);
+	size_t size;
+	struct applier_tx_work *work =
+		region_alloc_object(&fiber()->gc, typeof(*work), &size);
+	if (work == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_object", "work");
+		return -1;
+	}
+	struct fiber *f = fiber_new("applier_tx", applier_tx_worker_f);
+	if (f == NULL)
+		return -1;
+	work->batch = batch;
+	work->txs = txs;
+	work->tx_count = tx_count;
+	work->seq = seq;
+	work->dep_seq = dep_seq;
+	batch->worker_count++;
+	fiber_start(f, work);
+	return 0;
+}
+
+/** Apply the transactions accumulated in the group of a batch. */
+static void
+applier_tx_batch_flush(struct applier_tx_batch *batch)
+{
+	int count = batch->group_count;
+	if (count == 0)
+		return;
+	struct stailq **txs = batch->group;
+	batch->group = NULL;
+	batch->group_count = 0;
+	if (batch->is_failed)
+		return;
+	if (batch->group_order == APPLIER_TX_SERIAL &&
+	    batch->worker_count == 0) {
+		applier_tx_batch_apply(batch, txs, count, batch->group_seq);
+	} else if (applier_tx_batch_dispatch(batch, txs, count,
+					     batch->group_seq,
+					     batch->group_dep_seq) != 0) {
+		applier_tx_batch_fail(batch);
+	}
+}
+
+/**
+ * Check if a transaction may be added to the group of a batch. Applies
+ * the group if the transaction doesn't fit in it.
+ */
+static bool
+applier_tx_batch_can_group(struct applier_tx_batch *batch,
+			   struct stailq *rows, struct engine **engine)
+{
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	/*
+	 * A synchronous transaction is confirmed by its own LSN, so it
+	 * can't be committed together with the following transactions.
+	 */
+	if (replication_txn_group_size <= 1 || last_row->wait_sync) {
+		applier_tx_batch_flush(batch);
+		return false;
+	}
+	/* Only one engine can be used in a transaction. */
+	*engine = applier_tx_engine(rows);
+	if (batch->group_count > 0 &&
+	    (batch->group_count >= batch->group_size ||
+	     (*engine != NULL && batch->group_engine != NULL &&
+	      *engine != batch->group_engine)))
+		applier_tx_batch_flush(batch);
+	return !batch->is_failed;
+}
+
+/** Add a transaction to the group of a batch. */
+static int
+applier_tx_batch_group(struct applier_tx_batch *batch, struct stailq *rows,
+		       enum applier_tx_order order, int64_t dep_seq,
+		       struct engine *engine)
+{
+	if (batch->group_count == 0) {
+		int size = replication_txn_group_size;
+		size_t alloc_size;
+		batch->group = region_alloc_array(&fiber()->gc,
+						  typeof(*batch->group), size,
+						  &alloc_size);
+		if (batch->group == NULL) {
+			diag_set(OutOfMemory, alloc_size,
+				 "region_alloc_array", "group");
+			return -1;
+		}
+		batch->group_size = size;
+		batch->group_dep_seq = 0;
+		batch->group_order = APPLIER_TX_CONCURRENT;
+		batch->group_engine = NULL;
+	}
+	assert(batch->group_count < batch->group_size);
+	batch->group[batch->group_count++] = rows;
+	batch->group_dep_seq = MAX(batch->group_dep_seq, dep_seq);
+	batch->group_order = MAX(batch->group_order, order);
+	if (engine != NULL)
+		batch->group_engine = engine;
+	return 0;
+}
+
 /**
  * Apply all rows in the rows queue as a single transaction.
+ * The transaction may be still being applied by a worker fiber
+ * on return, see applier_tx_batch.
  *
  * Return 0 for success or -1 in case of an error.
  */
 static int
-applier_apply_tx(struct applier *applier, struct stailq *rows)
+applier_apply_tx(struct applier_tx_batch *batch, struct stailq *rows)
 {
 	/*
 	 * Initially we've been filtering out data if it came from
@@ -1605,6 +2347,7 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	 * Finally we dropped such "sender" filtration and use transaction
 	 * "initiator" filtration via xrow->replica_id only.
 	 */
+	struct applier *applier = batch->applier;
 	struct applier_tx_row *txr = stailq_first_entry(rows,
 							struct applier_tx_row,
 							next);
@@ -1612,7 +2355,6 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	struct xrow_header *last_row;
 	last_row = &stailq_last_entry(rows, struct applier_tx_row, next)->row;
 	struct replica *replica = replica_by_id(first_row->replica_id);
-	int rc = 0;
 	/*
 	 * In a full mesh topology, the same set of changes
 	 * may arrive via two concurrently running appliers.
@@ -1621,10 +2363,10 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	 */
 	struct latch *latch = (replica ? &replica->order_latch :
 			       &replicaset.applier.order_latch);
-	latch_lock(latch);
+	applier_tx_batch_lock(batch, latch);
 	if (vclock_get(&replicaset.applier.vclock,
 		       last_row->replica_id) >= last_row->lsn) {
-		goto finish;
+		return 0;
 	} else if (vclock_get(&replicaset.applier.vclock,
 			      first_row->replica_id) >= first_row->lsn) {
 		/*
@@ -1653,20 +2395,58 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 		 * each other.
 		 */
 		assert(first_row == last_row);
-		rc = apply_synchro_req(applier->instance_id, &txr->row,
-				       &txr->req.synchro);
-	} else {
-		rc = apply_plain_tx(applier->instance_id, rows,
-				    replication_skip_conflict, true);
+		applier_tx_batch_drain(batch);
+		if (batch->is_failed)
+			return 0;
+		if (apply_synchro_req(applier->instance_id, &txr->row,
+				      &txr->req.synchro) != 0)
+			return -1;
+		applier_tx_follow(rows);
+		applier_tx_batch_submit(batch, ++applier->tx_seq);
+		return 0;
 	}
-	if (rc != 0)
-		goto finish;
-
-	vclock_follow(&replicaset.applier.vclock, last_row->replica_id,
-		      last_row->lsn);
-finish:
-	latch_unlock(latch);
-	return rc;
+	struct engine *engine = NULL;
+	bool can_group = applier_tx_batch_can_group(batch, rows, &engine);
+	int64_t seq = batch->group_count > 0 ? batch->group_seq :
+			++applier->tx_seq;
+	int64_t dep_seq;
+	enum applier_tx_order order = applier_tx_deps(applier, rows, seq,
+						      &dep_seq);
+	if (order == APPLIER_TX_EXCLUSIVE) {
+		if (batch->group_count > 0) {
+			applier_tx_batch_flush(batch);
+			seq = ++applier->tx_seq;
+		}
+	} else if (can_group) {
+		batch->group_seq = seq;
+		return applier_tx_batch_group(batch, rows, order, dep_seq,
+					      engine);
+	}
+	if (order == APPLIER_TX_EXCLUSIVE ||
+	    (order == APPLIER_TX_SERIAL && batch->worker_count == 0)) {
+		/*
+		 * Apply the transaction in this fiber after all
+		 * the transactions received before it are submitted.
+		 */
+		applier_tx_batch_drain(batch);
+		if (batch->is_failed)
+			return 0;
+		if (apply_plain_tx(applier->instance_id, rows,
+				   replication_skip_conflict, true) != 0)
+			return -1;
+		applier_tx_follow(rows);
+		applier_tx_batch_submit(batch, seq);
+		return 0;
+	}
+	size_t size;
+	struct stailq **txs = region_alloc_object(&fiber()->gc, typeof(*txs),
+						  &size);
+	if (txs == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_object", "txs");
+		return -1;
+	}
+	*txs = rows;
+	return applier_tx_batch_dispatch(batch, txs, 1, seq, dep_seq);
 }
 
 /**
@@ -1832,6 +2612,25 @@ applier_handle_raft(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+/**
+ * Account a received transaction in the applier histograms. The size
+ * of the transaction is estimated as the sum of the sizes of its rows.
+ */
+static void
+applier_tx_collect_stat(struct applier *applier, struct stailq *rows)
+{
+	size_t size = 0;
+	struct applier_tx_row *txr;
+	stailq_foreach_entry(txr, rows, next)
+		size += xrow_approx_len(&txr->row);
+	replication_hist_collect_bytes(&applier->hist, size);
+	txr = stailq_last_entry(rows, struct applier_tx_row, next);
+	if (txr->row.lsn != 0 && txr->row.tm > 0) {
+		latency_collect(&applier->hist.lag,
+				MAX(ev_now(loop()) - txr->row.tm, 0));
+	}
+}
+
 /**
  * The tx part of applier-in-thread machinery. Apply all the parsed
  * transactions.
@@ -1841,38 +2640,55 @@ applier_process_batch(struct cmsg *base)
 {
 	struct applier_data_msg *msg = (struct applier_data_msg *)base;
 	struct applier *applier = msg->base.applier;
+	struct applier_tx_batch batch;
+	applier_tx_batch_create(&batch, applier);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
 	struct applier_tx *tx;
-	stailq_foreach_entry(tx, &msg->txs, next) {
-		struct applier_tx_row *last_txr =
-			stailq_last_entry(&tx->rows, struct applier_tx_row,
-					  next);
-		/*
-		 * Tarantool before version 2.11.0 doesn't send heartbeats when
-		 * there is data to be sent. Instead each row is treated as
-		 * heartbeat.
-		 */
-		if (applier->version_id < version_id(2, 11, 0)) {
-			raft_process_heartbeat(box_raft(),
-					       applier->instance_id);
-		}
-		if (last_txr->row.lsn == 0) {
-			if (applier_process_heartbeat(applier, last_txr) != 0)
-				diag_raise();
-			if (applier_handle_raft(applier, last_txr) != 0)
+	try {
+		stailq_foreach_entry(tx, &msg->txs, next) {
+			if (batch.is_failed)
+				break;
+			struct applier_tx_row *last_txr =
+				stailq_last_entry(&tx->rows,
+						  struct applier_tx_row, next);
+			applier_tx_collect_stat(applier, &tx->rows);
+			/*
+			 * Tarantool before version 2.11.0 doesn't send
+			 * heartbeats when there is data to be sent. Instead
+			 * each row is treated as heartbeat.
+			 */
+			if (applier->version_id < version_id(2, 11, 0)) {
+				raft_process_heartbeat(box_raft(),
+						       applier->instance_id);
+			}
+			if (last_txr->row.lsn == 0) {
+				applier_tx_batch_drain(&batch);
+				if (applier_process_heartbeat(applier,
+							      last_txr) != 0)
+					diag_raise();
+				if (applier_handle_raft(applier, last_txr) != 0)
+					diag_raise();
+				applier_signal_ack(applier);
+				applier_check_sync(applier);
+			} else if (applier_apply_tx(&batch, &tx->rows) != 0) {
 				diag_raise();
-			applier_signal_ack(applier);
-			applier_check_sync(applier);
-		} else if (applier_apply_tx(applier, &tx->rows) != 0) {
-			diag_raise();
-		}
-		if (applier->state == APPLIER_FINAL_JOIN &&
-		    instance_id != REPLICA_ID_NIL) {
-			say_info("final data received");
-			applier_set_state(applier, APPLIER_JOINED);
-			applier_set_state(applier, APPLIER_READY);
-			applier_set_state(applier, APPLIER_FOLLOW);
+			}
+			if (applier->state == APPLIER_FINAL_JOIN &&
+			    instance_id != REPLICA_ID_NIL) {
+				say_info("final data received");
+				applier_set_state(applier, APPLIER_JOINED);
+				applier_set_state(applier, APPLIER_READY);
+				applier_set_state(applier, APPLIER_FOLLOW);
+			}
 		}
+	} catch (Exception *) {
+		applier_tx_batch_fail(&batch);
 	}
+	int rc = applier_tx_batch_destroy(&batch);
+	region_truncate(region, region_svp);
+	if (rc != 0)
+		diag_raise();
 
 	/* Return the message to applier thread. */
 	cmsg_init(&msg->base.base, return_route);
@@ -2329,9 +3145,22 @@ applier_subscribe(struct applier *applier)
 	 * instance as soon as local WAL starts accepting writes.
 	 */
 	req.id_filter = box_is_orphan() ? 0 : 1 << instance_id;
+	req.compression_level = applier_compression_level(applier);
 	RegionGuard region_guard(&fiber()->gc);
+	if (replication_spaces != NULL) {
+		int count = replication_space_count;
+		size_t size = mp_sizeof_array(count) +
+			      count * mp_sizeof_uint(UINT32_MAX);
+		char *data = (char *)xregion_alloc(&fiber()->gc, size);
+		req.space_filter = data;
+		data = mp_encode_array(data, count);
+		for (int i = 0; i < count; i++)
+			data = mp_encode_uint(data, replication_spaces[i]);
+		req.space_filter_end = data;
+	}
 	xrow_encode_subscribe(&row, &req);
 	coio_write_xrow(io, &row);
+	applier_start_compression(applier, req.compression_level);
 
 	/* Read SUBSCRIBE response */
 	if (applier->version_id >= version_id(1, 6, 7)) {
@@ -2707,6 +3536,7 @@ applier_new(const struct uri *uri)
 	rlist_create(&applier->on_state);
 	fiber_cond_create(&applier->resume_cond);
 	diag_create(&applier->diag);
+	replication_hist_create(&applier->hist);
 
 	return applier;
 }
@@ -2721,6 +3551,7 @@ applier_delete(struct applier *applier)
 	uri_destroy(&applier->uri);
 	trigger_destroy(&applier->on_state);
 	diag_destroy(&applier->diag);
+	replication_hist_destroy(&applier->hist);
 	free(applier);
 }
 
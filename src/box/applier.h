@@ -39,6 +39,7 @@
 
 #include "fiber_cond.h"
 #include "iostream.h"
+#include "replication_hist.h"
 #include "trigger.h"
 #include "trivia/util.h"
 #include "tt_uuid.h"
@@ -54,6 +55,13 @@ extern "C" {
 
 enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 
+/**
+ * Number of slots in the table used to track the keys modified by
+ * transactions being applied concurrently. Keys are not stored, so
+ * a collision merely makes a transaction wait for an unrelated one.
+ */
+enum { APPLIER_TX_KEY_SLOTS = 4096 };
+
 #define applier_STATE(_)                                             \
 	_(APPLIER_OFF, 0)                                            \
 	_(APPLIER_CONNECT, 1)                                        \
@@ -151,6 +159,11 @@ struct applier {
 	ev_tstamp last_row_time;
 	/** Number of seconds this replica is behind the remote master */
 	ev_tstamp lag;
+	/**
+	 * Distributions of the transaction lag, the apply latency and
+	 * the received bytes per second, see box.stat.replication().
+	 */
+	struct replication_hist hist;
 	/** The last box_error_code() logged to avoid log flooding */
 	uint32_t last_logged_errcode;
 	/** Remote instance ID. */
@@ -220,6 +233,22 @@ struct applier {
 	bool is_ack_sent;
 	/** True if ACK was signalled in tx while ack_msg was en route. */
 	bool is_ack_pending;
+	/**
+	 * Sequence number of the last transaction dispatched for applying.
+	 * Transactions are numbered in the order of receipt.
+	 */
+	int64_t tx_seq;
+	/**
+	 * Sequence number of the last transaction submitted to the journal.
+	 * Transactions are submitted strictly in the order of receipt.
+	 */
+	int64_t tx_submitted_seq;
+	/**
+	 * Sequence numbers of the last transactions that modified the keys
+	 * hashed to each slot. A transaction may start applying as soon as
+	 * all the transactions it conflicts with are submitted.
+	 */
+	int64_t tx_key_seq[APPLIER_TX_KEY_SLOTS];
 	/** Fields used only by applier thread. */
 	struct {
 		alignas(CACHELINE_SIZE)
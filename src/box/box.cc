@@ -98,6 +98,7 @@
 #include "memory.h"
 #include "node_name.h"
 #include "tt_sort.h"
+#include "zstd_iostream.h"
 
 static char status[64] = "unconfigured";
 
@@ -446,8 +447,11 @@ box_process_rw(struct request *request, struct space *space,
 	bool return_tuple = false;
 	struct txn *txn = in_txn();
 	bool is_autocommit = txn == NULL;
-	if (is_autocommit && (txn = txn_begin()) == NULL)
-		return -1;
+	if (is_autocommit) {
+		if ((txn = txn_begin()) == NULL)
+			return -1;
+		txn_set_flags(txn, TXN_IS_AUTOCOMMIT);
+	}
 	assert(iproto_type_is_dml(request->type));
 	rmean_collect(rmean_box, request->type, 1);
 	if (access_check_space(space, PRIV_W) != 0)
@@ -1240,6 +1244,70 @@ box_check_replication_threads(void)
 	return 0;
 }
 
+static int
+box_check_replication_relay_threads(void)
+{
+	int count = cfg_geti("replication_relay_threads");
+	if (count < 0 || count > REPLICATION_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "replication_relay_threads",
+			 tt_sprintf("must be greater than or equal to 0, less "
+				    "than or equal to %d",
+				    REPLICATION_THREADS_MAX));
+		return -1;
+	}
+	return 0;
+}
+
+static int
+box_check_replication_compression_level(void)
+{
+	int level = cfg_geti("replication_compression_level");
+	int max_level = zstd_iostream_max_level();
+	if (level < 0 || level > max_level) {
+		diag_set(ClientError, ER_CFG, "replication_compression_level",
+			 tt_sprintf("must be greater than or equal to 0, "
+				    "less than or equal to %d", max_level));
+		return -1;
+	}
+	return level;
+}
+
+static int
+box_check_replication_txn_group_size(void)
+{
+	int size = cfg_geti("replication_txn_group_size");
+	if (size < 1) {
+		diag_set(ClientError, ER_CFG, "replication_txn_group_size",
+			 "must be greater than 0");
+		return -1;
+	}
+	return size;
+}
+
+/**
+ * Check replication_spaces option validity. Returns the number of space
+ * ids and stores them in @a ids unless it's NULL. On error returns -1.
+ */
+static int
+box_check_replication_spaces(uint32_t *ids)
+{
+	int count = cfg_getarr_size("replication_spaces");
+	for (int i = 0; i < count; i++) {
+		const char *val = cfg_getarr_elem("replication_spaces", i);
+		char *end;
+		long long id = val == NULL ? -1 : strtoll(val, &end, 10);
+		if (id < 0 || id > BOX_SPACE_MAX || end == val ||
+		    *end != '\0') {
+			diag_set(ClientError, ER_CFG, "replication_spaces",
+				 "must be an array of space ids");
+			return -1;
+		}
+		if (ids != NULL)
+			ids[i] = id;
+	}
+	return count;
+}
+
 /** Check bootstrap_strategy option validity. */
 static enum bootstrap_strategy
 box_check_bootstrap_strategy(void)
@@ -1594,6 +1662,18 @@ box_check_wal_queue_max_size(void)
 	return size;
 }
 
+static int64_t
+box_check_wal_tail_size(void)
+{
+	int64_t size = cfg_geti64("wal_tail_size");
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "wal_tail_size",
+			 "the value must be >= 0");
+		return -1;
+	}
+	return size;
+}
+
 static double
 box_check_wal_cleanup_delay(void)
 {
@@ -1882,6 +1962,14 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_replication_threads() < 0)
 		diag_raise();
+	if (box_check_replication_relay_threads() < 0)
+		diag_raise();
+	if (box_check_replication_compression_level() < 0)
+		diag_raise();
+	if (box_check_replication_spaces(NULL) < 0)
+		diag_raise();
+	if (box_check_replication_txn_group_size() < 0)
+		diag_raise();
 	box_check_replication_sync_timeout();
 	if (box_check_bootstrap_strategy() == BOOTSTRAP_STRATEGY_INVALID)
 		diag_raise();
@@ -1894,6 +1982,8 @@ box_check_config(void)
 	box_check_wal_mode(cfg_gets("wal_mode"));
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
+	if (box_check_wal_tail_size() < 0)
+		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
@@ -2189,6 +2279,49 @@ box_set_replication_sync_timeout(void)
 	replication_sync_timeout = box_check_replication_sync_timeout();
 }
 
+int
+box_set_replication_compression_level(void)
+{
+	int level = box_check_replication_compression_level();
+	if (level < 0)
+		return -1;
+	replication_compression_level = level;
+	return 0;
+}
+
+void
+box_set_replication_join_files(void)
+{
+	replication_join_files = cfg_geti("replication_join_files");
+}
+
+int
+box_set_replication_spaces(void)
+{
+	int count = box_check_replication_spaces(NULL);
+	if (count < 0)
+		return -1;
+	uint32_t *ids = NULL;
+	if (count > 0) {
+		ids = (uint32_t *)xmalloc(count * sizeof(*ids));
+		box_check_replication_spaces(ids);
+	}
+	free(replication_spaces);
+	replication_spaces = ids;
+	replication_space_count = count;
+	return 0;
+}
+
+int
+box_set_replication_txn_group_size(void)
+{
+	int size = box_check_replication_txn_group_size();
+	if (size < 0)
+		return -1;
+	replication_txn_group_size = size;
+	return 0;
+}
+
 void
 box_set_replication_skip_conflict(void)
 {
@@ -3080,6 +3213,16 @@ box_set_wal_queue_max_size(void)
 	return 0;
 }
 
+int
+box_set_wal_tail_size(void)
+{
+	int64_t size = box_check_wal_tail_size();
+	if (size < 0)
+		return -1;
+	wal_set_tail_size(size);
+	return 0;
+}
+
 int
 box_set_wal_cleanup_delay(void)
 {
@@ -3535,14 +3678,12 @@ box_index_id_by_name(uint32_t space_id, const char *name, uint32_t len)
 	return result;
 }
 
-int
-box_process1(struct request *request, box_tuple_t **result)
+/**
+ * Checks that DML requests can be executed in the given space.
+ */
+static int
+box_check_space_writable(struct space *space)
 {
-	if (box_check_slice() != 0)
-		return -1;
-	struct space *space = space_cache_find(request->space_id);
-	if (space == NULL)
-		return -1;
 	/*
 	 * Allow to write to temporary and local spaces in the read-only mode.
 	 * To handle space truncation, we postpone the read-only check for the
@@ -3571,10 +3712,114 @@ box_process1(struct request *request, box_tuple_t **result)
 			return -1;
 		}
 	}
+	return 0;
+}
 
+int
+box_process1(struct request *request, box_tuple_t **result)
+{
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space = space_cache_find(request->space_id);
+	if (space == NULL)
+		return -1;
+	if (box_check_space_writable(space) != 0)
+		return -1;
 	return box_process_rw(request, space, result);
 }
 
+/**
+ * Execute one statement of a batch, see box_process_many(). The
+ * statement is rolled back on failure.
+ */
+static int
+box_process_many_stmt(struct txn *txn, struct space *space,
+		      struct request *stmt)
+{
+	if (mp_typeof(*stmt->tuple) != MP_ARRAY) {
+		diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+		return -1;
+	}
+	if (txn_begin_stmt(txn, space, stmt->type) != 0)
+		return -1;
+	struct tuple *unused;
+	if (space_execute_dml(space, txn, stmt, &unused) != 0) {
+		txn_rollback_stmt(txn);
+		return -1;
+	}
+	return txn_commit_stmt(txn, stmt);
+}
+
+int
+box_process_many(struct request *request,
+		 box_process_many_on_error_f on_error, void *ctx)
+{
+	assert(request->type == IPROTO_INSERT ||
+	       request->type == IPROTO_REPLACE);
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space = space_cache_find(request->space_id);
+	if (space == NULL)
+		return -1;
+	if (box_check_space_writable(space) != 0)
+		return -1;
+	const char *tuples = request->tuple;
+	if (mp_typeof(*tuples) != MP_ARRAY) {
+		diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+		return -1;
+	}
+	uint32_t count = mp_decode_array(&tuples);
+	uint32_t space_version = space_cache_version;
+	struct txn *txn = in_txn();
+	bool is_autocommit = txn == NULL;
+	struct txn_savepoint *svp = NULL;
+	if (is_autocommit) {
+		if ((txn = txn_begin()) == NULL)
+			return -1;
+	} else {
+		/* Roll back the whole batch on failure. */
+		svp = txn_savepoint_new(txn, NULL);
+		if (svp == NULL)
+			return -1;
+	}
+	if (access_check_space(space, PRIV_W) != 0)
+		goto rollback;
+	rmean_collect(rmean_box, request->type, count);
+	struct request stmt;
+	stmt = *request;
+	for (uint32_t i = 0; i < count; i++) {
+		stmt.tuple = tuples;
+		mp_next(&tuples);
+		stmt.tuple_end = tuples;
+		/*
+		 * A statement may yield (e.g. a vinyl space reads disk),
+		 * and the space may be altered meanwhile.
+		 */
+		if (unlikely(space_cache_version != space_version)) {
+			space = space_cache_find(request->space_id);
+			if (space == NULL)
+				goto rollback;
+			space_version = space_cache_version;
+		}
+		if (box_process_many_stmt(txn, space, &stmt) == 0)
+			continue;
+		if (on_error == NULL ||
+		    on_error(ctx, i, diag_last_error(diag_get())) != 0)
+			goto rollback;
+		diag_clear(diag_get());
+	}
+	if (is_autocommit)
+		return txn_commit(txn) < 0 ? -1 : 0;
+	txn_savepoint_release(svp);
+	return 0;
+rollback:
+	if (is_autocommit)
+		txn_abort(txn);
+	else
+		box_txn_rollback_to_savepoint(svp);
+	return -1;
+}
+
 void
 box_iterator_position_pack(const char *pos, const char *pos_end,
 			   uint32_t found, const char **packed_pos,
@@ -3781,6 +4026,32 @@ box_replace(uint32_t space_id, const char *tuple, const char *tuple_end,
 	return box_process1(&request, result);
 }
 
+API_EXPORT int
+box_insert_many(uint32_t space_id, const char *tuples, const char *tuples_end)
+{
+	mp_tuple_assert(tuples, tuples_end);
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = IPROTO_INSERT;
+	request.space_id = space_id;
+	request.tuple = tuples;
+	request.tuple_end = tuples_end;
+	return box_process_many(&request, NULL, NULL);
+}
+
+API_EXPORT int
+box_replace_many(uint32_t space_id, const char *tuples, const char *tuples_end)
+{
+	mp_tuple_assert(tuples, tuples_end);
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = IPROTO_REPLACE;
+	request.space_id = space_id;
+	request.tuple = tuples;
+	request.tuple_end = tuples_end;
+	return box_process_many(&request, NULL, NULL);
+}
+
 API_EXPORT int
 box_delete(uint32_t space_id, uint32_t index_id, const char *key,
 	   const char *key_end, box_tuple_t **result)
@@ -4268,6 +4539,50 @@ box_process_register(struct iostream *io, const struct xrow_header *header)
 	gc_guard.is_active = false;
 }
 
+/**
+ * Start compressing the data sent over a replication connection if the
+ * replica requested it. The replica expects the compressed stream right
+ * after its request, but it also accepts plain data, so errors raised
+ * before this point reach it as is. The connection stays compressed
+ * until it's closed.
+ */
+static void
+box_start_replication_compression(struct iostream *io, uint32_t level)
+{
+	if (level == 0 || zstd_iostream_is_wrapped(io))
+		return;
+	level = MIN(level, (uint32_t)zstd_iostream_max_level());
+	if (zstd_iostream_wrap(io, level, false) != 0)
+		diag_raise();
+}
+
+/** Space callback failing if the space data is stored by vinyl. */
+static int
+box_check_space_is_not_vinyl(struct space *space, void *arg)
+{
+	(void)arg;
+	return space_is_vinyl(space) ? -1 : 0;
+}
+
+/**
+ * Returns the checkpoint to send to a joining replica as files or NULL
+ * if a read view must be sent instead. Only the memtx snapshot file is
+ * sent, so vinyl spaces can be sent only in a read view.
+ */
+static struct gc_checkpoint *
+box_join_checkpoint(void)
+{
+	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
+	if (checkpoint == NULL)
+		return NULL;
+	if (space_foreach(box_check_space_is_not_vinyl, NULL) != 0) {
+		say_info("can't send checkpoint files to a replica "
+			 "because there are vinyl spaces");
+		return NULL;
+	}
+	return checkpoint;
+}
+
 void
 box_process_join(struct iostream *io, const struct xrow_header *header)
 {
@@ -4311,12 +4626,25 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	 *  - Cluster UUID in _schema space
 	 *  - Registration of master in _cluster space
 	 *  - Registration of the new replica in _cluster space
+	 *
+	 * If the replica sets JOIN_FILES in the request, the initial data
+	 * may be sent as the master's latest checkpoint file instead:
+	 *
+	 * <= OK { VCLOCK: start_vclock }
+	 *     - start_vclock - vclock of the checkpoint.
+	 * <= JOIN_FILE { VCLOCK: start_vclock, FILE_SIZE: size }
+	 *    Followed by `size` bytes of the memtx snapshot file. The
+	 *    replica recovers the data from it locally.
+	 * <= OK { VCLOCK: stop_vclock }
+	 *
+	 * The final stage is the same, it starts from the checkpoint.
 	 */
 
 	assert(header->type == IPROTO_JOIN);
 
 	struct join_request req;
 	xrow_decode_join_xc(header, &req);
+	box_start_replication_compression(io, req.compression_level);
 
 	/* Check that bootstrap has been finished */
 	if (!is_box_configured)
@@ -4364,12 +4692,29 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 				  tt_uuid_str(&other->uuid));
 		}
 	}
+	/*
+	 * Pin the checkpoint sent to the replica, if any, so that it isn't
+	 * removed while being sent.
+	 */
+	struct gc_checkpoint *checkpoint = NULL;
+	struct gc_checkpoint_ref checkpoint_ref;
+	if (req.join_files)
+		checkpoint = box_join_checkpoint();
+	if (checkpoint != NULL) {
+		gc_ref_checkpoint(checkpoint, &checkpoint_ref, "replica %s",
+				  tt_uuid_str(&req.instance_uuid));
+	}
+	auto checkpoint_guard = make_scoped_guard([&] {
+		if (checkpoint != NULL)
+			gc_unref_checkpoint(&checkpoint_ref);
+	});
 	/*
 	 * Register the replica as a WAL consumer so that
 	 * it can resume FINAL JOIN where INITIAL JOIN ends.
 	 */
-	struct gc_consumer *gc = gc_consumer_register(&replicaset.vclock,
-				"replica %s", tt_uuid_str(&req.instance_uuid));
+	struct gc_consumer *gc = gc_consumer_register(
+		checkpoint != NULL ? &checkpoint->vclock : &replicaset.vclock,
+		"replica %s", tt_uuid_str(&req.instance_uuid));
 	if (gc == NULL)
 		diag_raise();
 	auto gc_guard = make_scoped_guard([&] { gc_consumer_unregister(gc); });
@@ -4381,7 +4726,20 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	 * Initial stream: feed replica with dirty data from engines.
 	 */
 	struct vclock start_vclock;
-	relay_initial_join(io, header->sync, &start_vclock, req.version_id);
+	if (checkpoint != NULL) {
+		vclock_copy(&start_vclock, &checkpoint->vclock);
+		struct memtx_engine *memtx =
+			(struct memtx_engine *)engine_by_name("memtx");
+		char path[PATH_MAX];
+		strlcpy(path, xdir_format_filename(&memtx->snap_dir,
+						   vclock_sum(&start_vclock),
+						   NONE), sizeof(path));
+		relay_initial_join_files(io, header->sync, &start_vclock,
+					 path);
+	} else {
+		relay_initial_join(io, header->sync, &start_vclock,
+				   req.version_id);
+	}
 	say_info("initial data sent.");
 	/**
 	 * Register the replica after sending the last row but before sending
@@ -4439,6 +4797,7 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 
 	struct subscribe_request req;
 	xrow_decode_subscribe_xc(header, &req);
+	box_start_replication_compression(io, req.compression_level);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&req.instance_uuid, &INSTANCE_UUID))
@@ -4607,7 +4966,8 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &req.vclock,
-			req.version_id, req.id_filter, sent_raft_term);
+			req.version_id, req.id_filter, req.space_filter,
+			sent_raft_term);
 }
 
 void
@@ -5295,6 +5655,13 @@ box_cfg_xc(void)
 	if (box_set_replication_synchro_timeout() != 0)
 		diag_raise();
 	box_set_replication_sync_timeout();
+	if (box_set_replication_compression_level() != 0)
+		diag_raise();
+	box_set_replication_join_files();
+	if (box_set_replication_spaces() != 0)
+		diag_raise();
+	if (box_set_replication_txn_group_size() != 0)
+		diag_raise();
 	box_set_replication_skip_conflict();
 	if (box_check_instance_name(cfg_instance_name) != 0)
 		diag_raise();
@@ -5538,6 +5905,7 @@ box_reset_stat(void)
 	rmean_cleanup(rmean_error);
 	engine_reset_stat();
 	space_foreach(box_reset_space_stat, NULL);
+	replicaset_reset_stat();
 }
 
 static void
@@ -5738,7 +6106,8 @@ box_storage_init(void)
 	gc_init(on_garbage_collection);
 	engine_init();
 	schema_init();
-	replication_init(cfg_geti_default("replication_threads", 1));
+	replication_init(cfg_geti_default("replication_threads", 1),
+			 cfg_geti_default("replication_relay_threads", 0));
 	port_init();
 	iproto_init(cfg_geti("iproto_threads"));
 	sql_init();
@@ -53,6 +53,7 @@ struct auth_request;
 struct space;
 struct vclock;
 struct key_def;
+struct error;
 
 /**
  * Pointer to TX thread local vclock.
@@ -306,6 +307,7 @@ void box_set_checkpoint_count(void);
 void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
 int box_set_wal_queue_max_size(void);
+int box_set_wal_tail_size(void);
 int box_set_wal_cleanup_delay(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
@@ -325,6 +327,10 @@ void box_update_replication_synchro_quorum(void);
 int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
 void box_set_replication_sync_timeout(void);
+int box_set_replication_compression_level(void);
+void box_set_replication_join_files(void);
+int box_set_replication_spaces(void);
+int box_set_replication_txn_group_size(void);
 void box_set_replication_skip_conflict(void);
 void box_set_replication_anon(void);
 void box_set_instance_name(void);
@@ -551,6 +557,37 @@ API_EXPORT int
 box_replace(uint32_t space_id, const char *tuple, const char *tuple_end,
 	    box_tuple_t **result);
 
+/**
+ * Execute a batch of INSERT requests into one space in one transaction.
+ * If a transaction is active, the tuples are inserted in it; otherwise
+ * a new transaction is started and committed. If any of the tuples can't
+ * be inserted, none of them is.
+ *
+ * \param space_id space identifier
+ * \param tuples encoded array of tuples in MsgPack Array format
+ *        ([[field1, field2, ...], ...])
+ * \param tuples_end end of @a tuples
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+API_EXPORT int
+box_insert_many(uint32_t space_id, const char *tuples, const char *tuples_end);
+
+/**
+ * Execute a batch of REPLACE requests into one space in one transaction.
+ * See box_insert_many().
+ *
+ * \param space_id space identifier
+ * \param tuples encoded array of tuples in MsgPack Array format
+ *        ([[field1, field2, ...], ...])
+ * \param tuples_end end of @a tuples
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+API_EXPORT int
+box_replace_many(uint32_t space_id, const char *tuples,
+		 const char *tuples_end);
+
 /**
  * Execute an DELETE request.
  *
@@ -742,6 +779,30 @@ box_iproto_override(uint32_t req_type, iproto_handler_t handler,
 int
 box_process1(struct request *request, box_tuple_t **result);
 
+/**
+ * Callback invoked by box_process_many() when the tuple number @a i
+ * (zero-based) of a batch fails with @a error. If it returns 0, only
+ * the failed statement is rolled back and the batch goes on, otherwise
+ * the whole batch fails.
+ */
+typedef int
+(*box_process_many_on_error_f)(void *ctx, uint32_t i, struct error *error);
+
+/**
+ * Execute an INSERT or REPLACE request whose tuple is a MsgPack array of
+ * tuples. The space is looked up and access is checked once for the whole
+ * batch. Every tuple becomes a separate statement (and a separate WAL row)
+ * of one transaction, so the batch is written to WAL by one journal entry
+ * unless a transaction is already active, in which case the batch is
+ * executed in it and rolled back as a whole on failure.
+ *
+ * If @a on_error is set, it's called for every tuple that fails and
+ * decides whether to go on with the rest of the batch or not.
+ */
+int
+box_process_many(struct request *request,
+		 box_process_many_on_error_f on_error, void *ctx);
+
 /**
  * Execute request on given space.
  *
@@ -78,11 +78,12 @@ key_validate(const struct index_def *index_def, enum iterator_type type,
 	if (part_count == 0) {
 		/*
 		 * Zero key parts are allowed:
-		 * - for TREE index, all iterator types,
+		 * - for TREE and ART indexes, all iterator types,
 		 * - ITER_ALL iterator type, all index types
 		 * - ITER_GT iterator in HASH index (legacy)
 		 */
-		if (index_def->type == TREE || type == ITER_ALL ||
+		if (index_def->type == TREE || index_def->type == ART ||
+		    type == ITER_ALL ||
 		    (index_def->type == HASH && type == ITER_GT))
 			return 0;
 		/* Fall through. */
@@ -125,8 +126,9 @@ key_validate(const struct index_def *index_def, enum iterator_type type,
 			return -1;
 		}
 
-		/* Partial keys are allowed only for TREE index type. */
-		if (index_def->type != TREE && part_count < index_def->key_def->part_count) {
+		/* Partial keys are allowed only for ordered index types. */
+		if (index_def->type != TREE && index_def->type != ART &&
+		    part_count < index_def->key_def->part_count) {
 			diag_set(ClientError, ER_PARTIAL_KEY,
 				 index_type_strs[index_def->type],
 				 index_def->key_def->part_count,
@@ -336,6 +338,59 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	return 0;
 }
 
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, box_tuple_t **results)
+{
+	assert(keys != NULL && keys_end != NULL && results != NULL);
+	mp_tuple_assert(keys, keys_end);
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (!index->def->opts.is_unique) {
+		diag_set(ClientError, ER_MORE_THAN_ONE_TUPLE);
+		return -1;
+	}
+	RegionGuard region_guard(&fiber()->gc);
+	uint32_t count = mp_decode_array(&keys);
+	const char **key_parts = xregion_alloc_array(&fiber()->gc,
+						     const char *, count);
+	for (uint32_t i = 0; i < count; i++) {
+		if (mp_typeof(*keys) != MP_ARRAY) {
+			diag_set(IllegalParams, "key must be an array");
+			return -1;
+		}
+		const char *key_array = keys;
+		uint32_t part_count = mp_decode_array(&keys);
+		if (exact_key_validate(index->def->key_def, keys, part_count))
+			return -1;
+		box_run_on_select(space, index, ITER_EQ, key_array);
+		key_parts[i] = keys;
+		keys = key_array;
+		mp_next(&keys);
+	}
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	struct result_processor res_proc;
+	result_process_prepare(&res_proc, space);
+	int rc = index_get_many(index, key_parts,
+				index->def->key_def->part_count, count,
+				results);
+	result_process_perform_many(&res_proc, &rc, results, count);
+	txn_end_ro_stmt(txn, &svp);
+	if (rc != 0)
+		return -1;
+	/* Count statistics. */
+	rmean_collect(rmean_box, IPROTO_SELECT, count);
+	return 0;
+}
+
 int
 box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result)
@@ -346,7 +401,7 @@ box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	struct index *index;
 	if (check_index(space_id, index_id, &space, &index) != 0)
 		return -1;
-	if (index->def->type != TREE) {
+	if (index->def->type != TREE && index->def->type != ART) {
 		/* Show nice error messages in Lua. */
 		diag_set(UnsupportedIndexFeature, index->def, "min()");
 		return -1;
@@ -383,7 +438,7 @@ box_index_max(uint32_t space_id, uint32_t index_id, const char *key,
 	struct index *index;
 	if (check_index(space_id, index_id, &space, &index) != 0)
 		return -1;
-	if (index->def->type != TREE) {
+	if (index->def->type != TREE && index->def->type != ART) {
 		/* Show nice error messages in Lua. */
 		diag_set(UnsupportedIndexFeature, index->def, "max()");
 		return -1;
@@ -959,6 +1014,29 @@ generic_index_get(struct index *index, const char *key,
 	return -1;
 }
 
+int
+generic_index_get_many(struct index *index, const char **keys,
+		       uint32_t part_count, uint32_t count,
+		       struct tuple **results)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		if (index_get(index, keys[i], part_count, &results[i]) != 0) {
+			for (uint32_t j = 0; j < i; j++) {
+				if (results[j] != NULL)
+					tuple_unref(results[j]);
+			}
+			return -1;
+		}
+		/*
+		 * Reference the tuple right away, because the next lookup
+		 * may yield and the tuple may be freed meanwhile.
+		 */
+		if (results[i] != NULL)
+			tuple_ref(results[i]);
+	}
+	return 0;
+}
+
 int
 generic_index_replace(struct index *index, struct tuple *old_tuple,
 		      struct tuple *new_tuple, enum dup_replace_mode mode,
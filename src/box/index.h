@@ -187,6 +187,33 @@ int
 box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result);
 
+/**
+ * Get tuples from index by an array of keys.
+ *
+ * This function is equivalent to calling box_index_get() for each key,
+ * but it's faster for big arrays because lookups of different keys are
+ * interleaved to make use of memory-level parallelism.
+ *
+ * Unlike box_index_get(), the found tuples are referenced and must be
+ * unreferenced with box_tuple_unref() by the caller.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys encoded array of keys in MsgPack Array format
+ *        ([[part1, part2, ...], [part1, part2, ...], ...]).
+ * \param keys_end the end of encoded \a keys
+ * \param[out] results array of tuples, must have room for as many
+ *        tuples as there are keys; a tuple is set to NULL if there's
+ *        no tuple matching the corresponding key
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \pre keys != NULL
+ * \sa \code box.space[space_id].index[index_id]:get_many(keys) \endcode
+ */
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, box_tuple_t **results);
+
 /**
  * Return a first (minimal) tuple matched the provided key.
  *
@@ -592,6 +619,16 @@ struct index_vtab {
 			    uint32_t part_count, struct tuple **result);
 	int (*get)(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result);
+	/**
+	 * Same as get() called for each of @a count keys, but lookups
+	 * may be interleaved to overlap their cache misses. All keys
+	 * are full and have @a part_count parts. Found tuples are stored
+	 * in @a results and referenced, NULL is stored for keys without
+	 * a match. On failure no tuples are left referenced.
+	 */
+	int (*get_many)(struct index *index, const char **keys,
+			uint32_t part_count, uint32_t count,
+			struct tuple **results);
 	/**
 	 * Main entrance point for changing data in index. Once built and
 	 * before deletion this is the only way to insert, replace and delete
@@ -965,6 +1002,13 @@ index_get(struct index *index, const char *key,
 	return index->vtab->get(index, key, part_count, result);
 }
 
+static inline int
+index_get_many(struct index *index, const char **keys, uint32_t part_count,
+	       uint32_t count, struct tuple **results)
+{
+	return index->vtab->get_many(index, keys, part_count, count, results);
+}
+
 static inline int
 index_replace(struct index *index, struct tuple *old_tuple,
 	      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -1121,6 +1165,10 @@ int
 generic_index_get_internal(struct index *index, const char *key,
 			   uint32_t part_count, struct tuple **result);
 int generic_index_get(struct index *, const char *, uint32_t, struct tuple **);
+int
+generic_index_get_many(struct index *index, const char **keys,
+		       uint32_t part_count, uint32_t count,
+		       struct tuple **results);
 int generic_index_replace(struct index *, struct tuple *, struct tuple *,
 			  enum dup_replace_mode,
 			  struct tuple **, struct tuple **);
@@ -35,10 +35,12 @@
 #include "json/json.h"
 #include "fiber.h"
 
-const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
+const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE", "ART" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *index_hash_func_strs[] = { "MURMUR3", "XXH3" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -52,6 +54,8 @@ const struct index_opts index_opts_default = {
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
 	/* .hint                = */ true,
+	/* .inline_key          = */ false,
+	/* .hash_func           = */ INDEX_HASH_FUNC_MURMUR3,
 };
 
 const struct opt_def index_opts_reg[] = {
@@ -68,6 +72,9 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
 	OPT_DEF("hint", OPT_BOOL, struct index_opts, hint),
+	OPT_DEF("inline_key", OPT_BOOL, struct index_opts, inline_key),
+	OPT_DEF_ENUM("hash_func", index_hash_func, struct index_opts,
+		     hash_func, NULL),
 	OPT_END,
 };
 
@@ -44,6 +44,7 @@ enum index_type {
 	TREE,     /* TREE Index */
 	BITSET,   /* BITSET Index */
 	RTREE,    /* R-Tree Index */
+	ART,      /* Adaptive Radix Tree Index */
 	index_type_MAX,
 };
 
@@ -58,6 +59,16 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Hash function used by a memtx HASH index. */
+enum index_hash_func {
+	/* 32-bit MurmurHash3, see key_def::tuple_hash. */
+	INDEX_HASH_FUNC_MURMUR3,
+	/* 64-bit XXH3, see tuple_hash_xxh3(). */
+	INDEX_HASH_FUNC_XXH3,
+	index_hash_func_MAX
+};
+extern const char *index_hash_func_strs[];
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -169,6 +180,15 @@ struct index_opts {
 	 * Use hint optimization for tree index.
 	 */
 	bool hint;
+	/**
+	 * Store a prefix of the normalized key in tree index elements,
+	 * see memtx_tree_data<false, true>.
+	 */
+	bool inline_key;
+	/**
+	 * Hash function of memtx hash index.
+	 */
+	enum index_hash_func hash_func;
 };
 
 extern const struct index_opts index_opts_default;
@@ -217,6 +237,10 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
 		return o1->hint - o2->hint;
+	if (o1->inline_key != o2->inline_key)
+		return o1->inline_key - o2->inline_key;
+	if (o1->hash_func != o2->hash_func)
+		return o1->hash_func < o2->hash_func ? -1 : 1;
 	return 0;
 }
 
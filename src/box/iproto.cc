@@ -53,6 +53,7 @@
 
 #include "bind.h"
 #include "port.h"
+#include "tuple_projection.h"
 #include "box.h"
 #include "call.h"
 #include "tuple_convert.h"
@@ -164,7 +165,22 @@ struct iproto_thread {
 	struct cmsg_hop misc_route[2];
 	struct cmsg_hop call_route[2];
 	struct cmsg_hop select_route[2];
+	/**
+	 * Route of a SELECT whose tuples are copied to the output buffer
+	 * by the iproto thread. The first hop is never taken: the message
+	 * is switched to this route by the tx thread, see
+	 * tx_reserve_select_data().
+	 *
+	 * The tuple data is read by the iproto thread while tx runs, and
+	 * the tuples are only protected by references taken in tx. This
+	 * relies on tuples being immutable once referenced: memtx applies
+	 * an update in place only to a tuple nobody references and never
+	 * restores the old data of a tuple referenced since then, see
+	 * memtx_update_undo_f().
+	 */
+	struct cmsg_hop select_encode_route[4];
 	struct cmsg_hop process1_route[2];
+	struct cmsg_hop process_many_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
 	struct cmsg_hop subscribe_route[2];
@@ -249,6 +265,12 @@ struct iproto_kharon {
 	 * iproto_msg.wpos).
 	 */
 	struct iproto_wpos wpos;
+	/**
+	 * Set by tx if it waits for the output to be flushed, see
+	 * tx_wait_output_flush(). Then iproto holds the message until
+	 * some output is flushed instead of returning it at once.
+	 */
+	bool wait_flush;
 };
 
 /**
@@ -372,6 +394,19 @@ struct iproto_msg
 		struct sql_request sql;
 		/* BEGIN request */
 		struct begin_request begin;
+		/**
+		 * Tuples of a SELECT response that are copied to the output
+		 * buffer by the iproto thread, see tx_reserve_select_data().
+		 * Set after the request has been executed.
+		 */
+		struct {
+			/** Referenced tuples. */
+			struct tuple **tuples;
+			/** Number of tuples. */
+			uint32_t tuple_count;
+			/** Memory reserved for the tuples in the output buffer. */
+			char *data;
+		} select;
 		/** In case of iproto parse error, saved diagnostics. */
 		struct diag diag;
 	};
@@ -498,6 +533,13 @@ net_finish_disconnect(struct cmsg *m);
 static void
 iproto_process_push(struct cmsg *m);
 
+/**
+ * Send Kharon back to tx with the last flushed position.
+ * @param con iproto connection.
+ */
+static void
+iproto_return_kharon(struct iproto_connection *con);
+
 /**
  * Kharon returns to the living world (tx) back from the dead one
  * (iproto). Check if a new push is pending and make a new trip
@@ -655,6 +697,11 @@ struct iproto_connection
 	 * should not write to the socket.
 	 */
 	bool can_write;
+	/**
+	 * Set if the iproto thread holds Kharon until some output
+	 * is flushed, see iproto_kharon::wait_flush.
+	 */
+	bool is_kharon_held;
 	/**
 	 * Hash table that holds all streams for this connection.
 	 * This field is accesable only from iproto thread.
@@ -706,6 +753,23 @@ struct iproto_connection
 		 * return.
 		 */
 		bool is_push_pending;
+		/**
+		 * True if the disconnect message has been received,
+		 * i.e. no more output will be flushed to the socket.
+		 */
+		bool is_disconnected;
+		/**
+		 * Last position in the output buffers flushed by the
+		 * iproto thread, as seen by the tx thread.
+		 */
+		struct iproto_wpos wpos;
+		/**
+		 * Signalled when the flushed position is updated and
+		 * when the connection is closed.
+		 */
+		struct fiber_cond output_cond;
+		/** Number of fibers waiting on output_cond. */
+		int output_waiter_count;
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
@@ -972,6 +1036,9 @@ iproto_connection_close(struct iproto_connection *con)
 			    stailq_empty(&stream->pending_requests))
 				iproto_stream_rollback_on_disconnect(stream);
 		}
+		/* No more output will be flushed. */
+		if (con->is_kharon_held)
+			iproto_return_kharon(con);
 		cpipe_push(&con->iproto_thread->tx_pipe, &con->disconnect_msg);
 		assert(con->state == IPROTO_CONNECTION_ALIVE);
 		con->state = IPROTO_CONNECTION_CLOSED;
@@ -1441,6 +1508,7 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 {
 	struct iproto_connection *con = (struct iproto_connection *) watcher->data;
 	assert(con->state == IPROTO_CONNECTION_ALIVE);
+	struct iproto_wpos wpos = con->wpos;
 	int rc;
 	while ((rc = iproto_flush(con)) <= 0) {
 		if (rc != 0) {
@@ -1450,11 +1518,18 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 				ev_io_set(&con->output, con->io.fd, events);
 			}
 			ev_io_start(loop, &con->output);
+			/* Let tx know that some output was flushed. */
+			if (con->is_kharon_held &&
+			    (con->wpos.obuf != wpos.obuf ||
+			     con->wpos.svp.used != wpos.svp.used))
+				iproto_return_kharon(con);
 			return;
 		}
 	}
 	if (ev_is_active(&con->output))
 		ev_io_stop(con->loop, &con->output);
+	if (con->is_kharon_held)
+		iproto_return_kharon(con);
 	/*
 	 * If the out channel isn't clogged, we can read more requests.
 	 * Note, we trigger input even if we didn't write any responses
@@ -1492,6 +1567,7 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
 	con->parse_size = 0;
 	con->can_write = true;
+	con->is_kharon_held = false;
 	con->long_poll_count = 0;
 	con->session = NULL;
 	rlist_create(&con->in_stop_list);
@@ -1501,6 +1577,10 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	con->state = IPROTO_CONNECTION_ALIVE;
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = false;
+	con->tx.is_disconnected = false;
+	iproto_wpos_create(&con->tx.wpos, con->tx.p_obuf);
+	fiber_cond_create(&con->tx.output_cond);
+	con->tx.output_waiter_count = 0;
 	rmean_collect(iproto_thread->rmean, IPROTO_CONNECTIONS, 1);
 	return con;
 }
@@ -1542,6 +1622,9 @@ tx_process_call(struct cmsg *msg);
 static void
 tx_process1(struct cmsg *msg);
 
+static void
+tx_process_many(struct cmsg *msg);
+
 static void
 tx_process_select(struct cmsg *msg);
 
@@ -1557,6 +1640,15 @@ tx_reply_iproto_error(struct cmsg *m);
 static void
 net_send_msg(struct cmsg *msg);
 
+static void
+net_send_select(struct cmsg *msg);
+
+static void
+tx_end_select(struct cmsg *msg);
+
+static void
+net_end_select(struct cmsg *msg);
+
 static void
 net_send_error(struct cmsg *msg);
 
@@ -1600,7 +1692,8 @@ iproto_msg_prepare(struct iproto_msg *msg, const char **pos, const char *reqend,
 	stream_id = msg->header.stream_id;
 	request_is_not_for_stream =
 		((type > IPROTO_TYPE_STAT_MAX &&
-		 type != IPROTO_PING) || type == IPROTO_AUTH);
+		 type != IPROTO_PING && !iproto_type_is_dml_many(type)) ||
+		 type == IPROTO_AUTH);
 	request_is_only_for_stream =
 		(type == IPROTO_BEGIN ||
 		 type == IPROTO_COMMIT ||
@@ -1677,6 +1770,18 @@ iproto_msg_decode(struct iproto_msg *msg, struct cmsg_hop **route)
 		 */
 		msg->dml.header = NULL;
 		return 0;
+	case IPROTO_INSERT_MANY:
+	case IPROTO_REPLACE_MANY:
+		*route = iproto_thread->process_many_route;
+		if (xrow_decode_dml_iproto(&msg->header, &msg->dml,
+					   iproto_key_bit(IPROTO_SPACE_ID) |
+					   iproto_key_bit(IPROTO_TUPLE)) != 0)
+			return -1;
+		msg->dml.header = NULL;
+		/* Every tuple is executed as a separate INSERT or REPLACE. */
+		msg->dml.type = type == IPROTO_INSERT_MANY ?
+				IPROTO_INSERT : IPROTO_REPLACE;
+		return 0;
 	case IPROTO_BEGIN:
 		*route = iproto_thread->begin_route;
 		if (xrow_decode_begin(&msg->header, &msg->begin) != 0)
@@ -1808,6 +1913,8 @@ tx_process_disconnect(struct cmsg *m)
 {
 	struct iproto_connection *con =
 		container_of(m, struct iproto_connection, disconnect_msg);
+	con->tx.is_disconnected = true;
+	fiber_cond_broadcast(&con->tx.output_cond);
 	if (con->session != NULL) {
 		session_close(con->session);
 		/*
@@ -1852,6 +1959,7 @@ tx_process_destroy(struct cmsg *m)
 	 */
 	obuf_destroy(&con->obuf[0]);
 	obuf_destroy(&con->obuf[1]);
+	fiber_cond_destroy(&con->tx.output_cond);
 }
 
 /**
@@ -1911,6 +2019,7 @@ static void
 tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 {
 	struct obuf *prev = &con->obuf[con->tx.p_obuf == con->obuf];
+	con->tx.wpos = *wpos;
 	if (wpos->obuf == con->tx.p_obuf) {
 		/*
 		 * We got a message advancing the buffer which
@@ -1929,6 +2038,23 @@ tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 		 */
 		con->tx.p_obuf = prev;
 	}
+	fiber_cond_broadcast(&con->tx.output_cond);
+}
+
+/**
+ * Return the size of the data written to the output buffers of
+ * a connection that hasn't been flushed to the socket yet, as far
+ * as the tx thread knows. Relies on the fact that the buffer being
+ * flushed is never reset and the other one is empty if the iproto
+ * thread is flushing the current buffer, see tx_accept_wpos().
+ */
+static size_t
+tx_output_unflushed_size(struct iproto_connection *con)
+{
+	struct obuf *prev = &con->obuf[con->tx.p_obuf == con->obuf];
+	size_t size = obuf_size(con->tx.p_obuf) + obuf_size(prev);
+	assert(size >= con->tx.wpos.svp.used);
+	return size - con->tx.wpos.svp.used;
 }
 
 /**
@@ -2213,6 +2339,271 @@ error:
 	tx_end_msg(msg, &svp);
 }
 
+static void
+tx_process_many(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct obuf *out;
+	struct obuf_svp header;
+	if (tx_check_msg(msg) != 0)
+		goto error;
+	tx_inject_delay();
+	if (tx_resolve_space_and_index_name(&msg->dml) != 0)
+		goto error;
+	if (box_process_many(&msg->dml, NULL, NULL) != 0)
+		goto error;
+	out = msg->connection->tx.p_obuf;
+	header = obuf_create_svp(out);
+	iproto_reply_ok(out, msg->header.sync, ::schema_version);
+	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, &header);
+	return;
+error:
+	out = msg->connection->tx.p_obuf;
+	header = obuf_create_svp(out);
+	tx_reply_error(msg);
+	tx_end_msg(msg, &header);
+}
+
+/**
+ * Minimal size of tuple data in a SELECT response that is copied to the
+ * output buffer by the iproto thread rather than by tx. For smaller
+ * responses, the extra round trip between the threads costs more than
+ * the copying.
+ */
+enum { IPROTO_SELECT_NET_COPY_MIN = 16 * 1024 };
+
+/**
+ * Check if the tuples in @a port can be copied to the output buffer by
+ * the iproto thread. If so, reserve memory for them in @a out, reference
+ * them and store them in @a msg. Returns the number of tuples or -1 if
+ * the tuples must be encoded by tx.
+ *
+ * The references guarantee that the tuple data doesn't change until the
+ * iproto thread copies it, because a referenced tuple is never modified.
+ */
+static int
+tx_reserve_select_data(struct iproto_msg *msg, struct port *base,
+		       struct obuf *out)
+{
+#if defined(ENABLE_FLIGHT_RECORDER)
+	/* The flight recorder logs the response data in tx. */
+	(void)msg;
+	(void)base;
+	(void)out;
+	return -1;
+#else
+	if (base->vtab != &port_c_vtab)
+		return -1;
+	struct port_c *port = (struct port_c *)base;
+	if (port->projection != NULL)
+		return -1;
+	size_t size = 0;
+	struct port_c_entry *pe;
+	for (pe = port->first; pe != NULL; pe = pe->next) {
+		if (pe->mp_size != 0)
+			return -1;
+		size += tuple_bsize(pe->tuple);
+	}
+	if (size < IPROTO_SELECT_NET_COPY_MIN)
+		return -1;
+	struct tuple **tuples =
+		(struct tuple **)malloc(port->size * sizeof(*tuples));
+	if (tuples == NULL)
+		return -1;
+	char *data = (char *)obuf_alloc(out, size);
+	if (data == NULL) {
+		free(tuples);
+		return -1;
+	}
+	uint32_t count = 0;
+	for (pe = port->first; pe != NULL; pe = pe->next) {
+		tuple_ref(pe->tuple);
+		tuples[count++] = pe->tuple;
+	}
+	msg->select.tuples = tuples;
+	msg->select.tuple_count = count;
+	msg->select.data = data;
+	return count;
+#endif
+}
+
+/** Release the tuples referenced by tx_reserve_select_data(). */
+static void
+tx_release_select_data(struct iproto_msg *msg)
+{
+	for (uint32_t i = 0; i < msg->select.tuple_count; i++)
+		tuple_unref(msg->select.tuples[i]);
+	free(msg->select.tuples);
+}
+
+/**
+ * Write the response to a SELECT request with the tuples from @a port
+ * and, unless @a packed_pos is NULL, the position of the last of them.
+ * The port is destroyed. On success, @a svp is set to the beginning of
+ * the response.
+ *
+ * If the response is large, the tuple data is only reserved in the
+ * output buffer and the message is rerouted so that the data is copied
+ * by the iproto thread, see tx_reserve_select_data().
+ */
+static int
+tx_reply_select(struct iproto_msg *msg, struct port *port,
+		const char *packed_pos, const char *packed_pos_end,
+		struct obuf_svp *svp)
+{
+	struct obuf *out = msg->connection->tx.p_obuf;
+	bool reply_position = packed_pos != NULL;
+	int rc;
+	if (reply_position)
+		rc = iproto_prepare_select_with_position(out, svp);
+	else
+		rc = iproto_prepare_select(out, svp);
+	if (rc != 0) {
+		port_destroy(port);
+		return -1;
+	}
+	/*
+	 * SELECT output format has not changed since Tarantool 1.6
+	 */
+	int count = tx_reserve_select_data(msg, port, out);
+	bool is_reserved = count >= 0;
+	if (!is_reserved)
+		count = port_dump_msgpack_16(port, out);
+	port_destroy(port);
+	if (count < 0)
+		goto discard;
+	if (reply_position) {
+		if (iproto_reply_select_with_position(out, svp,
+						      msg->header.sync,
+						      ::schema_version, count,
+						      packed_pos,
+						      packed_pos_end) != 0)
+			goto discard;
+	} else {
+		iproto_reply_select(out, svp, msg->header.sync,
+				    ::schema_version, count);
+	}
+	if (is_reserved) {
+		struct iproto_thread *iproto_thread =
+			msg->connection->iproto_thread;
+		msg->base.hop = iproto_thread->select_encode_route;
+	}
+	return 0;
+discard:
+	if (is_reserved)
+		tx_release_select_data(msg);
+	/* Discard the prepared select. */
+	obuf_rollback_to_svp(out, svp);
+	return -1;
+}
+
+static void
+tx_push(struct iproto_connection *con, struct obuf_svp *svp);
+
+static int
+tx_wait_output_flush(struct iproto_connection *con, size_t size);
+
+/**
+ * Process a SELECT request with IPROTO_CHUNK_SIZE. The tuples are
+ * selected in batches of the chunk size, each batch starting after the
+ * position of the last tuple of the previous one. All batches but the
+ * last one are sent in IPROTO_CHUNK messages, the last one is sent in
+ * the final response. Before selecting the next batch, the fiber waits
+ * for the previous chunk to be flushed to the socket, so the output
+ * never holds more than a couple of chunks regardless of the result
+ * size. Since the fiber yields between batches, the result is not a
+ * consistent snapshot of the index, unlike the result of a plain SELECT.
+ * For the same reason, the request isn't allowed in a transaction.
+ */
+static int
+tx_process_select_chunked(struct iproto_msg *msg,
+			  struct tuple_projection *projection,
+			  const char *packed_pos, const char *packed_pos_end)
+{
+	struct iproto_connection *con = msg->connection;
+	struct request *req = &msg->dml;
+	struct region *region = &fiber()->gc;
+	assert(!in_txn());
+	/*
+	 * The iteration position is updated after each batch, so it's kept
+	 * in a separate buffer rather than on the region.
+	 */
+	char *pos_buf = NULL;
+	if (packed_pos != NULL) {
+		size_t size = packed_pos_end - packed_pos;
+		pos_buf = (char *)xmalloc(size);
+		memcpy(pos_buf, packed_pos, size);
+		packed_pos = pos_buf;
+		packed_pos_end = pos_buf + size;
+	}
+	size_t key_size = req->key_end - req->key;
+	char *key = (char *)xregion_alloc(region, key_size);
+	memcpy(key, req->key, key_size);
+	/*
+	 * Don't stall other requests of the connection while waiting
+	 * for the output to be flushed.
+	 */
+	tx_discard_input(msg);
+	uint32_t offset = req->offset;
+	uint32_t limit = req->limit;
+	bool found_any = false;
+	int rc = -1;
+	for (;;) {
+		size_t region_svp = region_used(region);
+		uint32_t batch_size = MIN(limit, req->chunk_size);
+		const char *pos = packed_pos, *pos_end = packed_pos_end;
+		struct port port;
+		if (box_select(req->space_id, req->index_id, req->iterator,
+			       offset, batch_size, key, key + key_size,
+			       &pos, &pos_end, true, &port) != 0)
+			break;
+		port_c_set_projection(&port, projection);
+		uint32_t count = ((struct port_c *)&port)->size;
+		if (pos != NULL) {
+			size_t size = pos_end - pos;
+			pos_buf = (char *)xrealloc(pos_buf, size);
+			memcpy(pos_buf, pos, size);
+			packed_pos = pos_buf;
+			packed_pos_end = pos_buf + size;
+		}
+		found_any = found_any || count > 0;
+		offset = 0;
+		limit -= count;
+		struct obuf_svp svp;
+		if (count < batch_size || limit == 0) {
+			if (!req->fetch_position || !found_any)
+				packed_pos = packed_pos_end = NULL;
+			if (tx_reply_select(msg, &port, packed_pos,
+					    packed_pos_end, &svp) != 0)
+				break;
+			iproto_wpos_create(&msg->wpos, con->tx.p_obuf);
+			tx_end_msg(msg, &svp);
+			rc = 0;
+			break;
+		}
+		struct obuf *out = con->tx.p_obuf;
+		if (iproto_prepare_select(out, &svp) != 0) {
+			port_destroy(&port);
+			break;
+		}
+		int dumped = port_dump_msgpack_16(&port, out);
+		port_destroy(&port);
+		if (dumped < 0) {
+			obuf_rollback_to_svp(out, &svp);
+			break;
+		}
+		iproto_reply_select_chunk(out, &svp, msg->header.sync,
+					  ::schema_version, dumped);
+		tx_push(con, &svp);
+		region_truncate(region, region_svp);
+		if (tx_wait_output_flush(con, obuf_size(out) - svp.used) != 0)
+			break;
+	}
+	free(pos_buf);
+	return rc;
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
@@ -2220,10 +2611,9 @@ tx_process_select(struct cmsg *m)
 	struct obuf *out;
 	struct obuf_svp svp;
 	struct port port;
-	int count;
 	int rc;
 	const char *packed_pos, *packed_pos_end;
-	bool reply_position;
+	struct tuple_projection *projection = NULL;
 	struct request *req = &msg->dml;
 	uint32_t region_svp = region_used(&fiber()->gc);
 	if (tx_check_msg(msg) != 0)
@@ -2232,6 +2622,13 @@ tx_process_select(struct cmsg *m)
 	tx_inject_delay();
 	if (tx_resolve_space_and_index_name(&msg->dml) != 0)
 		goto error;
+	if (req->fields != NULL) {
+		projection = tuple_projection_decode(req->fields,
+						     req->index_base,
+						     &fiber()->gc);
+		if (projection == NULL)
+			goto error;
+	}
 	packed_pos = req->after_position;
 	packed_pos_end = req->after_position_end;
 	if (packed_pos != NULL) {
@@ -2244,50 +2641,39 @@ tx_process_select(struct cmsg *m)
 		if (rc < 0)
 			goto error;
 	}
+	if (req->chunk_size != 0) {
+		/*
+		 * The output can't be bounded without yielding between
+		 * batches, which aborts a memtx transaction unless MVCC
+		 * is enabled.
+		 */
+		if (in_txn() != NULL) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "Chunked select", "transactions");
+			goto error;
+		}
+		if (tx_process_select_chunked(msg, projection, packed_pos,
+					      packed_pos_end) != 0)
+			goto error;
+		region_truncate(&fiber()->gc, region_svp);
+		return;
+	}
 	rc = box_select(req->space_id, req->index_id,
 			req->iterator, req->offset, req->limit,
 			req->key, req->key_end, &packed_pos, &packed_pos_end,
 			req->fetch_position, &port);
 	if (rc < 0)
 		goto error;
-
-	out = msg->connection->tx.p_obuf;
-	reply_position = req->fetch_position && packed_pos != NULL;
-	if (reply_position)
-		rc = iproto_prepare_select_with_position(out, &svp);
-	else
-		rc = iproto_prepare_select(out, &svp);
-	if (rc != 0) {
-		port_destroy(&port);
+	port_c_set_projection(&port, projection);
+	if (!req->fetch_position)
+		packed_pos = packed_pos_end = NULL;
+	if (tx_reply_select(msg, &port, packed_pos, packed_pos_end, &svp) != 0)
 		goto error;
-	}
-	/*
-	 * SELECT output format has not changed since Tarantool 1.6
-	 */
-	count = port_dump_msgpack_16(&port, out);
-	port_destroy(&port);
-	if (count < 0) {
-		goto discard;
-	}
-	if (reply_position) {
-		assert(packed_pos != NULL);
-		if (iproto_reply_select_with_position(out, &svp,
-						      msg->header.sync,
-						      ::schema_version, count,
-						      packed_pos,
-						      packed_pos_end) != 0)
-			goto discard;
-	} else {
-		iproto_reply_select(out, &svp, msg->header.sync,
-				    ::schema_version, count);
-	}
 	region_truncate(&fiber()->gc, region_svp);
+	out = msg->connection->tx.p_obuf;
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg, &svp);
 	return;
-discard:
-	/* Discard the prepared select. */
-	obuf_rollback_to_svp(out, &svp);
 error:
 	region_truncate(&fiber()->gc, region_svp);
 	out = msg->connection->tx.p_obuf;
@@ -2751,10 +3137,14 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 	}
 }
 
+/**
+ * Complete processing of a message whose response has been written to
+ * the output buffer: discard the request, flush the output and delete
+ * the message.
+ */
 static void
-net_send_msg(struct cmsg *m)
+net_finish_msg(struct iproto_msg *msg)
 {
-	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
 
 	iproto_msg_finish_processing_in_stream(msg);
@@ -2766,7 +3156,6 @@ net_send_msg(struct cmsg *m)
 		assert(con->long_poll_count > 0);
 		con->long_poll_count--;
 	}
-	con->wend = msg->wpos;
 
 	if (con->state == IPROTO_CONNECTION_ALIVE) {
 		iproto_connection_feed_output(con);
@@ -2776,6 +3165,56 @@ net_send_msg(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
+static void
+net_send_msg(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *) m;
+	msg->connection->wend = msg->wpos;
+	net_finish_msg(msg);
+}
+
+/**
+ * Copy the tuples of a SELECT response to the memory reserved for them
+ * in the output buffer and flush the response. The tuples are pinned
+ * by references, so their data can't change until the message returns
+ * to tx. The request isn't discarded until then, so that the connection
+ * stays alive.
+ */
+static void
+net_send_select(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *) m;
+	struct iproto_connection *con = msg->connection;
+	char *data = msg->select.data;
+	for (uint32_t i = 0; i < msg->select.tuple_count; i++) {
+		uint32_t size;
+		const char *tuple_data =
+			tuple_data_range(msg->select.tuples[i], &size);
+		memcpy(data, tuple_data, size);
+		data += size;
+	}
+	con->wend = msg->wpos;
+	if (con->state == IPROTO_CONNECTION_ALIVE)
+		iproto_connection_feed_output(con);
+}
+
+/** Release the tuples copied to the output by net_send_select(). */
+static void
+tx_end_select(struct cmsg *m)
+{
+	tx_release_select_data((struct iproto_msg *) m);
+}
+
+static void
+net_end_select(struct cmsg *m)
+{
+	/*
+	 * Don't update the write end: newer responses may have been
+	 * written after the select response by now.
+	 */
+	net_finish_msg((struct iproto_msg *) m);
+}
+
 /**
  * Complete sending an iproto error:
  * recycle the error object and flush output.
@@ -2999,9 +3438,34 @@ iproto_process_push(struct cmsg *m)
 	struct iproto_connection *con =
 		container_of(kharon, struct iproto_connection, kharon);
 	con->wend = kharon->wpos;
-	kharon->wpos = con->wpos;
-	if (con->state == IPROTO_CONNECTION_ALIVE)
-		iproto_connection_feed_output(con);
+	if (con->state != IPROTO_CONNECTION_ALIVE) {
+		iproto_return_kharon(con);
+		return;
+	}
+	iproto_connection_feed_output(con);
+	/*
+	 * Returning at once while the socket is clogged would make tx
+	 * send Kharon back and forth without any progress, so hold it
+	 * until the output is flushed, see iproto_connection_on_output().
+	 */
+	if (kharon->wait_flush) {
+		con->is_kharon_held = true;
+		return;
+	}
+	iproto_return_kharon(con);
+}
+
+static void
+iproto_return_kharon(struct iproto_connection *con)
+{
+	con->is_kharon_held = false;
+	con->kharon.wpos = con->wpos;
+	/*
+	 * The first hop of the route has no pipe, so that the message
+	 * may be held, dispatch it to tx manually.
+	 */
+	con->kharon.base.hop++;
+	cpipe_push(&con->iproto_thread->tx_pipe, &con->kharon.base);
 }
 
 /**
@@ -3014,6 +3478,7 @@ tx_begin_push(struct iproto_connection *con)
 	assert(! con->tx.is_push_sent);
 	cmsg_init(&con->kharon.base, con->iproto_thread->push_route);
 	iproto_wpos_create(&con->kharon.wpos, con->tx.p_obuf);
+	con->kharon.wait_flush = con->tx.output_waiter_count > 0;
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = true;
 	cpipe_push(&con->iproto_thread->net_pipe,
@@ -3045,6 +3510,36 @@ tx_push(struct iproto_connection *con, struct obuf_svp *svp)
 		con->tx.is_push_pending = true;
 }
 
+/**
+ * Wait until the output of a connection that hasn't been flushed to
+ * the socket shrinks to @a size bytes. The flushed position is brought
+ * to tx by Kharon, which iproto holds until some output is flushed, see
+ * iproto_kharon::wait_flush. Used by requests that write many messages,
+ * so that the output doesn't pile up in memory while the client is
+ * reading it slowly.
+ */
+static int
+tx_wait_output_flush(struct iproto_connection *con, size_t size)
+{
+	int rc = 0;
+	con->tx.output_waiter_count++;
+	while (tx_output_unflushed_size(con) > size) {
+		if (con->tx.is_disconnected) {
+			diag_set(ClientError, ER_SESSION_CLOSED);
+			rc = -1;
+			break;
+		}
+		if (!con->tx.is_push_sent)
+			tx_begin_push(con);
+		if (fiber_cond_wait(&con->tx.output_cond) != 0) {
+			rc = -1;
+			break;
+		}
+	}
+	con->tx.output_waiter_count--;
+	return rc;
+}
+
 /**
  * Push a message from @a port to a remote client.
  * @param session iproto session.
@@ -3151,9 +3646,19 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->select_route[0] =
 		{ tx_process_select, &iproto_thread->net_pipe };
 	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_encode_route[0] =
+		{ tx_process_select, &iproto_thread->net_pipe };
+	iproto_thread->select_encode_route[1] =
+		{ net_send_select, &iproto_thread->tx_pipe };
+	iproto_thread->select_encode_route[2] =
+		{ tx_end_select, &iproto_thread->net_pipe };
+	iproto_thread->select_encode_route[3] = { net_end_select, NULL };
 	iproto_thread->process1_route[0] =
 		{ tx_process1, &iproto_thread->net_pipe };
 	iproto_thread->process1_route[1] = { net_send_msg, NULL };
+	iproto_thread->process_many_route[0] =
+		{ tx_process_many, &iproto_thread->net_pipe };
+	iproto_thread->process_many_route[1] = { net_send_msg, NULL };
 	iproto_thread->sql_route[0] =
 		{ tx_process_sql, &iproto_thread->net_pipe };
 	iproto_thread->sql_route[1] = { net_send_msg, NULL };
@@ -3166,8 +3671,8 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->error_route[0] =
 		{ tx_reply_iproto_error, &iproto_thread->net_pipe };
 	iproto_thread->error_route[1] = { net_send_error, NULL };
-	iproto_thread->push_route[0] =
-		{ iproto_process_push, &iproto_thread->tx_pipe };
+	/* Kharon is dispatched to tx by iproto_return_kharon(). */
+	iproto_thread->push_route[0] = { iproto_process_push, NULL };
 	iproto_thread->push_route[1] = { tx_end_push, NULL };
 	/* IPROTO_OK */
 	iproto_thread->dml_route[0] = NULL;
@@ -208,6 +208,39 @@ extern const char *iproto_flag_bit_strs[];
 	 * when identifier is present (i.e., the identifier is ignored).
 	 */								\
 	_(INDEX_NAME, 0x5f, MP_STR)					\
+	/**
+	 * Field numbers and JSON paths of the fields to return instead of
+	 * whole tuples in reply to IPROTO_SELECT. Field numbers and array
+	 * indexes in paths start from IPROTO_INDEX_BASE.
+	 */								\
+	_(FIELDS, 0x60, MP_ARRAY)					\
+	/**
+	 * Maximal number of tuples in one IPROTO_CHUNK message sent in
+	 * reply to IPROTO_SELECT. If set, the selected tuples are sent in
+	 * IPROTO_CHUNK messages while the iterator advances, and the final
+	 * response only contains the tuples of the last chunk.
+	 */								\
+	_(CHUNK_SIZE, 0x61, MP_UINT)					\
+	/**
+	 * Zstd compression level of the replication stream requested by
+	 * a replica in IPROTO_JOIN or IPROTO_SUBSCRIBE. If set, the master
+	 * compresses all the data it sends over the connection afterwards.
+	 */								\
+	_(COMPRESSION_LEVEL, 0x62, MP_UINT)				\
+	/**
+	 * Flag set by a replica in IPROTO_JOIN to request the master's
+	 * latest checkpoint files instead of the rows of a read view, see
+	 * IPROTO_JOIN_FILE.
+	 */								\
+	_(JOIN_FILES, 0x63, MP_BOOL)					\
+	/** Size of the raw file data following IPROTO_JOIN_FILE. */	\
+	_(FILE_SIZE, 0x64, MP_UINT)					\
+	/**								\
+	 * Ids of the user spaces a replica wants to receive rows of	\
+	 * in reply to IPROTO_SUBSCRIBE. Rows of the other user spaces	\
+	 * aren't sent. Rows of system spaces are always sent.		\
+	 */								\
+	_(SPACE_FILTER, 0x65, MP_ARRAY)					\
 
 #define IPROTO_KEY_MEMBER(s, v, ...) IPROTO_ ## s = v,
 
@@ -320,6 +353,10 @@ iproto_key_bit(unsigned char key)
 	_(COMMIT, 15)							\
 	/* Rollback transaction */					\
 	_(ROLLBACK, 16)							\
+	/** INSERT of an array of tuples */				\
+	_(INSERT_MANY, 17)						\
+	/** REPLACE of an array of tuples */				\
+	_(REPLACE_MANY, 18)						\
 									\
 	_(RAFT, 30)							\
 	/** PROMOTE request. */						\
@@ -378,6 +415,13 @@ iproto_key_bit(unsigned char key)
 	 * a notification key without subscribing to changes.
 	 */								\
 	_(WATCH_ONCE, 77)						\
+	/**
+	 * A checkpoint file sent in reply to IPROTO_JOIN with
+	 * IPROTO_JOIN_FILES set. The body contains the checkpoint vclock
+	 * and IPROTO_FILE_SIZE. The packet is followed by the raw file
+	 * data of this size.
+	 */								\
+	_(JOIN_FILE, 78)						\
 									\
 	/**
 	 * The following three requests are reserved for vinyl types.
@@ -490,6 +534,13 @@ iproto_type_is_dml(uint16_t type)
 		type == IPROTO_UPSERT || type == IPROTO_NOP;
 }
 
+/** Batch DML request types, executed by box_process_many(). */
+static inline bool
+iproto_type_is_dml_many(uint16_t type)
+{
+	return type == IPROTO_INSERT_MANY || type == IPROTO_REPLACE_MANY;
+}
+
 /**
  * Returns a map of mandatory members of IPROTO DML request.
  * @param type iproto type.
@@ -79,4 +79,10 @@ iproto_features_init(void)
 			    IPROTO_FEATURE_SPACE_AND_INDEX_NAMES);
 	iproto_features_set(&IPROTO_CURRENT_FEATURES,
 			    IPROTO_FEATURE_WATCH_ONCE);
+	iproto_features_set(&IPROTO_CURRENT_FEATURES,
+			    IPROTO_FEATURE_FIELD_PROJECTION);
+	iproto_features_set(&IPROTO_CURRENT_FEATURES,
+			    IPROTO_FEATURE_SELECT_CHUNKS);
+	iproto_features_set(&IPROTO_CURRENT_FEATURES,
+			    IPROTO_FEATURE_REPLICATION_COMPRESSION);
 }
@@ -59,6 +59,15 @@ extern "C" {
 	_(SPACE_AND_INDEX_NAMES,  5)					\
 	/** IPROTO_WATCH_ONCE request support. */			\
 	_(WATCH_ONCE,  6)						\
+	/** IPROTO_FIELDS field in IPROTO_SELECT request body. */	\
+	_(FIELD_PROJECTION, 7)						\
+	/** IPROTO_CHUNK_SIZE field in IPROTO_SELECT request body. */	\
+	_(SELECT_CHUNKS, 8)						\
+	/**
+	 * IPROTO_COMPRESSION_LEVEL field in IPROTO_JOIN and IPROTO_SUBSCRIBE
+	 * request body.
+	 */								\
+	_(REPLICATION_COMPRESSION, 9)					\
 
 #define IPROTO_FEATURE_MEMBER(s, v) IPROTO_FEATURE_ ## s = v,
 
@@ -83,7 +92,7 @@ struct iproto_features {
  * `box.iproto.protocol_version` needs to be updated correspondingly.
  */
 enum {
-	IPROTO_CURRENT_VERSION = 6,
+	IPROTO_CURRENT_VERSION = 9,
 };
 
 /**
@@ -0,0 +1,176 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "key_normalize.h"
+
+#include <string.h>
+
+#include "key_def.h"
+#include "mp_extension_types.h"
+#include "mp_uuid.h"
+#include "tuple.h"
+
+bool
+key_def_is_normalizable(const struct key_def *def)
+{
+	if (def->is_multikey || def->for_func_index)
+		return false;
+	for (uint32_t i = 0; i < def->part_count; i++) {
+		const struct key_part *part = &def->parts[i];
+		switch (part->type) {
+		case FIELD_TYPE_STRING:
+			if (part->coll != NULL)
+				return false;
+			break;
+		case FIELD_TYPE_UNSIGNED:
+		case FIELD_TYPE_INTEGER:
+		case FIELD_TYPE_VARBINARY:
+		case FIELD_TYPE_BOOLEAN:
+		case FIELD_TYPE_UUID:
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+bool
+key_is_normalizable(const char *key, uint32_t part_count,
+		    const struct key_def *def)
+{
+	assert(part_count <= def->part_count);
+	for (uint32_t i = 0; i < part_count; i++) {
+		const struct key_part *part = &def->parts[i];
+		enum mp_type type = mp_typeof(*key);
+		bool ok;
+		switch (part->type) {
+		case FIELD_TYPE_UNSIGNED:
+			ok = type == MP_UINT;
+			break;
+		case FIELD_TYPE_INTEGER:
+			ok = type == MP_UINT || type == MP_INT;
+			break;
+		case FIELD_TYPE_STRING:
+			ok = type == MP_STR;
+			break;
+		case FIELD_TYPE_VARBINARY:
+			ok = type == MP_BIN;
+			break;
+		case FIELD_TYPE_BOOLEAN:
+			ok = type == MP_BOOL;
+			break;
+		case FIELD_TYPE_UUID: {
+			int8_t ext_type;
+			const char *data = key;
+			ok = type == MP_EXT &&
+			     mp_decode_extl(&data, &ext_type) ==
+			     UUID_PACKED_LEN && ext_type == MP_UUID;
+			break;
+		}
+		default:
+			unreachable();
+			ok = false;
+		}
+		if (!ok && !(type == MP_NIL && key_part_is_nullable(part)))
+			return false;
+		mp_next(&key);
+	}
+	return true;
+}
+
+/**
+ * Normalize a key part. @a field may be NULL if the part is an absent
+ * optional field.
+ */
+static char *
+key_normalize_part(const char *field, const struct key_part *part, char *buf)
+{
+	if (field == NULL || mp_typeof(*field) == MP_NIL) {
+		assert(key_part_is_nullable(part));
+		*buf++ = 0;
+		return buf;
+	}
+	if (key_part_is_nullable(part))
+		*buf++ = 1;
+	switch (part->type) {
+	case FIELD_TYPE_UNSIGNED:
+		return mp_store_u64(buf, mp_decode_uint(&field));
+	case FIELD_TYPE_INTEGER: {
+		if (mp_typeof(*field) == MP_UINT) {
+			*buf++ = 1;
+			return mp_store_u64(buf, mp_decode_uint(&field));
+		}
+		int64_t value = mp_decode_int(&field);
+		*buf++ = value < 0 ? 0 : 1;
+		return mp_store_u64(buf, (uint64_t)value);
+	}
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY: {
+		uint32_t len;
+		const char *data = mp_decode_strbin(&field, &len);
+		for (uint32_t i = 0; i < len; i++) {
+			*buf++ = data[i];
+			if (data[i] == 0)
+				*buf++ = (char)0xff;
+		}
+		*buf++ = 0;
+		*buf++ = 0;
+		return buf;
+	}
+	case FIELD_TYPE_BOOLEAN:
+		*buf++ = mp_decode_bool(&field) ? 1 : 0;
+		return buf;
+	case FIELD_TYPE_UUID: {
+		int8_t type;
+		uint32_t len = mp_decode_extl(&field, &type);
+		assert(type == MP_UUID && len == UUID_PACKED_LEN);
+		(void)type;
+		memcpy(buf, field, len);
+		return buf + len;
+	}
+	default:
+		unreachable();
+	}
+	return buf;
+}
+
+char *
+tuple_normalize_key(struct tuple *tuple, struct key_def *def, char *buf)
+{
+	assert(key_def_is_normalizable(def));
+	bool was_null_met = false;
+	for (uint32_t i = 0; i < def->part_count; i++) {
+		if (def->is_nullable && !was_null_met &&
+		    i >= def->unique_part_count)
+			break;
+		struct key_part *part = &def->parts[i];
+		const char *field = tuple_field_by_part(tuple, part,
+							MULTIKEY_NONE);
+		if (field == NULL || mp_typeof(*field) == MP_NIL)
+			was_null_met = true;
+		buf = key_normalize_part(field, part, buf);
+	}
+	return buf;
+}
+
+char *
+key_normalize(const char *key, uint32_t part_count, struct key_def *def,
+	      char *buf)
+{
+	assert(key_def_is_normalizable(def));
+	assert(part_count <= def->part_count);
+	bool was_null_met = false;
+	for (uint32_t i = 0; i < part_count; i++) {
+		if (def->is_nullable && !was_null_met &&
+		    i >= def->unique_part_count)
+			break;
+		if (mp_typeof(*key) == MP_NIL)
+			was_null_met = true;
+		buf = key_normalize_part(key, &def->parts[i], buf);
+		mp_next(&key);
+	}
+	return buf;
+}
@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct key_def;
+struct tuple;
+
+/**
+ * Key normalization converts a key to a binary string such that normalized
+ * keys compare with memcmp() the same way as the original keys compare
+ * with the key definition. Part sort orders are ignored, the same way
+ * memtx index comparators do.
+ *
+ * A part is encoded as follows:
+ *  - unsigned: 8 bytes, big-endian;
+ *  - integer: 0 for a negative number or 1 otherwise, followed by the
+ *    number as 8 bytes, big-endian;
+ *  - string, varbinary: the data with each zero byte replaced with
+ *    0x00 0xff, terminated with 0x00 0x00;
+ *  - boolean: 0 for false, 1 for true;
+ *  - uuid: 16 bytes of the MsgPack representation.
+ * A nullable part is prefixed with 0 if it's null or 1 otherwise.
+ *
+ * Normalized tuple keys of the same key definition are prefix-free,
+ * i.e. no one is a prefix of another. A normalized partial key is a
+ * prefix of normalized keys of all tuples that match it.
+ */
+
+/** Check if keys of the given definition can be normalized. */
+bool
+key_def_is_normalizable(const struct key_def *def);
+
+/**
+ * Upper bound of the size of a normalized key.
+ * @param data_size - size of the MsgPack data the key is taken from
+ * @param part_count - number of key parts
+ */
+static inline size_t
+key_normalized_size_max(size_t data_size, uint32_t part_count)
+{
+	return 2 * data_size + 11 * (size_t)part_count;
+}
+
+/**
+ * Normalize the key of a tuple. If the key definition is nullable, parts
+ * past unique_part_count are only encoded if the key contains null, the
+ * same way tuple_compare() only compares them in this case.
+ * @param tuple - tuple
+ * @param def - key definition, must be normalizable
+ * @param buf - output buffer of at least key_normalized_size_max() bytes
+ * @return end of the normalized key
+ */
+char *
+tuple_normalize_key(struct tuple *tuple, struct key_def *def, char *buf);
+
+/**
+ * Check if a key can be normalized, i.e. MsgPack types of all its parts
+ * match the part types exactly. For instance, a key passed from SQL may
+ * contain a double value for an integer part, which can't be normalized.
+ * @param key - MsgPack key without the array header
+ * @param part_count - number of parts in the key
+ * @param def - key definition, must be normalizable
+ */
+bool
+key_is_normalizable(const char *key, uint32_t part_count,
+		    const struct key_def *def);
+
+/**
+ * Normalize a key. Parts past unique_part_count are skipped the same way
+ * as in tuple_normalize_key() so that a full key extracted from a tuple
+ * is normalized to the same string as the tuple itself.
+ * @param key - MsgPack key without the array header
+ * @param part_count - number of parts in the key
+ * @param def - key definition, must be normalizable
+ * @param buf - output buffer of at least key_normalized_size_max() bytes
+ * @return end of the normalized key
+ */
+char *
+key_normalize(const char *key, uint32_t part_count, struct key_def *def,
+	      char *buf);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -177,6 +177,14 @@ lbox_cfg_set_wal_queue_max_size(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_wal_tail_size(struct lua_State *L)
+{
+	if (box_set_wal_tail_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_wal_cleanup_delay(struct lua_State *L)
 {
@@ -440,6 +448,38 @@ lbox_cfg_set_cluster_name(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_compression_level(struct lua_State *L)
+{
+	if (box_set_replication_compression_level() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_join_files(struct lua_State *L)
+{
+	(void) L;
+	box_set_replication_join_files();
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_spaces(struct lua_State *L)
+{
+	if (box_set_replication_spaces() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_txn_group_size(struct lua_State *L)
+{
+	if (box_set_replication_txn_group_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_skip_conflict(struct lua_State *L)
 {
@@ -498,6 +538,7 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_checkpoint_interval", lbox_cfg_set_checkpoint_interval},
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
 		{"cfg_set_wal_queue_max_size", lbox_cfg_set_wal_queue_max_size},
+		{"cfg_set_wal_tail_size", lbox_cfg_set_wal_tail_size},
 		{"cfg_set_wal_cleanup_delay", lbox_cfg_set_wal_cleanup_delay},
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
 		{"cfg_set_memtx_memory", lbox_cfg_set_memtx_memory},
@@ -517,6 +558,11 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_replication_synchro_quorum", lbox_cfg_set_replication_synchro_quorum},
 		{"cfg_set_replication_synchro_timeout", lbox_cfg_set_replication_synchro_timeout},
 		{"cfg_set_replication_sync_timeout", lbox_cfg_set_replication_sync_timeout},
+		{"cfg_set_replication_compression_level", lbox_cfg_set_replication_compression_level},
+		{"cfg_set_replication_join_files", lbox_cfg_set_replication_join_files},
+		{"cfg_set_replication_spaces", lbox_cfg_set_replication_spaces},
+		{"cfg_set_replication_txn_group_size",
+		 lbox_cfg_set_replication_txn_group_size},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
 		{"cfg_set_replication_anon", lbox_cfg_set_replication_anon},
 		{"cfg_set_replicaset_name", lbox_cfg_set_replicaset_name},
@@ -842,6 +842,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'wal_queue_max_size',
             default = 16 * 1024 * 1024,
         }),
+        tail_size = schema.scalar({
+            type = 'integer',
+            box_cfg = 'wal_tail_size',
+            default = 16 * 1024 * 1024,
+        }),
         cleanup_delay = schema.scalar({
             type = 'number',
             box_cfg = 'wal_cleanup_delay',
@@ -973,6 +978,12 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 1,
         }),
+        relay_threads = schema.scalar({
+            type = 'integer',
+            box_cfg = 'replication_relay_threads',
+            box_cfg_nondynamic = true,
+            default = 0,
+        }),
         timeout = schema.scalar({
             type = 'number',
             box_cfg = 'replication_timeout',
@@ -1009,6 +1020,28 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'replication_skip_conflict',
             default = false,
         }),
+        compression_level = schema.scalar({
+            type = 'integer',
+            box_cfg = 'replication_compression_level',
+            default = 0,
+        }),
+        join_files = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'replication_join_files',
+            default = false,
+        }),
+        spaces = schema.array({
+            items = schema.scalar({
+                type = 'integer',
+            }),
+            box_cfg = 'replication_spaces',
+            default = box.NULL,
+        }),
+        txn_group_size = schema.scalar({
+            type = 'integer',
+            box_cfg = 'replication_txn_group_size',
+            default = 1,
+        }),
         election_mode = schema.enum({
             'off',
             'voter',
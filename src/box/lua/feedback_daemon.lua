@@ -147,6 +147,8 @@ local function fill_in_indices_stats(space, stats)
                 stats.rtree = stats.rtree + 1
             elseif idx_type == 'BITSET' then
                 stats.bitset = stats.bitset + 1
+            elseif idx_type == 'ART' then
+                stats.art = stats.art + 1
             end
         end
     end
@@ -166,6 +168,7 @@ local function fill_in_schema_stats_impl(schema)
         tree                = 0,
         rtree               = 0,
         bitset              = 0,
+        art                 = 0,
         jsonpath            = 0,
         jsonpath_multikey   = 0,
         functional          = 0,
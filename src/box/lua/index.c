@@ -33,10 +33,15 @@
 #include "lua/info.h"
 #include "info/info.h"
 #include "box/box.h"
+#include "box/error.h"
 #include "box/index.h"
 #include "box/lua/tuple.h"
 #include "box/lua/misc.h"
+#include "box/iproto_constants.h"
+#include "box/xrow.h"
+#include "lua/msgpack.h"
 #include "small/region.h"
+#include "msgpuck.h"
 #include "fiber.h"
 
 /** {{{ box.index Lua library: access to spaces and indexes
@@ -82,6 +87,94 @@ lbox_replace(lua_State *L)
 	return rc == 0 ? luaT_pushtupleornil(L, result) : luaT_error(L);
 }
 
+/** Context of lbox_process_many_on_error(). */
+struct lbox_process_many_ctx {
+	struct lua_State *L;
+	/** Stack index of the table of errors. */
+	int errors_idx;
+	/** Number of failed tuples. */
+	uint32_t error_count;
+};
+
+static int
+lbox_process_many_on_error(void *arg, uint32_t i, struct error *error)
+{
+	struct lbox_process_many_ctx *ctx = arg;
+	luaT_pusherror(ctx->L, error);
+	lua_rawseti(ctx->L, ctx->errors_idx, i + 1);
+	ctx->error_count++;
+	return 0;
+}
+
+/**
+ * Execute a batch of INSERT or REPLACE requests with box_process_many().
+ * The tuples are given either as a Lua array of tables and tuples or as
+ * a MsgPack array in a string or a msgpack object. A failed tuple only
+ * rolls back its own statement. Returns the number of tuples that were
+ * written and a table that maps the (one-based) number of every failed
+ * tuple to its error.
+ */
+static int
+lbox_process_many(lua_State *L, uint16_t type, const char *usage)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1))
+		return luaL_error(L, usage);
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	size_t region_svp = region_used(&fiber()->gc);
+	size_t tuples_len;
+	const char *tuples;
+	if (lua_type(L, 2) == LUA_TSTRING) {
+		tuples = lua_tolstring(L, 2, &tuples_len);
+		const char *pos = tuples;
+		const char *end = tuples + tuples_len;
+		if (tuples_len == 0 || mp_check(&pos, end) != 0 || pos != end) {
+			diag_set(ClientError, ER_INVALID_MSGPACK, "tuples");
+			return luaT_error(L);
+		}
+	} else if ((tuples = luamp_get(L, 2, &tuples_len)) == NULL) {
+		tuples = lbox_encode_tuple_on_gc(L, 2, &tuples_len);
+		if (tuples == NULL)
+			return luaT_error(L);
+	}
+
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = type;
+	request.space_id = space_id;
+	request.tuple = tuples;
+	request.tuple_end = tuples + tuples_len;
+	lua_newtable(L);
+	struct lbox_process_many_ctx ctx = {
+		.L = L,
+		.errors_idx = lua_gettop(L),
+		.error_count = 0,
+	};
+	int rc = box_process_many(&request, lbox_process_many_on_error, &ctx);
+	region_truncate(&fiber()->gc, region_svp);
+	if (rc != 0)
+		return luaT_error(L);
+	uint32_t count = mp_typeof(*tuples) == MP_ARRAY ?
+			 mp_decode_array(&tuples) : 0;
+	lua_pushnumber(L, count - ctx.error_count);
+	lua_insert(L, -2);
+	return 2;
+}
+
+static int
+lbox_insert_many(lua_State *L)
+{
+	return lbox_process_many(L, IPROTO_INSERT,
+				 "Usage space:insert_many(tuples)");
+}
+
+static int
+lbox_replace_many(lua_State *L)
+{
+	return lbox_process_many(L, IPROTO_REPLACE,
+				 "Usage space:replace_many(tuples)");
+}
+
 static int
 lbox_index_update(lua_State *L)
 {
@@ -197,6 +290,43 @@ lbox_index_get(lua_State *L)
 	return rc == 0 ? luaT_pushtupleornil(L, tuple) : luaT_error(L);
 }
 
+static int
+lbox_index_get_many(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2))
+		return luaL_error(L, "Usage index.get_many(space_id, index_id, "
+				  "keys)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	size_t keys_len;
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *keys = lbox_encode_tuple_on_gc(L, 3, &keys_len);
+	if (keys == NULL)
+		return luaT_error(L);
+
+	const char *data = keys;
+	uint32_t count = mp_decode_array(&data);
+	struct tuple **results = xregion_alloc_array(&fiber()->gc,
+						     struct tuple *, count);
+	int rc = box_index_get_many(space_id, index_id, keys, keys + keys_len,
+				    results);
+	if (rc != 0) {
+		region_truncate(&fiber()->gc, region_svp);
+		return luaT_error(L);
+	}
+	lua_createtable(L, count, 0);
+	for (uint32_t i = 0; i < count; i++) {
+		if (results[i] == NULL)
+			continue;
+		luaT_pushtuple(L, results[i]);
+		lua_rawseti(L, -2, i + 1);
+		tuple_unref(results[i]);
+	}
+	region_truncate(&fiber()->gc, region_svp);
+	return 1;
+}
+
 static int
 lbox_index_min(lua_State *L)
 {
@@ -398,11 +528,14 @@ box_lua_index_init(struct lua_State *L)
 	static const struct luaL_Reg boxlib_internal[] = {
 		{"insert", lbox_insert},
 		{"replace",  lbox_replace},
+		{"insert_many", lbox_insert_many},
+		{"replace_many", lbox_replace_many},
 		{"update", lbox_index_update},
 		{"upsert",  lbox_upsert},
 		{"delete",  lbox_index_delete},
 		{"random", lbox_index_random},
 		{"get",  lbox_index_get},
+		{"get_many", lbox_index_get_many},
 		{"min", lbox_index_min},
 		{"max", lbox_index_max},
 		{"count", lbox_index_count},
@@ -54,6 +54,7 @@
 #include "box/txn_limbo.h"
 #include "box/schema.h"
 #include "box/node_name.h"
+#include "box/zstd_iostream.h"
 #include "lua/utils.h"
 #include "lua/serializer.h" /* luaL_setmaphint */
 #include "fiber.h"
@@ -96,6 +97,38 @@ lbox_push_replication_error_message(struct lua_State *L, struct error *e,
 	lua_settable(L, idx - 2);
 }
 
+/** Push traffic statistics of a compressed replication stream. */
+static void
+lbox_push_compression_stat(lua_State *L, const struct zstd_iostream_stat *stat)
+{
+	lua_createtable(L, 0, 2);
+	lua_pushstring(L, "raw");
+	luaL_pushuint64(L, stat->raw);
+	lua_settable(L, -3);
+	lua_pushstring(L, "compressed");
+	luaL_pushuint64(L, stat->compressed);
+	lua_settable(L, -3);
+}
+
+/** Push statistics of the data sent by a relay. */
+static void
+lbox_push_relay_send_stat(lua_State *L, const struct relay_send_stat *stat)
+{
+	lua_createtable(L, 0, 4);
+	lua_pushstring(L, "rows");
+	luaL_pushuint64(L, stat->rows);
+	lua_settable(L, -3);
+	lua_pushstring(L, "bytes");
+	luaL_pushuint64(L, stat->bytes);
+	lua_settable(L, -3);
+	lua_pushstring(L, "rows_per_sec");
+	lua_pushnumber(L, stat->rows_per_sec);
+	lua_settable(L, -3);
+	lua_pushstring(L, "bytes_per_sec");
+	lua_pushnumber(L, stat->bytes_per_sec);
+	lua_settable(L, -3);
+}
+
 static void
 lbox_pushapplier(lua_State *L, struct applier *applier)
 {
@@ -133,6 +166,14 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 		lua_pushlstring(L, name, total);
 		lua_settable(L, -3);
 
+		if (zstd_iostream_is_wrapped(&applier->io)) {
+			struct zstd_iostream_stat stat;
+			zstd_iostream_stat(&applier->io, &stat);
+			lua_pushstring(L, "compression");
+			lbox_push_compression_stat(L, &stat);
+			lua_settable(L, -3);
+		}
+
 		struct error *e = diag_last_error(&applier->fiber->diag);
 		if (e != NULL)
 			lbox_push_replication_error_message(L, e, -1);
@@ -159,6 +200,17 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 		lua_pushstring(L, "lag");
 		lua_pushnumber(L, relay_txn_lag(relay));
 		lua_settable(L, -3);
+		struct zstd_iostream_stat stat;
+		if (relay_compression_stat(relay, &stat)) {
+			lua_pushstring(L, "compression");
+			lbox_push_compression_stat(L, &stat);
+			lua_settable(L, -3);
+		}
+		struct relay_send_stat send_stat;
+		relay_send_stat(relay, &send_stat);
+		lua_pushstring(L, "throughput");
+		lbox_push_relay_send_stat(L, &send_stat);
+		lua_settable(L, -3);
 		break;
 	case RELAY_STOPPED:
 	{
@@ -146,6 +146,7 @@ local default_cfg = {
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
+    wal_tail_size       = 16 * 1024 * 1024,
     wal_cleanup_delay   = 4 * 3600,
     wal_ext             = ifdef_wal_ext(nil),
     force_recovery      = false,
@@ -180,6 +181,10 @@ local default_cfg = {
     replication_skip_conflict = false,
     replication_anon      = false,
     replication_threads   = 1,
+    replication_relay_threads = 0,
+    replication_compression_level = 0,
+    replication_join_files = false,
+    replication_txn_group_size = 1,
     bootstrap_strategy    = "auto",
     bootstrap_leader      = nil,
     feedback_enabled      = ifdef_feedback(true),
@@ -357,6 +362,7 @@ local template_cfg = {
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
     wal_queue_max_size  = 'number',
+    wal_tail_size       = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
@@ -376,6 +382,11 @@ local template_cfg = {
     replication_skip_conflict = 'boolean',
     replication_anon      = 'boolean',
     replication_threads   = 'number',
+    replication_relay_threads = 'number',
+    replication_compression_level = 'number',
+    replication_join_files = 'boolean',
+    replication_spaces = 'number, table',
+    replication_txn_group_size = 'number',
     bootstrap_strategy    = 'string',
     bootstrap_leader      = 'string, number',
     feedback_enabled      = ifdef_feedback('boolean'),
@@ -485,6 +496,7 @@ local dynamic_cfg = {
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
     wal_queue_max_size      = private.cfg_set_wal_queue_max_size,
+    wal_tail_size           = private.cfg_set_wal_tail_size,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = nop,
@@ -505,6 +517,12 @@ local dynamic_cfg = {
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
     replication_anon        = private.cfg_set_replication_anon,
+    replication_compression_level =
+        private.cfg_set_replication_compression_level,
+    replication_join_files  = private.cfg_set_replication_join_files,
+    replication_spaces      = private.cfg_set_replication_spaces,
+    replication_txn_group_size =
+        private.cfg_set_replication_txn_group_size,
     bootstrap_strategy      = private.cfg_set_bootstrap_strategy,
     instance_uuid           = check_instance_uuid,
     instance_name           = private.cfg_set_instance_name,
@@ -619,6 +637,10 @@ local dynamic_cfg_order = {
     replication_synchro_timeout = 150,
     replication_connect_timeout = 150,
     replication_connect_quorum  = 150,
+    replication_compression_level = 150,
+    replication_join_files  = 150,
+    replication_spaces      = 150,
+    replication_txn_group_size = 150,
     -- Apply bootstrap_strategy before replication, but after
     -- replication_connect_quorum. The latter might influence its value.
     bootstrap_strategy      = 175,
@@ -666,6 +688,10 @@ local dynamic_cfg_skip_at_load = {
     replication_synchro_timeout = true,
     replication_skip_conflict = true,
     replication_anon        = true,
+    replication_compression_level = true,
+    replication_join_files  = true,
+    replication_spaces      = true,
+    replication_txn_group_size = true,
     bootstrap_strategy      = true,
     wal_dir_rescan_delay    = true,
     custom_proc_title       = true,
@@ -55,6 +55,7 @@
 
 #include "small/ibuf.h"      /* struct ibuf */
 #include "msgpuck.h"         /* mp_*() */
+#include "mp_check_fast.h"    /* mp_check_fast() */
 
 #include "box/merger.h"      /* merge_source_*, merger_*() */
 
@@ -591,7 +592,7 @@ luaL_merge_source_buffer_next(struct merge_source *base,
 	}
 	const char *tuple_beg = source->buf->rpos;
 	const char *tuple_end = tuple_beg;
-	if (mp_check(&tuple_end, source->buf->wpos) != 0) {
+	if (mp_check_fast(&tuple_end, source->buf->wpos) != 0) {
 		diag_set(IllegalParams, "Unexpected msgpack buffer end");
 		return -1;
 	}
@@ -44,6 +44,7 @@
 #include "box/read_view.h"
 #include "box/space_cache.h"
 #include "box/tuple.h"
+#include "box/tuple_projection.h"
 #include "box/txn.h"
 #include "box/xrow.h"
 #include "core/diag.h"
@@ -196,6 +197,27 @@ lua_wrap_formatted_array(struct lua_State *L, struct tuple_format *format)
 	lua_setmetatable(L, -2);
 }
 
+/**
+ * Push the projection of a tuple to the Lua stack as a new tuple
+ * without format.
+ */
+static void
+port_c_push_projection(struct lua_State *L,
+		       struct tuple_projection *projection,
+		       struct tuple *tuple)
+{
+	struct region *region = &fiber()->gc;
+	size_t svp = region_used(region);
+	size_t size = tuple_projection_lookup(projection, tuple);
+	char *data = (char *)xregion_alloc(region, size);
+	char *data_end = tuple_projection_encode(projection, data);
+	struct tuple *result = tuple_new(tuple_format_runtime, data, data_end);
+	region_truncate(region, svp);
+	if (result == NULL)
+		luaT_error(L);
+	luaT_pushtuple(L, result);
+}
+
 extern "C" void
 port_c_dump_lua(struct port *base, struct lua_State *L, bool is_flat)
 {
@@ -205,7 +227,9 @@ port_c_dump_lua(struct port *base, struct lua_State *L, bool is_flat)
 	struct port_c_entry *pe = port->first;
 	const char *mp;
 	for (int i = 0; pe != NULL; pe = pe->next) {
-		if (pe->mp_size == 0) {
+		if (pe->mp_size == 0 && port->projection != NULL) {
+			port_c_push_projection(L, port->projection, pe->tuple);
+		} else if (pe->mp_size == 0) {
 			luaT_pushtuple(L, pe->tuple);
 		} else {
 			mp = pe->mp;
@@ -287,11 +311,11 @@ lbox_prepare_auth(lua_State *L)
 static int
 lbox_select(lua_State *L)
 {
-	if (lua_gettop(L) != 8 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	if (lua_gettop(L) != 9 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
 	    !lua_isnumber(L, 3) || !lua_isnumber(L, 4) || !lua_isnumber(L, 5) ||
 	    !lua_isboolean(L, 8)) {
 		return luaL_error(L, "Usage index:select(iterator, offset, "
-				  "limit, key, after, fetch_pos)");
+				  "limit, key, after, fetch_pos, fields)");
 	}
 
 	uint32_t svp = region_used(&fiber()->gc);
@@ -313,11 +337,23 @@ lbox_select(lua_State *L)
 	if (lbox_index_normalize_position(L, 7, space_id, index_id,
 					  &packed_pos, &packed_pos_end) != 0)
 		goto fail;
+	struct tuple_projection *projection;
+	projection = NULL;
+	if (!lua_isnil(L, 9)) {
+		size_t fields_len;
+		const char *fields = lbox_encode_tuple_on_gc(L, 9, &fields_len);
+		if (fields == NULL)
+			goto fail;
+		projection = tuple_projection_decode(fields, 1, &fiber()->gc);
+		if (projection == NULL)
+			goto fail;
+	}
 
 	if (box_select(space_id, index_id, iterator, offset, limit, key,
 		       key + key_len, &packed_pos, &packed_pos_end, fetch_pos,
 		       &port) != 0)
 		goto fail;
+	port_c_set_projection(&port, projection);
 	/*
 	 * Lua may raise an exception during allocating table or pushing
 	 * tuples. In this case `port' definitely will leak. It is possible to
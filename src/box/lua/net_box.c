@@ -319,6 +319,12 @@ struct netbox_request {
 	 * a msgpack object will be returned to the caller.
 	 */
 	bool return_raw;
+	/**
+	 * Set for a select request with IPROTO_CHUNK_SIZE. Pushes received
+	 * for such a request are chunks of the result, which are decoded
+	 * the same way as the final response.
+	 */
+	bool is_chunked;
 	/** Lua references to on_push trigger and its context. */
 	int on_push_ref;
 	int on_push_ctx_ref;
@@ -845,7 +851,7 @@ netbox_encode_select(lua_State *L, int idx, struct mpstream *stream,
 {
 	/*
 	 * Lua stack at idx: space_id, index_id, iterator, offset, limit, key,
-	 * after, fetch_pos.
+	 * after, fetch_pos, fields, chunk_size.
 	 */
 	size_t svp = netbox_begin_encode(stream, sync, IPROTO_SELECT,
 					 stream_id);
@@ -857,6 +863,12 @@ netbox_encode_select(lua_State *L, int idx, struct mpstream *stream,
 	bool fetch_pos = lua_toboolean(L, idx + 7);
 	if (fetch_pos)
 		map_size++;
+	bool have_fields = !lua_isnoneornil(L, idx + 8);
+	if (have_fields)
+		map_size += 2;
+	bool have_chunk_size = !lua_isnoneornil(L, idx + 9);
+	if (have_chunk_size)
+		map_size++;
 	mpstream_encode_map(stream, map_size);
 	int iterator = lua_tointeger(L, idx + 2);
 	uint32_t offset = lua_tonumber(L, idx + 3);
@@ -905,6 +917,21 @@ netbox_encode_select(lua_State *L, int idx, struct mpstream *stream,
 		mpstream_encode_bool(stream, fetch_pos);
 	}
 
+	/* encode fields */
+	if (have_fields) {
+		mpstream_encode_uint(stream, IPROTO_INDEX_BASE);
+		mpstream_encode_uint(stream, 1);
+		mpstream_encode_uint(stream, IPROTO_FIELDS);
+		if (luamp_encode_tuple(L, cfg, stream, idx + 8) != 0)
+			return -1;
+	}
+
+	/* encode chunk_size */
+	if (have_chunk_size) {
+		mpstream_encode_uint(stream, IPROTO_CHUNK_SIZE);
+		mpstream_encode_uint(stream, lua_tointeger(L, idx + 9));
+	}
+
 	netbox_end_encode(stream, svp);
 	return 0;
 }
@@ -2307,8 +2334,9 @@ luaT_netbox_transport_make_request(struct lua_State *L, int idx,
 	enum netbox_method method = lua_tointeger(L, arg++);
 	assert(method < netbox_method_MAX);
 	size_t svp = ibuf_used(&transport->send_buf);
-	if (netbox_encode_method(L, arg++, method, &transport->send_buf, sync,
-				 stream_id) != 0) {
+	int method_arg = arg++;
+	if (netbox_encode_method(L, method_arg, method, &transport->send_buf,
+				 sync, stream_id) != 0) {
 		ibuf_truncate(&transport->send_buf, svp);
 		return -1;
 	}
@@ -2321,6 +2349,10 @@ luaT_netbox_transport_make_request(struct lua_State *L, int idx,
 	arg = idx;
 	request->method = method;
 	request->sync = sync;
+	/* See the arguments of netbox_encode_select(). */
+	request->is_chunked = (method == NETBOX_SELECT ||
+			       method == NETBOX_SELECT_WITH_POS) &&
+			      !lua_isnoneornil(L, method_arg + 9);
 	request->buffer = (struct ibuf *)lua_topointer(L, arg);
 	lua_pushvalue(L, arg++);
 	request->buffer_ref = luaL_ref(L, LUA_REGISTRYINDEX);
@@ -2613,6 +2645,10 @@ netbox_transport_dispatch_response(struct netbox_transport *transport,
 			netbox_decode_method(L, request->method, &data,
 					     data_end, request->return_raw,
 					     request->format);
+		} else if (request->is_chunked) {
+			netbox_decode_select(L, &data, data_end,
+					     request->return_raw,
+					     request->format);
 		} else {
 			netbox_decode_value(L, &data, data_end,
 					    request->return_raw,
@@ -3082,6 +3118,10 @@ luaopen_net_box(struct lua_State *L)
 			    IPROTO_FEATURE_SPACE_AND_INDEX_NAMES);
 	iproto_features_set(&NETBOX_IPROTO_FEATURES,
 			    IPROTO_FEATURE_WATCH_ONCE);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_FIELD_PROJECTION);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_SELECT_CHUNKS);
 
 	lua_pushcfunction(L, luaT_netbox_request_iterator_next);
 	luaT_netbox_request_iterator_next_ref = luaL_ref(L, LUA_REGISTRYINDEX);
@@ -38,6 +38,8 @@ local REQUEST_OPTION_TYPES = {
     skip_header = "boolean",
     timeout     = "number",
     fetch_pos   = "boolean",
+    fields      = "table",
+    chunk_size  = "number",
     after = function(after)
         if after ~= nil and type(after) ~= "string" and type(after) ~= "table"
                 and not is_tuple(after) then
@@ -1128,20 +1130,45 @@ index_metatable = function(remote)
         check_param_table(opts, REQUEST_OPTION_TYPES)
         local key_is_nil = (key == nil or
                             (type(key) == 'table' and #key == 0))
-        local iterator, offset, limit, _, after, fetch_pos =
+        local iterator, offset, limit, _, after, fetch_pos, fields =
             check_select_opts(opts, key_is_nil)
         if (after ~= nil or fetch_pos)
                 and not remote.peer_protocol_features.pagination then
             return box.error(box.error.UNSUPPORTED, "Remote server",
                 "pagination")
         end
+        if fields ~= nil and
+                not remote.peer_protocol_features.field_projection then
+            return box.error(box.error.UNSUPPORTED, "Remote server",
+                "field projection")
+        end
+        -- All chunks but the last one are passed to on_push or returned
+        -- by future:pairs(), the last one is returned as the result.
+        local chunk_size = opts and opts.chunk_size
+        if chunk_size ~= nil then
+            if not remote.peer_protocol_features.select_chunks then
+                return box.error(box.error.UNSUPPORTED, "Remote server",
+                    "select chunks")
+            end
+            if chunk_size <= 0 or math.floor(chunk_size) ~= chunk_size then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "chunk_size must be a positive integer")
+            end
+            if not opts.is_async and opts.on_push == nil and
+                    opts.buffer == nil then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "chunk_size requires on_push, is_async or buffer")
+            end
+        end
 
         local res
         local method = fetch_pos and 'SELECT_WITH_POS' or 'SELECT'
-        res = (remote:_request(method, opts, self.space._format_cdata,
+        -- Projected tuples don't match the space format.
+        local format = fields == nil and self.space._format_cdata or nil
+        res = (remote:_request(method, opts, format,
                                self._stream_id, self.space._id_or_name,
                                self._id_or_name, iterator, offset, limit, key,
-                               after, fetch_pos))
+                               after, fetch_pos, fields, chunk_size))
         if type(res) ~= 'table' or not fetch_pos or opts and opts.is_async then
             return res
         end
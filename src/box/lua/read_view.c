@@ -0,0 +1,421 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/read_view.h"
+
+#include <lua.h>
+#include <lauxlib.h>
+
+#include "msgpuck.h"
+
+#include "box/index.h"
+#include "box/iterator_type.h"
+#include "box/read_view.h"
+#include "box/tuple.h"
+#include "box/tuple_format.h"
+#include "box/lua/misc.h"
+#include "box/lua/tuple.h"
+#include "diag.h"
+#include "fiber.h"
+#include "lua/utils.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+
+static const char lbox_read_view_iterator_typename[] =
+	"box.read_view.iterator";
+
+/** Iterator over an index read view created from Lua. */
+struct lbox_read_view_iterator {
+	/**
+	 * Id of the read view the iterator belongs to. The read view may
+	 * be closed while the iterator is still referenced from Lua so we
+	 * look it up by id before every step.
+	 */
+	uint64_t rv_id;
+	/** Set if the underlying iterator is exhausted or destroyed. */
+	bool is_eof;
+	/** Format of tuples returned by the iterator. */
+	struct tuple_format *format;
+	/** Index read view iterator. */
+	struct index_read_view_iterator it;
+};
+
+/** Creates tuple formats for all spaces of a read view. */
+static int
+lbox_read_view_create_formats(struct read_view *rv)
+{
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, rv) {
+		assert(space_rv->format == NULL);
+		struct tuple_format *format = tuple_format_runtime;
+		if (space_rv->format_data != NULL) {
+			format = runtime_tuple_format_new(
+				space_rv->format_data,
+				space_rv->format_data_len,
+				/*names_only=*/true);
+			if (format == NULL)
+				return -1;
+		}
+		tuple_format_ref(format);
+		space_rv->format = format;
+	}
+	return 0;
+}
+
+/** Closes a read view opened by lbox_read_view_open() and frees it. */
+static void
+lbox_read_view_delete(struct read_view *rv)
+{
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, rv) {
+		if (space_rv->format != NULL) {
+			tuple_format_unref(space_rv->format);
+			space_rv->format = NULL;
+		}
+	}
+	read_view_close(rv);
+	free(rv);
+}
+
+/**
+ * Pushes a description of the spaces of a read view to the Lua stack:
+ * an array of {id = ..., name = ..., index = {{id = ..., name = ...}, ...}}.
+ */
+static void
+lbox_push_read_view_spaces(struct lua_State *L, struct read_view *rv)
+{
+	lua_newtable(L);
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, rv) {
+		lua_newtable(L);
+		lua_pushinteger(L, space_rv->id);
+		lua_setfield(L, -2, "id");
+		lua_pushstring(L, space_rv->name);
+		lua_setfield(L, -2, "name");
+		lua_newtable(L);
+		for (uint32_t i = 0; i <= space_rv->index_id_max; i++) {
+			struct index_read_view *index_rv =
+				space_read_view_index(space_rv, i);
+			if (index_rv == NULL)
+				continue;
+			lua_newtable(L);
+			lua_pushinteger(L, index_rv->def->iid);
+			lua_setfield(L, -2, "id");
+			lua_pushstring(L, index_rv->def->name);
+			lua_setfield(L, -2, "name");
+			lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
+		}
+		lua_setfield(L, -2, "index");
+		lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
+	}
+}
+
+/**
+ * Opens a user read view with the given name and pushes a table describing
+ * it (see lbox_push_read_view()) extended with the 'spaces' field (see
+ * lbox_push_read_view_spaces()) to the Lua stack.
+ */
+static int
+lbox_read_view_open(struct lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = name;
+	opts.enable_field_names = true;
+	struct read_view *rv = xmalloc(sizeof(*rv));
+	if (read_view_open(rv, &opts) != 0) {
+		free(rv);
+		return luaT_error(L);
+	}
+	if (lbox_read_view_create_formats(rv) != 0) {
+		lbox_read_view_delete(rv);
+		return luaT_error(L);
+	}
+	lbox_push_read_view(L, rv);
+	lbox_push_read_view_spaces(L, rv);
+	lua_setfield(L, -2, "spaces");
+	return 1;
+}
+
+/** Closes a read view opened with lbox_read_view_open() given its id. */
+static int
+lbox_read_view_close(struct lua_State *L)
+{
+	uint64_t id = luaL_checkuint64(L, 1);
+	struct read_view *rv = read_view_by_id(id);
+	if (rv == NULL)
+		return luaL_error(L, "read view is closed");
+	if (rv->is_system)
+		return luaL_error(L, "read view is busy");
+	lbox_read_view_delete(rv);
+	return 0;
+}
+
+/**
+ * Looks up an index read view given the read view id, space id and index id
+ * passed at the given Lua stack index and the next two. Raises a Lua error
+ * if not found.
+ */
+static struct index_read_view *
+lbox_check_index_read_view(struct lua_State *L, int idx)
+{
+	uint64_t rv_id = luaL_checkuint64(L, idx);
+	uint32_t space_id = luaL_checkinteger(L, idx + 1);
+	uint32_t index_id = luaL_checkinteger(L, idx + 2);
+	struct read_view *rv = read_view_by_id(rv_id);
+	if (rv == NULL)
+		luaL_error(L, "read view is closed");
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, rv) {
+		if (space_rv->id != space_id)
+			continue;
+		struct index_read_view *index_rv =
+			space_read_view_index(space_rv, index_id);
+		if (index_rv == NULL) {
+			diag_set(ClientError, ER_NO_SUCH_INDEX_ID, index_id,
+				 space_rv->name);
+			luaT_error(L);
+		}
+		return index_rv;
+	}
+	diag_set(ClientError, ER_NO_SUCH_SPACE, int2str(space_id));
+	luaT_error(L);
+	unreachable();
+	return NULL;
+}
+
+/**
+ * Creates a tuple from data fetched from a read view and pushes it to
+ * the Lua stack. Raises a Lua error on failure.
+ */
+static void
+lbox_push_read_view_tuple(struct lua_State *L, struct tuple_format *format,
+			  const struct read_view_tuple *result)
+{
+	struct tuple *tuple = tuple_new(format, result->data,
+					result->data + result->size);
+	if (tuple == NULL)
+		luaT_error(L);
+	luaT_pushtuple(L, tuple);
+}
+
+/**
+ * Checks that an iterator over an index read view is a full scan. Index
+ * read views of this edition only support iteration from the first tuple
+ * in the index order (see tree_read_view_iterator_start() and
+ * hash_read_view_iterator_start()), so keys and iterator types other than
+ * ALL are rejected.
+ */
+static int
+lbox_read_view_check_full_scan(int type, uint32_t part_count)
+{
+	if (type != ITER_ALL) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Read view",
+			 tt_sprintf("iterator type %s",
+				    iterator_type_strs[type]));
+		return -1;
+	}
+	if (part_count > 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Read view",
+			 "iteration by key");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Looks up a tuple by a key in an index read view. Arguments: read view
+ * id, space id, index id, key. Lookups aren't supported by index read
+ * views of this edition so it always raises an error.
+ */
+static int
+lbox_read_view_get(struct lua_State *L)
+{
+	lbox_check_index_read_view(L, 1);
+	diag_set(ClientError, ER_UNSUPPORTED, "Read view", "get()");
+	return luaT_error(L);
+}
+
+/**
+ * Selects tuples from an index read view and pushes them to the Lua stack
+ * as an array. Arguments: read view id, space id, index id, iterator type,
+ * offset, limit, key.
+ */
+static int
+lbox_read_view_select(struct lua_State *L)
+{
+	struct index_read_view *index_rv = lbox_check_index_read_view(L, 1);
+	int type = luaL_checkinteger(L, 4);
+	uint32_t offset = luaL_checkinteger(L, 5);
+	uint32_t limit = luaL_checkinteger(L, 6);
+	if (type < 0 || type >= iterator_type_MAX) {
+		diag_set(IllegalParams, "Invalid iterator type");
+		return luaT_error(L);
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t key_len;
+	const char *key = lbox_encode_tuple_on_gc(L, 7, &key_len);
+	if (key == NULL)
+		return luaT_error(L);
+	uint32_t part_count = mp_decode_array(&key);
+	struct index_read_view_iterator it;
+	if (lbox_read_view_check_full_scan(type, part_count) != 0 ||
+	    index_read_view_create_iterator(index_rv, ITER_ALL, NULL, 0,
+					    &it) != 0) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	lua_newtable(L);
+	uint32_t found = 0;
+	while (found < limit) {
+		size_t tuple_svp = region_used(region);
+		struct read_view_tuple result;
+		if (index_read_view_iterator_next_raw(&it, &result) != 0) {
+			index_read_view_iterator_destroy(&it);
+			region_truncate(region, region_svp);
+			return luaT_error(L);
+		}
+		if (result.data == NULL)
+			break;
+		if (offset > 0) {
+			offset--;
+		} else {
+			lbox_push_read_view_tuple(L, index_rv->space->format,
+						  &result);
+			lua_rawseti(L, -2, ++found);
+		}
+		region_truncate(region, tuple_svp);
+	}
+	index_read_view_iterator_destroy(&it);
+	region_truncate(region, region_svp);
+	return 1;
+}
+
+static inline struct lbox_read_view_iterator *
+lbox_check_read_view_iterator(struct lua_State *L, int idx)
+{
+	return luaL_checkudata(L, idx, lbox_read_view_iterator_typename);
+}
+
+/**
+ * Creates an iterator over an index read view. Arguments: read view id,
+ * space id, index id, iterator type, key.
+ */
+static int
+lbox_read_view_iterator(struct lua_State *L)
+{
+	struct index_read_view *index_rv = lbox_check_index_read_view(L, 1);
+	int type = luaL_checkinteger(L, 4);
+	if (type < 0 || type >= iterator_type_MAX) {
+		diag_set(IllegalParams, "Invalid iterator type");
+		return luaT_error(L);
+	}
+	struct lbox_read_view_iterator *iterator =
+		lua_newuserdata(L, sizeof(*iterator));
+	iterator->rv_id = luaL_checkuint64(L, 1);
+	iterator->is_eof = true;
+	iterator->format = index_rv->space->format;
+	luaL_getmetatable(L, lbox_read_view_iterator_typename);
+	lua_setmetatable(L, -2);
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t key_len;
+	const char *key = lbox_encode_tuple_on_gc(L, 5, &key_len);
+	if (key == NULL)
+		return luaT_error(L);
+	uint32_t part_count = mp_decode_array(&key);
+	int rc = lbox_read_view_check_full_scan(type, part_count);
+	if (rc == 0)
+		rc = index_read_view_create_iterator(index_rv, ITER_ALL,
+						     NULL, 0, &iterator->it);
+	region_truncate(region, region_svp);
+	if (rc != 0)
+		return luaT_error(L);
+	iterator->is_eof = false;
+	return 1;
+}
+
+/**
+ * Advances a read view iterator and pushes the next tuple or nil on EOF
+ * to the Lua stack.
+ */
+static int
+lbox_read_view_iterator_next(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *iterator =
+		lbox_check_read_view_iterator(L, 1);
+	if (iterator->is_eof) {
+		lua_pushnil(L);
+		return 1;
+	}
+	if (read_view_by_id(iterator->rv_id) == NULL) {
+		/* The iterator memory is freed with the read view. */
+		iterator->is_eof = true;
+		return luaL_error(L, "read view is closed");
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct read_view_tuple result;
+	if (index_read_view_iterator_next_raw(&iterator->it, &result) != 0) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	if (result.data == NULL) {
+		index_read_view_iterator_destroy(&iterator->it);
+		iterator->is_eof = true;
+		lua_pushnil(L);
+	} else {
+		lbox_push_read_view_tuple(L, iterator->format, &result);
+	}
+	region_truncate(region, region_svp);
+	return 1;
+}
+
+static int
+lbox_read_view_iterator_gc(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *iterator =
+		lbox_check_read_view_iterator(L, 1);
+	if (!iterator->is_eof && read_view_by_id(iterator->rv_id) != NULL)
+		index_read_view_iterator_destroy(&iterator->it);
+	iterator->is_eof = true;
+	return 0;
+}
+
+static int
+lbox_read_view_iterator_tostring(struct lua_State *L)
+{
+	lua_pushstring(L, lbox_read_view_iterator_typename);
+	return 1;
+}
+
+void
+box_lua_read_view_init(struct lua_State *L)
+{
+	static const struct luaL_Reg lbox_read_view_iterator_meta[] = {
+		{"__gc", lbox_read_view_iterator_gc},
+		{"__tostring", lbox_read_view_iterator_tostring},
+		{NULL, NULL},
+	};
+	luaL_register_type(L, lbox_read_view_iterator_typename,
+			   lbox_read_view_iterator_meta);
+
+	static const struct luaL_Reg lbox_read_view_internal[] = {
+		{"open", lbox_read_view_open},
+		{"close", lbox_read_view_close},
+		{"get", lbox_read_view_get},
+		{"select", lbox_read_view_select},
+		{"iterator", lbox_read_view_iterator},
+		{"iterator_next", lbox_read_view_iterator_next},
+		{NULL, NULL},
+	};
+	luaL_findtable(L, LUA_GLOBALSINDEX, "box.internal.read_view", 0);
+	luaL_setfuncs(L, lbox_read_view_internal, 0);
+	lua_pop(L, 1);
+}
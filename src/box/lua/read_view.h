@@ -15,10 +15,11 @@
 
 struct lua_State;
 
-static inline void
-box_lua_read_view_init(struct lua_State *L)
-{
-	(void)L;
-}
+/**
+ * Registers the internal Lua functions used by the box.read_view module
+ * in the box.internal.read_view table.
+ */
+void
+box_lua_read_view_init(struct lua_State *L);
 
 #endif /* !defined(ENABLE_READ_VIEW) */
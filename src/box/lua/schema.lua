@@ -88,7 +88,7 @@ ffi.cdef[[
 
     struct port {
         const struct port_vtab *vtab;
-        char pad[68];
+        char pad[76];
     };
 
     struct port_c_entry {
@@ -107,6 +107,7 @@ ffi.cdef[[
         struct port_c_entry *last;
         struct port_c_entry first_entry;
         int size;
+        struct tuple_projection *projection;
     };
 
     void
@@ -799,6 +800,7 @@ box.schema.space.create = function(name, options)
         temporary = 'boolean',
         is_sync = 'boolean',
         defer_deletes = 'boolean',
+        field_offsets = 'number',
         constraint = 'string, table',
         foreign_key = 'table',
     }
@@ -846,6 +848,8 @@ box.schema.space.create = function(name, options)
         temporary = options.temporary and true or nil,
         is_sync = options.is_sync,
         defer_deletes = options.defer_deletes and true or nil,
+        field_offsets = options.field_offsets ~= 0 and options.field_offsets
+                        or nil,
         constraint = constraint,
         foreign_key = foreign_key,
     })
@@ -939,6 +943,7 @@ local alter_space_template = {
     temporary = 'boolean',
     is_sync = 'boolean',
     defer_deletes = 'boolean',
+    field_offsets = 'number',
     name = 'string',
     constraint = 'string, table',
     foreign_key = 'table',
@@ -981,6 +986,11 @@ box.schema.space.alter = function(space_id, options)
         flags.defer_deletes = options.defer_deletes
     end
 
+    if options.field_offsets ~= nil then
+        flags.field_offsets = options.field_offsets ~= 0 and
+                              options.field_offsets or nil
+    end
+
     local format
     if options.format ~= nil then
         format = normalize_format(space_id, tuple.name, options.format)
@@ -1464,6 +1474,8 @@ local index_options = {
     bloom_fpr = 'number',
     func = 'number, string',
     hint = 'boolean',
+    inline_key = 'boolean',
+    hash_func = 'string',
 }
 
 local function jsonpaths_from_idx_parts(parts)
@@ -1572,6 +1584,24 @@ box.schema.index.create = function(space_id, name, options)
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "functional index can't use hints")
     end
+    if options.inline_key and
+            (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "inline_key is only reasonable with memtx tree index")
+    end
+    if options.inline_key and options.func then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "functional index can't use inline_key")
+    end
+    if options.inline_key and options.hint then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "index can't use both hints and inline_key")
+    end
+    if options.hash_func and
+            (options.type ~= 'hash' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "hash_func is only reasonable with memtx hash index")
+    end
 
     local _index = box.space[box.schema.INDEX_ID]
     local _vindex = box.space[box.schema.VINDEX_ID]
@@ -1611,6 +1641,8 @@ box.schema.index.create = function(space_id, name, options)
             bloom_fpr = options.bloom_fpr,
             func = options.func,
             hint = options.hint,
+            inline_key = options.inline_key,
+            hash_func = options.hash_func,
     }
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
@@ -1633,6 +1665,10 @@ box.schema.index.create = function(space_id, name, options)
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "multikey index can't use hints")
     end
+    if options.inline_key and is_multikey_index(parts) then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "multikey index can't use inline_key")
+    end
     if index_opts.func ~= nil and type(index_opts.func) == 'string' then
         index_opts.func = func_id_by_name(index_opts.func)
     end
@@ -1766,6 +1802,28 @@ box.schema.index.alter = function(space_id, index_id, options)
                                           space.name,
                 "functional index can't use hints")
     end
+    if options.inline_key and
+       (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "inline_key is only reasonable with memtx tree index")
+    end
+    if options.inline_key and options.func then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "functional index can't use inline_key")
+    end
+    if options.inline_key and options.hint then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "index can't use both hints and inline_key")
+    end
+    if options.hash_func and
+       (options.type ~= 'hash' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "hash_func is only reasonable with memtx hash index")
+    end
     if options.parts then
         parts = update_index_parts(format, options.parts)
         -- save parts in old format if possible
@@ -1776,6 +1834,11 @@ box.schema.index.alter = function(space_id, index_id, options)
                                           space.name,
                 "multikey index can't use hints")
     end
+    if options.inline_key and is_multikey_index(parts) then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "multikey index can't use inline_key")
+    end
     if index_opts.func ~= nil and type(index_opts.func) == 'string' then
         index_opts.func = func_id_by_name(index_opts.func)
     end
@@ -2426,6 +2489,18 @@ base_index_mt.get_luac = function(index, key)
     key = keify(key)
     return internal.get(index.space_id, index.id, key)
 end
+base_index_mt.get_many = function(index, keys)
+    check_index_arg(index, 'get_many')
+    if type(keys) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: index:get_many({key1, key2, ...})")
+    end
+    local keified = {}
+    for i, key in ipairs(keys) do
+        keified[i] = keify(key)
+    end
+    return internal.get_many(index.space_id, index.id, keified)
+end
 
 local function check_select_opts(opts, key_is_nil)
     local offset = 0
@@ -2434,6 +2509,7 @@ local function check_select_opts(opts, key_is_nil)
     local fullscan = false
     local after = nil
     local fetch_pos = false
+    local fields = nil
     if opts ~= nil and type(opts) == "table" then
         if opts.offset ~= nil then
             offset = opts.offset
@@ -2454,8 +2530,15 @@ local function check_select_opts(opts, key_is_nil)
         if opts.fetch_pos ~= nil then
             fetch_pos = opts.fetch_pos
         end
+        if opts.fields ~= nil then
+            fields = opts.fields
+            if type(fields) ~= "table" then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "fields must be a table")
+            end
+        end
     end
-    return iterator, offset, limit, fullscan, after, fetch_pos
+    return iterator, offset, limit, fullscan, after, fetch_pos, fields
 end
 
 box.internal.check_select_opts = check_select_opts -- for net.box
@@ -2479,7 +2562,9 @@ local function log_long_select(space)
 end
 
 base_index_mt.select_ffi = function(index, key, opts)
-    if builtin.box_read_ffi_is_disabled then
+    -- Projected tuples are created by port_c_dump_lua().
+    if builtin.box_read_ffi_is_disabled or
+            (type(opts) == "table" and opts.fields ~= nil) then
         return base_index_mt.select_luac(index, key, opts)
     end
     local nok
@@ -2527,7 +2612,7 @@ base_index_mt.select_luac = function(index, key, opts)
     check_index_arg(index, 'select')
     local key = keify(key)
     local key_is_nil = #key == 0
-    local iterator, offset, limit, fullscan, after, fetch_pos =
+    local iterator, offset, limit, fullscan, after, fetch_pos, fields =
         check_select_opts(opts, key_is_nil)
     local sid = index.space_id
     if is_select_long(sid, key_is_nil, iterator, limit, offset,
@@ -2535,7 +2620,7 @@ base_index_mt.select_luac = function(index, key, opts)
         log_long_select(box.space[sid])
     end
     return internal.select(sid, index.id, iterator,
-        offset, limit, key, after, fetch_pos)
+        offset, limit, key, after, fetch_pos, fields)
 end
 
 base_index_mt.update = function(index, key, ops)
@@ -2624,11 +2709,19 @@ space_mt.bsize = function(space)
     end
     return builtin.space_bsize(s)
 end
+space_mt.stat = function(space)
+    check_space_arg(space, 'stat')
+    return internal.space.stat(space.id)
+end
 
 space_mt.get = function(space, key)
     check_space_arg(space, 'get')
     return check_primary_index(space):get(key)
 end
+space_mt.get_many = function(space, keys)
+    check_space_arg(space, 'get_many')
+    return check_primary_index(space):get_many(keys)
+end
 space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select')
     return check_primary_index(space):select(key, opts)
@@ -2654,6 +2747,14 @@ space_mt.replace = function(space, tuple)
     return internal.replace(space.id, tuple);
 end
 space_mt.put = space_mt.replace; -- put is an alias for replace
+space_mt.insert_many = function(space, tuples)
+    check_space_arg(space, 'insert_many')
+    return internal.insert_many(space.id, tuples)
+end
+space_mt.replace_many = function(space, tuples)
+    check_space_arg(space, 'replace_many')
+    return internal.replace_many(space.id, tuples)
+end
 space_mt.update = function(space, key, ops)
     check_space_arg(space, 'update')
     return check_primary_index(space):update(key, ops)
@@ -3763,10 +3864,14 @@ function read_view_methods:info()
 end
 
 --
--- Function stub. Implemented in Tarantool EE.
+-- Closes a read view given its object. Raises an error if the read view
+-- is used for system purposes.
 --
-function box.internal.read_view_close()
-    error('read view is busy', 3)
+function box.internal.read_view_close(rv)
+    local ok, err = pcall(internal.read_view.close, rv.id)
+    if not ok then
+        error(err, 3)
+    end
 end
 
 --
@@ -3809,13 +3914,6 @@ local read_view_mt = {
 
 box.read_view = {}
 
---
--- Function stub. Implemented in Tarantool EE.
---
-function box.read_view.open()
-    box.error(box.error.UNSUPPORTED, "Community edition", "read view")
-end
-
 --
 -- Table of open read views: id -> read view object.
 --
@@ -3824,6 +3922,132 @@ end
 --
 local read_view_registry = setmetatable({}, {__mode = 'v'})
 
+--
+-- Table of read view finalizers: read view object -> cdata that closes
+-- the read view when garbage collected. Since tables can't have __gc in
+-- LuaJIT, we use it to close a read view opened by box.read_view.open()
+-- after the user drops the last reference to it.
+--
+local read_view_gc = setmetatable({}, {__mode = 'k'})
+
+local function check_read_view_index_arg(index, method)
+    if type(index) ~= 'table' then
+        local fmt = 'Use index:%s(...) instead of index.%s(...)'
+        error(string.format(fmt, method, method), 3)
+    end
+end
+
+local function read_view_key_is_nil(key)
+    return key == nil or (type(key) == 'table' and #key == 0)
+end
+
+local read_view_index_methods = {}
+
+--
+-- Looks up a tuple by a full key in a read view of an index. Not supported
+-- by read views of this edition, raises an error.
+--
+function read_view_index_methods:get(key)
+    check_read_view_index_arg(self, 'get')
+    return internal.read_view.get(self.read_view.id, self.space_id,
+                                  self.id, key or {})
+end
+
+--
+-- Selects tuples from a read view of an index. Supported options are
+-- 'iterator', 'offset' and 'limit'. Only full scans (no key, the ALL
+-- iterator) are supported.
+--
+function read_view_index_methods:select(key, opts)
+    check_read_view_index_arg(self, 'select')
+    local itype = check_iterator_type(opts, read_view_key_is_nil(key))
+    local offset = 0
+    local limit = 4294967295
+    if type(opts) == 'table' then
+        offset = opts.offset or offset
+        limit = opts.limit or limit
+    end
+    return internal.read_view.select(self.read_view.id, self.space_id,
+                                     self.id, itype, offset, limit,
+                                     key or {})
+end
+
+local function read_view_iterator_gen(rv, it) -- luacheck: no unused args
+    local tuple = internal.read_view.iterator_next(it)
+    if tuple == nil then
+        return nil
+    end
+    return it, tuple
+end
+
+--
+-- Returns an iterator over a read view of an index. The iterator may be
+-- used across yields. Only full scans (no key, the ALL iterator) are
+-- supported.
+--
+function read_view_index_methods:pairs(key, opts)
+    check_read_view_index_arg(self, 'pairs')
+    local itype = check_iterator_type(opts, read_view_key_is_nil(key))
+    local rv = self.read_view
+    local it = internal.read_view.iterator(rv.id, self.space_id, self.id,
+                                           itype, key or {})
+    -- Pass the read view object as the iterator parameter so that it isn't
+    -- garbage collected (and so closed) while the iterator is in use.
+    return fun.wrap(read_view_iterator_gen, rv, it)
+end
+
+local read_view_index_mt = {
+    __index = read_view_index_methods,
+    __serialize = function(self)
+        return {id = self.id, name = self.name}
+    end,
+}
+
+local read_view_space_mt = {
+    __serialize = function(self)
+        return {id = self.id, name = self.name}
+    end,
+}
+
+--
+-- Opens a read view of all memtx spaces. Takes an optional table with
+-- the read view name ('name').
+--
+function box.read_view.open(opts)
+    if opts ~= nil and type(opts) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS, "options should be a table")
+    end
+    local name = opts ~= nil and opts.name or 'unknown'
+    if type(name) ~= 'string' then
+        box.error(box.error.ILLEGAL_PARAMS, "name should be a string")
+    end
+    local rv = internal.read_view.open(name)
+    local spaces = rv.spaces
+    rv.spaces = nil
+    rv.space = {}
+    for _, s in ipairs(spaces) do
+        local space = setmetatable({id = s.id, name = s.name, index = {}},
+                                   read_view_space_mt)
+        for _, i in ipairs(s.index) do
+            local index = setmetatable({
+                id = i.id,
+                name = i.name,
+                space_id = s.id,
+                read_view = rv,
+            }, read_view_index_mt)
+            space.index[i.id] = index
+            space.index[i.name] = index
+        end
+        rv.space[s.id] = space
+        rv.space[s.name] = space
+    end
+    local id = rv.id
+    read_view_gc[rv] = ffi.gc(ffi.new('char[1]'), function()
+        pcall(internal.read_view.close, id)
+    end)
+    return box.internal.read_view_register(rv)
+end
+
 --
 -- Sets a metatable for a new read view object and adds it to the registry so
 -- that it can be returned by box.read_view_list().
@@ -455,6 +455,14 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 	lua_pushcfunction(L, lbox_space_before_replace);
 	lua_settable(L, i);
 
+	/* space.field_offsets */
+	lua_pushstring(L, "field_offsets");
+	if (space->def->opts.field_offset_count > 0)
+		lua_pushnumber(L, space->def->opts.field_offset_count);
+	else
+		lua_pushnil(L);
+	lua_settable(L, i);
+
 	if (space_is_vinyl(space)) {
 		lua_pushstring(L, "defer_deletes");
 		lua_pushboolean(L, space->def->opts.defer_deletes);
@@ -525,7 +533,8 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			assert(! lua_isnil(L, -1));
 		}
 
-		if (index_def->type == HASH || index_def->type == TREE) {
+		if (index_def->type == HASH || index_def->type == TREE ||
+		    index_def->type == ART) {
 			lua_pushboolean(L, index_opts->is_unique);
 			lua_setfield(L, -2, "unique");
 		} else if (index_def->type == RTREE) {
@@ -539,6 +548,24 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnil(L);
 			lua_setfield(L, -2, "hint");
 		}
+		/* Only exported if set to keep the output compact. */
+		if (space_is_memtx(space) && index_def->type == TREE &&
+		    index_opts->inline_key) {
+			lua_pushboolean(L, true);
+			lua_setfield(L, -2, "inline_key");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "inline_key");
+		}
+		if (space_is_memtx(space) && index_def->type == HASH &&
+		    index_opts->hash_func != INDEX_HASH_FUNC_MURMUR3) {
+			lua_pushstring(L,
+				       index_hash_func_strs[index_opts->hash_func]);
+			lua_setfield(L, -2, "hash_func");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "hash_func");
+		}
 
 		if (index_opts->func_id > 0) {
 			lua_pushstring(L, "func");
@@ -795,6 +822,44 @@ usage_error:
 	return luaL_error(L, "Usage: space:frommap(map, opts)");
 }
 
+/**
+ * Return space statistics:
+ * - field_offsets.count - value of the field_offsets space option.
+ * - field_offsets.tuple_size - size of the field map part occupied
+ *   by offsets stored because of the option, per tuple.
+ * - field_offsets.size - memory used by such offsets in all tuples.
+ *   Since tuples inserted before the option was changed keep their
+ *   field maps, this is an estimate.
+ * @param L Lua stack.
+ * @param 1 Space identifier.
+ * @retval Statistics table.
+ */
+static int
+lbox_space_stat(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_isnumber(L, 1))
+		return luaL_error(L, "Usage: space:stat()");
+	struct space *space = space_cache_find(lua_tointeger(L, 1));
+	if (space == NULL)
+		return luaT_error(L);
+	struct index *pk = space_index(space, 0);
+	ssize_t tuple_count = pk != NULL ? index_size(pk) : 0;
+	if (tuple_count < 0)
+		return luaT_error(L);
+	size_t tuple_size = space->format->field_offsets_size;
+
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushnumber(L, space->def->opts.field_offset_count);
+	lua_setfield(L, -2, "count");
+	lua_pushnumber(L, tuple_size);
+	lua_setfield(L, -2, "tuple_size");
+	lua_pushnumber(L, tuple_size * tuple_count);
+	lua_setfield(L, -2, "size");
+	lua_setfield(L, -2, "field_offsets");
+	return 1;
+}
+
 void
 box_lua_space_init(struct lua_State *L)
 {
@@ -896,6 +961,7 @@ box_lua_space_init(struct lua_State *L)
 
 	static const struct luaL_Reg space_internal_lib[] = {
 		{"frommap", lbox_space_frommap},
+		{"stat", lbox_space_stat},
 		{NULL, NULL}
 	};
 	luaL_findtable(L, LUA_GLOBALSINDEX, "box.internal.space", 0);
@@ -41,12 +41,19 @@
 #include "box/box.h"
 #include "box/iproto.h"
 #include "box/engine.h"
+#include "box/relay.h"
+#include "box/replication.h"
+#include "box/replication_hist.h"
 #include "box/vinyl.h"
 #include "box/sql.h"
 #include "box/memtx_engine.h"
 #include "info/info.h"
 #include "lua/info.h"
 #include "lua/utils.h"
+#include "histogram.h"
+#include "latency.h"
+#include "trivia/util.h"
+#include "tt_static.h"
 
 extern struct rmean *rmean_box;
 extern struct rmean *rmean_error;
@@ -317,6 +324,76 @@ lbox_stat_net_thread_call(struct lua_State *L)
 	return 1;
 }
 
+/** Percentiles reported for replication histograms. */
+static const int replication_stat_pct[] = {50, 75, 90, 95, 99};
+
+/** Push a table with percentiles of a latency, in seconds. */
+static void
+lbox_push_latency_pct(struct lua_State *L, struct latency *latency)
+{
+	lua_createtable(L, 0, lengthof(replication_stat_pct));
+	for (size_t i = 0; i < lengthof(replication_stat_pct); i++) {
+		int pct = replication_stat_pct[i];
+		lua_pushnumber(L, latency_get(latency, pct));
+		lua_setfield(L, -2, tt_sprintf("p%d", pct));
+	}
+}
+
+/** Push a table with percentiles of a histogram. */
+static void
+lbox_push_histogram_pct(struct lua_State *L, struct histogram *hist)
+{
+	lua_createtable(L, 0, lengthof(replication_stat_pct));
+	for (size_t i = 0; i < lengthof(replication_stat_pct); i++) {
+		int pct = replication_stat_pct[i];
+		lua_pushnumber(L, histogram_percentile(hist, pct));
+		lua_setfield(L, -2, tt_sprintf("p%d", pct));
+	}
+}
+
+/**
+ * Push the replication histograms. @a latency_name is the name of
+ * the latency histogram, which has different meaning for appliers
+ * and relays.
+ */
+static void
+lbox_push_replication_hist(struct lua_State *L, struct replication_hist *hist,
+			   const char *latency_name)
+{
+	lua_createtable(L, 0, 3);
+	lbox_push_latency_pct(L, &hist->lag);
+	lua_setfield(L, -2, "lag");
+	lbox_push_latency_pct(L, &hist->latency);
+	lua_setfield(L, -2, latency_name);
+	lbox_push_histogram_pct(L, hist->bytes_per_sec);
+	lua_setfield(L, -2, "bytes_per_sec");
+}
+
+/* box.stat.replication() */
+static int
+lbox_stat_replication(struct lua_State *L)
+{
+	lua_newtable(L);
+	replicaset_foreach(replica) {
+		if (replica->id == REPLICA_ID_NIL)
+			continue;
+		lua_newtable(L);
+		if (replica->applier != NULL) {
+			lbox_push_replication_hist(L, &replica->applier->hist,
+						   "apply_latency");
+			lua_setfield(L, -2, "upstream");
+		}
+		if (relay_get_state(replica->relay) != RELAY_OFF) {
+			lbox_push_replication_hist(L,
+						   relay_hist(replica->relay),
+						   "ack_rtt");
+			lua_setfield(L, -2, "downstream");
+		}
+		lua_rawseti(L, -2, replica->id);
+	}
+	return 1;
+}
+
 static int
 lbox_stat_sql(struct lua_State *L)
 {
@@ -367,6 +444,7 @@ box_lua_stat_init(struct lua_State *L)
 		{"vinyl", lbox_stat_vinyl},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
+		{"replication", lbox_stat_replication},
 		{NULL, NULL}
 	};
 
@@ -331,6 +331,20 @@ public:
 		}
 	}
 
+	/**
+	 * Returns true if the tuple may be used by an open read view,
+	 * i.e. it was allocated before the last read view was created.
+	 * Such a tuple must not be modified.
+	 */
+	static bool tuple_is_in_read_view(struct tuple *tuple)
+	{
+		struct memtx_tuple *memtx_tuple = container_of(
+			tuple, struct memtx_tuple, base);
+		struct memtx_tuple_rv *rv = tuple_rv_last(tuple);
+		return rv != nullptr &&
+		       memtx_tuple->version < memtx_tuple_rv_version(rv);
+	}
+
 	/**
 	 * Does a garbage collection step. Returns false if there's no more
 	 * tuples to collect.
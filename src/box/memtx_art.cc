@@ -0,0 +1,1185 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_art.h"
+
+#include <salad/art.h>
+#include <small/mempool.h>
+
+#include "index.h"
+#include "errinj.h"
+#include "fiber.h"
+#include "trivia/util.h"
+
+#include "key_normalize.h"
+#include "tuple.h"
+#include "txn.h"
+#include "memtx_tx.h"
+#include "space.h"
+#include "schema.h"
+#include "memtx_engine.h"
+
+enum {
+	/** Tree node sizes are rounded up to a multiple of this. */
+	MEMTX_ART_NODE_ALIGN = 16,
+	/**
+	 * Max size of a tree node. Limits the length of a normalized key,
+	 * see memtx_art_key_len_max().
+	 */
+	MEMTX_ART_NODE_SIZE_MAX = MEMTX_EXTENT_SIZE / 2,
+	/** Number of node size classes. */
+	MEMTX_ART_NODE_CLASS_COUNT =
+		MEMTX_ART_NODE_SIZE_MAX / MEMTX_ART_NODE_ALIGN,
+};
+
+struct memtx_art_index {
+	struct index base;
+	/** Radix tree mapping normalized tuple keys to tuples. */
+	struct art_tree tree;
+	/**
+	 * Key definition used for key normalization.
+	 * See memtx_art_index_update_def().
+	 */
+	struct key_def *cmp_def;
+	struct memtx_gc_task gc_task;
+	struct art_iterator gc_iterator;
+	/**
+	 * Tree nodes are carved from memtx index extents so they are
+	 * accounted in the memtx quota, and allocations done on rollback
+	 * are served from extents reserved before each change with
+	 * memtx_index_extent_reserve(). Freed nodes are kept in lists,
+	 * one per size class, linked by the first word.
+	 */
+	void *free_nodes[MEMTX_ART_NODE_CLASS_COUNT];
+	/** Unused space at the end of the last allocated extent. */
+	char *extent_pos;
+	/** Size of the unused space at extent_pos. */
+	size_t extent_left;
+	/**
+	 * Extents allocated by the index, linked by the first word.
+	 * Freed only when the index is destroyed.
+	 */
+	void *extents;
+	/** Number of extents allocated by the index. */
+	size_t extent_count;
+};
+
+/* {{{ Utilities. *************************************************/
+
+/** Size class of a tree node. */
+static inline size_t
+memtx_art_node_class(size_t size)
+{
+	assert(size > 0 && size <= MEMTX_ART_NODE_SIZE_MAX);
+	return DIV_ROUND_UP(size, MEMTX_ART_NODE_ALIGN) - 1;
+}
+
+static void
+memtx_art_free(void *ctx, void *ptr, size_t size)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)ctx;
+	size_t cls = memtx_art_node_class(size);
+	*(void **)ptr = index->free_nodes[cls];
+	index->free_nodes[cls] = ptr;
+}
+
+static void *
+memtx_art_alloc(void *ctx, size_t size)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)ctx;
+	size_t cls = memtx_art_node_class(size);
+	void *node = index->free_nodes[cls];
+	if (node != NULL) {
+		index->free_nodes[cls] = *(void **)node;
+		return node;
+	}
+	size = (cls + 1) * MEMTX_ART_NODE_ALIGN;
+	if (index->extent_left < size) {
+		struct memtx_engine *memtx =
+			(struct memtx_engine *)index->base.engine;
+		char *extent = (char *)memtx_index_extent_alloc(memtx);
+		if (extent == NULL)
+			return NULL;
+		memtx->index_extent_stats.extent_count++;
+		/* Don't waste the end of the previous extent. */
+		if (index->extent_left > 0)
+			memtx_art_free(index, index->extent_pos,
+				       index->extent_left);
+		*(void **)extent = index->extents;
+		index->extents = extent;
+		index->extent_count++;
+		index->extent_pos = extent + MEMTX_ART_NODE_ALIGN;
+		index->extent_left = MEMTX_EXTENT_SIZE - MEMTX_ART_NODE_ALIGN;
+	}
+	node = index->extent_pos;
+	index->extent_pos += size;
+	index->extent_left -= size;
+	return node;
+}
+
+/**
+ * Max length of a normalized key that may be stored in the index.
+ * Bounded so that any tree node fits in an index extent.
+ */
+static inline uint32_t
+memtx_art_key_len_max(void)
+{
+	return MEMTX_ART_NODE_SIZE_MAX - art_node_size_max(0);
+}
+
+/**
+ * Normalize the key of a tuple. The result is allocated on the fiber
+ * region.
+ */
+static const char *
+memtx_art_tuple_key(struct key_def *cmp_def, struct tuple *tuple,
+		    uint32_t *len)
+{
+	size_t size = key_normalized_size_max(tuple_bsize(tuple),
+					      cmp_def->part_count);
+	char *buf = (char *)xregion_alloc(&fiber()->gc, size);
+	*len = tuple_normalize_key(tuple, cmp_def, buf) - buf;
+	return buf;
+}
+
+/**
+ * Normalize a search key. The result is allocated on the fiber region.
+ * Parts past the ones covered by @a cmp_def are ignored.
+ */
+static const char *
+memtx_art_search_key(struct key_def *cmp_def, const char *key,
+		     uint32_t part_count, uint32_t *len)
+{
+	part_count = MIN(part_count, cmp_def->part_count);
+	const char *key_end = key;
+	for (uint32_t i = 0; i < part_count; i++)
+		mp_next(&key_end);
+	size_t size = key_normalized_size_max(key_end - key, part_count);
+	char *buf = (char *)xregion_alloc(&fiber()->gc, size);
+	*len = key_normalize(key, part_count, cmp_def, buf) - buf;
+	return buf;
+}
+
+/* }}} */
+
+/* {{{ MemtxArt Iterators ****************************************/
+
+struct art_iterator_wrapper {
+	struct iterator base;
+	enum iterator_type type;
+	/** Search key, MsgPack without the array header. */
+	const char *key;
+	uint32_t part_count;
+	/** Position to start after, extracted cmp_def or NULL. */
+	const char *after;
+	/**
+	 * The iterator is invalidated by any change of the tree. In this
+	 * case it's repositioned by the last fetched tuple.
+	 */
+	struct art_iterator impl;
+	/**
+	 * Tuple that was fetched last, needed to make iterators stable.
+	 * Contains NULL only if there was no tuple fetched. Otherwise,
+	 * it's not NULL, even if iterator is exhausted - pagination
+	 * relies on it. Referenced.
+	 */
+	struct tuple *last;
+	/** Memory pool the iterator was allocated from. */
+	struct mempool *pool;
+};
+
+/** Set last fetched tuple. */
+static inline void
+art_iterator_wrapper_set_last(struct art_iterator_wrapper *it,
+			      struct tuple *tuple)
+{
+	assert(tuple != NULL);
+	if (it->last != NULL)
+		tuple_unref(it->last);
+	it->last = tuple;
+	tuple_ref(tuple);
+}
+
+static void
+art_iterator_wrapper_free(struct iterator *iterator)
+{
+	struct art_iterator_wrapper *it =
+		(struct art_iterator_wrapper *)iterator;
+	if (it->last != NULL)
+		tuple_unref(it->last);
+	mempool_free(it->pool, it);
+}
+
+/**
+ * Step the iterator in the given direction from the last fetched tuple.
+ * If the tree was modified since the iterator was positioned, it is
+ * repositioned by the key of the last fetched tuple first.
+ */
+static void
+art_iterator_wrapper_step(struct art_iterator_wrapper *it, bool reverse)
+{
+	struct memtx_art_index *index =
+		(struct memtx_art_index *)it->base.index;
+	assert(it->last != NULL);
+	if (art_iterator_is_valid(&it->impl, &index->tree)) {
+		if (reverse)
+			art_iterator_prev(&it->impl, index->tree.root);
+		else
+			art_iterator_next(&it->impl, index->tree.root);
+	} else {
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		uint32_t len;
+		const char *key = memtx_art_tuple_key(index->cmp_def,
+						      it->last, &len);
+		if (reverse)
+			art_iterator_lt(&it->impl, index->tree.root, key, len);
+		else
+			art_iterator_gt(&it->impl, index->tree.root, key, len);
+		region_truncate(region, region_svp);
+	}
+	art_iterator_set_version(&it->impl, &index->tree);
+}
+
+static int
+art_iterator_wrapper_next_base(struct iterator *iterator, struct tuple **ret)
+{
+	struct art_iterator_wrapper *it =
+		(struct art_iterator_wrapper *)iterator;
+	art_iterator_wrapper_step(it, false);
+	struct tuple *res = (struct tuple *)art_iterator_value(&it->impl);
+	struct index *idx = iterator->index;
+	struct space *space = space_by_id(iterator->space_id);
+	*ret = res;
+	if (res == NULL) {
+		iterator->next_internal = exhausted_iterator_next;
+	} else {
+		art_iterator_wrapper_set_last(it, res);
+		struct txn *txn = in_txn();
+		*ret = memtx_tx_tuple_clarify(txn, space, res, idx, 0);
+	}
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+	/*
+	 * Pass no key because any write to the gap between that
+	 * two tuples must lead to conflict.
+	 */
+	memtx_tx_track_gap(in_txn(), space, idx, res, ITER_GE, NULL, 0);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	return 0;
+}
+
+static int
+art_iterator_wrapper_prev_base(struct iterator *iterator, struct tuple **ret)
+{
+	struct art_iterator_wrapper *it =
+		(struct art_iterator_wrapper *)iterator;
+	struct tuple *successor = it->last;
+	tuple_ref(successor);
+	art_iterator_wrapper_step(it, true);
+	struct tuple *res = (struct tuple *)art_iterator_value(&it->impl);
+	struct index *idx = iterator->index;
+	struct space *space = space_by_id(iterator->space_id);
+	*ret = res;
+	if (res == NULL) {
+		iterator->next_internal = exhausted_iterator_next;
+	} else {
+		art_iterator_wrapper_set_last(it, res);
+		struct txn *txn = in_txn();
+		/*
+		 * We need to clarify the result tuple before story garbage
+		 * collection, otherwise it could get cleaned there.
+		 */
+		*ret = memtx_tx_tuple_clarify(txn, space, res, idx, 0);
+	}
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+	/*
+	 * Pass no key because any write to the gap between that
+	 * two tuples must lead to conflict.
+	 */
+	memtx_tx_track_gap(in_txn(), space, idx, successor, ITER_LE, NULL, 0);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	tuple_unref(successor);
+	return 0;
+}
+
+static int
+art_iterator_wrapper_next_equal_base(struct iterator *iterator,
+				     struct tuple **ret)
+{
+	struct art_iterator_wrapper *it =
+		(struct art_iterator_wrapper *)iterator;
+	art_iterator_wrapper_step(it, false);
+	struct tuple *res = (struct tuple *)art_iterator_value(&it->impl);
+	struct index *idx = iterator->index;
+	struct space *space = space_by_id(iterator->space_id);
+	/* Use user key def to save a few loops. */
+	if (res == NULL ||
+	    tuple_compare_with_key(res, HINT_NONE, it->key, it->part_count,
+				   HINT_NONE, idx->def->key_def) != 0) {
+		iterator->next_internal = exhausted_iterator_next;
+		*ret = NULL;
+		/*
+		 * Got end of key. Store gap from the previous tuple to the
+		 * key boundary in nearby tuple.
+		 */
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		memtx_tx_track_gap(in_txn(), space, idx, res, ITER_EQ,
+				   it->key, it->part_count);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	} else {
+		art_iterator_wrapper_set_last(it, res);
+		struct txn *txn = in_txn();
+		*ret = memtx_tx_tuple_clarify(txn, space, res, idx, 0);
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		/*
+		 * Pass no key because any write to the gap between that
+		 * two tuples must lead to conflict.
+		 */
+		memtx_tx_track_gap(in_txn(), space, idx, res, ITER_GE,
+				   NULL, 0);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	}
+	return 0;
+}
+
+static int
+art_iterator_wrapper_prev_equal_base(struct iterator *iterator,
+				     struct tuple **ret)
+{
+	struct art_iterator_wrapper *it =
+		(struct art_iterator_wrapper *)iterator;
+	struct tuple *successor = it->last;
+	tuple_ref(successor);
+	art_iterator_wrapper_step(it, true);
+	struct tuple *res = (struct tuple *)art_iterator_value(&it->impl);
+	struct index *idx = iterator->index;
+	struct space *space = space_by_id(iterator->space_id);
+	/* Use user key def to save a few loops. */
+	if (res == NULL ||
+	    tuple_compare_with_key(res, HINT_NONE, it->key, it->part_count,
+				   HINT_NONE, idx->def->key_def) != 0) {
+		iterator->next_internal = exhausted_iterator_next;
+		*ret = NULL;
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		/*
+		 * Got end of key. Store gap from the key boundary to the
+		 * previous tuple in nearby tuple.
+		 */
+		memtx_tx_track_gap(in_txn(), space, idx, successor, ITER_REQ,
+				   it->key, it->part_count);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	} else {
+		art_iterator_wrapper_set_last(it, res);
+		struct txn *txn = in_txn();
+		/*
+		 * We need to clarify the result tuple before story garbage
+		 * collection, otherwise it could get cleaned there.
+		 */
+		*ret = memtx_tx_tuple_clarify(txn, space, res, idx, 0);
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		/*
+		 * Pass no key because any write to the gap between that
+		 * two tuples must lead to conflict.
+		 */
+		memtx_tx_track_gap(in_txn(), space, idx, successor, ITER_LE,
+				   NULL, 0);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	}
+	tuple_unref(successor);
+	return 0;
+}
+
+#define WRAP_ITERATOR_METHOD(name)						\
+static int									\
+name(struct iterator *iterator, struct tuple **ret)				\
+{										\
+	do {									\
+		int rc = name##_base(iterator, ret);				\
+		if (rc != 0 ||							\
+		    iterator->next_internal == exhausted_iterator_next)		\
+			return rc;						\
+	} while (*ret == NULL);							\
+	return 0;								\
+}										\
+struct forgot_to_add_semicolon
+
+WRAP_ITERATOR_METHOD(art_iterator_wrapper_next);
+WRAP_ITERATOR_METHOD(art_iterator_wrapper_prev);
+WRAP_ITERATOR_METHOD(art_iterator_wrapper_next_equal);
+WRAP_ITERATOR_METHOD(art_iterator_wrapper_prev_equal);
+
+#undef WRAP_ITERATOR_METHOD
+
+static void
+art_iterator_wrapper_set_next_method(struct art_iterator_wrapper *it)
+{
+	assert(it->last != NULL);
+	switch (it->type) {
+	case ITER_EQ:
+		it->base.next_internal = art_iterator_wrapper_next_equal;
+		break;
+	case ITER_REQ:
+		it->base.next_internal = art_iterator_wrapper_prev_equal;
+		break;
+	case ITER_LT:
+	case ITER_LE:
+		it->base.next_internal = art_iterator_wrapper_prev;
+		break;
+	case ITER_GE:
+	case ITER_GT:
+		it->base.next_internal = art_iterator_wrapper_next;
+		break;
+	default:
+		/* The type was checked in create_iterator. */
+		assert(false);
+	}
+	it->base.next = memtx_iterator_next;
+}
+
+static int
+art_iterator_wrapper_start(struct iterator *iterator, struct tuple **ret)
+{
+	*ret = NULL;
+	struct memtx_art_index *index = (struct memtx_art_index *)
+		iterator->index;
+	struct art_iterator_wrapper *it =
+		(struct art_iterator_wrapper *)iterator;
+	iterator->next_internal = exhausted_iterator_next;
+	struct art_tree *tree = &index->tree;
+	struct txn *txn = in_txn();
+	struct space *space = space_by_id(iterator->space_id);
+	assert(space != NULL || iterator->space_id == 0);
+	struct index *idx = iterator->index;
+	struct key_def *cmp_def = idx->def->cmp_def;
+	const char *start_key = it->after != NULL ? it->after : it->key;
+	uint32_t start_part_count = it->after != NULL ?
+				    cmp_def->part_count : it->part_count;
+	enum iterator_type type = it->type;
+	/*
+	 * Since iteration with equality iterators returns first found tuple,
+	 * we need a special flag for EQ and REQ if we want to start iteration
+	 * after specified key. As for range iterators with equality, we can
+	 * simply change them to their equivalents with inequality.
+	 */
+	bool skip_equal_tuple = it->after != NULL;
+	if (skip_equal_tuple && type != ITER_EQ && type != ITER_REQ)
+		type = iterator_type_is_reverse(type) ? ITER_LT : ITER_GT;
+	/*
+	 * The key is full - all parts a present. If key if full, EQ and REQ
+	 * queries can return no more than one tuple.
+	 */
+	bool key_is_full = start_part_count == cmp_def->part_count;
+	assert(it->last == NULL);
+	if (start_key == NULL) {
+		assert(type == ITER_GE || type == ITER_LE);
+		if (iterator_type_is_reverse(type))
+			art_iterator_last(&it->impl, tree->root);
+		else
+			art_iterator_first(&it->impl, tree->root);
+	} else {
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		uint32_t len;
+		const char *key = memtx_art_search_key(index->cmp_def,
+						       start_key,
+						       start_part_count, &len);
+		/*
+		 * A stored key that starts with the search key is considered
+		 * equal to it by the radix tree so partial keys are handled
+		 * by the same lookups. To start after the given position,
+		 * EQ and REQ use the strict lookups.
+		 */
+		switch (type) {
+		case ITER_EQ:
+		case ITER_GE:
+			if (skip_equal_tuple)
+				art_iterator_gt(&it->impl, tree->root,
+						key, len);
+			else
+				art_iterator_ge(&it->impl, tree->root,
+						key, len);
+			break;
+		case ITER_GT:
+			art_iterator_gt(&it->impl, tree->root, key, len);
+			break;
+		case ITER_REQ:
+		case ITER_LE:
+			if (skip_equal_tuple)
+				art_iterator_lt(&it->impl, tree->root,
+						key, len);
+			else
+				art_iterator_le(&it->impl, tree->root,
+						key, len);
+			break;
+		case ITER_LT:
+			art_iterator_lt(&it->impl, tree->root, key, len);
+			break;
+		default:
+			unreachable();
+		}
+		region_truncate(region, region_svp);
+	}
+	art_iterator_set_version(&it->impl, tree);
+	struct tuple *res = (struct tuple *)art_iterator_value(&it->impl);
+	/*
+	 * The gap is tracked by the successor of the found position, which
+	 * is the found tuple for forward iterators and the next one for
+	 * reverse iterators.
+	 */
+	struct tuple *successor = res;
+	if (iterator_type_is_reverse(type)) {
+		struct art_iterator next = it->impl;
+		if (res != NULL)
+			art_iterator_next(&next, tree->root);
+		else
+			art_iterator_first(&next, tree->root);
+		successor = (struct tuple *)art_iterator_value(&next);
+	}
+	/* The flag is set if the found tuple equals to the key. */
+	bool equals = false;
+	if (res != NULL) {
+		equals = it->key == NULL ||
+			 tuple_compare_with_key(res, HINT_NONE, it->key,
+						it->part_count, HINT_NONE,
+						idx->def->key_def) == 0;
+	}
+	/*
+	 * Equality iterators requires exact key match: if the result does not
+	 * equal to the key, iteration ends.
+	 */
+	bool eq_match = equals || (type != ITER_EQ && type != ITER_REQ);
+	if (res != NULL && eq_match) {
+		art_iterator_wrapper_set_last(it, res);
+		art_iterator_wrapper_set_next_method(it);
+		/*
+		 * We need to clarify the result tuple before story garbage
+		 * collection, otherwise it could get cleaned there.
+		 */
+		*ret = memtx_tx_tuple_clarify(txn, space, res, idx, 0);
+	}
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+	if (key_is_full && !eq_match)
+		memtx_tx_track_point(txn, space, idx, it->key);
+	if (!key_is_full ||
+	    ((type == ITER_GE || type == ITER_LE) && !equals) ||
+	    (type == ITER_GT || type == ITER_LT))
+		memtx_tx_track_gap(txn, space, idx, successor, type,
+				   start_key, start_part_count);
+	memtx_tx_story_gc();
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	return res == NULL || !eq_match || *ret != NULL ? 0 :
+	       iterator->next_internal(iterator, ret);
+}
+
+static int
+art_iterator_wrapper_position(struct iterator *iterator, const char **pos,
+			      uint32_t *size)
+{
+	struct art_iterator_wrapper *it =
+		(struct art_iterator_wrapper *)iterator;
+	if (it->last == NULL) {
+		*pos = NULL;
+		*size = 0;
+		return 0;
+	}
+	const char *key = tuple_extract_key(it->last,
+					    iterator->index->def->cmp_def,
+					    MULTIKEY_NONE, size);
+	if (key == NULL)
+		return -1;
+	*pos = key;
+	return 0;
+}
+
+/* }}} */
+
+/* {{{ MemtxArt  **********************************************************/
+
+static void
+memtx_art_index_free(struct memtx_art_index *index)
+{
+	/*
+	 * All tree nodes are freed together with the extents they were
+	 * carved from so there's no need to walk the tree.
+	 */
+	struct memtx_engine *memtx = (struct memtx_engine *)index->base.engine;
+	while (index->extents != NULL) {
+		void *extent = index->extents;
+		index->extents = *(void **)extent;
+		memtx_index_extent_free(memtx, extent);
+		memtx->index_extent_stats.extent_count--;
+	}
+	free(index);
+}
+
+static void
+memtx_art_index_gc_run(struct memtx_gc_task *task, bool *done)
+{
+	/*
+	 * Yield every 1K tuples to keep latency < 0.1 ms.
+	 * Yield more often in debug mode.
+	 */
+#ifdef NDEBUG
+	enum { YIELD_LOOPS = 1000 };
+#else
+	enum { YIELD_LOOPS = 10 };
+#endif
+
+	struct memtx_art_index *index = container_of(task,
+			struct memtx_art_index, gc_task);
+	struct art_tree *tree = &index->tree;
+	struct art_iterator *itr = &index->gc_iterator;
+
+	unsigned int loops = 0;
+	struct tuple *tuple;
+	while ((tuple = (struct tuple *)art_iterator_value(itr)) != NULL) {
+		art_iterator_next(itr, tree->root);
+		tuple_unref(tuple);
+		if (++loops >= YIELD_LOOPS) {
+			*done = false;
+			return;
+		}
+	}
+	*done = true;
+}
+
+static void
+memtx_art_index_gc_free(struct memtx_gc_task *task)
+{
+	struct memtx_art_index *index = container_of(task,
+			struct memtx_art_index, gc_task);
+	memtx_art_index_free(index);
+}
+
+static const struct memtx_gc_task_vtab memtx_art_index_gc_vtab = {
+	.run = memtx_art_index_gc_run,
+	.free = memtx_art_index_gc_free,
+};
+
+static void
+memtx_art_index_destroy(struct index *base)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	if (base->def->iid == 0) {
+		/*
+		 * Primary index. We need to free all tuples stored
+		 * in the index, which may take a while. Schedule a
+		 * background task in order not to block tx thread.
+		 */
+		index->gc_task.vtab = &memtx_art_index_gc_vtab;
+		art_iterator_first(&index->gc_iterator, index->tree.root);
+		memtx_engine_schedule_gc(memtx, &index->gc_task);
+	} else {
+		/*
+		 * Secondary index. Destruction is fast, no need to
+		 * hand over to background fiber.
+		 */
+		memtx_art_index_free(index);
+	}
+}
+
+/**
+ * Select the key definition used for key normalization. The rules are
+ * the same as for the memtx tree index: the extended key definition is
+ * used for non-unique and nullable indexes. Unique but nullable index can
+ * store multiple NULLs so they are told apart by the primary key parts.
+ */
+static struct key_def *
+memtx_art_index_cmp_def(struct index_def *def)
+{
+	return def->opts.is_unique && !def->key_def->is_nullable ?
+	       def->key_def : def->cmp_def;
+}
+
+static void
+memtx_art_index_update_def(struct index *base)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	index->cmp_def = memtx_art_index_cmp_def(base->def);
+}
+
+static bool
+memtx_art_index_depends_on_pk(struct index *base)
+{
+	struct index_def *def = base->def;
+	/* See comment to memtx_art_index_cmp_def(). */
+	return !def->opts.is_unique || def->key_def->is_nullable;
+}
+
+static bool
+memtx_art_index_def_change_requires_rebuild(struct index *index,
+					    const struct index_def *new_def)
+{
+	if (memtx_index_def_change_requires_rebuild(index, new_def))
+		return true;
+	struct index_def *old_def = index->def;
+	/*
+	 * Normalized keys depend on part types and nullability and on
+	 * whether primary key parts are appended, so a change of any of
+	 * them changes the stored keys.
+	 */
+	if (old_def->opts.is_unique != new_def->opts.is_unique)
+		return true;
+	const struct key_def *old_cmp_def = old_def->cmp_def;
+	const struct key_def *new_cmp_def = new_def->cmp_def;
+	if (old_cmp_def->part_count != new_cmp_def->part_count)
+		return true;
+	for (uint32_t i = 0; i < new_cmp_def->part_count; i++) {
+		const struct key_part *old_part = &old_cmp_def->parts[i];
+		const struct key_part *new_part = &new_cmp_def->parts[i];
+		if (old_part->type != new_part->type ||
+		    key_part_is_nullable(old_part) !=
+		    key_part_is_nullable(new_part))
+			return true;
+	}
+	return false;
+}
+
+static ssize_t
+memtx_art_index_size(struct index *base)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct space *space = space_by_id(base->def->space_id);
+	/* Substract invisible count. */
+	return art_size(&index->tree) -
+	       memtx_tx_index_invisible_count(in_txn(), space, base);
+}
+
+static ssize_t
+memtx_art_index_bsize(struct index *base)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	return index->extent_count * MEMTX_EXTENT_SIZE;
+}
+
+static ssize_t
+memtx_art_index_count(struct index *base, enum iterator_type type,
+		      const char *key, uint32_t part_count)
+{
+	if (type == ITER_ALL)
+		return memtx_art_index_size(base); /* optimization */
+	return generic_index_count(base, type, key, part_count);
+}
+
+static int
+memtx_art_index_get_internal(struct index *base, const char *key,
+			     uint32_t part_count, struct tuple **result)
+{
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct txn *txn = in_txn();
+	struct space *space = space_by_id(base->def->space_id);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t len;
+	const char *normalized = memtx_art_search_key(index->cmp_def, key,
+						      part_count, &len);
+	struct tuple *res = (struct tuple *)art_find(index->tree.root,
+						     normalized, len);
+	region_truncate(region, region_svp);
+	if (res == NULL) {
+		*result = NULL;
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		memtx_tx_track_point(txn, space, base, key);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+		return 0;
+	}
+	*result = memtx_tx_tuple_clarify(txn, space, res, base, 0);
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+	memtx_tx_story_gc();
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	return 0;
+}
+
+/**
+ * Revert insertion of a new tuple into the tree: delete the inserted key
+ * or restore the tuple it replaced. Can't fail, because the insertion
+ * made the whole path to the key private to the tree so no node needs
+ * to be copied.
+ */
+static void
+memtx_art_index_undo_insert(struct memtx_art_index *index, const char *key,
+			    uint32_t len, struct tuple *dup_tuple)
+{
+	void *unused;
+	int rc;
+	if (dup_tuple != NULL)
+		rc = art_insert(&index->tree, key, len, dup_tuple, &unused);
+	else
+		rc = art_delete(&index->tree, key, len, &unused);
+	if (rc != 0)
+		panic("failed to rollback change");
+}
+
+static int
+memtx_art_index_replace(struct index *base, struct tuple *old_tuple,
+			struct tuple *new_tuple, enum dup_replace_mode mode,
+			struct tuple **result, struct tuple **successor)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct key_def *key_def = base->def->key_def;
+	RegionGuard region_guard(&fiber()->gc);
+	*successor = NULL;
+	const char *new_key = NULL;
+	uint32_t new_len = 0;
+	if (new_tuple != NULL &&
+	    !tuple_key_is_excluded(new_tuple, key_def, MULTIKEY_NONE)) {
+		new_key = memtx_art_tuple_key(index->cmp_def, new_tuple,
+					      &new_len);
+		if (new_len > memtx_art_key_len_max()) {
+			diag_set(ClientError, ER_KEY_PART_IS_TOO_LONG,
+				 new_len, memtx_art_key_len_max());
+			return -1;
+		}
+		void *dup;
+		/* Try to optimistically replace the new_tuple. */
+		if (art_insert(&index->tree, new_key, new_len,
+			       new_tuple, &dup) != 0) {
+			diag_set(OutOfMemory, new_len,
+				 "memtx_art_index", "replace");
+			return -1;
+		}
+		struct tuple *dup_tuple = (struct tuple *)dup;
+		uint32_t errcode = replace_check_dup(old_tuple, dup_tuple,
+						     mode);
+		if (errcode) {
+			memtx_art_index_undo_insert(index, new_key, new_len,
+						    dup_tuple);
+			struct space *sp = space_cache_find(base->def->space_id);
+			if (sp != NULL) {
+				if (errcode == ER_TUPLE_FOUND) {
+					diag_set(ClientError, errcode,
+						 base->def->name,
+						 space_name(sp),
+						 tuple_str(dup_tuple),
+						 tuple_str(new_tuple));
+				} else {
+					diag_set(ClientError, errcode,
+						 space_name(sp));
+				}
+			}
+			return -1;
+		}
+		if (dup_tuple != NULL) {
+			*result = dup_tuple;
+			return 0;
+		}
+		/* The successor is only needed by the transaction manager. */
+		if (memtx_tx_manager_use_mvcc_engine) {
+			struct art_iterator it;
+			art_iterator_gt(&it, index->tree.root,
+					new_key, new_len);
+			*successor = (struct tuple *)art_iterator_value(&it);
+		}
+	}
+	if (old_tuple != NULL &&
+	    !tuple_key_is_excluded(old_tuple, key_def, MULTIKEY_NONE)) {
+		uint32_t old_len;
+		const char *old_key = memtx_art_tuple_key(index->cmp_def,
+							  old_tuple, &old_len);
+		void *unused;
+		/*
+		 * Deletion may need to copy nodes shared with a read view
+		 * and fail to allocate memory.
+		 */
+		if (art_delete(&index->tree, old_key, old_len,
+			       &unused) != 0) {
+			if (new_key != NULL)
+				memtx_art_index_undo_insert(index, new_key,
+							    new_len, NULL);
+			diag_set(OutOfMemory, old_len,
+				 "memtx_art_index", "replace");
+			return -1;
+		}
+		*result = old_tuple;
+	} else {
+		*result = NULL;
+	}
+	return 0;
+}
+
+static struct iterator *
+memtx_art_index_create_iterator(struct index *base, enum iterator_type type,
+				const char *key, uint32_t part_count,
+				const char *pos)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+
+	assert(part_count == 0 || key != NULL);
+	if (type > ITER_GT) {
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		return NULL;
+	}
+	if (part_count == 0) {
+		/*
+		 * If no key is specified, downgrade equality
+		 * iterators to a full range.
+		 */
+		type = iterator_type_is_reverse(type) ? ITER_LE : ITER_GE;
+		key = NULL;
+	}
+
+	if (type == ITER_ALL)
+		type = ITER_GE;
+
+	ERROR_INJECT(ERRINJ_INDEX_ITERATOR_NEW, {
+		diag_set(ClientError, ER_INJECTION, "iterator fail");
+		return NULL;
+	});
+
+	struct art_iterator_wrapper *it = (struct art_iterator_wrapper *)
+		mempool_alloc(&memtx->art_iterator_pool);
+	if (it == NULL) {
+		diag_set(OutOfMemory, sizeof(struct art_iterator_wrapper),
+			 "memtx_art_index", "iterator");
+		return NULL;
+	}
+	iterator_create(&it->base, base);
+	it->pool = &memtx->art_iterator_pool;
+	it->base.next_internal = art_iterator_wrapper_start;
+	it->base.next = memtx_iterator_next;
+	it->base.free = art_iterator_wrapper_free;
+	it->base.position = art_iterator_wrapper_position;
+	it->type = type;
+	it->key = key;
+	it->part_count = part_count;
+	it->after = pos;
+	it->last = NULL;
+	return (struct iterator *)it;
+}
+
+/** Read view implementation. */
+struct art_read_view {
+	/** Base class. */
+	struct index_read_view base;
+	/** Read view index. Ref counter incremented. */
+	struct memtx_art_index *index;
+	/** Radix tree read view. */
+	struct art_view view;
+	/** Used for clarifying read view tuples. */
+	struct memtx_tx_snapshot_cleaner cleaner;
+};
+
+/**
+ * Read view iterator implementation. A radix tree iterator doesn't fit
+ * in the read view iterator so the position is kept as the normalized
+ * key of the last fetched tuple, which is stored in the read view and
+ * stays valid while the view is open.
+ */
+struct art_read_view_iterator {
+	/** Base class. */
+	struct index_read_view_iterator_base base;
+	/** Normalized key of the last fetched tuple. */
+	const char *last_key;
+	/** Length of the normalized key of the last fetched tuple. */
+	uint32_t last_key_len;
+	/**
+	 * Tuple that was fetched last. Is NULL only if there was no tuple
+	 * fetched. Otherwise, it's not NULL, even if iterator is
+	 * exhausted - pagination relies on it.
+	 */
+	struct tuple *last;
+	/** Set if the iterator is exhausted. */
+	bool is_exhausted;
+};
+
+static_assert(sizeof(struct art_read_view_iterator) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct art_read_view_iterator) must be less than "
+	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+
+static void
+art_read_view_free(struct index_read_view *base)
+{
+	struct art_read_view *rv = (struct art_read_view *)base;
+	art_view_destroy(&rv->view);
+	index_unref(&rv->index->base);
+	memtx_tx_snapshot_cleaner_destroy(&rv->cleaner);
+	TRASH(rv);
+	free(rv);
+}
+
+static int
+art_read_view_get_raw(struct index_read_view *rv,
+		      const char *key, uint32_t part_count,
+		      struct read_view_tuple *result)
+{
+	(void)rv;
+	(void)key;
+	(void)part_count;
+	(void)result;
+	unreachable();
+	return 0;
+}
+
+/** Implementation of next_raw index_read_view_iterator callback. */
+static int
+art_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
+				struct read_view_tuple *result)
+{
+	struct art_read_view_iterator *it =
+		(struct art_read_view_iterator *)iterator;
+	struct art_read_view *rv = (struct art_read_view *)it->base.index;
+
+	while (true) {
+		if (it->is_exhausted) {
+			*result = read_view_tuple_none();
+			return 0;
+		}
+		struct art_iterator impl;
+		if (it->last == NULL)
+			art_iterator_first(&impl, rv->view.root);
+		else
+			art_iterator_gt(&impl, rv->view.root,
+					it->last_key, it->last_key_len);
+		struct tuple *tuple = (struct tuple *)art_iterator_value(&impl);
+		if (tuple == NULL) {
+			it->is_exhausted = true;
+			continue;
+		}
+		it->last = tuple;
+		it->last_key = art_iterator_key(&impl, &it->last_key_len);
+		if (memtx_prepare_read_view_tuple(tuple, &rv->base,
+						  &rv->cleaner, result) != 0)
+			return -1;
+		if (result->data != NULL)
+			return 0;
+	}
+}
+
+/**
+ * Implementation of position index_read_view_iterator callback.
+ */
+static int
+art_read_view_iterator_position(struct index_read_view_iterator *iterator,
+				const char **pos, uint32_t *size)
+{
+	struct art_read_view_iterator *it =
+		(struct art_read_view_iterator *)iterator;
+	if (it->last == NULL) {
+		*pos = NULL;
+		*size = 0;
+		return 0;
+	}
+	const char *key = tuple_extract_key(it->last,
+					    it->base.index->def->cmp_def,
+					    MULTIKEY_NONE, size);
+	if (key == NULL)
+		return -1;
+	*pos = key;
+	return 0;
+}
+
+/** Implementation of create_iterator index_read_view callback. */
+static int
+art_read_view_create_iterator(struct index_read_view *base,
+			      enum iterator_type type,
+			      const char *key, uint32_t part_count,
+			      const char *pos,
+			      struct index_read_view_iterator *iterator)
+{
+	assert(type == ITER_ALL);
+	assert(key == NULL);
+	assert(part_count == 0);
+	assert(pos == NULL);
+	(void)type;
+	(void)key;
+	(void)part_count;
+	(void)pos;
+	struct art_read_view_iterator *it =
+		(struct art_read_view_iterator *)iterator;
+	it->base.index = base;
+	it->base.next_raw = art_read_view_iterator_next_raw;
+	it->base.position = art_read_view_iterator_position;
+	it->last_key = NULL;
+	it->last_key_len = 0;
+	it->last = NULL;
+	it->is_exhausted = false;
+	return 0;
+}
+
+/** Implementation of create_read_view index callback. */
+static struct index_read_view *
+memtx_art_index_create_read_view(struct index *base)
+{
+	static const struct index_read_view_vtab vtab = {
+		.free = art_read_view_free,
+		.get_raw = art_read_view_get_raw,
+		.create_iterator = art_read_view_create_iterator,
+	};
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct art_read_view *rv =
+		(struct art_read_view *)xmalloc(sizeof(*rv));
+	if (index_read_view_create(&rv->base, &vtab, base->def) != 0) {
+		free(rv);
+		return NULL;
+	}
+	struct space *space = space_cache_find(base->def->space_id);
+	memtx_tx_snapshot_cleaner_create(&rv->cleaner, space);
+	rv->index = index;
+	index_ref(base);
+	art_view_create(&rv->view, &index->tree);
+	return (struct index_read_view *)rv;
+}
+
+static const struct index_vtab memtx_art_index_vtab = {
+	/* .destroy = */ memtx_art_index_destroy,
+	/* .commit_create = */ generic_index_commit_create,
+	/* .abort_create = */ generic_index_abort_create,
+	/* .commit_modify = */ generic_index_commit_modify,
+	/* .commit_drop = */ generic_index_commit_drop,
+	/* .update_def = */ memtx_art_index_update_def,
+	/* .depends_on_pk = */ memtx_art_index_depends_on_pk,
+	/* .def_change_requires_rebuild = */
+		memtx_art_index_def_change_requires_rebuild,
+	/* .size = */ memtx_art_index_size,
+	/* .bsize = */ memtx_art_index_bsize,
+	/* .min = */ generic_index_min,
+	/* .max = */ generic_index_max,
+	/* .random = */ generic_index_random,
+	/* .count = */ memtx_art_index_count,
+	/* .get_internal = */ memtx_art_index_get_internal,
+	/* .get = */ memtx_index_get,
+	/* .get_many = */ generic_index_get_many,
+	/* .replace = */ memtx_art_index_replace,
+	/* .create_iterator = */ memtx_art_index_create_iterator,
+	/* .create_read_view = */ memtx_art_index_create_read_view,
+	/* .stat = */ generic_index_stat,
+	/* .compact = */ generic_index_compact,
+	/* .reset_stat = */ generic_index_reset_stat,
+	/* .begin_build = */ generic_index_begin_build,
+	/* .reserve = */ generic_index_reserve,
+	/* .build_next = */ generic_index_build_next,
+	/* .end_build = */ generic_index_end_build,
+};
+
+struct index *
+memtx_art_index_new(struct memtx_engine *memtx, struct index_def *def)
+{
+	assert(key_def_is_normalizable(def->cmp_def));
+	if (!mempool_is_initialized(&memtx->art_iterator_pool)) {
+		mempool_create(&memtx->art_iterator_pool, cord_slab_cache(),
+			       sizeof(struct art_iterator_wrapper));
+	}
+
+	struct memtx_art_index *index =
+		(struct memtx_art_index *)calloc(1, sizeof(*index));
+	if (index == NULL) {
+		diag_set(OutOfMemory, sizeof(*index),
+			 "malloc", "struct memtx_art_index");
+		return NULL;
+	}
+	if (index_create(&index->base, (struct engine *)memtx,
+			 &memtx_art_index_vtab, def) != 0) {
+		free(index);
+		return NULL;
+	}
+	index->cmp_def = memtx_art_index_cmp_def(index->base.def);
+	art_create(&index->tree, memtx_art_alloc, memtx_art_free, index);
+	return &index->base;
+}
@@ -90,11 +90,16 @@ static inline struct tuple *
 memtx_tuple_new_raw_impl(struct tuple_format *format, const char *data,
 			 const char *end, bool validate);
 
+bool
+(*memtx_tuple_is_in_read_view)(struct tuple *tuple);
+
 template <class ALLOC>
 static void
 memtx_alloc_init(void)
 {
 	memtx_tuple_new_raw = memtx_tuple_new_raw_impl<ALLOC>;
+	memtx_tuple_is_in_read_view =
+		MemtxAllocator<ALLOC>::tuple_is_in_read_view;
 }
 
 static int
@@ -204,6 +209,8 @@ memtx_engine_shutdown(struct engine *engine)
 	mempool_destroy(&memtx->iterator_pool);
 	if (mempool_is_initialized(&memtx->rtree_iterator_pool))
 		mempool_destroy(&memtx->rtree_iterator_pool);
+	if (mempool_is_initialized(&memtx->art_iterator_pool))
+		mempool_destroy(&memtx->art_iterator_pool);
 	mempool_destroy(&memtx->index_extent_pool);
 	slab_cache_destroy(&memtx->index_slab_cache);
 	/*
@@ -245,16 +252,44 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				  struct xrow_header *row,
 				  enum snapshot_recovery_state *state);
 
+/**
+ * Recover the data from a snapshot file. If @a is_local is false, the
+ * file was received from a remote peer, so it's never recovered with
+ * force_recovery and a broken file fails recovery instead of crashing
+ * the instance.
+ */
+static int
+memtx_engine_recover_snapshot_from(struct memtx_engine *memtx,
+				   const char *filename,
+				   const struct vclock *vclock, bool is_local);
+
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock)
 {
 	/* Process existing snapshot */
 	say_info("recovery start");
-	int64_t signature = vclock_sum(vclock);
 	const char *filename = xdir_format_filename(&memtx->snap_dir,
-						    signature, NONE);
+						    vclock_sum(vclock), NONE);
+	return memtx_engine_recover_snapshot_from(memtx, filename, vclock,
+						  true);
+}
 
+int
+memtx_engine_recover_snapshot_file(struct memtx_engine *memtx,
+				   const char *filename,
+				   const struct vclock *vclock)
+{
+	return memtx_engine_recover_snapshot_from(memtx, filename, vclock,
+						  false);
+}
+
+static int
+memtx_engine_recover_snapshot_from(struct memtx_engine *memtx,
+				   const char *filename,
+				   const struct vclock *vclock, bool is_local)
+{
+	int64_t signature = vclock_sum(vclock);
 	say_info("recovering from `%s'", filename);
 	struct xlog_cursor cursor;
 	if (xlog_cursor_open(&cursor, filename) < 0)
@@ -268,7 +303,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	while ((rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
 		row.lsn = signature;
 		rc = memtx_engine_recover_snapshot_row(memtx, &row, &state);
-		if (state == DONE_RECOVERING_SYSTEM_SPACES)
+		if (state == DONE_RECOVERING_SYSTEM_SPACES && is_local)
 			force_recovery = memtx->force_recovery;
 		if (rc < 0) {
 			if (!force_recovery)
@@ -293,6 +328,11 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	 * should not be trusted.
 	 */
 	if (!xlog_cursor_is_eof(&cursor)) {
+		if (!is_local) {
+			diag_set(XlogError, "snapshot `%s' has no EOF marker",
+				 cursor.name);
+			return -1;
+		}
 		if (!memtx->force_recovery)
 			panic("snapshot `%s' has no EOF marker", cursor.name);
 		else
@@ -1906,6 +1946,17 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (old_def->opts.inline_key != new_def->opts.inline_key)
+		return true;
+	if (old_def->opts.hash_func != new_def->opts.hash_func)
+		return true;
+	/*
+	 * Inlined keys depend on the comparison key definition, which is
+	 * selected by the index uniqueness, see memtx_tree_index_update_def().
+	 */
+	if (new_def->opts.inline_key &&
+	    old_def->opts.is_unique != new_def->opts.is_unique)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -1937,6 +1988,12 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 			return true;
 		if (old_part->exclude_null != new_part->exclude_null)
 			return true;
+		/* Normalized key encoding depends on the part type. */
+		if (new_def->opts.inline_key &&
+		    (old_part->type != new_part->type ||
+		     key_part_is_nullable(old_part) !=
+		     key_part_is_nullable(new_part)))
+			return true;
 	}
 	assert(old_cmp_def->is_multikey == new_cmp_def->is_multikey);
 	return false;
@@ -1954,6 +2011,23 @@ memtx_prepare_result_tuple(struct tuple **result)
 	return 0;
 }
 
+int
+memtx_prepare_result_tuples(struct tuple **results, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		if (memtx_prepare_result_tuple(&results[i]) != 0) {
+			for (uint32_t j = 0; j < i; j++) {
+				if (results[j] != NULL)
+					tuple_unref(results[j]);
+			}
+			return -1;
+		}
+		if (results[i] != NULL)
+			tuple_ref(results[i]);
+	}
+	return 0;
+}
+
 int
 memtx_prepare_read_view_tuple(struct tuple *tuple,
 			      struct index_read_view *index,
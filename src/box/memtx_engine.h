@@ -103,13 +103,27 @@ enum memtx_reserve_extents_num {
 	RESERVE_EXTENTS_BEFORE_REPLACE = 16
 };
 
+#ifndef MEMTX_TREE_INLINE_KEY_SIZE
+/**
+ * Size of the normalized key prefix stored in memtx tree index
+ * elements if the index has the inline_key option. Normally set
+ * by cmake/SetMemtxTreeInlineKeySize.cmake.
+ */
+#define MEMTX_TREE_INLINE_KEY_SIZE 16
+#endif
+
+static_assert(MEMTX_TREE_INLINE_KEY_SIZE > 0 &&
+	      MEMTX_TREE_INLINE_KEY_SIZE % 8 == 0,
+	      "MEMTX_TREE_INLINE_KEY_SIZE must be a positive multiple of 8");
+
 /**
  * The size of the biggest memtx iterator. Used with
  * mempool_create. This is the size of the block that will be
- * allocated for each iterator (except rtree index iterator that
- * is significantly bigger so has own pool).
+ * allocated for each iterator (except rtree and art index
+ * iterators that are significantly bigger so have own pools).
+ * The biggest one is the tree iterator with an inlined key.
  */
-#define MEMTX_ITERATOR_SIZE (176)
+#define MEMTX_ITERATOR_SIZE (160 + MEMTX_TREE_INLINE_KEY_SIZE)
 
 typedef void
 (*memtx_on_indexes_built_cb)(void);
@@ -166,10 +180,12 @@ struct memtx_engine {
 	size_t max_tuple_size;
 	/** Memory pool for rtree index iterator. */
 	struct mempool rtree_iterator_pool;
+	/** Memory pool for art index iterator. */
+	struct mempool art_iterator_pool;
 	/**
-	 * Memory pool for all index iterators except rtree.
-	 * The latter is significantly larger so it has its
-	 * own memory pool.
+	 * Memory pool for all index iterators except rtree and art.
+	 * The latter are significantly larger so they have their
+	 * own memory pools.
 	 */
 	struct mempool iterator_pool;
 	/**
@@ -239,6 +255,18 @@ int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock);
 
+/**
+ * Recover the data from a snapshot file of the checkpoint made at the
+ * given vclock received from a remote peer on join. Unlike
+ * memtx_engine_recover_snapshot(), the file doesn't need to be in the
+ * snapshot directory or to have the standard name, force_recovery is
+ * ignored, and a file without the EOF marker fails recovery.
+ */
+int
+memtx_engine_recover_snapshot_file(struct memtx_engine *memtx,
+				   const char *filename,
+				   const struct vclock *vclock);
+
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
@@ -264,6 +292,13 @@ extern struct tuple *
 (*memtx_tuple_new_raw)(struct tuple_format *format, const char *data,
 		       const char *end, bool validate);
 
+/**
+ * Check if a memtx tuple may be used by an open read view, in which
+ * case it must not be modified in place.
+ */
+extern bool
+(*memtx_tuple_is_in_read_view)(struct tuple *tuple);
+
 /**
  * Allocate a block of size MEMTX_EXTENT_SIZE for memtx index
  * @ctx must point to memtx engine
@@ -303,6 +338,14 @@ memtx_set_tuple_format_vtab(const char *allocator_name);
 int
 memtx_prepare_result_tuple(struct tuple **result);
 
+/**
+ * Same as memtx_prepare_result_tuple(), but for an array of @a count tuples
+ * looked up by index_vtab::get_many. Found tuples are referenced on success.
+ * On failure nothing is left referenced.
+ */
+int
+memtx_prepare_result_tuples(struct tuple **results, uint32_t count);
+
 /**
  * Prepares a tuple retrieved from a consistent index read view to be returned
  * to the user.
@@ -395,6 +438,15 @@ memtx_engine_recover_snapshot_xc(struct memtx_engine *memtx,
 		diag_raise();
 }
 
+static inline void
+memtx_engine_recover_snapshot_file_xc(struct memtx_engine *memtx,
+				      const char *filename,
+				      const struct vclock *vclock)
+{
+	if (memtx_engine_recover_snapshot_file(memtx, filename, vclock) != 0)
+		diag_raise();
+}
+
 #endif /* defined(__plusplus) */
 
 #endif /* TARANTOOL_BOX_MEMTX_ENGINE_H_INCLUDED */
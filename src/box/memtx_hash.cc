@@ -33,6 +33,7 @@
 #include "fiber.h"
 #include "index.h"
 #include "tuple.h"
+#include "tuple_hash.h"
 #include "txn.h"
 #include "memtx_tx.h"
 #include "memtx_engine.h"
@@ -83,6 +84,36 @@ struct memtx_hash_index {
 	struct light_index_iterator gc_iterator;
 };
 
+/**
+ * Light stores 32-bit hashes in its records, so a 64-bit hash is folded
+ * to make all its bits affect the slot and the stored hash.
+ */
+static inline uint32_t
+memtx_hash_fold(uint64_t h)
+{
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+/** Calculate the hash of a tuple with the index hash function. */
+static inline uint32_t
+memtx_hash_index_tuple_hash(struct index *base, struct tuple *tuple)
+{
+	struct key_def *key_def = base->def->key_def;
+	if (base->def->opts.hash_func == INDEX_HASH_FUNC_XXH3)
+		return memtx_hash_fold(tuple_hash_xxh3(tuple, key_def));
+	return tuple_hash(tuple, key_def);
+}
+
+/** Calculate the hash of a key with the index hash function. */
+static inline uint32_t
+memtx_hash_index_key_hash(struct index *base, const char *key)
+{
+	struct key_def *key_def = base->def->key_def;
+	if (base->def->opts.hash_func == INDEX_HASH_FUNC_XXH3)
+		return memtx_hash_fold(key_hash_xxh3(key, key_def));
+	return key_hash(key, key_def);
+}
+
 /* {{{ MemtxHash Iterators ****************************************/
 
 struct hash_iterator {
@@ -336,7 +367,7 @@ memtx_hash_index_get_internal(struct index *base, const char *key,
 	struct space *space = space_by_id(base->def->space_id);
 	struct txn *txn = in_txn();
 	*result = NULL;
-	uint32_t h = key_hash(key, base->def->key_def);
+	uint32_t h = memtx_hash_index_key_hash(base, key);
 	uint32_t k = light_index_find_key(&index->hash_table, h, key);
 	if (k != light_index_end) {
 		struct tuple *tuple = light_index_get(&index->hash_table, k);
@@ -352,6 +383,57 @@ memtx_hash_index_get_internal(struct index *base, const char *key,
 	return 0;
 }
 
+static int
+memtx_hash_index_get_many(struct index *base, const char **keys,
+			  uint32_t part_count, uint32_t count,
+			  struct tuple **results)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct light_index_core *hash_table = &index->hash_table;
+
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
+	(void) part_count;
+
+	struct space *space = space_by_id(base->def->space_id);
+	struct txn *txn = in_txn();
+	/*
+	 * Lookups are done in batches: first hashes of all keys in a batch
+	 * are calculated and their slots are prefetched, then the slots are
+	 * probed. This way cache misses of different lookups overlap.
+	 */
+	enum { BATCH_SIZE = 16 };
+	uint32_t hashes[BATCH_SIZE];
+	for (uint32_t i = 0; i < count; i += BATCH_SIZE) {
+		uint32_t batch_size = MIN((uint32_t)BATCH_SIZE, count - i);
+		for (uint32_t j = 0; j < batch_size; j++) {
+			hashes[j] = memtx_hash_index_key_hash(base,
+							      keys[i + j]);
+			light_index_prefetch(hash_table, hashes[j]);
+		}
+		for (uint32_t j = 0; j < batch_size; j++) {
+			const char *key = keys[i + j];
+			uint32_t k = light_index_find_key(hash_table,
+							  hashes[j], key);
+			results[i + j] = NULL;
+			if (k != light_index_end) {
+				struct tuple *tuple =
+					light_index_get(hash_table, k);
+				results[i + j] = memtx_tx_tuple_clarify(
+					txn, space, tuple, base, 0);
+			} else {
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+				memtx_tx_track_point(txn, space, base, key);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+			}
+		}
+	}
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+	memtx_tx_story_gc();
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	return memtx_prepare_result_tuples(results, count);
+}
+
 static int
 memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 			 struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -364,7 +446,7 @@ memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 	*successor = NULL;
 
 	if (new_tuple) {
-		uint32_t h = tuple_hash(new_tuple, base->def->key_def);
+		uint32_t h = memtx_hash_index_tuple_hash(base, new_tuple);
 		struct tuple *dup_tuple = NULL;
 		uint32_t pos = light_index_replace(hash_table, h, new_tuple,
 						   &dup_tuple);
@@ -415,7 +497,7 @@ memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 	}
 
 	if (old_tuple) {
-		uint32_t h = tuple_hash(old_tuple, base->def->key_def);
+		uint32_t h = memtx_hash_index_tuple_hash(base, old_tuple);
 		int res = light_index_delete_value(hash_table, h, old_tuple);
 		assert(res == 0); (void) res;
 	}
@@ -463,7 +545,7 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 
 		if (part_count != 0) {
 			light_index_iterator_key(&index->hash_table, &it->iterator,
-					key_hash(key, base->def->key_def), key);
+					memtx_hash_index_key_hash(base, key), key);
 			it->base.next_internal = hash_iterator_gt;
 		} else {
 			light_index_iterator_begin(&index->hash_table, &it->iterator);
@@ -489,7 +571,7 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 	case ITER_EQ:
 		assert(part_count > 0);
 		light_index_iterator_key(&index->hash_table, &it->iterator,
-				key_hash(key, base->def->key_def), key);
+				memtx_hash_index_key_hash(base, key), key);
 		it->base.next_internal = hash_iterator_eq;
 		if (it->iterator.slotpos == light_index_end)
 /********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
@@ -678,6 +760,7 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .count = */ memtx_hash_index_count,
 	/* .get_internal = */ memtx_hash_index_get_internal,
 	/* .get = */ memtx_index_get,
+	/* .get_many = */ memtx_hash_index_get_many,
 	/* .replace = */ memtx_hash_index_replace,
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
 	/* .create_read_view = */ memtx_hash_index_create_read_view,
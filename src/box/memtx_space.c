@@ -38,8 +38,10 @@
 #include "xrow.h"
 #include "memtx_hash.h"
 #include "memtx_tree.h"
+#include "memtx_art.h"
 #include "memtx_rtree.h"
 #include "memtx_bitset.h"
+#include "key_normalize.h"
 #include "memtx_engine.h"
 #include "column_mask.h"
 #include "sequence.h"
@@ -437,6 +439,191 @@ memtx_space_execute_delete(struct space *space, struct txn *txn,
 	return *result == NULL ? -1 : 0;
 }
 
+/**
+ * Undo record of an update applied to a tuple in place, see
+ * memtx_space_update_in_place().
+ */
+struct memtx_update_undo {
+	/** Statement on_rollback trigger restoring the tuple data. */
+	struct trigger on_rollback;
+	/** Space of the updated tuple. */
+	struct space *space;
+	/** Updated tuple. */
+	struct tuple *tuple;
+	/** Size of the tuple data. */
+	uint32_t bsize;
+	/** Tuple data before the update. */
+	char data[0];
+};
+
+/**
+ * Check if a tuple is referenced by anyone but its @a owners (the
+ * space itself and the statement that updated the tuple) and
+ * box_tuple_last (which only guarantees that the tuple is alive).
+ */
+static inline bool
+memtx_tuple_is_shared(struct tuple *tuple, uint8_t owners)
+{
+	uint8_t refs = tuple == box_tuple_last ? owners + 1 : owners;
+	return tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS) ||
+	       tuple->local_refs != refs;
+}
+
+/**
+ * Replace the updated tuple with a new tuple made of the old data in
+ * all indexes of the space. Used to roll back an update applied in
+ * place if the updated tuple was shared while the transaction was in
+ * progress, because a shared tuple must never change.
+ */
+static int
+memtx_update_undo_replace(struct memtx_update_undo *undo)
+{
+	struct space *space = undo->space;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	struct tuple *tuple = space->format->vtab.tuple_new(
+		space->format, undo->data, undo->data + undo->bsize);
+	if (tuple == NULL)
+		return -1;
+	uint32_t index_count = space->index_count;
+	if (memtx_space->replace != memtx_space_replace_all_keys)
+		index_count = 1;
+	for (uint32_t i = 0; i < index_count; i++) {
+		struct tuple *unused;
+		/*
+		 * Keys are the same, so the tuple is replaced in
+		 * the index without allocations.
+		 */
+		if (index_replace(space->index[i], undo->tuple, tuple,
+				  DUP_REPLACE, &unused, &unused) != 0) {
+			diag_log();
+			unreachable();
+			panic("failed to rollback change");
+		}
+	}
+	tuple_ref(tuple);
+	tuple_unref(undo->tuple);
+	return 0;
+}
+
+static int
+memtx_update_undo_f(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct memtx_update_undo *undo = (struct memtx_update_undo *)trigger;
+	/*
+	 * The tuple is referenced by the space and the statement's
+	 * old and new tuples. Anyone else who took a reference to
+	 * the tuple or opened a read view while the transaction was
+	 * in progress (e.g. waited for WAL) must not see it change.
+	 */
+	if (memtx_tuple_is_shared(undo->tuple, 3) ||
+	    memtx_tuple_is_in_read_view(undo->tuple))
+		return memtx_update_undo_replace(undo);
+	memcpy((char *)tuple_data(undo->tuple), undo->data, undo->bsize);
+	return 0;
+}
+
+/**
+ * Check if an update that changes fields from @a column_mask and
+ * produces @a new_size bytes of data may be applied to @a tuple in
+ * place rather than by replacing it with a new tuple in all indexes.
+ *
+ * This is only possible if no key is affected, the data size stays
+ * the same, and nobody can observe the old tuple: it isn't
+ * referenced from Lua, iterators, or other statements, it isn't
+ * visible in a read view, and there are no MVCC stories or triggers
+ * that expect the old and new tuples to be different objects.
+ *
+ * The statement old and new tuples are the same object after the
+ * update, so it's only done in autocommit transactions: otherwise an
+ * on_commit trigger or a statement iterator set later in the same
+ * transaction would see the new data as the old tuple.
+ *
+ * The field map of the tuple is rebuilt with the space format, so
+ * tuples created with an older format (before an alter) are skipped.
+ */
+static bool
+memtx_space_can_update_in_place(struct space *space, struct txn *txn,
+				struct tuple *tuple, uint64_t column_mask,
+				uint32_t new_size)
+{
+	if (memtx_tx_manager_use_mvcc_engine || space->upgrade != NULL ||
+	    space->wal_ext != NULL || !rlist_empty(&space->on_replace) ||
+	    !txn_has_flag(txn, TXN_IS_AUTOCOMMIT) ||
+	    txn_has_flag(txn, TXN_HAS_TRIGGERS))
+		return false;
+	if (tuple_format(tuple) != space->format ||
+	    new_size != tuple_bsize(tuple) ||
+	    memtx_tuple_is_shared(tuple, 1) ||
+	    memtx_tuple_is_in_read_view(tuple))
+		return false;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct key_def *key_def = space->index[i]->def->key_def;
+		if (key_def->for_func_index ||
+		    !key_update_can_be_skipped(key_def->column_mask,
+					       column_mask))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Overwrite the data of @a tuple with @a new_data of the same size.
+ * Returns 1 if the new data doesn't fit the tuple field map so the
+ * tuple must be replaced, 0 on success, -1 on error.
+ *
+ * The tuple is kept in the indexes, so the statement's old and new
+ * tuples are both set to it. The old data is saved in the transaction
+ * region to be restored if the statement is rolled back.
+ */
+static int
+memtx_space_update_in_place(struct space *space, struct txn_stmt *stmt,
+			    struct tuple *tuple, const char *new_data)
+{
+	struct region *region = &fiber()->gc;
+	struct field_map_builder builder;
+	if (tuple_field_map_create(space->format, new_data, true,
+				   &builder) != 0)
+		return -1;
+	uint32_t field_map_size = field_map_build_size(&builder);
+	uint32_t header_size = sizeof(struct tuple);
+	if (tuple_is_compact(tuple))
+		header_size -= TUPLE_COMPACT_SAVINGS;
+	if (field_map_size != tuple_data_offset(tuple) - header_size)
+		return 1;
+	char *field_map = xregion_alloc(region, field_map_size);
+	field_map_build(&builder, field_map);
+	char *data = (char *)tuple_data(tuple);
+	if (memcmp(field_map, data - field_map_size, field_map_size) != 0)
+		return 1;
+
+	uint32_t bsize = tuple_bsize(tuple);
+	size_t size = sizeof(struct memtx_update_undo) + bsize;
+	struct region *txn_region = tx_region_acquire(stmt->txn);
+	struct memtx_update_undo *undo = region_aligned_alloc(
+		txn_region, size, alignof(struct memtx_update_undo));
+	tx_region_release(stmt->txn, TX_ALLOC_SYSTEM);
+	if (undo == NULL) {
+		diag_set(OutOfMemory, size, "region_aligned_alloc",
+			 "struct memtx_update_undo");
+		return -1;
+	}
+	trigger_create(&undo->on_rollback, memtx_update_undo_f, NULL, NULL);
+	undo->space = space;
+	undo->tuple = tuple;
+	undo->bsize = bsize;
+	memcpy(undo->data, data, bsize);
+	txn_stmt_on_rollback(stmt, &undo->on_rollback);
+	memcpy(data, new_data, bsize);
+
+	stmt->engine_savepoint = stmt;
+	stmt->old_tuple = tuple;
+	tuple_ref(stmt->old_tuple);
+	stmt->new_tuple = tuple;
+	tuple_ref(stmt->new_tuple);
+	return 0;
+}
+
 static int
 memtx_space_execute_update(struct space *space, struct txn *txn,
 			   struct request *request, struct tuple **result)
@@ -469,16 +656,32 @@ memtx_space_execute_update(struct space *space, struct txn *txn,
 
 	/* Update the tuple; legacy, request ops are in request->tuple */
 	uint32_t new_size = 0, bsize;
+	uint64_t column_mask = 0;
 	struct tuple_format *format = space->format;
 	const char *old_data = tuple_data_range(decompressed, &bsize);
 	size_t region_svp = region_used(&fiber()->gc);
 	const char *new_data =
 		xrow_update_execute(request->tuple, request->tuple_end,
 				    old_data, old_data + bsize, format,
-				    &new_size, request->index_base, NULL);
+				    &new_size, request->index_base,
+				    &column_mask);
 	if (new_data == NULL)
 		return -1;
 
+	if (decompressed == old_tuple &&
+	    memtx_space_can_update_in_place(space, txn, old_tuple,
+					    column_mask, new_size)) {
+		int rc = memtx_space_update_in_place(space, stmt, old_tuple,
+						     new_data);
+		region_truncate(&fiber()->gc, region_svp);
+		if (rc < 0)
+			return -1;
+		if (rc == 0) {
+			*result = stmt->new_tuple;
+			return 0;
+		}
+	}
+
 	struct tuple *new_tuple =
 		space->format->vtab.tuple_new(format, new_data,
 					      new_data + new_size);
@@ -713,13 +916,20 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 				 space_name(space));
 			return -1;
 		}
-		if (index_def->type != TREE) {
+		if (index_def->type != TREE && index_def->type != ART) {
 			diag_set(ClientError, ER_UNSUPPORTED,
 				 index_type_strs[index_def->type],
 				 "nullable parts");
 			return -1;
 		}
 	}
+	if (index_def->type != HASH &&
+	    index_def->opts.hash_func != INDEX_HASH_FUNC_MURMUR3) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "hash_func is only supported for HASH index");
+		return -1;
+	}
 	switch (index_def->type) {
 	case HASH:
 		if (! index_def->opts.is_unique) {
@@ -742,8 +952,56 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 		}
 		break;
 	case TREE:
-		/* TREE index has no limitations. */
+		/*
+		 * Secondary index keys are extended with primary key
+		 * parts so check the extended key definition.
+		 */
+		if (index_def->opts.inline_key &&
+		    !key_def_is_normalizable(index_def->cmp_def)) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "inline_key is only supported for unsigned, "
+				 "integer, string without collation, varbinary, "
+				 "boolean and uuid parts");
+			return -1;
+		}
 		break;
+	case ART:
+		if (key_def->is_multikey) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "ART index cannot be multikey");
+			return -1;
+		}
+		if (key_def->for_func_index) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "ART index can not use a function");
+			return -1;
+		}
+		/*
+		 * Secondary index keys are extended with primary key
+		 * parts so check the extended key definition.
+		 */
+		for (uint32_t i = 0; i < index_def->cmp_def->part_count; i++) {
+			struct key_part *part = &index_def->cmp_def->parts[i];
+			if (part->coll != NULL) {
+				diag_set(ClientError, ER_MODIFY_INDEX,
+					 index_def->name, space_name(space),
+					 "ART index does not support "
+					 "collations");
+				return -1;
+			}
+		}
+		if (!key_def_is_normalizable(index_def->cmp_def)) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "ART index field type must be unsigned, "
+				 "integer, string, varbinary, boolean or uuid");
+			return -1;
+		}
+		/* no further checks of parts needed */
+		return 0;
 	case RTREE:
 		if (key_def->part_count != 1) {
 			diag_set(ClientError, ER_MODIFY_INDEX,
@@ -874,6 +1132,8 @@ memtx_space_create_index(struct space *space, struct index_def *index_def)
 		return memtx_hash_index_new(memtx, index_def);
 	case TREE:
 		return memtx_tree_index_new(memtx, index_def);
+	case ART:
+		return memtx_art_index_new(memtx, index_def);
 	case RTREE:
 		return memtx_rtree_index_new(memtx, index_def);
 	case BITSET:
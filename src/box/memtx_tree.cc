@@ -43,6 +43,7 @@
 #include "trivia/config.h"
 #include "trivia/util.h"
 #include "tt_sort.h"
+#include "key_normalize.h"
 #include <small/mempool.h>
 
 /**
@@ -55,13 +56,14 @@ struct memtx_tree_key_data_common {
 	uint32_t part_count;
 };
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct memtx_tree_key_data;
 
 template <>
 struct memtx_tree_key_data<false> : memtx_tree_key_data_common {
 	static constexpr hint_t hint = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
+	void set_inline_key(struct key_def *) { assert(false); }
 };
 
 template <>
@@ -69,6 +71,42 @@ struct memtx_tree_key_data<true> : memtx_tree_key_data_common {
 	/** Comparison hint, see tuple_hint(). */
 	hint_t hint;
 	void set_hint(hint_t h) { hint = h; }
+	void set_inline_key(struct key_def *) { assert(false); }
+};
+
+template <>
+struct memtx_tree_key_data<false, true> : memtx_tree_key_data_common {
+	/** Length of the normalized key, see key_normalize(). */
+	uint32_t inline_key_len;
+	/**
+	 * Normalized key allocated on the fiber region or NULL if the key
+	 * can't be normalized, e.g. it contains a double value for an integer
+	 * part. In the latter case, the key is compared with tuples using the
+	 * regular comparator.
+	 */
+	const char *inline_key;
+	static constexpr hint_t hint = HINT_NONE;
+	void set_hint(hint_t) { assert(false); }
+	/**
+	 * Normalize the key. Must be called after the key and part_count
+	 * are set. The caller is responsible for truncating the fiber region.
+	 */
+	void set_inline_key(struct key_def *def)
+	{
+		if (!key_is_normalizable(key, part_count, def)) {
+			inline_key = NULL;
+			inline_key_len = 0;
+			return;
+		}
+		const char *key_end = key;
+		for (uint32_t i = 0; i < part_count; i++)
+			mp_next(&key_end);
+		size_t size = key_normalized_size_max(key_end - key,
+						      part_count);
+		char *buf = (char *)xregion_alloc(&fiber()->gc, size);
+		inline_key = buf;
+		inline_key_len = key_normalize(key, part_count, def, buf) - buf;
+	}
 };
 
 /**
@@ -79,13 +117,14 @@ struct memtx_tree_data_common {
 	struct tuple *tuple;
 };
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct memtx_tree_data;
 
 template <>
 struct memtx_tree_data<false> : memtx_tree_data_common {
 	static constexpr hint_t hint = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
+	void set_inline_key(struct key_def *) { assert(false); }
 };
 
 template <>
@@ -95,6 +134,76 @@ struct memtx_tree_data<true> :  memtx_tree_data<false> {
 	void set_hint(hint_t h) { hint = h; }
 };
 
+template <>
+struct memtx_tree_data<false, true> : memtx_tree_data<false> {
+	/**
+	 * First MEMTX_TREE_INLINE_KEY_SIZE bytes of the normalized tuple key
+	 * padded with zeros, see tuple_normalize_key(). Since normalized keys
+	 * are prefix-free, comparing inlined prefixes with memcmp() orders
+	 * tuples the same way as tuple_compare() unless the prefixes are
+	 * equal, so most comparisons don't need to access tuples at all.
+	 */
+	char inline_key[MEMTX_TREE_INLINE_KEY_SIZE];
+	/** Fill the inlined key prefix. Must be called after tuple is set. */
+	void set_inline_key(struct key_def *def)
+	{
+		RegionGuard region_guard(&fiber()->gc);
+		size_t size = key_normalized_size_max(tuple_bsize(tuple),
+						      def->part_count);
+		char *buf = (char *)xregion_alloc(&fiber()->gc, size);
+		size_t len = tuple_normalize_key(tuple, def, buf) - buf;
+		if (len >= MEMTX_TREE_INLINE_KEY_SIZE) {
+			memcpy(inline_key, buf, MEMTX_TREE_INLINE_KEY_SIZE);
+		} else {
+			memcpy(inline_key, buf, len);
+			memset(inline_key + len, 0,
+			       MEMTX_TREE_INLINE_KEY_SIZE - len);
+		}
+	}
+};
+
+/**
+ * Compare tuples of two BPS tree elements with inlined keys, see
+ * memtx_tree_data<false, true>.
+ */
+static inline int
+memtx_tree_inline_compare(const struct memtx_tree_data<false, true> *a,
+			  const struct memtx_tree_data<false, true> *b,
+			  struct key_def *def)
+{
+	int rc = memcmp(a->inline_key, b->inline_key,
+			MEMTX_TREE_INLINE_KEY_SIZE);
+	if (rc != 0)
+		return rc;
+	return tuple_compare(a->tuple, HINT_NONE, b->tuple, HINT_NONE, def);
+}
+
+/**
+ * Compare the tuple of a BPS tree element with an inlined key with a key,
+ * see memtx_tree_key_data<false, true>.
+ */
+static inline int
+memtx_tree_inline_compare_with_key(
+	const struct memtx_tree_data<false, true> *a,
+	const struct memtx_tree_key_data<false, true> *b,
+	struct key_def *def)
+{
+	if (b->inline_key != NULL) {
+		uint32_t len = MIN(b->inline_key_len,
+				   (uint32_t)MEMTX_TREE_INLINE_KEY_SIZE);
+		int rc = memcmp(a->inline_key, b->inline_key, len);
+		/*
+		 * A normalized partial key is a prefix of normalized keys
+		 * of all tuples that match it so if the whole key fits in
+		 * the inlined prefix, the tuple matches it.
+		 */
+		if (rc != 0 || b->inline_key_len <= MEMTX_TREE_INLINE_KEY_SIZE)
+			return rc;
+	}
+	return tuple_compare_with_key(a->tuple, HINT_NONE, b->key,
+				      b->part_count, HINT_NONE, def);
+}
+
 /**
  * Test whether BPS tree elements are identical i.e. represent
  * the same tuple at the same position in the tree.
@@ -142,6 +251,24 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
 
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+
+#define BPS_TREE_COMPARE(a, b, arg)\
+	memtx_tree_inline_compare(&a, &b, arg)
+#define BPS_TREE_COMPARE_KEY(a, b, arg)\
+	memtx_tree_inline_compare_with_key(&a, b, arg)
+
+#define BPS_TREE_NAMESPACE NS_INLINE_KEY
+#define bps_tree_elem_t struct memtx_tree_data<false, true>
+#define bps_tree_key_t struct memtx_tree_key_data<false, true> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
 #undef BPS_TREE_NAME
 #undef BPS_TREE_BLOCK_SIZE
 #undef BPS_TREE_EXTENT_SIZE
@@ -153,8 +280,9 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 
 using namespace NS_NO_HINT;
 using namespace NS_USE_HINT;
+using namespace NS_INLINE_KEY;
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct memtx_tree_selector;
 
 template <>
@@ -163,10 +291,13 @@ struct memtx_tree_selector<false> : NS_NO_HINT::memtx_tree {};
 template <>
 struct memtx_tree_selector<true> : NS_USE_HINT::memtx_tree {};
 
-template <bool USE_HINT>
-using memtx_tree_t = struct memtx_tree_selector<USE_HINT>;
+template <>
+struct memtx_tree_selector<false, true> : NS_INLINE_KEY::memtx_tree {};
+
+template <bool USE_HINT, bool INLINE_KEY = false>
+using memtx_tree_t = struct memtx_tree_selector<USE_HINT, INLINE_KEY>;
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct memtx_tree_view_selector;
 
 template <>
@@ -175,10 +306,14 @@ struct memtx_tree_view_selector<false> : NS_NO_HINT::memtx_tree_view {};
 template <>
 struct memtx_tree_view_selector<true> : NS_USE_HINT::memtx_tree_view {};
 
-template <bool USE_HINT>
-using memtx_tree_view_t = struct memtx_tree_view_selector<USE_HINT>;
+template <>
+struct memtx_tree_view_selector<false, true> :
+	NS_INLINE_KEY::memtx_tree_view {};
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
+using memtx_tree_view_t = struct memtx_tree_view_selector<USE_HINT, INLINE_KEY>;
+
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct memtx_tree_iterator_selector;
 
 template <>
@@ -191,8 +326,14 @@ struct memtx_tree_iterator_selector<true> {
 	using type = NS_USE_HINT::memtx_tree_iterator;
 };
 
-template <bool USE_HINT>
-using memtx_tree_iterator_t = typename memtx_tree_iterator_selector<USE_HINT>::type;
+template <>
+struct memtx_tree_iterator_selector<false, true> {
+	using type = NS_INLINE_KEY::memtx_tree_iterator;
+};
+
+template <bool USE_HINT, bool INLINE_KEY = false>
+using memtx_tree_iterator_t =
+	typename memtx_tree_iterator_selector<USE_HINT, INLINE_KEY>::type;
 
 static void
 invalidate_tree_iterator(NS_NO_HINT::memtx_tree_iterator *itr)
@@ -206,14 +347,20 @@ invalidate_tree_iterator(NS_USE_HINT::memtx_tree_iterator *itr)
 	*itr = NS_USE_HINT::memtx_tree_invalid_iterator();
 }
 
-template <bool USE_HINT>
+static void
+invalidate_tree_iterator(NS_INLINE_KEY::memtx_tree_iterator *itr)
+{
+	*itr = NS_INLINE_KEY::memtx_tree_invalid_iterator();
+}
+
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct memtx_tree_index {
 	struct index base;
-	memtx_tree_t<USE_HINT> tree;
-	struct memtx_tree_data<USE_HINT> *build_array;
+	memtx_tree_t<USE_HINT, INLINE_KEY> tree;
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *build_array;
 	size_t build_array_size, build_array_alloc_size;
 	struct memtx_gc_task gc_task;
-	memtx_tree_iterator_t<USE_HINT> gc_iterator;
+	memtx_tree_iterator_t<USE_HINT, INLINE_KEY> gc_iterator;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -225,21 +372,26 @@ memtx_tree_cmp_def(TREE *tree)
 	return tree->common.arg;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 memtx_tree_qcompare(const void* a, const void *b, void *c)
 {
-	const struct memtx_tree_data<USE_HINT> *data_a =
-		(struct memtx_tree_data<USE_HINT> *)a;
-	const struct memtx_tree_data<USE_HINT> *data_b =
-		(struct memtx_tree_data<USE_HINT> *)b;
+	const struct memtx_tree_data<USE_HINT, INLINE_KEY> *data_a =
+		(struct memtx_tree_data<USE_HINT, INLINE_KEY> *)a;
+	const struct memtx_tree_data<USE_HINT, INLINE_KEY> *data_b =
+		(struct memtx_tree_data<USE_HINT, INLINE_KEY> *)b;
 	struct key_def *key_def = (struct key_def *)c;
+	if (INLINE_KEY) {
+		return memtx_tree_inline_compare(
+			(const struct memtx_tree_data<false, true> *)a,
+			(const struct memtx_tree_data<false, true> *)b, key_def);
+	}
 	return tuple_compare(data_a->tuple, data_a->hint, data_b->tuple,
 			     data_b->hint, key_def);
 }
 
 /* {{{ MemtxTree Iterators ****************************************/
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct tree_iterator {
 	struct iterator base;
 
@@ -263,17 +415,17 @@ struct tree_iterator {
 	 * One need not care about the iterator's position: it will
 	 * automatically get adjusted on iterator->next call.
 	 */
-	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+	memtx_tree_iterator_t<USE_HINT, INLINE_KEY> tree_iterator;
 	enum iterator_type type;
-	struct memtx_tree_key_data<USE_HINT> after_data;
-	struct memtx_tree_key_data<USE_HINT> key_data;
+	struct memtx_tree_key_data<USE_HINT, INLINE_KEY> after_data;
+	struct memtx_tree_key_data<USE_HINT, INLINE_KEY> key_data;
 	/**
 	 * Data that was fetched last, needed to make iterators stable.
 	 * Contains NULL as pointer to tuple only if there was no data fetched.
 	 * Otherwise, tuple pointer is not NULL, even if iterator is
 	 * exhausted - pagination relies on it.
 	 */
-	struct memtx_tree_data<USE_HINT> last;
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> last;
 	/**
 	 * For functional indexes only: reference to the functional index key
 	 * at the last iterator position.
@@ -293,11 +445,14 @@ static_assert(sizeof(struct tree_iterator<false>) <= MEMTX_ITERATOR_SIZE,
 static_assert(sizeof(struct tree_iterator<true>) <= MEMTX_ITERATOR_SIZE,
 	      "sizeof(struct tree_iterator<true>) must be less than or equal "
 	      "to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<false, true>) <= MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<false, true>) must be less than or "
+	      "equal to MEMTX_ITERATOR_SIZE");
 
 /** Set last fetched tuple. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static inline void
-tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT> *it,
+tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT, INLINE_KEY> *it,
 			     struct tuple *tuple)
 {
 	assert(tuple != NULL);
@@ -308,9 +463,10 @@ tree_iterator_set_last_tuple(struct tree_iterator<USE_HINT> *it,
 }
 
 /** Set hint of last fetched tuple. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static inline void
-tree_iterator_set_last_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
+tree_iterator_set_last_hint(struct tree_iterator<USE_HINT, INLINE_KEY> *it,
+			    hint_t hint)
 {
 	if (!USE_HINT)
 		return;
@@ -330,33 +486,37 @@ tree_iterator_set_last_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
  * Prerequisites: last is not NULL and last->tuple is not NULL.
  * Use set_last_tuple and set_last_hint manually to free occupied resources.
  */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static inline void
-tree_iterator_set_last(struct tree_iterator<USE_HINT> *it,
-		       struct memtx_tree_data<USE_HINT> *last)
+tree_iterator_set_last(struct tree_iterator<USE_HINT, INLINE_KEY> *it,
+		       struct memtx_tree_data<USE_HINT, INLINE_KEY> *last)
 {
 	assert(last != NULL && last->tuple != NULL);
 	tree_iterator_set_last_tuple(it, last->tuple);
 	tree_iterator_set_last_hint(it, last->hint);
+	/* The inlined key is needed to reposition the iterator. */
+	if (INLINE_KEY)
+		it->last = *last;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 tree_iterator_free(struct iterator *iterator);
 
-template <bool USE_HINT>
-static inline struct tree_iterator<USE_HINT> *
+template <bool USE_HINT, bool INLINE_KEY>
+static inline struct tree_iterator<USE_HINT, INLINE_KEY> *
 get_tree_iterator(struct iterator *it)
 {
-	assert(it->free == &tree_iterator_free<USE_HINT>);
-	return (struct tree_iterator<USE_HINT> *) it;
+	assert(it->free == &tree_iterator_free<USE_HINT, INLINE_KEY>);
+	return (struct tree_iterator<USE_HINT, INLINE_KEY> *) it;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 tree_iterator_free(struct iterator *iterator)
 {
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct tree_iterator<USE_HINT, INLINE_KEY> *it =
+		get_tree_iterator<USE_HINT, INLINE_KEY>(iterator);
 	if (it->last.tuple != NULL)
 		tuple_unref(it->last.tuple);
 	if (it->last_func_key != NULL)
@@ -368,17 +528,18 @@ tree_iterator_free(struct iterator *iterator)
  * If the iterator's underlying tuple does not match its last tuple, it needs
  * to be repositioned.
  */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
-tree_iterator_prev_reposition(struct tree_iterator<USE_HINT> *iterator,
-			      struct memtx_tree_index<USE_HINT> *index)
+tree_iterator_prev_reposition(
+	struct tree_iterator<USE_HINT, INLINE_KEY> *iterator,
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index)
 {
 	bool exact = false;
 	iterator->tree_iterator =
 		memtx_tree_lower_bound_elem(&index->tree, iterator->last,
 					    &exact);
 	if (exact) {
-		struct memtx_tree_data<USE_HINT> *successor =
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> *successor =
 		memtx_tree_iterator_get_elem(&index->tree,
 					     &iterator->tree_iterator);
 		tree_iterator_set_last(iterator, successor);
@@ -391,15 +552,17 @@ tree_iterator_prev_reposition(struct tree_iterator<USE_HINT> *iterator,
 	assert(exact || in_txn() == NULL || !memtx_tx_manager_use_mvcc_engine);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, INLINE_KEY> *it =
+		get_tree_iterator<USE_HINT, INLINE_KEY>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last)) {
 		it->tree_iterator = memtx_tree_upper_bound_elem(&index->tree,
@@ -407,7 +570,7 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	} else {
 		memtx_tree_iterator_next(&index->tree, &it->tree_iterator);
 	}
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	*ret = res != NULL ? res->tuple : NULL;
 	struct index *idx = iterator->index;
@@ -415,7 +578,7 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	if (*ret == NULL) {
 		iterator->next_internal = exhausted_iterator_next;
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, INLINE_KEY>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -434,22 +597,24 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, INLINE_KEY> *it =
+		get_tree_iterator<USE_HINT, INLINE_KEY>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last))
 		tree_iterator_prev_reposition(it, index);
 	memtx_tree_iterator_prev(&index->tree, &it->tree_iterator);
 	struct tuple *successor = it->last.tuple;
 	tuple_ref(successor);
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	*ret = res != NULL ? res->tuple : NULL;
 	struct index *idx = iterator->index;
@@ -457,7 +622,7 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	if (*ret == NULL) {
 		iterator->next_internal = exhausted_iterator_next;
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, INLINE_KEY>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -480,15 +645,17 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, INLINE_KEY> *it =
+		get_tree_iterator<USE_HINT, INLINE_KEY>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last)) {
 		it->tree_iterator = memtx_tree_upper_bound_elem(&index->tree,
@@ -496,7 +663,7 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 	} else {
 		memtx_tree_iterator_next(&index->tree, &it->tree_iterator);
 	}
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	struct index *idx = iterator->index;
 	struct space *space = space_by_id(iterator->space_id);
@@ -520,7 +687,7 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 				   it->key_data.key, it->key_data.part_count);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, INLINE_KEY>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -539,22 +706,24 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, INLINE_KEY> *it =
+		get_tree_iterator<USE_HINT, INLINE_KEY>(iterator);
 	assert(it->last.tuple != NULL);
-	struct memtx_tree_data<USE_HINT> *check =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *check =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	if (check == NULL || !memtx_tree_data_is_equal(check, &it->last))
 		tree_iterator_prev_reposition(it, index);
 	memtx_tree_iterator_prev(&index->tree, &it->tree_iterator);
 	struct tuple *successor = it->last.tuple;
 	tuple_ref(successor);
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
 	struct index *idx = iterator->index;
 	struct space *space = space_by_id(iterator->space_id);
@@ -577,7 +746,7 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 				   it->key_data.key, it->key_data.part_count);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	} else {
-		tree_iterator_set_last<USE_HINT>(it, res);
+		tree_iterator_set_last<USE_HINT, INLINE_KEY>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = iterator->index->def->key_def->is_multikey;
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -601,12 +770,12 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 }
 
 #define WRAP_ITERATOR_METHOD(name)						\
-template <bool USE_HINT>							\
+template <bool USE_HINT, bool INLINE_KEY>					\
 static int									\
 name(struct iterator *iterator, struct tuple **ret)				\
 {										\
 	do {									\
-		int rc = name##_base<USE_HINT>(iterator, ret);			\
+		int rc = name##_base<USE_HINT, INLINE_KEY>(iterator, ret);			\
 		if (rc != 0 ||							\
 		    iterator->next_internal == exhausted_iterator_next)		\
 			return rc;						\
@@ -622,25 +791,29 @@ WRAP_ITERATOR_METHOD(tree_iterator_prev_equal);
 
 #undef WRAP_ITERATOR_METHOD
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
-tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
+tree_iterator_set_next_method(struct tree_iterator<USE_HINT, INLINE_KEY> *it)
 {
 	assert(it->last.tuple != NULL);
 	switch (it->type) {
 	case ITER_EQ:
-		it->base.next_internal = tree_iterator_next_equal<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_next_equal<USE_HINT, INLINE_KEY>;
 		break;
 	case ITER_REQ:
-		it->base.next_internal = tree_iterator_prev_equal<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_prev_equal<USE_HINT, INLINE_KEY>;
 		break;
 	case ITER_LT:
 	case ITER_LE:
-		it->base.next_internal = tree_iterator_prev<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_prev<USE_HINT, INLINE_KEY>;
 		break;
 	case ITER_GE:
 	case ITER_GT:
-		it->base.next_internal = tree_iterator_next<USE_HINT>;
+		it->base.next_internal =
+			tree_iterator_next<USE_HINT, INLINE_KEY>;
 		break;
 	default:
 		/* The type was checked in initIterator */
@@ -649,22 +822,24 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 	it->base.next = memtx_iterator_next;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 {
 	*ret = NULL;
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)iterator->index;
-	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)
+		iterator->index;
+	struct tree_iterator<USE_HINT, INLINE_KEY> *it =
+		get_tree_iterator<USE_HINT, INLINE_KEY>(iterator);
 	iterator->next_internal = exhausted_iterator_next;
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
+	memtx_tree_t<USE_HINT, INLINE_KEY> *tree = &index->tree;
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(iterator->space_id);
 	assert(space != NULL || iterator->space_id == 0);
 	struct index *idx = iterator->index;
 	struct key_def *cmp_def = index->base.def->cmp_def;
-	struct memtx_tree_key_data<USE_HINT> start_data =
+	struct memtx_tree_key_data<USE_HINT, INLINE_KEY> start_data =
 		it->after_data.key != NULL ? it->after_data : it->key_data;
 	enum iterator_type type = it->type;
 	/*
@@ -703,6 +878,9 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 		 * efficiently equals to the empty key. */
 		equals = memtx_tree_size(tree) != 0;
 	} else {
+		RegionGuard region_guard(&fiber()->gc);
+		if (INLINE_KEY)
+			start_data.set_inline_key(memtx_tree_cmp_def(tree));
 		/*
 		 * We use lower_bound on equality iterators instead of LE
 		 * because if iterator is reversed, we will take a step back.
@@ -735,7 +913,7 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 	 * `it->tree_iterator` could potentially be positioned on successor of
 	 * key: we need to track gap based on it.
 	 */
-	struct memtx_tree_data<USE_HINT> *res =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 		memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
 	struct tuple *successor = res == NULL ? NULL : res->tuple;
 	if (iterator_type_is_reverse(type)) {
@@ -798,16 +976,16 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 
 /* {{{ MemtxTree  **********************************************************/
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
-memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
+memtx_tree_index_free(struct memtx_tree_index<USE_HINT, INLINE_KEY> *index)
 {
 	memtx_tree_destroy(&index->tree);
 	free(index->build_array);
 	free(index);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 {
@@ -821,14 +999,14 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	enum { YIELD_LOOPS = 10 };
 #endif
 
-	struct memtx_tree_index<USE_HINT> *index = container_of(task,
-			struct memtx_tree_index<USE_HINT>, gc_task);
-	memtx_tree_t<USE_HINT> *tree = &index->tree;
-	memtx_tree_iterator_t<USE_HINT> *itr = &index->gc_iterator;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index = container_of(
+		task, struct memtx_tree_index<USE_HINT, INLINE_KEY>, gc_task);
+	memtx_tree_t<USE_HINT, INLINE_KEY> *tree = &index->tree;
+	memtx_tree_iterator_t<USE_HINT, INLINE_KEY> *itr = &index->gc_iterator;
 
 	unsigned int loops = 0;
 	while (!memtx_tree_iterator_is_invalid(itr)) {
-		struct memtx_tree_data<USE_HINT> *res =
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 			memtx_tree_iterator_get_elem(tree, itr);
 		memtx_tree_iterator_next(tree, itr);
 		tuple_unref(res->tuple);
@@ -840,32 +1018,32 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	*done = true;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 memtx_tree_index_gc_free(struct memtx_gc_task *task)
 {
-	struct memtx_tree_index<USE_HINT> *index = container_of(task,
-			struct memtx_tree_index<USE_HINT>, gc_task);
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index = container_of(
+		task, struct memtx_tree_index<USE_HINT, INLINE_KEY>, gc_task);
 	memtx_tree_index_free(index);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static struct memtx_gc_task_vtab * get_memtx_tree_index_gc_vtab()
 {
 	static memtx_gc_task_vtab tab =
 	{
-		.run = memtx_tree_index_gc_run<USE_HINT>,
-		.free = memtx_tree_index_gc_free<USE_HINT>,
+		.run = memtx_tree_index_gc_run<USE_HINT, INLINE_KEY>,
+		.free = memtx_tree_index_gc_free<USE_HINT, INLINE_KEY>,
 	};
 	return &tab;
 };
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 memtx_tree_index_destroy(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	if (base->def->iid == 0) {
 		/*
@@ -873,7 +1051,8 @@ memtx_tree_index_destroy(struct index *base)
 		 * in the index, which may take a while. Schedule a
 		 * background task in order not to block tx thread.
 		 */
-		index->gc_task.vtab = get_memtx_tree_index_gc_vtab<USE_HINT>();
+		index->gc_task.vtab =
+			get_memtx_tree_index_gc_vtab<USE_HINT, INLINE_KEY>();
 		index->gc_iterator = memtx_tree_first(&index->tree);
 		memtx_engine_schedule_gc(memtx, &index->gc_task);
 	} else {
@@ -885,12 +1064,12 @@ memtx_tree_index_destroy(struct index *base)
 	}
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 memtx_tree_index_update_def(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct index_def *def = base->def;
 	/*
 	 * We use extended key def for non-unique and nullable
@@ -911,44 +1090,44 @@ memtx_tree_index_depends_on_pk(struct index *base)
 	return !def->opts.is_unique || def->key_def->is_nullable;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static ssize_t
 memtx_tree_index_size(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct space *space = space_by_id(base->def->space_id);
 	/* Substract invisible count. */
 	return memtx_tree_size(&index->tree) -
 	       memtx_tx_index_invisible_count(in_txn(), space, base);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static ssize_t
 memtx_tree_index_bsize(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	return memtx_tree_mem_used(&index->tree);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(base->def->space_id);
 	bool is_multikey = base->def->key_def->is_multikey;
-	if (memtx_tree_index_size<USE_HINT>(base) == 0) {
+	if (memtx_tree_index_size<USE_HINT, INLINE_KEY>(base) == 0) {
 		*result = NULL;
 		memtx_tx_track_gap(txn, space, base, NULL, ITER_GE, NULL, 0);
 		return 0;
 	}
 
 	do {
-		struct memtx_tree_data<USE_HINT> *res =
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 			memtx_tree_random(&index->tree, rnd++);
 		assert(res != NULL);
 		uint32_t mk_index = is_multikey ? (uint32_t)res->hint : 0;
@@ -961,35 +1140,41 @@ memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 	return memtx_prepare_result_tuple(result);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static ssize_t
 memtx_tree_index_count(struct index *base, enum iterator_type type,
 		       const char *key, uint32_t part_count)
 {
 	if (type == ITER_ALL)
-		return memtx_tree_index_size<USE_HINT>(base); /* optimization */
+		/* optimization */
+		return memtx_tree_index_size<USE_HINT, INLINE_KEY>(base);
 	return generic_index_count(base, type, key, part_count);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 memtx_tree_index_get_internal(struct index *base, const char *key,
 			      uint32_t part_count, struct tuple **result)
 {
 	assert(base->def->opts.is_unique &&
 	       part_count == base->def->key_def->part_count);
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct txn *txn = in_txn();
 	struct space *space = space_by_id(base->def->space_id);
-	struct memtx_tree_key_data<USE_HINT> key_data;
+	struct memtx_tree_key_data<USE_HINT, INLINE_KEY> key_data;
 	key_data.key = key;
 	key_data.part_count = part_count;
 	if (USE_HINT)
 		key_data.set_hint(key_hint(key, part_count, cmp_def));
-	struct memtx_tree_data<USE_HINT> *res =
-		memtx_tree_find(&index->tree, &key_data);
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *res;
+	{
+		RegionGuard region_guard(&fiber()->gc);
+		if (INLINE_KEY)
+			key_data.set_inline_key(cmp_def);
+		res = memtx_tree_find(&index->tree, &key_data);
+	}
 	if (res == NULL) {
 		*result = NULL;
 		assert(part_count == cmp_def->unique_part_count);
@@ -1008,12 +1193,66 @@ memtx_tree_index_get_internal(struct index *base, const char *key,
 	return 0;
 }
 
+template <bool USE_HINT, bool INLINE_KEY>
+static int
+memtx_tree_index_get_many(struct index *base, const char **keys,
+			  uint32_t part_count, uint32_t count,
+			  struct tuple **results)
+{
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	struct txn *txn = in_txn();
+	struct space *space = space_by_id(base->def->space_id);
+	bool is_multikey = base->def->key_def->is_multikey;
+	struct region *region = &fiber()->gc;
+	RegionGuard region_guard(region);
+	auto *key_data = xregion_alloc_array(
+		region, struct memtx_tree_key_data<USE_HINT, INLINE_KEY>,
+		count);
+	auto **key_ptrs = xregion_alloc_array(
+		region, struct memtx_tree_key_data<USE_HINT, INLINE_KEY> *,
+		count);
+	auto **res = xregion_alloc_array(
+		region, struct memtx_tree_data<USE_HINT, INLINE_KEY> *, count);
+	for (uint32_t i = 0; i < count; i++) {
+		key_data[i].key = keys[i];
+		key_data[i].part_count = part_count;
+		if (USE_HINT)
+			key_data[i].set_hint(key_hint(keys[i], part_count,
+						      cmp_def));
+		if (INLINE_KEY)
+			key_data[i].set_inline_key(cmp_def);
+		key_ptrs[i] = &key_data[i];
+	}
+	memtx_tree_find_many(&index->tree, key_ptrs, count, res);
+	for (uint32_t i = 0; i < count; i++) {
+		if (res[i] == NULL) {
+			results[i] = NULL;
+			assert(part_count == cmp_def->unique_part_count);
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+			memtx_tx_track_point(txn, space, base, keys[i]);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+			continue;
+		}
+		uint32_t mk_index = is_multikey ? (uint32_t)res[i]->hint : 0;
+		results[i] = memtx_tx_tuple_clarify(txn, space, res[i]->tuple,
+						    base, mk_index);
+	}
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+	memtx_tx_story_gc();
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	return memtx_prepare_result_tuples(results, count);
+}
+
 /**
  * Implementation of iterator position for general and multikey indexes.
  */
-template <bool USE_HINT, bool IS_MULTIKEY>
+template <bool USE_HINT, bool INLINE_KEY, bool IS_MULTIKEY>
 static inline int
-tree_iterator_position_impl(struct memtx_tree_data<USE_HINT> *last,
+tree_iterator_position_impl(struct memtx_tree_data<USE_HINT, INLINE_KEY> *last,
 			    struct index_def *def,
 			    const char **pos, uint32_t *size)
 {
@@ -1038,17 +1277,17 @@ tree_iterator_position_impl(struct memtx_tree_data<USE_HINT> *last,
 /**
  * Implementation of iterator position for general and multikey indexes.
  */
-template <bool USE_HINT, bool IS_MULTIKEY>
+template <bool USE_HINT, bool INLINE_KEY, bool IS_MULTIKEY>
 static int
 tree_iterator_position(struct iterator *it, const char **pos, uint32_t *size)
 {
 	static_assert(!IS_MULTIKEY || USE_HINT,
 		      "Multikey index actually uses hint.");
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)it->index;
-	struct tree_iterator<USE_HINT> *tree_it =
-		get_tree_iterator<USE_HINT>(it);
-	return tree_iterator_position_impl<USE_HINT, IS_MULTIKEY>(
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)it->index;
+	struct tree_iterator<USE_HINT, INLINE_KEY> *tree_it =
+		get_tree_iterator<USE_HINT, INLINE_KEY>(it);
+	return tree_iterator_position_impl<USE_HINT, INLINE_KEY, IS_MULTIKEY>(
 		&tree_it->last, index->base.def, pos, size);
 }
 
@@ -1104,28 +1343,31 @@ static int
 tree_iterator_position_func(struct iterator *it, const char **pos,
 			    uint32_t *size)
 {
-	struct tree_iterator<true> *tree_it = get_tree_iterator<true>(it);
+	struct tree_iterator<true> *tree_it =
+		get_tree_iterator<true, false>(it);
 	return tree_iterator_position_func_impl(&tree_it->last, it->index->def,
 						pos, size);
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 			 struct tuple *new_tuple, enum dup_replace_mode mode,
 			 struct tuple **result, struct tuple **successor)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct key_def *key_def = base->def->key_def;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	if (new_tuple != NULL &&
 	    !tuple_key_is_excluded(new_tuple, key_def, MULTIKEY_NONE)) {
-		struct memtx_tree_data<USE_HINT> new_data;
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> new_data;
 		new_data.tuple = new_tuple;
 		if (USE_HINT)
 			new_data.set_hint(tuple_hint(new_tuple, cmp_def));
-		struct memtx_tree_data<USE_HINT> dup_data, suc_data;
+		if (INLINE_KEY)
+			new_data.set_inline_key(cmp_def);
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> dup_data, suc_data;
 		dup_data.tuple = suc_data.tuple = NULL;
 
 		/* Try to optimistically replace the new_tuple. */
@@ -1166,10 +1408,12 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 	}
 	if (old_tuple != NULL &&
 	    !tuple_key_is_excluded(old_tuple, key_def, MULTIKEY_NONE)) {
-		struct memtx_tree_data<USE_HINT> old_data;
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> old_data;
 		old_data.tuple = old_tuple;
 		if (USE_HINT)
 			old_data.set_hint(tuple_hint(old_tuple, cmp_def));
+		if (INLINE_KEY)
+			old_data.set_inline_key(cmp_def);
 		memtx_tree_delete(&index->tree, old_data);
 		*result = old_tuple;
 	} else {
@@ -1578,14 +1822,14 @@ end:
 	return rc;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static struct iterator *
 memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 				 const char *key, uint32_t part_count,
 				 const char *pos)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 
@@ -1612,26 +1856,29 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 		return NULL;
 	});
 
-	struct tree_iterator<USE_HINT> *it = (struct tree_iterator<USE_HINT> *)
+	struct tree_iterator<USE_HINT, INLINE_KEY> *it =
+		(struct tree_iterator<USE_HINT, INLINE_KEY> *)
 		mempool_alloc(&memtx->iterator_pool);
 	if (it == NULL) {
-		diag_set(OutOfMemory, sizeof(struct tree_iterator<USE_HINT>),
+		diag_set(OutOfMemory,
+			 sizeof(struct tree_iterator<USE_HINT, INLINE_KEY>),
 			 "memtx_tree_index", "iterator");
 		return NULL;
 	}
 	iterator_create(&it->base, base);
 	it->pool = &memtx->iterator_pool;
-	it->base.next_internal = tree_iterator_start<USE_HINT>;
+	it->base.next_internal = tree_iterator_start<USE_HINT, INLINE_KEY>;
 	it->base.next = memtx_iterator_next;
-	it->base.free = tree_iterator_free<USE_HINT>;
+	it->base.free = tree_iterator_free<USE_HINT, INLINE_KEY>;
 	if (base->def->key_def->for_func_index) {
 		assert(USE_HINT);
 		it->base.position = tree_iterator_position_func;
 	} else if (base->def->key_def->is_multikey) {
 		assert(USE_HINT);
-		it->base.position = tree_iterator_position<true, true>;
+		it->base.position = tree_iterator_position<true, false, true>;
 	} else {
-		it->base.position = tree_iterator_position<USE_HINT, false>;
+		it->base.position =
+			tree_iterator_position<USE_HINT, INLINE_KEY, false>;
 	}
 	it->type = type;
 	it->key_data.key = key;
@@ -1655,26 +1902,26 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	return (struct iterator *)it;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 memtx_tree_index_begin_build(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	assert(memtx_tree_size(&index->tree) == 0);
 	(void)index;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	if (size_hint < index->build_array_alloc_size)
 		return 0;
-	struct memtx_tree_data<USE_HINT> *tmp =
-		(struct memtx_tree_data<USE_HINT> *)
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *tmp =
+		(struct memtx_tree_data<USE_HINT, INLINE_KEY> *)
 			realloc(index->build_array, size_hint * sizeof(*tmp));
 	if (tmp == NULL) {
 		diag_set(OutOfMemory, size_hint * sizeof(*tmp),
@@ -1686,15 +1933,17 @@ memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 /** Initialize the next element of the index build_array. */
 static int
-memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
-				    struct tuple *tuple, hint_t hint)
+memtx_tree_index_build_array_append(
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index,
+	struct tuple *tuple, hint_t hint)
 {
 	if (index->build_array == NULL) {
 		index->build_array =
-			(struct memtx_tree_data<USE_HINT> *)malloc(MEMTX_EXTENT_SIZE);
+			(struct memtx_tree_data<USE_HINT, INLINE_KEY> *)
+			malloc(MEMTX_EXTENT_SIZE);
 		if (index->build_array == NULL) {
 			diag_set(OutOfMemory, MEMTX_EXTENT_SIZE,
 				 "memtx_tree_index", "build_next");
@@ -1707,8 +1956,9 @@ memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
 	if (index->build_array_size == index->build_array_alloc_size) {
 		index->build_array_alloc_size = index->build_array_alloc_size +
 				DIV_ROUND_UP(index->build_array_alloc_size, 2);
-		struct memtx_tree_data<USE_HINT> *tmp =
-			(struct memtx_tree_data<USE_HINT> *)realloc(index->build_array,
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> *tmp =
+			(struct memtx_tree_data<USE_HINT, INLINE_KEY> *)
+			realloc(index->build_array,
 				index->build_array_alloc_size * sizeof(*tmp));
 		if (tmp == NULL) {
 			diag_set(OutOfMemory, index->build_array_alloc_size *
@@ -1717,22 +1967,24 @@ memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
 		}
 		index->build_array = tmp;
 	}
-	struct memtx_tree_data<USE_HINT> *elem =
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *elem =
 		&index->build_array[index->build_array_size++];
 	elem->tuple = tuple;
 	if (USE_HINT)
 		elem->set_hint(hint);
+	if (INLINE_KEY)
+		elem->set_inline_key(memtx_tree_cmp_def(&index->tree));
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 {
 	if (tuple_key_is_excluded(tuple, base->def->key_def, MULTIKEY_NONE))
 		return 0;
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	return memtx_tree_index_build_array_append(index, tuple,
 						   tuple_hint(tuple, cmp_def));
@@ -1797,10 +2049,10 @@ error:
  * of equal tuples (in terms of index's cmp_def and have same
  * tuple pointer). The build_array is expected to be sorted.
  */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 memtx_tree_index_build_array_deduplicate(
-	struct memtx_tree_index<USE_HINT> *index)
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index)
 {
 	if (index->build_array_size == 0)
 		return;
@@ -1833,16 +2085,17 @@ memtx_tree_index_build_array_deduplicate(
 	index->build_array_size = w_idx + 1;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 memtx_tree_index_end_build(struct index *base)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	tt_sort(index->build_array, index->build_array_size,
-		sizeof(index->build_array[0]), memtx_tree_qcompare<USE_HINT>,
+		sizeof(index->build_array[0]),
+		memtx_tree_qcompare<USE_HINT, INLINE_KEY>,
 		cmp_def, memtx->sort_threads);
 	if (cmp_def->is_multikey || cmp_def->for_func_index) {
 		/*
@@ -1852,7 +2105,8 @@ memtx_tree_index_end_build(struct index *base)
 		 * the following memtx_tree_build assumes that
 		 * all keys are unique.
 		 */
-		memtx_tree_index_build_array_deduplicate<USE_HINT>(index);
+		memtx_tree_index_build_array_deduplicate<USE_HINT,
+							 INLINE_KEY>(index);
 	}
 	memtx_tree_build(&index->tree, index->build_array,
 			 index->build_array_size);
@@ -1864,33 +2118,33 @@ memtx_tree_index_end_build(struct index *base)
 }
 
 /** Read view implementation. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct tree_read_view {
 	/** Base class. */
 	struct index_read_view base;
 	/** Read view index. Ref counter incremented. */
-	struct memtx_tree_index<USE_HINT> *index;
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index;
 	/** BPS tree read view. */
-	memtx_tree_view_t<USE_HINT> tree_view;
+	memtx_tree_view_t<USE_HINT, INLINE_KEY> tree_view;
 	/** Used for clarifying read view tuples. */
 	struct memtx_tx_snapshot_cleaner cleaner;
 };
 
 /** Read view iterator implementation. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY = false>
 struct tree_read_view_iterator {
 	/** Base class. */
 	struct index_read_view_iterator_base base;
 	/** Iterator key. */
-	struct memtx_tree_key_data<USE_HINT> key_data;
+	struct memtx_tree_key_data<USE_HINT, INLINE_KEY> key_data;
 	/** BPS tree iterator. */
-	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+	memtx_tree_iterator_t<USE_HINT, INLINE_KEY> tree_iterator;
 	/**
 	 * Data that was fetched last. Is NULL only if there was no data
 	 * fetched. Otherwise, tuple pointer is not NULL, even if iterator
 	 * is exhausted - pagination relies on it.
 	 */
-	struct memtx_tree_data<USE_HINT> *last;
+	struct memtx_tree_data<USE_HINT, INLINE_KEY> *last;
 };
 
 static_assert(sizeof(struct tree_read_view_iterator<false>) <=
@@ -1901,13 +2155,17 @@ static_assert(sizeof(struct tree_read_view_iterator<true>) <=
 	      INDEX_READ_VIEW_ITERATOR_SIZE,
 	      "sizeof(struct tree_read_view_iterator<true>) must be less than "
 	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_read_view_iterator<false, true>) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct tree_read_view_iterator<false, true>) must be "
+	      "less than or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
 tree_read_view_free(struct index_read_view *base)
 {
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)base;
+	struct tree_read_view<USE_HINT, INLINE_KEY> *rv =
+		(struct tree_read_view<USE_HINT, INLINE_KEY> *)base;
 	memtx_tree_view_destroy(&rv->tree_view);
 	index_unref(&rv->index->base);
 	memtx_tx_snapshot_cleaner_destroy(&rv->cleaner);
@@ -1919,7 +2177,7 @@ tree_read_view_free(struct index_read_view *base)
 # include "memtx_tree_read_view.cc"
 #else /* !defined(ENABLE_READ_VIEW) */
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_read_view_get_raw(struct index_read_view *rv,
 		       const char *key, uint32_t part_count,
@@ -1934,18 +2192,19 @@ tree_read_view_get_raw(struct index_read_view *rv,
 }
 
 /** Implementation of next_raw index_read_view_iterator callback. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 				 struct read_view_tuple *result)
 {
-	struct tree_read_view_iterator<USE_HINT> *it =
-		(struct tree_read_view_iterator<USE_HINT> *)iterator;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)it->base.index;
+	struct tree_read_view_iterator<USE_HINT, INLINE_KEY> *it =
+		(struct tree_read_view_iterator<USE_HINT, INLINE_KEY> *)
+		iterator;
+	struct tree_read_view<USE_HINT, INLINE_KEY> *rv =
+		(struct tree_read_view<USE_HINT, INLINE_KEY> *)it->base.index;
 
 	while (true) {
-		struct memtx_tree_data<USE_HINT> *res =
+		struct memtx_tree_data<USE_HINT, INLINE_KEY> *res =
 			memtx_tree_view_iterator_get_elem(&rv->tree_view,
 							  &it->tree_iterator);
 
@@ -1965,12 +2224,12 @@ tree_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 }
 
 /** Positions the iterator to the given key. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
-tree_read_view_iterator_start(struct tree_read_view_iterator<USE_HINT> *it,
-			      enum iterator_type type,
-			      const char *key, uint32_t part_count,
-			      const char *pos)
+tree_read_view_iterator_start(
+	struct tree_read_view_iterator<USE_HINT, INLINE_KEY> *it,
+	enum iterator_type type, const char *key, uint32_t part_count,
+	const char *pos)
 {
 	assert(type == ITER_ALL);
 	assert(key == NULL);
@@ -1980,16 +2239,17 @@ tree_read_view_iterator_start(struct tree_read_view_iterator<USE_HINT> *it,
 	(void)key;
 	(void)part_count;
 	(void)pos;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)it->base.index;
-	it->base.next_raw = tree_read_view_iterator_next_raw<USE_HINT>;
+	struct tree_read_view<USE_HINT, INLINE_KEY> *rv =
+		(struct tree_read_view<USE_HINT, INLINE_KEY> *)it->base.index;
+	it->base.next_raw =
+		tree_read_view_iterator_next_raw<USE_HINT, INLINE_KEY>;
 	it->tree_iterator = memtx_tree_view_first(&rv->tree_view);
 	return 0;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static void
-tree_read_view_reset_key_def(struct tree_read_view<USE_HINT> *rv)
+tree_read_view_reset_key_def(struct tree_read_view<USE_HINT, INLINE_KEY> *rv)
 {
 	rv->tree_view.common.arg = NULL;
 }
@@ -1999,14 +2259,14 @@ tree_read_view_reset_key_def(struct tree_read_view<USE_HINT> *rv)
 /**
  * Implementation of iterator position for general and multikey read views.
  */
-template <bool USE_HINT, bool IS_MULTIKEY>
+template <bool USE_HINT, bool INLINE_KEY, bool IS_MULTIKEY>
 static int
 tree_read_view_iterator_position(struct index_read_view_iterator *it,
 				 const char **pos, uint32_t *size)
 {
-	struct tree_read_view_iterator<USE_HINT> *tree_it =
-		(struct tree_read_view_iterator<USE_HINT> *)it;
-	return tree_iterator_position_impl<USE_HINT, IS_MULTIKEY>(
+	struct tree_read_view_iterator<USE_HINT, INLINE_KEY> *tree_it =
+		(struct tree_read_view_iterator<USE_HINT, INLINE_KEY> *)it;
+	return tree_iterator_position_impl<USE_HINT, INLINE_KEY, IS_MULTIKEY>(
 		tree_it->last, it->base.index->def, pos, size);
 }
 
@@ -2025,7 +2285,7 @@ tree_read_view_iterator_position_func(struct index_read_view_iterator *it,
 }
 
 /** Implementation of create_iterator index_read_view callback. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static int
 tree_read_view_create_iterator(struct index_read_view *base,
 			       enum iterator_type type,
@@ -2033,8 +2293,9 @@ tree_read_view_create_iterator(struct index_read_view *base,
 			       const char *pos,
 			       struct index_read_view_iterator *iterator)
 {
-	struct tree_read_view_iterator<USE_HINT> *it =
-		(struct tree_read_view_iterator<USE_HINT> *)iterator;
+	struct tree_read_view_iterator<USE_HINT, INLINE_KEY> *it =
+		(struct tree_read_view_iterator<USE_HINT, INLINE_KEY> *)
+		iterator;
 	it->base.index = base;
 	it->base.next_raw = exhausted_index_read_view_iterator_next_raw;
 	if (it->base.index->def->key_def->for_func_index)
@@ -2042,10 +2303,11 @@ tree_read_view_create_iterator(struct index_read_view *base,
 			tree_read_view_iterator_position_func;
 	else if (it->base.index->def->key_def->is_multikey)
 		it->base.position =
-			tree_read_view_iterator_position<true, true>;
+			tree_read_view_iterator_position<true, false, true>;
 	else
 		it->base.position =
-			tree_read_view_iterator_position<USE_HINT, false>;
+			tree_read_view_iterator_position<USE_HINT, INLINE_KEY,
+							 false>;
 	it->key_data.key = NULL;
 	it->key_data.part_count = 0;
 	if (USE_HINT)
@@ -2056,19 +2318,21 @@ tree_read_view_create_iterator(struct index_read_view *base,
 }
 
 /** Implementation of create_read_view index callback. */
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static struct index_read_view *
 memtx_tree_index_create_read_view(struct index *base)
 {
 	static const struct index_read_view_vtab vtab = {
-		.free = tree_read_view_free<USE_HINT>,
-		.get_raw = tree_read_view_get_raw<USE_HINT>,
-		.create_iterator = tree_read_view_create_iterator<USE_HINT>,
+		.free = tree_read_view_free<USE_HINT, INLINE_KEY>,
+		.get_raw = tree_read_view_get_raw<USE_HINT, INLINE_KEY>,
+		.create_iterator =
+			tree_read_view_create_iterator<USE_HINT, INLINE_KEY>,
 	};
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
-	struct tree_read_view<USE_HINT> *rv =
-		(struct tree_read_view<USE_HINT> *)xmalloc(sizeof(*rv));
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)base;
+	struct tree_read_view<USE_HINT, INLINE_KEY> *rv =
+		(struct tree_read_view<USE_HINT, INLINE_KEY> *)
+		xmalloc(sizeof(*rv));
 	if (index_read_view_create(&rv->base, &vtab, base->def) != 0) {
 		free(rv);
 		return NULL;
@@ -2089,7 +2353,7 @@ memtx_tree_index_create_read_view(struct index *base)
  * key defintion is not completely initialized at that moment).
  */
 static const struct index_vtab memtx_tree_disabled_index_vtab = {
-	/* .destroy = */ memtx_tree_index_destroy<true>,
+	/* .destroy = */ memtx_tree_index_destroy<true, false>,
 	/* .commit_create = */ generic_index_commit_create,
 	/* .abort_create = */ generic_index_abort_create,
 	/* .commit_modify = */ generic_index_commit_modify,
@@ -2106,6 +2370,7 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .count = */ generic_index_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ generic_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ disabled_index_replace,
 	/* .create_iterator = */ generic_index_create_iterator,
 	/* .create_read_view = */ generic_index_create_read_view,
@@ -2133,15 +2398,19 @@ enum memtx_tree_vtab_type {
 };
 
 /**
- * Get index vtab by @a TYPE and @a USE_HINT, template version.
- * USE_HINT == false is only allowed for general index type.
+ * Get index vtab by @a TYPE, @a USE_HINT and @a INLINE_KEY, template
+ * version. USE_HINT == false and INLINE_KEY == true are only allowed for
+ * general index type.
  */
-template <memtx_tree_vtab_type TYPE, bool USE_HINT = true>
+template <memtx_tree_vtab_type TYPE, bool USE_HINT = true,
+	  bool INLINE_KEY = false>
 static const struct index_vtab *
 get_memtx_tree_index_vtab(void)
 {
 	static_assert(USE_HINT || TYPE == MEMTX_TREE_VTAB_GENERAL,
 		      "Multikey and func indexes must use hints");
+	static_assert(!(USE_HINT && INLINE_KEY),
+		      "Hints and inlined keys can't be used together");
 
 	if (TYPE == MEMTX_TREE_VTAB_DISABLED)
 		return &memtx_tree_disabled_index_vtab;
@@ -2149,50 +2418,57 @@ get_memtx_tree_index_vtab(void)
 	const bool is_mk = TYPE == MEMTX_TREE_VTAB_MULTIKEY;
 	const bool is_func = TYPE == MEMTX_TREE_VTAB_FUNC;
 	static const struct index_vtab vtab = {
-		/* .destroy = */ memtx_tree_index_destroy<USE_HINT>,
+		/* .destroy = */ memtx_tree_index_destroy<USE_HINT, INLINE_KEY>,
 		/* .commit_create = */ generic_index_commit_create,
 		/* .abort_create = */ generic_index_abort_create,
 		/* .commit_modify = */ generic_index_commit_modify,
 		/* .commit_drop = */ generic_index_commit_drop,
-		/* .update_def = */ memtx_tree_index_update_def<USE_HINT>,
+		/* .update_def = */
+			memtx_tree_index_update_def<USE_HINT, INLINE_KEY>,
 		/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
 		/* .def_change_requires_rebuild = */
 			memtx_index_def_change_requires_rebuild,
-		/* .size = */ memtx_tree_index_size<USE_HINT>,
-		/* .bsize = */ memtx_tree_index_bsize<USE_HINT>,
+		/* .size = */ memtx_tree_index_size<USE_HINT, INLINE_KEY>,
+		/* .bsize = */ memtx_tree_index_bsize<USE_HINT, INLINE_KEY>,
 		/* .min = */ generic_index_min,
 		/* .max = */ generic_index_max,
-		/* .random = */ memtx_tree_index_random<USE_HINT>,
-		/* .count = */ memtx_tree_index_count<USE_HINT>,
-		/* .get_internal */ memtx_tree_index_get_internal<USE_HINT>,
+		/* .random = */ memtx_tree_index_random<USE_HINT, INLINE_KEY>,
+		/* .count = */ memtx_tree_index_count<USE_HINT, INLINE_KEY>,
+		/* .get_internal */
+			memtx_tree_index_get_internal<USE_HINT, INLINE_KEY>,
 		/* .get = */ memtx_index_get,
+		/* .get_many = */
+			memtx_tree_index_get_many<USE_HINT, INLINE_KEY>,
 		/* .replace = */ is_mk ? memtx_tree_index_replace_multikey :
 				 is_func ? memtx_tree_func_index_replace :
-				 memtx_tree_index_replace<USE_HINT>,
+				 memtx_tree_index_replace<USE_HINT, INLINE_KEY>,
 		/* .create_iterator = */
-			memtx_tree_index_create_iterator<USE_HINT>,
+			memtx_tree_index_create_iterator<USE_HINT, INLINE_KEY>,
 		/* .create_read_view = */
-			memtx_tree_index_create_read_view<USE_HINT>,
+			memtx_tree_index_create_read_view<USE_HINT, INLINE_KEY>,
 		/* .stat = */ generic_index_stat,
 		/* .compact = */ generic_index_compact,
 		/* .reset_stat = */ generic_index_reset_stat,
-		/* .begin_build = */ memtx_tree_index_begin_build<USE_HINT>,
-		/* .reserve = */ memtx_tree_index_reserve<USE_HINT>,
+		/* .begin_build = */
+			memtx_tree_index_begin_build<USE_HINT, INLINE_KEY>,
+		/* .reserve = */ memtx_tree_index_reserve<USE_HINT, INLINE_KEY>,
 		/* .build_next = */ is_mk ? memtx_tree_index_build_next_multikey :
 				    is_func ? memtx_tree_func_index_build_next :
-				    memtx_tree_index_build_next<USE_HINT>,
-		/* .end_build = */ memtx_tree_index_end_build<USE_HINT>,
+				    memtx_tree_index_build_next<USE_HINT,
+								INLINE_KEY>,
+		/* .end_build = */
+			memtx_tree_index_end_build<USE_HINT, INLINE_KEY>,
 	};
 	return &vtab;
 }
 
-template <bool USE_HINT>
+template <bool USE_HINT, bool INLINE_KEY>
 static struct index *
 memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 			 const struct index_vtab *vtab)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)
+	struct memtx_tree_index<USE_HINT, INLINE_KEY> *index =
+		(struct memtx_tree_index<USE_HINT, INLINE_KEY> *)
 		calloc(1, sizeof(*index));
 	if (index == NULL) {
 		diag_set(OutOfMemory, sizeof(*index),
@@ -2233,6 +2509,10 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 	} else if (def->key_def->is_multikey) {
 		vtab = get_memtx_tree_index_vtab<MEMTX_TREE_VTAB_MULTIKEY>();
 		use_hint = true;
+	} else if (def->opts.inline_key) {
+		vtab = get_memtx_tree_index_vtab
+			<MEMTX_TREE_VTAB_GENERAL, false, true>();
+		return memtx_tree_index_new_tpl<false, true>(memtx, def, vtab);
 	} else if (def->opts.hint) {
 		vtab = get_memtx_tree_index_vtab
 			<MEMTX_TREE_VTAB_GENERAL, true>();
@@ -2242,7 +2522,7 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 			<MEMTX_TREE_VTAB_GENERAL, false>();
 	}
 	if (use_hint)
-		return memtx_tree_index_new_tpl<true>(memtx, def, vtab);
+		return memtx_tree_index_new_tpl<true, false>(memtx, def, vtab);
 	else
-		return memtx_tree_index_new_tpl<false>(memtx, def, vtab);
+		return memtx_tree_index_new_tpl<false, false>(memtx, def, vtab);
 }
@@ -30,6 +30,7 @@
  */
 #include "port.h"
 #include "tuple.h"
+#include "tuple_projection.h"
 #include "tuple_convert.h"
 #include <small/obuf.h>
 #include <small/slab_cache.h>
@@ -203,6 +204,23 @@ port_c_add_str(struct port *base, const char *str, uint32_t len)
 	return 0;
 }
 
+/** Encode the projection of a tuple to an output buffer. */
+static int
+port_c_projection_to_obuf(struct tuple_projection *projection,
+			  struct tuple *tuple, struct obuf *out)
+{
+	size_t size = tuple_projection_lookup(projection, tuple);
+	char *buf = obuf_alloc(out, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "buf");
+		return -1;
+	}
+	char *buf_end = tuple_projection_encode(projection, buf);
+	assert(buf_end == buf + size);
+	(void)buf_end;
+	return 0;
+}
+
 static int
 port_c_dump_msgpack_16(struct port *base, struct obuf *out)
 {
@@ -210,7 +228,11 @@ port_c_dump_msgpack_16(struct port *base, struct obuf *out)
 	struct port_c_entry *pe;
 	for (pe = port->first; pe != NULL; pe = pe->next) {
 		uint32_t size = pe->mp_size;
-		if (size == 0) {
+		if (size == 0 && port->projection != NULL) {
+			if (port_c_projection_to_obuf(port->projection,
+						      pe->tuple, out) != 0)
+				return -1;
+		} else if (size == 0) {
 			if (tuple_to_obuf(pe->tuple, out) != 0)
 				return -1;
 		} else if (obuf_dup(out, pe->mp, size) != size) {
@@ -266,7 +288,16 @@ port_c_get_msgpack(struct port *base, uint32_t *size)
 	for (pe = port->first; pe != NULL; pe = pe->next) {
 		const char *data;
 		uint32_t len;
-		if (pe->mp_size == 0) {
+		if (pe->mp_size == 0 && port->projection != NULL) {
+			len = tuple_projection_lookup(port->projection,
+						      pe->tuple);
+			char *buf = mpstream_reserve(&stream, len);
+			if (buf == NULL)
+				break;
+			tuple_projection_encode(port->projection, buf);
+			mpstream_advance(&stream, len);
+			continue;
+		} else if (pe->mp_size == 0) {
 			data = tuple_data(pe->tuple);
 			len = tuple_bsize(pe->tuple);
 		} else {
@@ -316,6 +347,7 @@ port_c_create(struct port *base)
 	port->first = NULL;
 	port->last = NULL;
 	port->size = 0;
+	port->projection = NULL;
 }
 
 void
@@ -136,6 +136,12 @@ struct port_c {
 	struct port_c_entry *last;
 	struct port_c_entry first_entry;
 	int size;
+	/**
+	 * Optional projection applied to tuple entries when they are
+	 * encoded to MsgPack or pushed to Lua. Is NULL if tuples are
+	 * returned as is.
+	 */
+	struct tuple_projection *projection;
 };
 
 static_assert(sizeof(struct port_c) <= sizeof(struct port),
@@ -167,6 +173,19 @@ port_c_add_formatted_mp(struct port *port, const char *mp, const char *mp_end,
 int
 port_c_add_str(struct port *port, const char *str, uint32_t len);
 
+struct tuple_projection;
+
+/**
+ * Set a projection to apply to the tuples of the port, see
+ * port_c::projection. The projection must outlive the port.
+ */
+static inline void
+port_c_set_projection(struct port *base, struct tuple_projection *projection)
+{
+	struct port_c *port = (struct port_c *)base;
+	port->projection = projection;
+}
+
 void
 port_init(void);
 
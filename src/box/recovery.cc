@@ -369,6 +369,21 @@ recovery_finalize(struct recovery *r)
 	recovery_close_log(r);
 }
 
+void
+recovery_detach_log(struct recovery *r)
+{
+	bool is_open = xlog_cursor_is_open(&r->cursor);
+	if (is_open)
+		xlog_cursor_close(&r->cursor, false);
+	/*
+	 * Forget the last read WAL so that the next one is opened
+	 * without checking that it follows the last one.
+	 */
+	r->cursor.state = XLOG_CURSOR_NEW;
+	if (is_open)
+		trigger_run_xc(&r->on_close_log, NULL);
+}
+
 
 /* }}} */
 
@@ -86,6 +86,14 @@ recovery_stop_local(struct recovery *r);
 void
 recovery_finalize(struct recovery *r);
 
+/**
+ * Stop reading the current WAL file without reaching its end. The next
+ * call to recover_remaining_wals() looks up the WAL file to read by the
+ * recovery vclock as if the recovery were new.
+ */
+void
+recovery_detach_log(struct recovery *r);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
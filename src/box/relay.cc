@@ -34,10 +34,12 @@
 #include "trivia/util.h" /** static_assert */
 #include "tt_static.h"
 #include "scoped_guard.h"
+#include "assoc.h"
 #include "cbus.h"
 #include "errinj.h"
 #include "fiber.h"
 #include "say.h"
+#include "sio.h"
 
 #include "coio.h"
 #include "coio_task.h"
@@ -47,6 +49,8 @@
 #include "iproto_constants.h"
 #include "recovery.h"
 #include "replication.h"
+#include "replication_hist.h"
+#include "schema_def.h"
 #include "trigger.h"
 #include "vclock/vclock.h"
 #include "version.h"
@@ -54,10 +58,39 @@
 #include "xrow_io.h"
 #include "xstream.h"
 #include "wal.h"
+#include "wal_tail.h"
+#include "zstd_iostream.h"
 #include "txn_limbo.h"
 #include "raft.h"
 
+#include <fcntl.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum {
+	/**
+	 * Size of rows copied from the WAL tail buffer at once, see
+	 * relay_send_wal_tail().
+	 */
+	RELAY_WAL_TAIL_READ_SIZE = 256 * 1024,
+	/**
+	 * Max size of checkpoint file data sent at once, see
+	 * relay_initial_join_files().
+	 */
+	RELAY_JOIN_FILE_CHUNK_SIZE = 1024 * 1024,
+	/**
+	 * Size of rows accumulated in the send buffer that makes the
+	 * relay write them to the socket, see relay_send().
+	 */
+	RELAY_SEND_BUF_SIZE = 64 * 1024,
+};
+
+/**
+ * Min time span between two updates of the relay throughput in tx
+ * thread, in seconds.
+ */
+static const double RELAY_SEND_RATE_INTERVAL = 1.0;
 
 /**
  * Cbus message to send status updates from relay to tx thread.
@@ -75,6 +108,16 @@ struct relay_status_msg {
 	double txn_lag;
 	/** Last vclock sync received in replica's response. */
 	uint64_t vclock_sync;
+	/** Traffic statistics of the stream if it's compressed. */
+	struct zstd_iostream_stat compression;
+	/** Number of data rows sent to the replica. */
+	uint64_t sent_rows;
+	/** Number of bytes sent to the replica. */
+	uint64_t sent_bytes;
+	/** Last measured heartbeat round trip time. */
+	double ack_rtt;
+	/** Sync of the heartbeat the round trip was measured for. */
+	uint64_t ack_rtt_sync;
 };
 
 /**
@@ -105,11 +148,41 @@ struct relay_raft_msg {
 	struct relay *relay;
 };
 
+/** A thread of the relay thread pool. */
+struct relay_thread {
+	/** The thread. */
+	struct cord cord;
+	/** Endpoint to receive messages from tx. */
+	struct cbus_endpoint endpoint;
+	/** A pipe from tx to the thread. */
+	struct cpipe thread_pipe;
+	/** A pipe from the thread to tx. */
+	struct cpipe tx_pipe;
+	/** Number of relays running in the thread. Accessed from tx. */
+	int relay_count;
+};
+
 
 /** State of a replication relay. */
 struct relay {
-	/** The thread in which we relay data to the replica. */
+	/**
+	 * The thread in which we relay data to the replica unless
+	 * the relay thread pool is used.
+	 */
 	struct cord cord;
+	/**
+	 * The pool thread in which the relay runs as a fiber or NULL
+	 * if the relay has its own thread.
+	 */
+	struct relay_thread *thread;
+	/** Message starting the relay in the pool thread. */
+	struct cmsg thread_start_msg;
+	/** Message notifying tx that the relay has stopped. */
+	struct cmsg thread_exit_msg;
+	/** The tx fiber waiting for the relay to stop. */
+	struct fiber *tx_fiber;
+	/** Set when the relay running in the pool thread stops. */
+	bool is_thread_done;
 	/** Replica connection */
 	struct iostream *io;
 	/** Request sync */
@@ -128,6 +201,35 @@ struct relay {
 	struct replica *replica;
 	/** WAL event watcher. */
 	struct wal_watcher wal_watcher;
+	/** Position in the WAL tail buffer, see relay_send_wal_tail(). */
+	struct wal_tail_cursor wal_tail;
+	/** Rows copied from the WAL tail buffer. */
+	struct ibuf wal_tail_buf;
+	/** Encoded rows that haven't been written to the socket yet. */
+	struct ibuf send_buf;
+	/**
+	 * Set while the relay processes a WAL event. The rows are
+	 * accumulated in the send buffer then rather than written to
+	 * the socket one by one.
+	 */
+	bool is_buffering;
+	/** Number of data rows sent to the replica. */
+	uint64_t sent_rows;
+	/** Number of bytes sent to the replica. */
+	uint64_t sent_bytes;
+	/**
+	 * Round trip time of the last heartbeat acknowledged by the
+	 * replica, i.e. the time between sending the heartbeat and
+	 * receiving an ack with its sync.
+	 */
+	double ack_rtt;
+	/** Sync of the heartbeat ack_rtt was measured for. */
+	uint64_t ack_rtt_sync;
+	/**
+	 * Set if the rows are sent from the WAL tail buffer rather
+	 * than read from WAL files.
+	 */
+	bool is_reading_wal_tail;
 	/** Relay reader cond. */
 	struct fiber_cond reader_cond;
 	/** Relay diagnostics. */
@@ -146,6 +248,18 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * Set of the user space ids whose rows should be relayed or NULL
+	 * if rows of all spaces should be relayed. Rows of system spaces
+	 * are always relayed. The set is passed by the replica on
+	 * subscribe.
+	 */
+	struct mh_i32_t *space_filter;
+	/**
+	 * TSN of the transaction being relayed with the space filter set
+	 * or 0 if no row of the transaction has been relayed yet.
+	 */
+	int64_t filter_tsn;
 	/**
 	 * Local vclock at the moment of subscribe, used to check
 	 * dataset on the other side and send missing data rows if any.
@@ -208,6 +322,26 @@ struct relay {
 		double txn_lag;
 		/** Known vclock sync received in response from replica. */
 		uint64_t vclock_sync;
+		/** Whether the stream sent to the replica is compressed. */
+		bool is_compressed;
+		/** Known traffic statistics of the compressed stream. */
+		struct zstd_iostream_stat compression;
+		/** Known statistics of the data sent to the replica. */
+		struct relay_send_stat send_stat;
+		/**
+		 * Statistics used as the starting point for computing
+		 * the throughput, and the time they were received at.
+		 */
+		struct relay_send_stat send_rate_stat;
+		double send_rate_time;
+		/**
+		 * Distributions of the transaction lag, the heartbeat
+		 * round trip time and the sent bytes per second, see
+		 * box.stat.replication().
+		 */
+		struct replication_hist hist;
+		/** Sync of the last heartbeat round trip collected. */
+		uint64_t ack_rtt_sync;
 		/**
 		 * True if the relay is ready to accept messages via the cbus.
 		 */
@@ -263,9 +397,31 @@ relay_txn_lag(const struct relay *relay)
 	return relay->tx.txn_lag;
 }
 
+bool
+relay_compression_stat(const struct relay *relay,
+		       struct zstd_iostream_stat *stat)
+{
+	*stat = relay->tx.compression;
+	return relay->tx.is_compressed;
+}
+
+void
+relay_send_stat(const struct relay *relay, struct relay_send_stat *stat)
+{
+	*stat = relay->tx.send_stat;
+}
+
+struct replication_hist *
+relay_hist(struct relay *relay)
+{
+	return &relay->tx.hist;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
+relay_flush(struct relay *relay);
+static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
@@ -302,6 +458,7 @@ relay_new(struct replica *replica)
 	fiber_cond_create(&relay->reader_cond);
 	diag_create(&relay->diag);
 	stailq_create(&relay->pending_gc);
+	replication_hist_create(&relay->tx.hist);
 	relay->state = RELAY_OFF;
 	return relay;
 }
@@ -323,6 +480,7 @@ relay_yield_and_send_heartbeat(struct xstream *stream)
 {
 	struct relay *relay = container_of(stream, struct relay, stream);
 	relay_send_heartbeat_on_timeout(relay);
+	relay_flush(relay);
 	fiber_sleep(0);
 }
 
@@ -344,6 +502,16 @@ relay_start(struct relay *relay, struct iostream *io, uint64_t sync,
 	relay->sent_raft_term = sent_raft_term;
 	relay->need_new_vclock_sync = false;
 	relay->is_sending_tx = false;
+	relay->is_buffering = false;
+	relay->sent_rows = 0;
+	relay->sent_bytes = 0;
+	relay->ack_rtt = 0;
+	relay->ack_rtt_sync = 0;
+	relay->tx.ack_rtt_sync = 0;
+	memset(&relay->tx.send_stat, 0, sizeof(relay->tx.send_stat));
+	memset(&relay->tx.send_rate_stat, 0, sizeof(relay->tx.send_rate_stat));
+	relay->tx.send_rate_time = ev_monotonic_now(loop());
+	relay->tx.is_compressed = zstd_iostream_is_wrapped(io);
 	relay->last_row_time = ev_monotonic_now(loop());
 	relay->tx_seen_time = relay->last_row_time;
 	relay->last_heartbeat_time = relay->last_row_time;
@@ -352,13 +520,85 @@ relay_start(struct relay *relay, struct iostream *io, uint64_t sync,
 void
 relay_cancel(struct relay *relay)
 {
-	/* Check that the thread is running first. */
+	/*
+	 * Check that the thread is running first. A relay running
+	 * in the thread pool is stopped along with the pool.
+	 */
 	if (relay->cord.id != 0) {
 		cord_cancel_and_join(&relay->cord);
 		relay->cord.id = 0;
 	}
 }
 
+/** The main relay pool thread fiber function. */
+static int
+relay_thread_f(va_list ap)
+{
+	struct relay_thread *thread = va_arg(ap, typeof(thread));
+	coio_enable();
+	int rc = cbus_endpoint_create(&thread->endpoint, cord()->name,
+				      fiber_schedule_cb, fiber());
+	assert(rc == 0);
+	(void)rc;
+
+	cpipe_create(&thread->tx_pipe, "tx");
+
+	cbus_loop(&thread->endpoint);
+
+	unreachable();
+}
+
+/** Initialize and start a relay pool thread. */
+static void
+relay_thread_create(struct relay_thread *thread)
+{
+	static int thread_id = 0;
+	const char *name = tt_sprintf("relay_%d", ++thread_id);
+
+	memset(thread, 0, sizeof(*thread));
+
+	if (cord_costart(&thread->cord, name, relay_thread_f, thread) != 0)
+		diag_raise();
+
+	cpipe_create(&thread->thread_pipe, name);
+}
+
+/** Relay thread pool, empty if each relay has its own thread. */
+static struct relay_thread *relay_threads;
+
+void
+relay_init(void)
+{
+	if (replication_relay_threads == 0)
+		return;
+	relay_threads = (struct relay_thread *)
+		xcalloc(replication_relay_threads, sizeof(*relay_threads));
+	for (int i = 0; i < replication_relay_threads; i++)
+		relay_thread_create(&relay_threads[i]);
+}
+
+void
+relay_free(void)
+{
+	for (int i = 0; i < replication_relay_threads; i++)
+		cord_cancel_and_join(&relay_threads[i].cord);
+	free(relay_threads);
+	relay_threads = NULL;
+}
+
+/** Get the least loaded relay pool thread. */
+static struct relay_thread *
+relay_thread_next(void)
+{
+	assert(replication_relay_threads > 0);
+	struct relay_thread *thread = &relay_threads[0];
+	for (int i = 1; i < replication_relay_threads; i++) {
+		if (relay_threads[i].relay_count < thread->relay_count)
+			thread = &relay_threads[i];
+	}
+	return thread;
+}
+
 /**
  * Called by a relay thread right before termination.
  */
@@ -405,6 +645,11 @@ relay_stop(struct relay *relay)
 	relay->txn_lag = 0;
 	relay->tx.txn_lag = 0;
 	relay->tx.vclock_sync = 0;
+	relay->tx.is_compressed = false;
+	memset(&relay->tx.compression, 0, sizeof(relay->tx.compression));
+	if (relay->space_filter != NULL)
+		mh_i32_delete(relay->space_filter);
+	relay->space_filter = NULL;
 }
 
 void
@@ -414,22 +659,30 @@ relay_delete(struct relay *relay)
 		relay_stop(relay);
 	fiber_cond_destroy(&relay->reader_cond);
 	diag_destroy(&relay->diag);
+	replication_hist_destroy(&relay->tx.hist);
 	TRASH(relay);
 	free(relay);
 }
 
+/** Format the name of a relay thread or fiber by the peer address. */
 static void
-relay_set_cord_name(int fd)
+relay_format_name(int fd, char *name, size_t size)
 {
-	char name[FIBER_NAME_MAX];
 	struct sockaddr_storage peer;
 	socklen_t addrlen = sizeof(peer);
 	if (getpeername(fd, ((struct sockaddr*)&peer), &addrlen) == 0) {
-		snprintf(name, sizeof(name), "relay/%s",
+		snprintf(name, size, "relay/%s",
 			 sio_strfaddr((struct sockaddr *)&peer, addrlen));
 	} else {
-		snprintf(name, sizeof(name), "relay/<unknown>");
+		snprintf(name, size, "relay/<unknown>");
 	}
+}
+
+static void
+relay_set_cord_name(int fd)
+{
+	char name[FIBER_NAME_MAX];
+	relay_format_name(fd, name, sizeof(name));
 	cord_set_name(name);
 }
 
@@ -508,6 +761,139 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 	engine_join_xc(&ctx, &relay->stream);
 }
 
+/** Checkpoint file sent to a joining replica. */
+struct relay_join_file {
+	/** Replica connection. */
+	struct iostream *io;
+	/** Sync of the JOIN request. */
+	uint64_t sync;
+	/** Vclock of the checkpoint. */
+	const struct vclock *vclock;
+	/** Path to the file. */
+	const char *path;
+};
+
+/**
+ * Send file data to a plain socket with sendfile(), so that it isn't
+ * copied to the user space.
+ */
+static int
+relay_sendfile(struct relay_join_file *file, int fd, off_t size)
+{
+	int sock = file->io->fd;
+	off_t offset = 0;
+	while (offset < size) {
+		size_t count = MIN(size - offset, RELAY_JOIN_FILE_CHUNK_SIZE);
+		ssize_t rc = eio_sendfile_sync(sock, fd, offset, count);
+		if (rc > 0) {
+			offset += rc;
+		} else if (rc == 0) {
+			diag_set(XlogError, "file `%s' is truncated",
+				 file->path);
+			return -1;
+		} else if (errno == EAGAIN || errno == EWOULDBLOCK ||
+			   errno == EINTR) {
+			coio_wait(sock, COIO_WRITE, TIMEOUT_INFINITY);
+			if (fiber_is_cancelled()) {
+				diag_set(FiberIsCancelled);
+				return -1;
+			}
+		} else {
+			diag_set(SocketError, sio_socketname(sock), "sendfile");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Send file data over a stream that needs to process the data, e.g.
+ * to encrypt or compress it.
+ */
+static int
+relay_copy_file(struct relay_join_file *file, int fd, off_t size)
+{
+	char *buf = (char *)xmalloc(RELAY_JOIN_FILE_CHUNK_SIZE);
+	auto buf_guard = make_scoped_guard([=] { free(buf); });
+	off_t offset = 0;
+	while (offset < size) {
+		size_t count = MIN(size - offset, RELAY_JOIN_FILE_CHUNK_SIZE);
+		ssize_t rc = pread(fd, buf, count, offset);
+		if (rc < 0) {
+			diag_set(SystemError, "failed to read `%s'",
+				 file->path);
+			return -1;
+		} else if (rc == 0) {
+			diag_set(XlogError, "file `%s' is truncated",
+				 file->path);
+			return -1;
+		}
+		if (coio_write_timeout(file->io, buf, rc,
+				       TIMEOUT_INFINITY) < 0)
+			return -1;
+		offset += rc;
+	}
+	return 0;
+}
+
+static int
+relay_join_file_f(va_list ap)
+{
+	struct relay_join_file *file = va_arg(ap, struct relay_join_file *);
+	int fd = open(file->path, O_RDONLY);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to open `%s'", file->path);
+		return -1;
+	}
+	auto fd_guard = make_scoped_guard([=] { close(fd); });
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		diag_set(SystemError, "failed to stat `%s'", file->path);
+		return -1;
+	}
+	struct join_file req;
+	vclock_copy(&req.vclock, file->vclock);
+	req.size = st.st_size;
+	struct xrow_header row;
+	RegionGuard region_guard(&fiber()->gc);
+	xrow_encode_join_file(&row, &req);
+	row.sync = file->sync;
+	try {
+		coio_write_xrow(file->io, &row);
+	} catch (Exception *e) {
+		return -1;
+	}
+	say_info("sending `%s', %lld bytes", file->path,
+		 (long long)st.st_size);
+	if (iostream_is_plain(file->io))
+		return relay_sendfile(file, fd, st.st_size);
+	return relay_copy_file(file, fd, st.st_size);
+}
+
+void
+relay_initial_join_files(struct iostream *io, uint64_t sync,
+			 const struct vclock *vclock, const char *path)
+{
+	/* Respond to the JOIN request with the checkpoint vclock. */
+	struct xrow_header row;
+	RegionGuard region_guard(&fiber()->gc);
+	xrow_encode_vclock(&row, vclock);
+	row.sync = sync;
+	coio_write_xrow(io, &row);
+	/*
+	 * The checkpoint contains the synchro and Raft state, so there's
+	 * no metadata stage. Send the file from a separate thread so as
+	 * not to block tx on disk reads.
+	 */
+	struct relay_join_file file = {io, sync, vclock, path};
+	struct cord cord;
+	if (cord_costart(&cord, "initial_join", relay_join_file_f,
+			 &file) != 0)
+		diag_raise();
+	if (cord_cojoin(&cord) != 0)
+		diag_raise();
+}
+
 int
 relay_final_join_f(va_list ap)
 {
@@ -579,6 +965,27 @@ relay_status_update(struct cmsg *msg)
 	relay_check_status_needs_update(relay);
 }
 
+/**
+ * Update the statistics of the data sent to the replica in tx thread.
+ * The throughput is averaged over at least RELAY_SEND_RATE_INTERVAL.
+ */
+static void
+relay_update_send_stat(struct relay *relay, uint64_t rows, uint64_t bytes)
+{
+	struct relay_send_stat *stat = &relay->tx.send_stat;
+	struct relay_send_stat *start = &relay->tx.send_rate_stat;
+	stat->rows = rows;
+	stat->bytes = bytes;
+	double now = ev_monotonic_now(loop());
+	double elapsed = now - relay->tx.send_rate_time;
+	if (elapsed < RELAY_SEND_RATE_INTERVAL)
+		return;
+	stat->rows_per_sec = (rows - start->rows) / elapsed;
+	stat->bytes_per_sec = (bytes - start->bytes) / elapsed;
+	*start = *stat;
+	relay->tx.send_rate_time = now;
+}
+
 /**
  * Deliver a fresh relay vclock to tx thread.
  */
@@ -587,9 +994,22 @@ tx_status_update(struct cmsg *msg)
 {
 	struct relay_status_msg *status = (struct relay_status_msg *)msg;
 	struct relay *relay = status->relay;
+	struct replication_hist *hist = &relay->tx.hist;
+	/* Collect the lag only when the replica acks a new transaction. */
+	if (vclock_get(&status->vclock, instance_id) >
+	    vclock_get(&relay->tx.vclock, instance_id))
+		latency_collect(&hist->lag, status->txn_lag);
+	if (status->ack_rtt_sync != relay->tx.ack_rtt_sync) {
+		latency_collect(&hist->latency, status->ack_rtt);
+		relay->tx.ack_rtt_sync = status->ack_rtt_sync;
+	}
+	replication_hist_collect_bytes(hist, status->sent_bytes -
+					     relay->tx.send_stat.bytes);
 	vclock_copy(&relay->tx.vclock, &status->vclock);
 	relay->tx.txn_lag = status->txn_lag;
 	relay->tx.vclock_sync = status->vclock_sync;
+	relay->tx.compression = status->compression;
+	relay_update_send_stat(relay, status->sent_rows, status->sent_bytes);
 
 	struct replication_ack ack;
 	ack.source = status->relay->replica->id;
@@ -610,9 +1030,12 @@ tx_status_update(struct cmsg *msg)
 	 * them were successfully sent to the replica. Acks are
 	 * collected only by the transactions originator (which is
 	 * the single master in 100% so far). Other instances wait
-	 * for master's CONFIRM message instead.
+	 * for master's CONFIRM message instead. A replica that
+	 * receives only a subset of spaces doesn't have the data
+	 * of the transactions, so it doesn't count in the quorum.
 	 */
-	if (txn_limbo.owner_id == instance_id && !anon) {
+	if (txn_limbo.owner_id == instance_id && !anon &&
+	    relay->space_filter == NULL) {
 		txn_limbo_ack(&txn_limbo, ack.source,
 			      vclock_get(ack.vclock, instance_id));
 	}
@@ -636,17 +1059,20 @@ tx_gc_advance(struct cmsg *msg)
 	free(m);
 }
 
-static int
-relay_on_close_log_f(struct trigger *trigger, void * /* event */)
+/**
+ * Allow garbage collection of the WAL files sent to the replica
+ * once it confirms that it has received them.
+ */
+static void
+relay_add_pending_gc(struct relay *relay)
 {
 	static const struct cmsg_hop route[] = {
 		{tx_gc_advance, NULL}
 	};
-	struct relay *relay = (struct relay *)trigger->data;
 	struct relay_gc_msg *m = (struct relay_gc_msg *)malloc(sizeof(*m));
 	if (m == NULL) {
 		say_warn("failed to allocate relay gc message");
-		return 0;
+		return;
 	}
 	cmsg_init(&m->msg, route);
 	m->relay = relay;
@@ -657,6 +1083,12 @@ relay_on_close_log_f(struct trigger *trigger, void * /* event */)
 	 * sent xlog.
 	 */
 	stailq_add_tail_entry(&relay->pending_gc, m, in_pending);
+}
+
+static int
+relay_on_close_log_f(struct trigger *trigger, void * /* event */)
+{
+	relay_add_pending_gc((struct relay *)trigger->data);
 	return 0;
 }
 
@@ -701,6 +1133,49 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Send the rows following the relay vclock from the WAL tail buffer.
+ * Returns false if the buffer doesn't have them (the replica lags
+ * behind it) so they must be read from WAL files.
+ */
+static bool
+relay_send_wal_tail(struct relay *relay)
+{
+	struct recovery *r = relay->r;
+	struct xstream *stream = &relay->stream;
+	struct ibuf *buf = &relay->wal_tail_buf;
+	while (true) {
+		ibuf_reset(buf);
+		int count = wal_read_tail(&relay->wal_tail, &r->vclock, buf,
+					  RELAY_WAL_TAIL_READ_SIZE);
+		if (count < 0)
+			return false;
+		if (!relay->is_reading_wal_tail) {
+			/*
+			 * All the rows preceding the buffer have been
+			 * sent so the current WAL file isn't needed.
+			 */
+			recovery_detach_log(r);
+			relay->is_reading_wal_tail = true;
+		}
+		if (count == 0)
+			return true;
+		const char *pos = buf->rpos;
+		for (int i = 0; i < count; i++) {
+			struct xrow_header row;
+			if (wal_tail_decode_row(&pos, &row) != 0)
+				diag_raise();
+			if (++stream->row_count % WAL_ROWS_PER_YIELD == 0)
+				xstream_yield(stream);
+			/* Skip the rows already sent, see recover_xlog(). */
+			if (row.lsn <= vclock_get(&r->vclock, row.replica_id))
+				continue;
+			vclock_follow_xrow(&r->vclock, &row);
+			xstream_write_xc(stream, &row);
+		}
+	}
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -717,9 +1192,37 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		 */
 		return;
 	}
+	bool is_rotated = (events & WAL_EVENT_ROTATE) != 0;
+	/*
+	 * Rows are written to the socket in batches while the event is
+	 * processed, see relay_send().
+	 */
+	relay->is_buffering = true;
+	auto buffering_guard = make_scoped_guard([relay] {
+		relay->is_buffering = false;
+		ibuf_reset(&relay->send_buf);
+	});
 	try {
-		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+		if (relay_send_wal_tail(relay)) {
+			/*
+			 * No WAL file is closed by the relay while it's
+			 * reading the buffer, so schedule garbage
+			 * collection on rotation instead.
+			 */
+			if (is_rotated && !relay->replica->anon)
+				relay_add_pending_gc(relay);
+		} else {
+			/*
+			 * The WAL directory may have changed while the
+			 * relay was reading the buffer so rescan it.
+			 */
+			bool scan_dir = is_rotated ||
+					relay->is_reading_wal_tail;
+			relay->is_reading_wal_tail = false;
+			recover_remaining_wals(relay->r, &relay->stream, NULL,
+					       scan_dir);
+		}
+		relay_flush(relay);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -763,6 +1266,18 @@ relay_reader_f(va_list ap)
 			    vclock_get(&status_msg->vclock, instance_id) <
 			    vclock_get(&last_recv_ack->vclock, instance_id))
 				relay->txn_lag = ev_now(loop()) - xrow.tm;
+			/*
+			 * The replica acks a heartbeat with its sync, see
+			 * relay_send_heartbeat(). Measure the round trip of
+			 * the last one sent.
+			 */
+			uint64_t sync = last_recv_ack->vclock_sync;
+			if (sync != 0 && sync != relay->ack_rtt_sync &&
+			    sync == relay->last_sent_ack.vclock_sync) {
+				relay->ack_rtt = ev_monotonic_now(loop()) -
+						 relay->last_heartbeat_time;
+				relay->ack_rtt_sync = sync;
+			}
 			fiber_cond_signal(&relay->reader_cond);
 		}
 	} catch (Exception *e) {
@@ -948,6 +1463,12 @@ relay_check_status_needs_update(struct relay *relay)
 	status_msg->relay = relay;
 	status_msg->term = last_recv_ack->term;
 	status_msg->vclock_sync = last_recv_ack->vclock_sync;
+	if (zstd_iostream_is_wrapped(relay->io))
+		zstd_iostream_stat(relay->io, &status_msg->compression);
+	status_msg->sent_rows = relay->sent_rows;
+	status_msg->sent_bytes = relay->sent_bytes;
+	status_msg->ack_rtt = relay->ack_rtt;
+	status_msg->ack_rtt_sync = relay->ack_rtt_sync;
 	cpipe_push(&relay->tx_pipe, &status_msg->msg);
 }
 
@@ -957,13 +1478,8 @@ relay_check_status_needs_update(struct relay *relay)
  * its socket, and we get an EOF.
  */
 static int
-relay_subscribe_f(va_list ap)
+relay_subscribe_run(struct relay *relay)
 {
-	struct relay *relay = va_arg(ap, struct relay *);
-
-	coio_enable();
-	relay_set_cord_name(relay->io->fd);
-
 	cbus_endpoint_create(&relay->tx_endpoint,
 			     tt_sprintf("relay_tx_%p", relay),
 			     fiber_schedule_cb, fiber());
@@ -975,6 +1491,12 @@ relay_subscribe_f(va_list ap)
 			     tt_sprintf("relay_wal_%p", relay),
 			     fiber_schedule_cb, fiber());
 
+	relay->wal_tail.is_open = false;
+	relay->is_reading_wal_tail = false;
+	ibuf_create(&relay->wal_tail_buf, &cord()->slabc,
+		    RELAY_WAL_TAIL_READ_SIZE);
+	ibuf_create(&relay->send_buf, &cord()->slabc, RELAY_SEND_BUF_SIZE);
+
 	/*
 	 * Setup garbage collection trigger.
 	 * Not needed for anonymous replicas, since they
@@ -1043,6 +1565,8 @@ relay_subscribe_f(va_list ap)
 	 */
 	trigger_clear(&on_close_log);
 	wal_clear_watcher(&relay->wal_watcher, cbus_process);
+	ibuf_destroy(&relay->wal_tail_buf);
+	ibuf_destroy(&relay->send_buf);
 
 	/* Join ack reader fiber. */
 	fiber_cancel(reader);
@@ -1068,11 +1592,117 @@ relay_subscribe_f(va_list ap)
 	return -1;
 }
 
+/** The main function of a relay running in its own thread. */
+static int
+relay_subscribe_f(va_list ap)
+{
+	struct relay *relay = va_arg(ap, struct relay *);
+
+	coio_enable();
+	relay_set_cord_name(relay->io->fd);
+
+	return relay_subscribe_run(relay);
+}
+
+/** Wake up the tx fiber waiting for the relay to stop. */
+static void
+relay_thread_exit_f(struct cmsg *msg)
+{
+	struct relay *relay = container_of(msg, struct relay, thread_exit_msg);
+	relay->is_thread_done = true;
+	fiber_wakeup(relay->tx_fiber);
+}
+
+/** Notify tx that the relay running in the pool thread has stopped. */
+static void
+relay_thread_exit(struct relay *relay)
+{
+	static const struct cmsg_hop route[] = {
+		{relay_thread_exit_f, NULL}
+	};
+	cmsg_init(&relay->thread_exit_msg, route);
+	cpipe_push(&relay->thread->tx_pipe, &relay->thread_exit_msg);
+}
+
+/** The main function of a relay running in the pool thread. */
+static int
+relay_subscribe_fiber_f(va_list ap)
+{
+	struct relay *relay = va_arg(ap, struct relay *);
+	try {
+		relay_subscribe_run(relay);
+	} catch (Exception *e) {
+		relay_set_error(relay, e);
+	}
+	/* The error has been logged and is kept in the relay diag. */
+	diag_clear(diag_get());
+	relay_thread_exit(relay);
+	return 0;
+}
+
+/** Start the relay in the pool thread. */
+static void
+relay_thread_start_f(struct cmsg *msg)
+{
+	struct relay *relay = container_of(msg, struct relay, thread_start_msg);
+	char name[FIBER_NAME_MAX];
+	relay_format_name(relay->io->fd, name, sizeof(name));
+	struct fiber *f = fiber_new(name, relay_subscribe_fiber_f);
+	if (f == NULL) {
+		diag_move(diag_get(), &relay->diag);
+		relay_thread_exit(relay);
+		return;
+	}
+	fiber_start(f, relay);
+}
+
+/**
+ * Run the relay as a fiber in one of the pool threads and wait
+ * for it to stop.
+ */
+static int
+relay_subscribe_in_pool(struct relay *relay)
+{
+	static const struct cmsg_hop route[] = {
+		{relay_thread_start_f, NULL}
+	};
+	struct relay_thread *thread = relay_thread_next();
+	thread->relay_count++;
+	relay->thread = thread;
+	relay->tx_fiber = fiber();
+	relay->is_thread_done = false;
+	cmsg_init(&relay->thread_start_msg, route);
+	cpipe_push(&thread->thread_pipe, &relay->thread_start_msg);
+	/* Like cord_cojoin(), the wait can't be cancelled. */
+	while (!relay->is_thread_done)
+		fiber_yield();
+	thread->relay_count--;
+	relay->thread = NULL;
+	relay->tx_fiber = NULL;
+	assert(!diag_is_empty(&relay->diag));
+	diag_set_error(diag_get(), diag_last_error(&relay->diag));
+	return -1;
+}
+
+/** Create a set of space ids from a MsgPack array. */
+static struct mh_i32_t *
+relay_space_filter_new(const char *data)
+{
+	struct mh_i32_t *filter = mh_i32_new();
+	uint32_t count = mp_decode_array(&data);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t space_id = mp_decode_uint(&data);
+		mh_i32_put(filter, &space_id, NULL, NULL);
+	}
+	return filter;
+}
+
 /** Replication acceptor fiber handler. */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter, uint64_t sent_raft_term)
+		uint32_t replica_id_filter, const char *replica_space_filter,
+		uint64_t sent_raft_term)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -1118,11 +1748,21 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
+	if (replica_space_filter != NULL) {
+		relay->space_filter =
+			relay_space_filter_new(replica_space_filter);
+	}
+	relay->filter_tsn = 0;
 
-	int rc = cord_costart(&relay->cord, "subscribe",
-			      relay_subscribe_f, relay);
-	if (rc == 0)
-		rc = cord_cojoin(&relay->cord);
+	int rc;
+	if (replication_relay_threads > 0) {
+		rc = relay_subscribe_in_pool(relay);
+	} else {
+		rc = cord_costart(&relay->cord, "subscribe",
+				  relay_subscribe_f, relay);
+		if (rc == 0)
+			rc = cord_cojoin(&relay->cord);
+	}
 	if (rc != 0)
 		diag_raise();
 }
@@ -1130,15 +1770,66 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 static void
 relay_send(struct relay *relay, struct xrow_header *packet)
 {
+	ERROR_INJECT(ERRINJ_RELAY_SEND_DELAY, relay_flush(relay));
 	ERROR_INJECT_YIELD(ERRINJ_RELAY_SEND_DELAY);
 
 	packet->sync = relay->sync;
-	relay->last_row_time = ev_monotonic_now(loop());
-	coio_write_xrow(relay->io, packet);
+	RegionGuard region_guard(&fiber()->gc);
+	int iovcnt;
+	struct iovec iov[XROW_IOVMAX];
+	xrow_to_iovec(packet, iov, &iovcnt);
+	size_t size = 0;
+	for (int i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	relay->sent_bytes += size;
+	if (!relay->is_buffering) {
+		/*
+		 * Take the time before the write, which may yield, so
+		 * that it equals last_heartbeat_time if a heartbeat is
+		 * sent, see relay_send_heartbeat().
+		 */
+		double now = ev_monotonic_now(loop());
+		if (coio_writev(relay->io, iov, iovcnt, 0) < 0)
+			diag_raise();
+		relay->last_row_time = now;
+	} else {
+		/*
+		 * Batch the rows so that a lagging replica gets them in
+		 * big writes rather than a syscall per row. The buffer is
+		 * flushed at the end of the WAL event and before yields.
+		 */
+		char *dst = (char *)xibuf_alloc(&relay->send_buf, size);
+		for (int i = 0; i < iovcnt; i++) {
+			memcpy(dst, iov[i].iov_base, iov[i].iov_len);
+			dst += iov[i].iov_len;
+		}
+		if (ibuf_used(&relay->send_buf) >= RELAY_SEND_BUF_SIZE)
+			relay_flush(relay);
+	}
 
 	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
-	if (inj != NULL && inj->dparam > 0)
+	if (inj != NULL && inj->dparam > 0) {
+		relay_flush(relay);
 		fiber_sleep(inj->dparam);
+	}
+}
+
+/**
+ * Write the rows accumulated in the send buffer to the socket. The
+ * rows are considered sent only after they are written, so the time
+ * of the last sent row is updated here rather than in relay_send().
+ */
+static void
+relay_flush(struct relay *relay)
+{
+	struct ibuf *buf = &relay->send_buf;
+	if (!relay->is_buffering || ibuf_used(buf) == 0)
+		return;
+	double now = ev_monotonic_now(loop());
+	if (coio_write(relay->io, buf->rpos, ibuf_used(buf)) < 0)
+		diag_raise();
+	relay->last_row_time = now;
+	ibuf_reset(buf);
 }
 
 static void
@@ -1206,6 +1897,39 @@ relay_push_raft(struct relay *relay, const struct raft_request *req)
 	relay_push_raft_msg(relay);
 }
 
+/**
+ * Apply the space filter requested by the replica to a row. A row of
+ * a user space that isn't in the filter is skipped unless it commits
+ * a transaction, in which case it's replaced with a NOP to promote the
+ * vclock on the replica. Returns false if the row should be skipped.
+ */
+static bool
+relay_filter_row(struct relay *relay, struct xrow_header *packet)
+{
+	if (iproto_type_is_dml(packet->type) && packet->type != IPROTO_NOP) {
+		struct request request;
+		xrow_decode_dml_xc(packet, &request, 0);
+		if (!space_id_is_system(request.space_id) &&
+		    mh_i32_find(relay->space_filter, request.space_id,
+				NULL) == mh_end(relay->space_filter)) {
+			if (!packet->is_commit)
+				return false;
+			packet->type = IPROTO_NOP;
+			packet->bodycnt = 0;
+		}
+	}
+	/*
+	 * The replica expects the TSN to be equal to the LSN of the first
+	 * row of the transaction, which might have been skipped.
+	 */
+	if (relay->filter_tsn == 0)
+		relay->filter_tsn = packet->lsn;
+	packet->tsn = relay->filter_tsn;
+	if (packet->is_commit)
+		relay->filter_tsn = 0;
+	return true;
+}
+
 /** Send a single row to the client. */
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *packet)
@@ -1276,10 +2000,15 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 				cbus_process(&relay->tx_endpoint);
 				if (relay->sent_raft_term >= req.term)
 					break;
+				relay_flush(relay);
 				fiber_yield();
 			}
 		}
+		if (relay->space_filter != NULL &&
+		    !relay_filter_row(relay, packet))
+			return;
 		relay_send(relay, packet);
+		relay->sent_rows++;
 		relay->is_sending_tx = !packet->is_commit;
 	}
 }
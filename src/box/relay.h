@@ -40,8 +40,22 @@ extern "C" {
 struct iostream;
 struct relay;
 struct replica;
+struct replication_hist;
 struct tt_uuid;
 struct vclock;
+struct zstd_iostream_stat;
+
+/** Statistics of the data sent by a relay to the replica. */
+struct relay_send_stat {
+	/** Number of data rows sent. */
+	uint64_t rows;
+	/** Number of bytes sent, including heartbeats. */
+	uint64_t bytes;
+	/** Data rows sent per second recently. */
+	double rows_per_sec;
+	/** Bytes sent per second recently. */
+	double bytes_per_sec;
+};
 
 enum relay_state {
 	/**
@@ -62,6 +76,17 @@ enum relay_state {
 struct relay *
 relay_new(struct replica *replica);
 
+/**
+ * Start the relay thread pool if relays are configured to run in
+ * a pool of threads rather than each in its own thread.
+ */
+void
+relay_init(void);
+
+/** Stop the relay thread pool. Called on shutdown. */
+void
+relay_free(void);
+
 /** Cancel a running relay. Called on shutdown. */
 void
 relay_cancel(struct relay *relay);
@@ -100,6 +125,22 @@ relay_last_row_time(const struct relay *relay);
 double
 relay_txn_lag(const struct relay *relay);
 
+/**
+ * Returns true and fills @a stat with the known traffic statistics if
+ * the stream sent to the replica is compressed.
+ */
+bool
+relay_compression_stat(const struct relay *relay,
+		       struct zstd_iostream_stat *stat);
+
+/** Fills @a stat with the known statistics of the data sent. */
+void
+relay_send_stat(const struct relay *relay, struct relay_send_stat *stat);
+
+/** Returns the histograms of the relay statistics. */
+struct replication_hist *
+relay_hist(struct relay *relay);
+
 /**
  * Makes the relay issue a new vclock sync request and returns the sync to wait
  * for.
@@ -131,6 +172,19 @@ void
 relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 		   uint32_t replica_version_id);
 
+/**
+ * Send a checkpoint file instead of the initial JOIN rows. The
+ * replica recovers the data from the file, see IPROTO_JOIN_FILE.
+ *
+ * @param io        client connection
+ * @param sync      sync from incoming JOIN request
+ * @param vclock    vclock of the checkpoint
+ * @param path      path to the memtx snapshot file of the checkpoint
+ */
+void
+relay_initial_join_files(struct iostream *io, uint64_t sync,
+			 const struct vclock *vclock, const char *path);
+
 /**
  * Send final JOIN rows to the replica.
  *
@@ -144,11 +198,16 @@ relay_final_join(struct iostream *io, uint64_t sync,
 /**
  * Subscribe a replica to updates.
  *
+ * @param replica_space_filter MsgPack array of the ids of the user
+ *                             spaces whose rows are sent to the replica
+ *                             or NULL if rows of all spaces are sent.
+ *
  * @return none.
  */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter, uint64_t sent_raft_term);
+		uint32_t replica_id_filter, const char *replica_space_filter,
+		uint64_t sent_raft_term);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -41,6 +41,7 @@
 #include "error.h"
 #include "raft.h"
 #include "relay.h"
+#include "replication_hist.h"
 #include "sio.h"
 
 uint32_t instance_id = REPLICA_ID_NIL;
@@ -61,6 +62,12 @@ double replication_synchro_timeout = 5.0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 int replication_threads = 1;
+int replication_relay_threads = 0;
+int replication_compression_level = 0;
+bool replication_join_files = false;
+uint32_t *replication_spaces = NULL;
+int replication_space_count = 0;
+int replication_txn_group_size = 1;
 
 bool cfg_replication_anon = true;
 struct tt_uuid cfg_bootstrap_leader_uuid;
@@ -199,7 +206,7 @@ replicaset_set_sync_quorum(void)
 }
 
 void
-replication_init(int num_threads)
+replication_init(int num_threads, int num_relay_threads)
 {
 	memset(&replicaset, 0, sizeof(replicaset));
 	replica_hash_new(&replicaset.hash);
@@ -219,11 +226,13 @@ replication_init(int num_threads)
 	diag_create(&replicaset.applier.diag);
 
 	replication_threads = num_threads;
+	replication_relay_threads = num_relay_threads;
 
 	/* The local instance is always part of the quorum. */
 	replicaset.healthy_count = 1;
 
 	applier_init();
+	relay_init();
 }
 
 void
@@ -236,10 +245,12 @@ replication_free(void)
 	 */
 	replicaset_foreach(replica)
 		relay_cancel(replica->relay);
+	relay_free();
 
 	diag_destroy(&replicaset.applier.diag);
 	trigger_destroy(&replicaset.on_ack);
 	trigger_destroy(&replicaset.on_relay_thread_start);
+	free(replication_spaces);
 
 	applier_free();
 }
@@ -1381,6 +1392,16 @@ replicaset_next(struct replica *replica)
 	return replica_hash_next(&replicaset.hash, replica);
 }
 
+void
+replicaset_reset_stat(void)
+{
+	replicaset_foreach(replica) {
+		if (replica->applier != NULL)
+			replication_hist_reset(&replica->applier->hist);
+		replication_hist_reset(relay_hist(replica->relay));
+	}
+}
+
 /** \sa replicaset_find_join_master. */
 static struct replica *
 replicaset_find_join_master_auto(void)
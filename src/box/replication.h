@@ -211,6 +211,40 @@ extern bool replication_skip_conflict;
 /** How many threads to use for decoding incoming replication stream. */
 extern int replication_threads;
 
+/**
+ * Number of threads running relays to replicas. 0 means that each
+ * relay runs in its own thread.
+ */
+extern int replication_relay_threads;
+
+/**
+ * Zstd compression level of the replication stream requested from
+ * masters on JOIN and SUBSCRIBE, 0 if compression is disabled.
+ */
+extern int replication_compression_level;
+
+/**
+ * If set, a new replica asks the master to send its latest checkpoint
+ * files on join instead of a stream of rows read from a read view.
+ */
+extern bool replication_join_files;
+
+/**
+ * Ids of the user spaces whose rows are requested from masters on
+ * SUBSCRIBE or NULL if rows of all spaces are requested.
+ */
+extern uint32_t *replication_spaces;
+
+/** Number of elements in replication_spaces. */
+extern int replication_space_count;
+
+/**
+ * Max number of consecutive transactions received from a master that
+ * are applied as one transaction and written to WAL in one journal
+ * entry. 1 means that each transaction is applied separately.
+ */
+extern int replication_txn_group_size;
+
 /**
  * A list of triggers fired once quorum of "healthy" connections is acquired.
  */
@@ -241,7 +275,7 @@ double
 replication_disconnect_timeout(void);
 
 void
-replication_init(int num_threads);
+replication_init(int num_threads, int num_relay_threads);
 
 void
 replication_free(void);
@@ -474,6 +508,10 @@ replicaset_next(struct replica *replica);
 	for (struct replica *var = replicaset_first(); \
 	     var != NULL; var = replicaset_next(var))
 
+/** Reset the replication histograms of all the replicas. */
+void
+replicaset_reset_stat(void);
+
 /**
  * Set numeric replica-set-local id of remote replica.
  * table. Add replica to the replica set vclock with LSN = 0.
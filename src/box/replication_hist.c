@@ -0,0 +1,84 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "replication_hist.h"
+
+#include "fiber.h"
+#include "histogram.h"
+#include "say.h"
+#include "trivia/util.h"
+
+/** Time span between two bytes_per_sec samples, in seconds. */
+static const double REPLICATION_HIST_RATE_INTERVAL = 1.0;
+
+/** Collect a bytes_per_sec sample, even if no bytes were transferred. */
+static void
+replication_hist_bytes_timer_cb(struct ev_loop *loop, struct ev_timer *timer,
+				int events)
+{
+	(void)events;
+	struct replication_hist *hist = (struct replication_hist *)timer->data;
+	double now = ev_monotonic_now(loop);
+	double elapsed = now - hist->bytes_time;
+	if (elapsed <= 0)
+		return;
+	histogram_collect(hist->bytes_per_sec, hist->bytes / elapsed);
+	hist->bytes = 0;
+	hist->bytes_time = now;
+}
+
+void
+replication_hist_create(struct replication_hist *hist)
+{
+	enum { KB = 1024, MB = 1024 * KB };
+	static const int64_t buckets[] = {
+		0,
+		  1 * KB,   2 * KB,   5 * KB,  10 * KB,  20 * KB,  50 * KB,
+		100 * KB, 200 * KB, 500 * KB,
+		  1 * MB,   2 * MB,   5 * MB,  10 * MB,  20 * MB,  50 * MB,
+		100 * MB, 200 * MB, 500 * MB, 1000 * MB,
+	};
+	if (latency_create(&hist->lag) != 0 ||
+	    latency_create(&hist->latency) != 0)
+		panic("failed to allocate replication histograms");
+	hist->bytes_per_sec = histogram_new(buckets, lengthof(buckets));
+	if (hist->bytes_per_sec == NULL)
+		panic("failed to allocate replication histograms");
+	histogram_collect(hist->bytes_per_sec, 0);
+	hist->bytes = 0;
+	hist->bytes_time = ev_monotonic_now(loop());
+	ev_timer_init(&hist->bytes_timer, replication_hist_bytes_timer_cb,
+		      REPLICATION_HIST_RATE_INTERVAL,
+		      REPLICATION_HIST_RATE_INTERVAL);
+	hist->bytes_timer.data = hist;
+	ev_timer_start(loop(), &hist->bytes_timer);
+}
+
+void
+replication_hist_destroy(struct replication_hist *hist)
+{
+	ev_timer_stop(loop(), &hist->bytes_timer);
+	latency_destroy(&hist->lag);
+	latency_destroy(&hist->latency);
+	histogram_delete(hist->bytes_per_sec);
+}
+
+void
+replication_hist_reset(struct replication_hist *hist)
+{
+	latency_reset(&hist->lag);
+	latency_reset(&hist->latency);
+	histogram_reset(hist->bytes_per_sec);
+	histogram_collect(hist->bytes_per_sec, 0);
+	hist->bytes = 0;
+	hist->bytes_time = ev_monotonic_now(loop());
+	ev_timer_again(loop(), &hist->bytes_timer);
+}
+
+void
+replication_hist_collect_bytes(struct replication_hist *hist, uint64_t bytes)
+{
+	hist->bytes += bytes;
+}
@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "latency.h"
+#include "tarantool_ev.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct histogram;
+
+/**
+ * Distributions of the metrics of a replication stream, reported by
+ * box.stat.replication(). Each applier and relay has one. All the
+ * values are collected in the tx thread.
+ */
+struct replication_hist {
+	/** Transaction lag, in seconds. */
+	struct latency lag;
+	/**
+	 * Applier: time between the start of applying a transaction and
+	 * its WAL write. Relay: round trip of a heartbeat and its ack.
+	 * In seconds.
+	 */
+	struct latency latency;
+	/** Bytes received (applier) or sent (relay) per second. */
+	struct histogram *bytes_per_sec;
+	/** Bytes accounted since the last bytes_per_sec sample. */
+	uint64_t bytes;
+	/** Time of the last bytes_per_sec sample. */
+	double bytes_time;
+	/**
+	 * Timer collecting a bytes_per_sec sample every second, including
+	 * the intervals with no bytes transferred.
+	 */
+	struct ev_timer bytes_timer;
+};
+
+/** Initialize replication histograms. Panics on memory error. */
+void
+replication_hist_create(struct replication_hist *hist);
+
+/** Destroy replication histograms. */
+void
+replication_hist_destroy(struct replication_hist *hist);
+
+/** Forget all the collected values. */
+void
+replication_hist_reset(struct replication_hist *hist);
+
+/**
+ * Account @a bytes transferred. They are added to the next
+ * bytes_per_sec sample collected by the timer.
+ */
+void
+replication_hist_collect_bytes(struct replication_hist *hist, uint64_t bytes);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -60,6 +60,37 @@ result_process_perform(struct result_processor *p, int *rc,
 	space_upgrade_unref(p->upgrade);
 }
 
+/**
+ * Same as result_process_perform(), but for an array of @a count tuples
+ * returned by index_get_many(). Tuples in the array are referenced; if
+ * a transformation fails, all of them are unreferenced.
+ */
+static inline void
+result_process_perform_many(struct result_processor *p, int *rc,
+			    struct tuple **results, uint32_t count)
+{
+	if (likely(p->upgrade == NULL))
+		return;
+	for (uint32_t i = 0; *rc == 0 && i < count; i++) {
+		if (results[i] == NULL)
+			continue;
+		struct tuple *tuple = space_upgrade_apply(p->upgrade,
+							  results[i]);
+		if (tuple == NULL) {
+			for (uint32_t j = 0; j < count; j++) {
+				if (results[j] != NULL)
+					tuple_unref(results[j]);
+			}
+			*rc = -1;
+			break;
+		}
+		tuple_ref(tuple);
+		tuple_unref(results[i]);
+		results[i] = tuple;
+	}
+	space_upgrade_unref(p->upgrade);
+}
+
 /**
  * A shortcut for
  *
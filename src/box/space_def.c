@@ -45,6 +45,7 @@ const struct space_opts space_opts_default = {
 	/* .view = */ false,
 	/* .is_sync = */ false,
 	/* .defer_deletes = */ false,
+	/* .field_offset_count = */ 0,
 	/* .sql        = */ NULL,
 	/* .constraint_def = */ NULL,
 	/* .constraint_count = */ 0,
@@ -81,6 +82,8 @@ const struct opt_def space_opts_reg[] = {
 	OPT_DEF("view", OPT_BOOL, struct space_opts, is_view),
 	OPT_DEF("is_sync", OPT_BOOL, struct space_opts, is_sync),
 	OPT_DEF("defer_deletes", OPT_BOOL, struct space_opts, defer_deletes),
+	OPT_DEF("field_offsets", OPT_UINT32, struct space_opts,
+		field_offset_count),
 	OPT_DEF("sql", OPT_STRPTR, struct space_opts, sql),
 	OPT_DEF_CUSTOM("constraint", space_opts_parse_constraint),
 	OPT_DEF_CUSTOM("foreign_key", space_opts_parse_foreign_key),
@@ -96,7 +99,8 @@ space_tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 {
 	return tuple_format_new(vtab, engine, keys, key_count,
 				def->fields, def->field_count,
-				def->exact_field_count, def->dict,
+				def->exact_field_count,
+				def->opts.field_offset_count, def->dict,
 				def->opts.is_temporary, def->opts.is_ephemeral,
 				def->opts.constraint_def,
 				def->opts.constraint_count, def->format_data,
@@ -81,6 +81,13 @@ struct space_opts {
 	 * which should speed up writes, but may also slow down reads.
 	 */
 	bool defer_deletes;
+	/**
+	 * Number of leading fields whose offsets are stored in the
+	 * tuple field map even if they are not indexed. Makes access
+	 * to such fields O(1) at the cost of 4 bytes per field per
+	 * tuple.
+	 */
+	uint32_t field_offset_count;
 	/** SQL statement that produced this space. */
 	char *sql;
 	/** Array of constraints. Can be NULL if constraints_count == 0. */
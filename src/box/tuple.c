@@ -310,7 +310,8 @@ runtime_tuple_format_new(const char *format_data, size_t format_data_len,
 				 /*engine=*/NULL, /*keys=*/NULL,
 				 /*key_count=*/0, /*space_fields=*/fields,
 				 /*space_field_count=*/field_count,
-				 /*exact_field_count=*/0,  /*dict=*/dict,
+				 /*exact_field_count=*/0,
+				 /*field_offset_count=*/0, /*dict=*/dict,
 				 /*is_temporary=*/false, /*is_reusable=*/true,
 				 /*constraint_def=*/NULL,
 				 /*constraint_count=*/0,
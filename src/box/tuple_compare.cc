@@ -1084,6 +1084,28 @@ field_compare<FIELD_TYPE_STRING>(const char **field_a, const char **field_b)
 	return r;
 }
 
+template <>
+inline int
+field_compare<FIELD_TYPE_INTEGER>(const char **field_a, const char **field_b)
+{
+	return mp_compare_integer_with_type(*field_a, mp_typeof(**field_a),
+					    *field_b, mp_typeof(**field_b));
+}
+
+template <>
+inline int
+field_compare<FIELD_TYPE_DOUBLE>(const char **field_a, const char **field_b)
+{
+	return mp_compare_as_double(*field_a, *field_b);
+}
+
+template <>
+inline int
+field_compare<FIELD_TYPE_UUID>(const char **field_a, const char **field_b)
+{
+	return mp_compare_uuid(*field_a, *field_b);
+}
+
 template <int TYPE>
 static inline int
 field_compare_and_next(const char **field_a, const char **field_b);
@@ -1115,6 +1137,62 @@ field_compare_and_next<FIELD_TYPE_STRING>(const char **field_a,
 	return r;
 }
 
+template <>
+inline int
+field_compare_and_next<FIELD_TYPE_INTEGER>(const char **field_a,
+					   const char **field_b)
+{
+	int r = field_compare<FIELD_TYPE_INTEGER>(field_a, field_b);
+	mp_next(field_a);
+	mp_next(field_b);
+	return r;
+}
+
+template <>
+inline int
+field_compare_and_next<FIELD_TYPE_DOUBLE>(const char **field_a,
+					  const char **field_b)
+{
+	int r = field_compare<FIELD_TYPE_DOUBLE>(field_a, field_b);
+	mp_next(field_a);
+	mp_next(field_b);
+	return r;
+}
+
+template <>
+inline int
+field_compare_and_next<FIELD_TYPE_UUID>(const char **field_a,
+					const char **field_b)
+{
+	int r = mp_compare_uuid(*field_a, *field_b);
+	*field_a += mp_sizeof_uuid();
+	*field_b += mp_sizeof_uuid();
+	return r;
+}
+
+/*
+ * Compare two fields of a nullable key part. NULL (either MP_NIL or
+ * an absent optional field) is less than any other value. Sets
+ * was_null_met if both fields are NULL.
+ */
+template <int TYPE>
+static inline int
+field_compare_nullable(const char *field_a, const char *field_b,
+		       bool *was_null_met)
+{
+	enum mp_type a_type = field_a != NULL ? mp_typeof(*field_a) : MP_NIL;
+	enum mp_type b_type = field_b != NULL ? mp_typeof(*field_b) : MP_NIL;
+	if (a_type == MP_NIL) {
+		if (b_type != MP_NIL)
+			return -1;
+		*was_null_met = true;
+		return 0;
+	} else if (b_type == MP_NIL) {
+		return 1;
+	}
+	return field_compare<TYPE>(&field_a, &field_b);
+}
+
 /* Tuple comparator */
 namespace /* local symbols */ {
 
@@ -1214,6 +1292,82 @@ struct TupleCompare<0, TYPE, MORE_TYPES...> {
 					format_a, format_b, field_a, field_b);
 	}
 };
+
+/**
+ * Nullable key definition comparator. PART is the number of the key part.
+ * Since a nullable field may be absent, fields are always looked up with
+ * tuple_field_raw() rather than decoded sequentially.
+ */
+template <int PART, int IDX, int TYPE, int ...MORE_TYPES>
+struct FieldCompareNullable { };
+
+template <int PART, int IDX, int TYPE, int IDX2, int TYPE2, int ...MORE_TYPES>
+struct FieldCompareNullable<PART, IDX, TYPE, IDX2, TYPE2, MORE_TYPES...>
+{
+	inline static int compare(struct tuple *tuple_a,
+				  struct tuple *tuple_b,
+				  struct tuple_format *format_a,
+				  struct tuple_format *format_b,
+				  struct key_def *key_def,
+				  bool was_null_met)
+	{
+		const char *field_a, *field_b;
+		field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
+					  tuple_field_map(tuple_a), IDX);
+		field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
+					  tuple_field_map(tuple_b), IDX);
+		int r = field_compare_nullable<TYPE>(field_a, field_b,
+						     &was_null_met);
+		if (r != 0)
+			return r;
+		/*
+		 * Compare the extended (primary key) parts only if NULLs
+		 * were met, see tuple_compare_slowpath().
+		 */
+		if (PART + 1 == key_def->unique_part_count && !was_null_met)
+			return 0;
+		return FieldCompareNullable<PART + 1, IDX2, TYPE2, MORE_TYPES...>::
+			compare(tuple_a, tuple_b, format_a, format_b,
+				key_def, was_null_met);
+	}
+};
+
+template <int PART, int IDX, int TYPE>
+struct FieldCompareNullable<PART, IDX, TYPE>
+{
+	inline static int compare(struct tuple *tuple_a,
+				  struct tuple *tuple_b,
+				  struct tuple_format *format_a,
+				  struct tuple_format *format_b,
+				  struct key_def *,
+				  bool was_null_met)
+	{
+		const char *field_a, *field_b;
+		field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
+					  tuple_field_map(tuple_a), IDX);
+		field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
+					  tuple_field_map(tuple_b), IDX);
+		return field_compare_nullable<TYPE>(field_a, field_b,
+						    &was_null_met);
+	}
+};
+
+template <int IDX, int TYPE, int ...MORE_TYPES>
+struct TupleCompareNullable
+{
+	static int compare(struct tuple *tuple_a, hint_t tuple_a_hint,
+			   struct tuple *tuple_b, hint_t tuple_b_hint,
+			   struct key_def *key_def)
+	{
+		assert(key_def->is_nullable);
+		int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
+		if (rc != 0)
+			return rc;
+		return FieldCompareNullable<0, IDX, TYPE, MORE_TYPES...>::
+			compare(tuple_a, tuple_b, tuple_format(tuple_a),
+				tuple_format(tuple_b), key_def, false);
+	}
+};
 } /* end of anonymous namespace */
 
 struct comparator_signature {
@@ -1241,6 +1395,29 @@ static const comparator_signature cmp_arr[] = {
 	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
 	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
 	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
+
+	COMPARATOR(0, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_DOUBLE)
+	COMPARATOR(0, FIELD_TYPE_UUID)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_UNSIGNED)
+	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_STRING)
+	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_UUID)
+	COMPARATOR(0, FIELD_TYPE_UUID    , 1, FIELD_TYPE_INTEGER)
+
+	/* Secondary keys extended with a primary key. */
+	COMPARATOR(1, FIELD_TYPE_UNSIGNED, 0, FIELD_TYPE_UNSIGNED)
+	COMPARATOR(1, FIELD_TYPE_STRING  , 0, FIELD_TYPE_UNSIGNED)
+	COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_UNSIGNED)
+	COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_UNSIGNED)
+	COMPARATOR(1, FIELD_TYPE_UNSIGNED, 0, FIELD_TYPE_STRING)
+	COMPARATOR(1, FIELD_TYPE_STRING  , 0, FIELD_TYPE_STRING)
+	COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_INTEGER)
+	COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_INTEGER)
+	COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_UUID)
+	COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_UUID)
 };
 
 #undef COMPARATOR
@@ -1272,6 +1449,27 @@ field_compare_with_key<FIELD_TYPE_STRING>(const char **field, const char **key)
 	return r;
 }
 
+template <>
+inline int
+field_compare_with_key<FIELD_TYPE_INTEGER>(const char **field, const char **key)
+{
+	return field_compare<FIELD_TYPE_INTEGER>(field, key);
+}
+
+template <>
+inline int
+field_compare_with_key<FIELD_TYPE_DOUBLE>(const char **field, const char **key)
+{
+	return field_compare<FIELD_TYPE_DOUBLE>(field, key);
+}
+
+template <>
+inline int
+field_compare_with_key<FIELD_TYPE_UUID>(const char **field, const char **key)
+{
+	return field_compare<FIELD_TYPE_UUID>(field, key);
+}
+
 template <int TYPE>
 static inline int
 field_compare_with_key_and_next(const char **field_a, const char **field_b);
@@ -1303,6 +1501,30 @@ field_compare_with_key_and_next<FIELD_TYPE_STRING>(const char **field_a,
 	return r;
 }
 
+template <>
+inline int
+field_compare_with_key_and_next<FIELD_TYPE_INTEGER>(const char **field_a,
+						    const char **field_b)
+{
+	return field_compare_and_next<FIELD_TYPE_INTEGER>(field_a, field_b);
+}
+
+template <>
+inline int
+field_compare_with_key_and_next<FIELD_TYPE_DOUBLE>(const char **field_a,
+						   const char **field_b)
+{
+	return field_compare_and_next<FIELD_TYPE_DOUBLE>(field_a, field_b);
+}
+
+template <>
+inline int
+field_compare_with_key_and_next<FIELD_TYPE_UUID>(const char **field_a,
+						 const char **field_b)
+{
+	return field_compare_and_next<FIELD_TYPE_UUID>(field_a, field_b);
+}
+
 /* Tuple with key comparator */
 namespace /* local symbols */ {
 
@@ -1401,6 +1623,69 @@ struct TupleCompareWithKey<0, 0, TYPE, MORE_TYPES...>
 	}
 };
 
+/**
+ * Nullable key definition comparator with key. See FieldCompareNullable.
+ */
+template <int FLD_ID, int IDX, int TYPE, int ...MORE_TYPES>
+struct FieldCompareWithKeyNullable {};
+
+template <int FLD_ID, int IDX, int TYPE, int IDX2, int TYPE2, int ...MORE_TYPES>
+struct FieldCompareWithKeyNullable<FLD_ID, IDX, TYPE, IDX2, TYPE2,
+				   MORE_TYPES...>
+{
+	inline static int
+	compare(struct tuple *tuple, const char *key, uint32_t part_count,
+		struct tuple_format *format)
+	{
+		const char *field = tuple_field_raw(format, tuple_data(tuple),
+						    tuple_field_map(tuple),
+						    IDX);
+		bool was_null_met = false;
+		int r = field_compare_nullable<TYPE>(field, key, &was_null_met);
+		if (r || part_count == FLD_ID + 1)
+			return r;
+		mp_next(&key);
+		return FieldCompareWithKeyNullable<FLD_ID + 1, IDX2, TYPE2,
+						   MORE_TYPES...>::
+			compare(tuple, key, part_count, format);
+	}
+};
+
+template <int FLD_ID, int IDX, int TYPE>
+struct FieldCompareWithKeyNullable<FLD_ID, IDX, TYPE> {
+	inline static int
+	compare(struct tuple *tuple, const char *key, uint32_t,
+		struct tuple_format *format)
+	{
+		const char *field = tuple_field_raw(format, tuple_data(tuple),
+						    tuple_field_map(tuple),
+						    IDX);
+		bool was_null_met = false;
+		return field_compare_nullable<TYPE>(field, key, &was_null_met);
+	}
+};
+
+template <int IDX, int TYPE, int ...MORE_TYPES>
+struct TupleCompareWithKeyNullable
+{
+	static int
+	compare(struct tuple *tuple, hint_t tuple_hint,
+		const char *key, uint32_t part_count,
+		hint_t key_hint, struct key_def *key_def)
+	{
+		assert(key_def->is_nullable);
+		(void)key_def;
+		/* Part count can be 0 in wildcard searches. */
+		if (part_count == 0)
+			return 0;
+		int rc = hint_cmp(tuple_hint, key_hint);
+		if (rc != 0)
+			return rc;
+		return FieldCompareWithKeyNullable<0, IDX, TYPE, MORE_TYPES...>::
+			compare(tuple, key, part_count, tuple_format(tuple));
+	}
+};
+
 } /* end of anonymous namespace */
 
 struct comparator_with_key_signature
@@ -1426,8 +1711,66 @@ static const comparator_with_key_signature cmp_wk_arr[] = {
 	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_UNSIGNED)
 	KEY_COMPARATOR(1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
 	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
+
+	KEY_COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_UNSIGNED)
+	KEY_COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_STRING)
+	KEY_COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_UUID)
+	KEY_COMPARATOR(0, FIELD_TYPE_UUID    , 1, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(0, FIELD_TYPE_DOUBLE)
+	KEY_COMPARATOR(0, FIELD_TYPE_UUID)
+
+	/* Secondary keys extended with a primary key. */
+	KEY_COMPARATOR(1, FIELD_TYPE_UNSIGNED, 0, FIELD_TYPE_UNSIGNED)
+	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 0, FIELD_TYPE_UNSIGNED)
+	KEY_COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_UNSIGNED)
+	KEY_COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_UNSIGNED)
+	KEY_COMPARATOR(1, FIELD_TYPE_UNSIGNED, 0, FIELD_TYPE_STRING)
+	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 0, FIELD_TYPE_STRING)
+	KEY_COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_UUID)
+	KEY_COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_UUID)
+};
+
+struct nullable_comparator_signature {
+	tuple_compare_t f;
+	tuple_compare_with_key_t f_wk;
+	uint32_t p[64];
+};
+
+#define NULLABLE_COMPARATOR(...) \
+	{ TupleCompareNullable<__VA_ARGS__>::compare, \
+	  TupleCompareWithKeyNullable<__VA_ARGS__>::compare, \
+	  { __VA_ARGS__, UINT32_MAX } },
+
+/**
+ * Comparators for nullable key definitions without collations and JSON
+ * paths. Unlike cmp_wk_arr, both comparators are looked up by the exact
+ * match of key parts. Any key part of a nullable key definition may be
+ * NULL so the signature doesn't include part nullability.
+ */
+static const nullable_comparator_signature cmp_nullable_arr[] = {
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_UNSIGNED)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_STRING)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_INTEGER)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_DOUBLE)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_UUID)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_UNSIGNED, 0, FIELD_TYPE_UNSIGNED)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_STRING  , 0, FIELD_TYPE_UNSIGNED)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_UNSIGNED)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_DOUBLE  , 0, FIELD_TYPE_UNSIGNED)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_UNSIGNED)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_STRING  , 0, FIELD_TYPE_STRING)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_INTEGER)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_INTEGER , 0, FIELD_TYPE_UUID)
+	NULLABLE_COMPARATOR(1, FIELD_TYPE_UUID    , 0, FIELD_TYPE_UUID)
 };
 
+#undef NULLABLE_COMPARATOR
+
 /**
  * A functional index tuple compare.
  * tuple_a_hint and tuple_b_hint are expected to be valid pointers to functional
@@ -2205,6 +2548,33 @@ key_def_set_compare_func_fast(struct key_def *def)
 	def->tuple_compare_with_key = cmp_wk;
 }
 
+/**
+ * Sets pre-compiled comparators for a nullable key definition if
+ * available. Leaves the comparators unchanged otherwise.
+ */
+static void
+key_def_set_compare_func_nullable(struct key_def *def)
+{
+	assert(def->is_nullable);
+	assert(!def->has_json_paths);
+	assert(!key_def_has_collation(def));
+
+	for (uint32_t k = 0; k < lengthof(cmp_nullable_arr); k++) {
+		const nullable_comparator_signature *sig = &cmp_nullable_arr[k];
+		uint32_t i = 0;
+		for (; i < def->part_count; i++) {
+			if (def->parts[i].fieldno != sig->p[i * 2] ||
+			    def->parts[i].type != sig->p[i * 2 + 1])
+				break;
+		}
+		if (i == def->part_count && sig->p[i * 2] == UINT32_MAX) {
+			def->tuple_compare = sig->f;
+			def->tuple_compare_with_key = sig->f_wk;
+			return;
+		}
+	}
+}
+
 template<bool is_nullable, bool has_optional_parts>
 static void
 key_def_set_compare_func_plain(struct key_def *def)
@@ -2270,6 +2640,8 @@ key_def_set_compare_func(struct key_def *def)
 			assert(!def->is_nullable && !def->has_optional_parts);
 			key_def_set_compare_func_plain<false, false>(def);
 		}
+		if (def->is_nullable && !key_def_has_collation(def))
+			key_def_set_compare_func_nullable(def);
 	} else {
 		if (def->is_nullable && def->has_optional_parts) {
 			key_def_set_compare_func_json<true, true>(def);
@@ -88,6 +88,8 @@ tuple_format_cmp(const struct tuple_format *format1,
 
 	if (a->exact_field_count != b->exact_field_count)
 		return a->exact_field_count - b->exact_field_count;
+	if (a->field_offset_count != b->field_offset_count)
+		return a->field_offset_count - b->field_offset_count;
 	if (a->total_field_count != b->total_field_count)
 		return a->total_field_count - b->total_field_count;
 
@@ -515,6 +517,7 @@ tuple_format_create(struct tuple_format *format, struct key_def *const *keys,
 		    struct tuple_constraint_def *constraint_def,
 		    uint32_t constraint_count)
 {
+	format->field_offsets_size = 0;
 	format->min_field_count =
 		tuple_format_min_field_count(keys, key_count, fields,
 					     field_count);
@@ -603,6 +606,29 @@ tuple_format_create(struct tuple_format *format, struct key_def *const *keys,
 
 	assert(tuple_format_field(format, 0)->offset_slot == TUPLE_OFFSET_SLOT_NIL
 	       || json_token_is_multikey(&tuple_format_field(format, 0)->token));
+	/*
+	 * Trailing fields that are added to the format only to store
+	 * their offsets are optional.
+	 */
+	for (uint32_t i = format->field_offset_count; i > field_count; i--) {
+		struct tuple_field *field = tuple_format_field(format, i - 1);
+		if (field->is_key_part)
+			break;
+		field->nullable_action = ON_CONFLICT_ACTION_NONE;
+	}
+	/*
+	 * Allocate offset slots for the leading fields that are not
+	 * indexed so that they can be accessed without decoding the
+	 * preceding fields. The first field doesn't need one.
+	 */
+	int index_slot = current_slot;
+	for (uint32_t i = 1; i < format->field_offset_count; i++) {
+		struct tuple_field *field = tuple_format_field(format, i);
+		if (field->offset_slot == TUPLE_OFFSET_SLOT_NIL)
+			field->offset_slot = --current_slot;
+	}
+	format->field_offsets_size =
+		(index_slot - current_slot) * sizeof(uint32_t);
 	size_t field_map_size = -current_slot * sizeof(uint32_t);
 	if (field_map_size > INT16_MAX) {
 		/** tuple->data_offset is 15 bits */
@@ -738,7 +764,8 @@ tuple_format_destroy_fields(struct tuple_format *format)
 
 static struct tuple_format *
 tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
-		   uint32_t space_field_count, struct tuple_dictionary *dict)
+		   uint32_t space_field_count, uint32_t field_offset_count,
+		   struct tuple_dictionary *dict)
 {
 	/* Size of area to store JSON paths data. */
 	uint32_t path_pool_size = 0;
@@ -756,6 +783,8 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 			path_pool_size += part->path_len;
 		}
 	}
+	/* Fields with offset slots are accessed like indexed ones. */
+	index_field_count = MAX(index_field_count, field_offset_count);
 	uint32_t field_count = MAX(space_field_count, index_field_count);
 
 	uint32_t allocation_size = sizeof(struct tuple_format) + path_pool_size;
@@ -796,6 +825,7 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 	format->refs = 0;
 	format->id = FORMAT_ID_NIL;
 	format->index_field_count = index_field_count;
+	format->field_offset_count = field_offset_count;
 	format->exact_field_count = 0;
 	format->min_field_count = 0;
 	format->epoch = 0;
@@ -878,13 +908,15 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 		 struct key_def * const *keys, uint16_t key_count,
 		 const struct field_def *space_fields,
 		 uint32_t space_field_count, uint32_t exact_field_count,
-		 struct tuple_dictionary *dict, bool is_temporary,
-		 bool is_reusable, struct tuple_constraint_def *constraint_def,
+		 uint32_t field_offset_count, struct tuple_dictionary *dict,
+		 bool is_temporary, bool is_reusable,
+		 struct tuple_constraint_def *constraint_def,
 		 uint32_t constraint_count, const char *format_data,
 		 size_t format_data_len)
 {
 	struct tuple_format *format =
-		tuple_format_alloc(keys, key_count, space_field_count, dict);
+		tuple_format_alloc(keys, key_count, space_field_count,
+				   field_offset_count, dict);
 	if (format == NULL)
 		return NULL;
 	if (vtab != NULL)
@@ -1087,6 +1119,14 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 	}
 	defined_field_count = MIN(defined_field_count,
 				  tuple_format_field_count(format));
+	/*
+	 * Fields past index_field_count have no offset slots so
+	 * there is no point in decoding them if they aren't to be
+	 * validated.
+	 */
+	if (!validate)
+		defined_field_count = MIN(defined_field_count,
+					  format->index_field_count);
 
 	void *required_fields = NULL;
 	uint32_t required_fields_sz = BITMAP_SIZE(format->total_field_count);
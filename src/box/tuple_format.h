@@ -251,9 +251,22 @@ struct tuple_format {
 	uint32_t exact_field_count;
 	/**
 	 * The longest field array prefix in which the last
-	 * element is used by an index.
+	 * element is used by an index or has an offset slot
+	 * because of field_offset_count.
 	 */
 	uint32_t index_field_count;
+	/**
+	 * Number of leading top-level fields that have offset
+	 * slots in the field map regardless of whether they are
+	 * indexed, see space_opts::field_offset_count.
+	 */
+	uint32_t field_offset_count;
+	/**
+	 * Size of the field map part (in bytes) occupied by
+	 * offset slots allocated only because of
+	 * field_offset_count.
+	 */
+	uint16_t field_offsets_size;
 	/**
 	 * The minimal field count that must be specified.
 	 * index_field_count <= min_field_count <= field_count.
@@ -394,6 +407,8 @@ tuple_format_unref(struct tuple_format *format)
  * @param space_fields Array of fields, defined in a space format.
  * @param space_field_count Length of @a space_fields.
  * @param exact_field_count Exact field count for format.
+ * @param field_offset_count Number of leading fields that have
+ *                           offset slots even if not indexed.
  * @param is_temporary Set if format belongs to temporary space.
  * @param is_reusable Set if format may be reused.
  * @param constraint_def - Array of constraint definitions.
@@ -409,8 +424,9 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 		 struct key_def * const *keys, uint16_t key_count,
 		 const struct field_def *space_fields,
 		 uint32_t space_field_count, uint32_t exact_field_count,
-		 struct tuple_dictionary *dict, bool is_temporary,
-		 bool is_reusable, struct tuple_constraint_def *constraint_def,
+		 uint32_t field_offset_count, struct tuple_dictionary *dict,
+		 bool is_temporary, bool is_reusable,
+		 struct tuple_constraint_def *constraint_def,
 		 uint32_t constraint_count, const char *format_data,
 		 size_t format_data_len);
 
@@ -432,8 +448,8 @@ simple_tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 			struct key_def * const *keys, uint16_t key_count)
 {
 	return tuple_format_new(vtab, engine, keys, key_count,
-				NULL, 0, 0, NULL, false, false, NULL, 0, NULL,
-				0);
+				NULL, 0, 0, 0, NULL, false, false, NULL, 0,
+				NULL, 0);
 }
 
 /**
@@ -35,6 +35,10 @@
 #include "coll/coll.h"
 #include <math.h>
 
+/* Inline the hash functions so that XXH3 can be fully optimized. */
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
 /* Tuple and key hasher */
 namespace {
 
@@ -474,3 +478,102 @@ key_hash_slowpath(const char *key, struct key_def *key_def)
 
 	return PMurHash32_Result(h, carry, total_size);
 }
+
+/**
+ * Mix a key field into a 64-bit XXH3 hash. The previous hash is used
+ * as the seed so the first part is hashed with the zero seed, which
+ * is the fastest XXH3 variant. Field values are normalized as in
+ * tuple_hash_field(), but unlike it the field pointer is always
+ * advanced past the field.
+ */
+static inline uint64_t
+tuple_hash_field_xxh3(uint64_t h, const char **field, enum field_type type,
+		      struct coll *coll)
+{
+	char buf[9]; /* enough to store MP_INT/MP_UINT/MP_DOUBLE */
+	const char *f = *field;
+	uint32_t size;
+
+	if (type == FIELD_TYPE_DOUBLE) {
+		double value;
+		if (mp_read_double_lossy(field, &value) == -1)
+			unreachable();
+		size = mp_encode_double(buf, value) - buf;
+		assert(size <= sizeof(buf));
+		return XXH3_64bits_withSeed(buf, size, h);
+	}
+
+	switch (mp_typeof(**field)) {
+	case MP_STR:
+		f = mp_decode_str(field, &size);
+		if (coll != NULL) {
+			/*
+			 * Collation hash functions are built on top of
+			 * incremental MurmurHash3 so mix its result in.
+			 */
+			uint32_t ch = HASH_SEED;
+			uint32_t carry = 0;
+			uint32_t total_size = coll->hash(f, size, &ch, &carry,
+							 coll);
+			ch = PMurHash32_Result(ch, carry, total_size);
+			return XXH3_64bits_withSeed(&ch, sizeof(ch), h);
+		}
+		break;
+	case MP_FLOAT:
+	case MP_DOUBLE: {
+		double iptr;
+		double val = mp_typeof(**field) == MP_FLOAT ?
+			     mp_decode_float(field) :
+			     mp_decode_double(field);
+		if (!isfinite(val) || modf(val, &iptr) != 0 ||
+		    val < -exp2(63) || val >= exp2(64)) {
+			size = *field - f;
+			break;
+		}
+		char *data;
+		if (val >= 0)
+			data = mp_encode_uint(buf, (uint64_t)val);
+		else
+			data = mp_encode_int(buf, (int64_t)val);
+		size = data - buf;
+		assert(size <= sizeof(buf));
+		f = buf;
+		break;
+	}
+	default:
+		mp_next(field);
+		size = *field - f;
+		break;
+	}
+	return XXH3_64bits_withSeed(f, size, h);
+}
+
+uint64_t
+tuple_hash_xxh3(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey);
+	assert(!key_def->for_func_index);
+	uint64_t h = 0;
+	for (struct key_part *part = key_def->parts;
+	     part < key_def->parts + key_def->part_count; part++) {
+		const char *field = tuple_field_by_part(tuple, part,
+							MULTIKEY_NONE);
+		if (field == NULL) {
+			const char null = 0xc0;
+			h = XXH3_64bits_withSeed(&null, 1, h);
+			continue;
+		}
+		h = tuple_hash_field_xxh3(h, &field, part->type, part->coll);
+	}
+	return h;
+}
+
+uint64_t
+key_hash_xxh3(const char *key, struct key_def *key_def)
+{
+	uint64_t h = 0;
+	for (struct key_part *part = key_def->parts;
+	     part < key_def->parts + key_def->part_count; part++)
+		h = tuple_hash_field_xxh3(h, &key, part->type, part->coll);
+	return h;
+}
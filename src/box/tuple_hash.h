@@ -30,11 +30,14 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stdint.h>
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct key_def;
+struct tuple;
 
 /**
  * Initialize tuple_hash() and key_hash() function for the key_def
@@ -43,6 +46,22 @@ struct key_def;
 void
 key_def_set_hash_func(struct key_def *def);
 
+/**
+ * Calculate a 64-bit XXH3 hash of a tuple key. Key parts are
+ * normalized the same way as for key_def::tuple_hash so values
+ * that are equal according to the key definition have equal
+ * hashes. Unlike key_def::tuple_hash, the result is never stored
+ * on disk and may change between releases.
+ */
+uint64_t
+tuple_hash_xxh3(struct tuple *tuple, struct key_def *key_def);
+
+/**
+ * Calculate a 64-bit XXH3 hash of a key, see tuple_hash_xxh3().
+ */
+uint64_t
+key_hash_xxh3(const char *key, struct key_def *key_def);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
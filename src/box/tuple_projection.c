@@ -0,0 +1,125 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "tuple_projection.h"
+
+#include <string.h>
+
+#include "diag.h"
+#include "error.h"
+#include "json/json.h"
+#include "msgpuck.h"
+#include "schema_def.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+#include "tuple.h"
+
+struct tuple_projection *
+tuple_projection_decode(const char *data, int index_base,
+			struct region *region)
+{
+	if (mp_typeof(*data) != MP_ARRAY) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "fields must be an array");
+		return NULL;
+	}
+	uint32_t field_count = mp_decode_array(&data);
+	size_t size = sizeof(struct tuple_projection) +
+		      field_count * sizeof(struct tuple_projection_field);
+	struct tuple_projection *projection =
+		xregion_aligned_alloc(region, size,
+				      alignof(struct tuple_projection));
+	projection->index_base = index_base;
+	projection->field_count = field_count;
+	for (uint32_t i = 0; i < field_count; i++) {
+		struct tuple_projection_field *field = &projection->fields[i];
+		memset(field, 0, sizeof(*field));
+		switch (mp_typeof(*data)) {
+		case MP_UINT: {
+			uint64_t fieldno = mp_decode_uint(&data);
+			if (fieldno < (uint64_t)index_base ||
+			    fieldno - index_base >= BOX_FIELD_MAX) {
+				const char *msg = tt_sprintf(
+					"invalid field number %llu in fields",
+					(unsigned long long)fieldno);
+				diag_set(ClientError, ER_ILLEGAL_PARAMS, msg);
+				return NULL;
+			}
+			field->fieldno = fieldno - index_base;
+			break;
+		}
+		case MP_STR:
+			field->path = mp_decode_str(&data, &field->path_len);
+			if (field->path_len == 0 ||
+			    json_path_validate(field->path, field->path_len,
+					       index_base) != 0) {
+				const char *msg = tt_sprintf(
+					"invalid field path '%.*s' in fields",
+					(int)field->path_len, field->path);
+				diag_set(ClientError, ER_ILLEGAL_PARAMS, msg);
+				return NULL;
+			}
+			field->path_hash = field_name_hash(field->path,
+							   field->path_len);
+			break;
+		default:
+			diag_set(ClientError, ER_ILLEGAL_PARAMS,
+				 "fields must contain field numbers or paths");
+			return NULL;
+		}
+	}
+	return projection;
+}
+
+size_t
+tuple_projection_lookup(struct tuple_projection *projection,
+			struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	const char *data = tuple_data(tuple);
+	const uint32_t *field_map = tuple_field_map(tuple);
+	size_t size = mp_sizeof_array(projection->field_count);
+	for (uint32_t i = 0; i < projection->field_count; i++) {
+		struct tuple_projection_field *field = &projection->fields[i];
+		const char *field_data;
+		if (field->path == NULL) {
+			field_data = tuple_field_raw(format, data, field_map,
+						     field->fieldno);
+		} else {
+			field_data = tuple_field_raw_by_full_path(
+				format, data, field_map, field->path,
+				field->path_len, field->path_hash,
+				projection->index_base);
+		}
+		field->data = field_data;
+		if (field_data == NULL) {
+			size += mp_sizeof_nil();
+			continue;
+		}
+		mp_next(&field_data);
+		field->data_end = field_data;
+		size += field->data_end - field->data;
+	}
+	return size;
+}
+
+char *
+tuple_projection_encode(const struct tuple_projection *projection, char *buf)
+{
+	buf = mp_encode_array(buf, projection->field_count);
+	for (uint32_t i = 0; i < projection->field_count; i++) {
+		const struct tuple_projection_field *field =
+			&projection->fields[i];
+		if (field->data == NULL) {
+			buf = mp_encode_nil(buf);
+			continue;
+		}
+		size_t size = field->data_end - field->data;
+		memcpy(buf, field->data, size);
+		buf += size;
+	}
+	return buf;
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct region;
+struct tuple;
+
+/** A field selected by a tuple projection. */
+struct tuple_projection_field {
+	/** Zero-based number of the field. Used if path is NULL. */
+	uint32_t fieldno;
+	/** Full JSON path to the field, points to the decoded MsgPack. */
+	const char *path;
+	/** Length of @a path. */
+	uint32_t path_len;
+	/** Hash of @a path, see field_name_hash(). */
+	uint32_t path_hash;
+	/** Field data found by the last tuple_projection_lookup(). */
+	const char *data;
+	/** End of @a data. */
+	const char *data_end;
+};
+
+/**
+ * A list of fields to return instead of a whole tuple, e.g. from
+ * SELECT. A projected tuple is a MsgPack array which contains the
+ * selected fields in the order they are listed in the projection,
+ * with MP_NIL in place of absent fields.
+ */
+struct tuple_projection {
+	/** Index base of array indexes in field paths. */
+	int index_base;
+	/** Number of fields in the projection. */
+	uint32_t field_count;
+	/** Projection fields. */
+	struct tuple_projection_field fields[0];
+};
+
+/**
+ * Decode a tuple projection from a MsgPack array of field numbers
+ * and full JSON paths. Field numbers and array indexes in paths
+ * start from @a index_base. The projection is allocated on
+ * @a region and refers to the paths in @a data, so it must not
+ * outlive it. Returns NULL and sets diag on error.
+ */
+struct tuple_projection *
+tuple_projection_decode(const char *data, int index_base,
+			struct region *region);
+
+/**
+ * Look up the projected fields of a tuple. Returns the size of the
+ * projected tuple MsgPack. The fields are stored in the projection
+ * until the next lookup so the projected tuple can be encoded with
+ * tuple_projection_encode().
+ */
+size_t
+tuple_projection_lookup(struct tuple_projection *projection,
+			struct tuple *tuple);
+
+/**
+ * Encode the projected tuple found by the last lookup to @a buf,
+ * which must have room for the size returned by the lookup.
+ * Returns the end of the encoded data.
+ */
+char *
+tuple_projection_encode(const struct tuple_projection *projection, char *buf);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -106,6 +106,12 @@ enum txn_flag {
 	 * rolled back at commit.
 	 */
 	TXN_IS_ABORTED_BY_TIMEOUT = 0x100,
+	/**
+	 * Transaction was started implicitly for a single statement
+	 * and is committed right after it, so no user code can access
+	 * the transaction statements.
+	 */
+	TXN_IS_AUTOCOMMIT = 0x200,
 };
 
 enum {
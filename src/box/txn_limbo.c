@@ -166,7 +166,6 @@ txn_limbo_append(struct txn_limbo *limbo, uint32_t id, struct txn *txn)
 	}
 	e->txn = txn;
 	e->lsn = -1;
-	e->ack_count = 0;
 	e->is_commit = false;
 	e->is_rollback = false;
 	rlist_add_tail_entry(&limbo->queue, e, in_queue);
@@ -236,20 +235,13 @@ txn_limbo_assign_local_lsn(struct txn_limbo *limbo,
 	assert(entry->lsn == -1);
 	assert(lsn > 0);
 
-	entry->lsn = lsn;
 	/*
 	 * The entry just got its LSN after a WAL write. It could
-	 * happen that this LSN was already ACKed by some
-	 * replicas. Update the ACK counter to take them into
-	 * account.
+	 * happen that this LSN was already ACKed by some replicas.
+	 * They are taken into account by the next ACK, because the
+	 * quorum is computed from the limbo vclock.
 	 */
-	struct vclock_iterator iter;
-	vclock_iterator_init(&iter, &limbo->vclock);
-	int ack_count = 0;
-	vclock_foreach(&iter, vc)
-		ack_count += vc.lsn >= lsn;
-	assert(ack_count >= entry->ack_count);
-	entry->ack_count = ack_count;
+	entry->lsn = lsn;
 }
 
 void
@@ -633,6 +625,59 @@ txn_limbo_read_demote(struct txn_limbo *limbo, uint32_t prev_id, int64_t lsn)
 	return txn_limbo_read_promote(limbo, REPLICA_ID_NIL, prev_id, lsn);
 }
 
+/**
+ * Get the biggest LSN of the limbo owner which is ACKed by a quorum of
+ * replicas. It is the k-th biggest component of the limbo vclock, where
+ * k is the synchro quorum. Returns 0 if there is no such LSN.
+ */
+static inline int64_t
+txn_limbo_quorum_lsn(struct txn_limbo *limbo)
+{
+	return vclock_nth_largest(&limbo->vclock,
+				  replication_synchro_quorum);
+}
+
+/**
+ * Confirm the sync transactions ACKed by a quorum of replicas, if
+ * there are new ones.
+ */
+static void
+txn_limbo_confirm_acked(struct txn_limbo *limbo)
+{
+	int64_t quorum_lsn = txn_limbo_quorum_lsn(limbo);
+	/*
+	 * The quorum LSN doesn't depend on the queue length, so most
+	 * of the ACKs not completing any transaction are filtered out
+	 * here without looking at the queue.
+	 */
+	if (quorum_lsn <= limbo->confirmed_lsn)
+		return;
+	/*
+	 * Find the last sync transaction covered by the quorum. All the
+	 * entries before it are going to be removed from the queue by
+	 * the confirmation, so the lookup doesn't make ACK processing
+	 * depend on the queue length.
+	 */
+	struct txn_limbo_entry *e;
+	int64_t confirm_lsn = -1;
+	rlist_foreach_entry(e, &limbo->queue, in_queue) {
+		/*
+		 * Sync transactions need to collect acks. Async
+		 * transactions are automatically committed right
+		 * after all the previous sync transactions are.
+		 */
+		if (!txn_has_flag(e->txn, TXN_WAIT_ACK))
+			continue;
+		if (e->lsn == -1 || e->lsn > quorum_lsn)
+			break;
+		confirm_lsn = e->lsn;
+	}
+	if (confirm_lsn <= limbo->confirmed_lsn)
+		return;
+	txn_limbo_write_confirm(limbo, confirm_lsn);
+	txn_limbo_read_confirm(limbo, confirm_lsn);
+}
+
 void
 txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 {
@@ -665,31 +710,7 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	if (lsn == prev_lsn)
 		return;
 	vclock_follow(&limbo->vclock, replica_id, lsn);
-	struct txn_limbo_entry *e;
-	int64_t confirm_lsn = -1;
-	rlist_foreach_entry(e, &limbo->queue, in_queue) {
-		assert(e->ack_count <= VCLOCK_MAX);
-		if (e->lsn > lsn)
-			break;
-		/*
-		 * Sync transactions need to collect acks. Async
-		 * transactions are automatically committed right
-		 * after all the previous sync transactions are.
-		 */
-		if (!txn_has_flag(e->txn, TXN_WAIT_ACK)) {
-			continue;
-		} else if (e->lsn <= prev_lsn) {
-			continue;
-		} else if (++e->ack_count < replication_synchro_quorum) {
-			continue;
-		} else {
-			confirm_lsn = e->lsn;
-		}
-	}
-	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
-		return;
-	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
+	txn_limbo_confirm_acked(limbo);
 }
 
 /**
@@ -1224,23 +1245,8 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 {
 	if (rlist_empty(&limbo->queue) || txn_limbo_is_frozen(limbo))
 		return;
-	struct txn_limbo_entry *e;
-	int64_t confirm_lsn = -1;
-	rlist_foreach_entry(e, &limbo->queue, in_queue) {
-		assert(e->ack_count <= VCLOCK_MAX);
-		if (!txn_has_flag(e->txn, TXN_WAIT_ACK)) {
-			continue;
-		} else if (e->ack_count < replication_synchro_quorum) {
-			continue;
-		} else {
-			confirm_lsn = e->lsn;
-			assert(confirm_lsn > 0);
-		}
-	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
-		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
-	}
+	if (!txn_limbo_is_ro(limbo) && !limbo->is_in_rollback)
+		txn_limbo_confirm_acked(limbo);
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
 	 * there can be non-transactional waiters, such as CONFIRM
@@ -43,6 +43,7 @@
 #include "coio_task.h"
 #include "replication.h"
 #include "iproto_constants.h"
+#include "wal_tail.h"
 
 enum {
 	/**
@@ -173,6 +174,12 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Rows recently written to the WAL, read by relays instead
+	 * of WAL files. Started when the first watcher is attached
+	 * unless disabled, see wal_set_tail_size().
+	 */
+	struct wal_tail tail;
 };
 
 struct wal_msg {
@@ -448,6 +455,7 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	vclock_create(&writer->vclock);
 	vclock_create(&writer->checkpoint_vclock);
 	rlist_create(&writer->watchers);
+	wal_tail_create(&writer->tail, 0);
 
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
@@ -461,6 +469,7 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	wal_tail_destroy(&writer->tail);
 }
 
 /** WAL writer thread routine. */
@@ -763,6 +772,34 @@ wal_set_checkpoint_threshold(int64_t threshold)
 		  wal_set_checkpoint_threshold_f);
 }
 
+struct wal_set_tail_size_msg {
+	struct cbus_call_msg base;
+	size_t size;
+};
+
+static int
+wal_set_tail_size_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_tail_size_msg *msg;
+	msg = (struct wal_set_tail_size_msg *)data;
+	/* Started again with the new size on the next write. */
+	wal_tail_set_capacity(&writer->tail, msg->size);
+	return 0;
+}
+
+void
+wal_set_tail_size(size_t size)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_tail_size_msg msg;
+	msg.size = size;
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe, &msg.base,
+		  wal_set_tail_size_f);
+}
+
 void
 wal_set_queue_max_size(int64_t size)
 {
@@ -1061,6 +1098,17 @@ wal_write_to_disk(struct cmsg *msg)
 		goto done;
 	}
 
+	/*
+	 * Start buffering rows for relays. The buffer starts at the
+	 * vclock preceding this batch.
+	 */
+	if (!wal_tail_is_started(&writer->tail) &&
+	    writer->tail.capacity > 0 && !rlist_empty(&writer->watchers) &&
+	    wal_tail_start(&writer->tail, &writer->vclock) != 0) {
+		say_warn_ratelimited("failed to start WAL tail buffer");
+		diag_clear(diag_get());
+	}
+
 	/* Ensure there's enough disk space before writing anything. */
 	if (wal_fallocate(writer, wal_msg->approx_len) != 0) {
 		err_code = JOURNAL_ENTRY_ERR_IO;
@@ -1176,6 +1224,11 @@ done:
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
+	if (wal_tail_is_started(&writer->tail)) {
+		stailq_foreach_entry(entry, &wal_msg->commit, fifo)
+			wal_tail_append(&writer->tail, entry->rows,
+					entry->n_rows);
+	}
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
@@ -1474,9 +1527,14 @@ static void
 wal_watcher_detach(void *arg)
 {
 	struct wal_watcher *watcher = (struct wal_watcher *) arg;
+	struct wal_writer *writer = &wal_writer_singleton;
 
 	assert(!rlist_empty(&watcher->next));
 	rlist_del_entry(watcher, next);
+	/* Nobody needs the buffered rows anymore. */
+	if (rlist_empty(&writer->watchers) &&
+	    wal_tail_is_started(&writer->tail))
+		wal_tail_stop(&writer->tail);
 }
 
 void
@@ -1502,6 +1560,14 @@ wal_set_watcher(struct wal_watcher *watcher, const char *name,
 		  wal_watcher_attach, watcher, process_cb);
 }
 
+int
+wal_read_tail(struct wal_tail_cursor *cursor, const struct vclock *vclock,
+	      struct ibuf *buf, size_t max_size)
+{
+	return wal_tail_read(&wal_writer_singleton.tail, cursor, vclock,
+			     buf, max_size);
+}
+
 void
 wal_clear_watcher(struct wal_watcher *watcher,
 		  void (*process_cb)(struct cbus_endpoint *))
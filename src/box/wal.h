@@ -38,7 +38,9 @@
 #include "vclock/vclock.h"
 
 struct fiber;
+struct ibuf;
 struct wal_writer;
+struct wal_tail_cursor;
 struct tt_uuid;
 
 enum wal_mode {
@@ -205,6 +207,15 @@ void
 wal_clear_watcher(struct wal_watcher *watcher,
 		  void (*process_cb)(struct cbus_endpoint *));
 
+/**
+ * Copy the rows recently written to the WAL that follow the cursor
+ * position from the WAL tail buffer to @a buf. May be called by a WAL
+ * watcher from its thread. See wal_tail_read() for details.
+ */
+int
+wal_read_tail(struct wal_tail_cursor *cursor, const struct vclock *vclock,
+	      struct ibuf *buf, size_t max_size);
+
 enum wal_mode
 wal_mode(void);
 
@@ -259,6 +270,14 @@ wal_commit_checkpoint(struct wal_checkpoint *checkpoint);
 void
 wal_set_checkpoint_threshold(int64_t threshold);
 
+/**
+ * Set the size of the buffer keeping the rows recently written to
+ * the WAL for relays, see wal_tail.h. Zero size disables the buffer.
+ * The buffer memory is allocated when a relay attaches to the WAL.
+ */
+void
+wal_set_tail_size(size_t size);
+
 /**
  * Set the pending write limit in bytes. Once the limit is reached, new
  * writes are blocked until some previous writes succeed.
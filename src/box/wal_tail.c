@@ -0,0 +1,270 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "wal_tail.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "small/ibuf.h"
+#include "small/region.h"
+#include "small/util.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "xrow.h"
+
+/** Header of a row stored in the WAL tail buffer. */
+struct wal_tail_row {
+	/** Size of the encoded row following the header, 0 for padding. */
+	uint32_t size;
+	/** Replica id of the row. */
+	uint32_t replica_id;
+	/** LSN of the row. */
+	int64_t lsn;
+};
+
+/**
+ * Size occupied by a row in the buffer. Rows are aligned by the header
+ * size, so the space left at the end of the buffer is either empty or
+ * big enough to store a padding header.
+ */
+static inline size_t
+wal_tail_row_bsize(size_t size)
+{
+	return small_align(sizeof(struct wal_tail_row) + size,
+			   sizeof(struct wal_tail_row));
+}
+
+void
+wal_tail_create(struct wal_tail *tail, size_t capacity)
+{
+	tt_pthread_mutex_init(&tail->mutex, NULL);
+	tail->data = NULL;
+	tail->capacity = small_align(capacity, sizeof(struct wal_tail_row));
+	tail->begin = 0;
+	tail->end = 0;
+	vclock_create(&tail->vclock);
+}
+
+void
+wal_tail_destroy(struct wal_tail *tail)
+{
+	free(tail->data);
+	tt_pthread_mutex_destroy(&tail->mutex);
+}
+
+int
+wal_tail_start(struct wal_tail *tail, const struct vclock *vclock)
+{
+	assert(tail->data == NULL);
+	assert(tail->capacity > 0);
+	char *data = malloc(tail->capacity);
+	if (data == NULL) {
+		diag_set(OutOfMemory, tail->capacity, "malloc", "wal tail");
+		return -1;
+	}
+	tt_pthread_mutex_lock(&tail->mutex);
+	tail->data = data;
+	/* Invalidate all cursors opened before. */
+	tail->end += tail->capacity;
+	tail->begin = tail->end;
+	vclock_copy(&tail->vclock, vclock);
+	tt_pthread_mutex_unlock(&tail->mutex);
+	return 0;
+}
+
+void
+wal_tail_stop(struct wal_tail *tail)
+{
+	tt_pthread_mutex_lock(&tail->mutex);
+	char *data = tail->data;
+	tail->data = NULL;
+	tt_pthread_mutex_unlock(&tail->mutex);
+	free(data);
+}
+
+void
+wal_tail_set_capacity(struct wal_tail *tail, size_t capacity)
+{
+	tt_pthread_mutex_lock(&tail->mutex);
+	char *data = tail->data;
+	tail->data = NULL;
+	tail->capacity = small_align(capacity, sizeof(struct wal_tail_row));
+	tt_pthread_mutex_unlock(&tail->mutex);
+	free(data);
+}
+
+/** Evict the oldest row from the buffer. */
+static void
+wal_tail_evict(struct wal_tail *tail)
+{
+	assert(tail->begin < tail->end);
+	size_t offset = tail->begin % tail->capacity;
+	struct wal_tail_row *row = (struct wal_tail_row *)(tail->data + offset);
+	if (row->size == 0) {
+		tail->begin += tail->capacity - offset;
+		return;
+	}
+	if (row->lsn > vclock_get(&tail->vclock, row->replica_id))
+		vclock_follow(&tail->vclock, row->replica_id, row->lsn);
+	tail->begin += wal_tail_row_bsize(row->size);
+}
+
+/** Make sure that @a size bytes following the newest row are free. */
+static void
+wal_tail_reserve(struct wal_tail *tail, size_t size)
+{
+	assert(size <= tail->capacity);
+	while (tail->end + size - tail->begin > tail->capacity)
+		wal_tail_evict(tail);
+}
+
+/** A row encoded before it's appended to the buffer. */
+struct wal_tail_encoded_row {
+	/** The row. */
+	struct xrow_header *row;
+	/** Encoded row data. */
+	struct iovec iov[XROW_IOVMAX];
+	/** Number of the used elements of iov. */
+	int iovcnt;
+	/** Size of the encoded row. */
+	size_t size;
+};
+
+/** Encode a row for appending to the buffer. */
+static void
+wal_tail_encode_row(struct xrow_header *row,
+		    struct wal_tail_encoded_row *encoded)
+{
+	encoded->row = row;
+	xrow_header_encode(row, /*sync=*/0, /*fixheader_len=*/0,
+			   encoded->iov, &encoded->iovcnt);
+	encoded->size = 0;
+	for (int i = 0; i < encoded->iovcnt; i++)
+		encoded->size += encoded->iov[i].iov_len;
+}
+
+/**
+ * Append an encoded row to the buffer. Must be called under the mutex.
+ */
+static void
+wal_tail_append_row(struct wal_tail *tail,
+		    const struct wal_tail_encoded_row *encoded)
+{
+	struct xrow_header *row = encoded->row;
+	size_t size = encoded->size;
+	size_t bsize = wal_tail_row_bsize(size);
+	if (bsize > tail->capacity) {
+		/*
+		 * The row is too big to be buffered. Drop all rows and
+		 * move the positions past it so that readers notice it.
+		 */
+		while (tail->begin < tail->end)
+			wal_tail_evict(tail);
+		if (row->lsn > vclock_get(&tail->vclock, row->replica_id))
+			vclock_follow(&tail->vclock, row->replica_id, row->lsn);
+		tail->end += bsize;
+		tail->begin = tail->end;
+		return;
+	}
+	size_t offset = tail->end % tail->capacity;
+	if (offset + bsize > tail->capacity) {
+		/* The row doesn't fit at the end, pad it and wrap. */
+		size_t pad = tail->capacity - offset;
+		wal_tail_reserve(tail, pad);
+		struct wal_tail_row *padding =
+			(struct wal_tail_row *)(tail->data + offset);
+		memset(padding, 0, sizeof(*padding));
+		tail->end += pad;
+		offset = 0;
+	}
+	wal_tail_reserve(tail, bsize);
+	struct wal_tail_row *header = (struct wal_tail_row *)(tail->data + offset);
+	header->size = size;
+	header->replica_id = row->replica_id;
+	header->lsn = row->lsn;
+	char *pos = (char *)(header + 1);
+	for (int i = 0; i < encoded->iovcnt; i++) {
+		memcpy(pos, encoded->iov[i].iov_base, encoded->iov[i].iov_len);
+		pos += encoded->iov[i].iov_len;
+	}
+	tail->end += bsize;
+}
+
+void
+wal_tail_append(struct wal_tail *tail, struct xrow_header **rows,
+		int row_count)
+{
+	assert(wal_tail_is_started(tail));
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	/* Encode the rows before locking so that readers wait less. */
+	struct wal_tail_encoded_row *encoded =
+		xregion_alloc_array(region, typeof(*encoded), row_count);
+	for (int i = 0; i < row_count; i++)
+		wal_tail_encode_row(rows[i], &encoded[i]);
+	tt_pthread_mutex_lock(&tail->mutex);
+	for (int i = 0; i < row_count; i++)
+		wal_tail_append_row(tail, &encoded[i]);
+	tt_pthread_mutex_unlock(&tail->mutex);
+	region_truncate(region, region_svp);
+}
+
+int
+wal_tail_read(struct wal_tail *tail, struct wal_tail_cursor *cursor,
+	      const struct vclock *vclock, struct ibuf *buf, size_t max_size)
+{
+	int count = 0;
+	size_t copied = 0;
+	tt_pthread_mutex_lock(&tail->mutex);
+	if (tail->data == NULL)
+		goto fail;
+	if (!cursor->is_open) {
+		int cmp = vclock_compare_ignore0(&tail->vclock, vclock);
+		if (cmp != 0 && cmp != -1)
+			goto fail;
+		cursor->pos = tail->begin;
+		cursor->is_open = true;
+	}
+	if (cursor->pos < tail->begin)
+		goto fail;
+	assert(cursor->pos <= tail->end);
+	while (cursor->pos < tail->end && (count == 0 || copied < max_size)) {
+		size_t offset = cursor->pos % tail->capacity;
+		struct wal_tail_row *row =
+			(struct wal_tail_row *)(tail->data + offset);
+		if (row->size == 0) {
+			cursor->pos += tail->capacity - offset;
+			continue;
+		}
+		size_t bsize = wal_tail_row_bsize(row->size);
+		void *dst = ibuf_alloc(buf, bsize);
+		if (dst == NULL)
+			goto fail;
+		memcpy(dst, row, bsize);
+		cursor->pos += bsize;
+		copied += bsize;
+		count++;
+	}
+	tt_pthread_mutex_unlock(&tail->mutex);
+	return count;
+fail:
+	cursor->is_open = false;
+	tt_pthread_mutex_unlock(&tail->mutex);
+	return -1;
+}
+
+int
+wal_tail_decode_row(const char **pos, struct xrow_header *row)
+{
+	const struct wal_tail_row *header = (const struct wal_tail_row *)*pos;
+	const char *data = (const char *)(header + 1);
+	const char *end = data + header->size;
+	*pos += wal_tail_row_bsize(header->size);
+	return xrow_header_decode(row, &data, end, /*end_is_exact=*/true);
+}
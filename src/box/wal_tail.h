@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vclock/vclock.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct ibuf;
+struct xrow_header;
+
+/**
+ * WAL tail buffer keeps the rows recently written to the WAL so that
+ * relays can send them to replicas without reading WAL files.
+ *
+ * The buffer is a ring of encoded rows. Rows are appended by the WAL
+ * thread, the oldest rows are evicted when there's no free space left.
+ * Relay threads copy the rows they haven't sent yet from the buffer
+ * under the mutex. A relay that lags behind the oldest row in the
+ * buffer has to read WAL files.
+ */
+struct wal_tail {
+	/** Protects the buffer from concurrent access. */
+	pthread_mutex_t mutex;
+	/** Buffer memory or NULL if the buffer isn't started. */
+	char *data;
+	/** Size of the buffer memory. */
+	size_t capacity;
+	/**
+	 * Position of the oldest row in the buffer. Positions only
+	 * grow, the offset of a row in the buffer memory is its
+	 * position modulo the capacity.
+	 */
+	uint64_t begin;
+	/** Position following the newest row in the buffer. */
+	uint64_t end;
+	/**
+	 * Vclock preceding the oldest row in the buffer: every row
+	 * written to the WAL before it has an LSN less than or equal
+	 * to the corresponding component of this vclock.
+	 */
+	struct vclock vclock;
+};
+
+/** Position of a reader in the WAL tail buffer. */
+struct wal_tail_cursor {
+	/** Position of the next row to read. */
+	uint64_t pos;
+	/** Set if the position is valid. */
+	bool is_open;
+};
+
+/**
+ * Initialize a WAL tail buffer. The memory is allocated on start.
+ * Zero capacity means that the buffer must not be started.
+ */
+void
+wal_tail_create(struct wal_tail *tail, size_t capacity);
+
+/** Destroy a WAL tail buffer. */
+void
+wal_tail_destroy(struct wal_tail *tail);
+
+/**
+ * Start buffering rows. @a vclock is the vclock of the WAL at the
+ * moment, i.e. the one preceding the next appended row. Returns -1
+ * and sets diag on memory allocation error.
+ */
+int
+wal_tail_start(struct wal_tail *tail, const struct vclock *vclock);
+
+/**
+ * Stop buffering rows and free the buffer memory. All readers have
+ * to read WAL files after that.
+ */
+void
+wal_tail_stop(struct wal_tail *tail);
+
+/**
+ * Change the size of the buffer memory. A started buffer is stopped,
+ * so that it's allocated with the new size when it's started again.
+ */
+void
+wal_tail_set_capacity(struct wal_tail *tail, size_t capacity);
+
+/**
+ * Check if the buffer is started. May only be called by the thread
+ * that appends rows.
+ */
+static inline bool
+wal_tail_is_started(const struct wal_tail *tail)
+{
+	return tail->data != NULL;
+}
+
+/**
+ * Append rows written to the WAL to a started buffer, evicting
+ * the oldest rows if needed.
+ */
+void
+wal_tail_append(struct wal_tail *tail, struct xrow_header **rows,
+		int row_count);
+
+/**
+ * Copy the rows following the cursor position to @a buf. At least one
+ * row is copied if there's any, the rest are copied while the copied
+ * size is less than @a max_size.
+ *
+ * If the cursor isn't open, it's opened at the oldest row provided that
+ * the reader has nothing to read before it, i.e. @a vclock is greater
+ * than or equal to the vclock preceding the oldest row (the zero
+ * component is ignored, because local rows aren't relayed).
+ *
+ * Returns the number of copied rows. If the rows following the cursor
+ * aren't in the buffer, returns -1 and closes the cursor (diag isn't
+ * set). The rows must be read from the WAL files then.
+ */
+int
+wal_tail_read(struct wal_tail *tail, struct wal_tail_cursor *cursor,
+	      const struct vclock *vclock, struct ibuf *buf, size_t max_size);
+
+/**
+ * Decode a row copied by wal_tail_read() and advance @a pos to the next
+ * one. The row body points to the copied data. Returns -1 and sets diag
+ * on decoding error.
+ */
+int
+wal_tail_decode_row(const char **pos, struct xrow_header *row);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -1597,6 +1597,17 @@ xlog_cursor_ensure(struct xlog_cursor *cursor, size_t count)
 		cursor->read_ahead = XLOG_READ_AHEAD_MIN;
 	}
 	cursor->read_offset += readen;
+#ifdef HAVE_POSIX_FADVISE
+	/*
+	 * The file is read sequentially, so ask the kernel to start
+	 * reading the next chunk in background while the rows of
+	 * the current one are being processed.
+	 */
+	if ((size_t)readen == to_load) {
+		(void)posix_fadvise(cursor->fd, cursor->read_offset,
+				    cursor->read_ahead, POSIX_FADV_WILLNEED);
+	}
+#endif /* HAVE_POSIX_FADVISE */
 	return ibuf_used(&cursor->rbuf) >= count ? 0: 1;
 }
 
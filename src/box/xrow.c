@@ -41,6 +41,7 @@
 #include "tt_static.h"
 #include "error.h"
 #include "mp_error.h"
+#include "mp_check_fast.h"
 #include "iproto_constants.h"
 #include "iproto_features.h"
 #include "mpstream/mpstream.h"
@@ -151,7 +152,7 @@ xrow_header_decode(struct xrow_header *header, const char **pos,
 	memset(header, 0, sizeof(struct xrow_header));
 	const char *tmp = *pos;
 	const char * const start = *pos;
-	if (mp_check(&tmp, end) != 0)
+	if (mp_check_fast(&tmp, end) != 0)
 		goto bad_header;
 	if (mp_typeof(**pos) != MP_MAP)
 		goto bad_header;
@@ -218,7 +219,7 @@ xrow_header_decode(struct xrow_header *header, const char **pos,
 	/* Nop requests aren't supposed to have a body. */
 	if (*pos < end && header->type != IPROTO_NOP) {
 		const char *body = *pos;
-		if (mp_check(pos, end))
+		if (mp_check_fast(pos, end))
 			goto bad_body;
 		header->bodycnt = 1;
 		header->body[0].iov_base = (void *) body;
@@ -769,6 +770,19 @@ iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
+void
+iproto_reply_select_chunk(struct obuf *buf, struct obuf_svp *svp,
+			  uint64_t sync, uint64_t schema_version,
+			  uint32_t count)
+{
+	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_CHUNK, sync, schema_version,
+			     obuf_size(buf) - svp->used - IPROTO_HEADER_LEN);
+	struct iproto_body_bin body = iproto_body_bin;
+	body.v_data_len = mp_bswap_u32(count);
+	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+}
+
 /** Reply select with IPROTO_DATA and IPROTO_POSITION. */
 int
 iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
@@ -983,6 +997,9 @@ error:
 		case IPROTO_FETCH_POSITION:
 			request->fetch_position = mp_decode_bool(&value);
 			break;
+		case IPROTO_CHUNK_SIZE:
+			request->chunk_size = mp_decode_uint(&value);
+			break;
 		case IPROTO_TUPLE:
 			request->tuple = value;
 			request->tuple_end = data;
@@ -1015,6 +1032,10 @@ error:
 			request->after_tuple = value;
 			request->after_tuple_end = data;
 			break;
+		case IPROTO_FIELDS:
+			request->fields = value;
+			request->fields_end = data;
+			break;
 		case IPROTO_SPACE_NAME:
 			request->space_name =
 				mp_decode_str(&value, &request->space_name_len);
@@ -1082,6 +1103,14 @@ request_snprint(char *buf, int size, const struct request *request)
 		SNPRINT(total, snprintf, buf, size, ", after_tuple: ");
 		SNPRINT(total, mp_snprint, buf, size, request->after_tuple);
 	}
+	if (request->fields != NULL) {
+		SNPRINT(total, snprintf, buf, size, ", fields: ");
+		SNPRINT(total, mp_snprint, buf, size, request->fields);
+	}
+	if (request->chunk_size != 0) {
+		SNPRINT(total, snprintf, buf, size, ", chunk_size: %u",
+			request->chunk_size);
+	}
 	SNPRINT(total, snprintf, buf, size, "}");
 	return total;
 }
@@ -1105,6 +1134,8 @@ xrow_encode_dml(const struct request *request, struct region *region,
 	       request->header->type != IPROTO_SELECT);
 	assert(request->after_position == NULL);
 	assert(request->after_tuple == NULL);
+	assert(request->fields == NULL);
+	assert(request->chunk_size == 0);
 	assert(!request->fetch_position);
 	const int MAP_LEN_MAX = 40;
 	uint32_t key_len = request->key_end - request->key;
@@ -2017,6 +2048,15 @@ struct replication_request {
 	uint32_t *version_id;
 	/** IPROTO_REPLICA_ANON. */
 	bool *is_anon;
+	/** IPROTO_COMPRESSION_LEVEL. */
+	uint32_t *compression_level;
+	/** IPROTO_JOIN_FILES. */
+	bool *join_files;
+	/** IPROTO_FILE_SIZE. */
+	uint64_t *file_size;
+	/** IPROTO_SPACE_FILTER, raw MsgPack array and its end. */
+	const char **space_filter;
+	const char **space_filter_end;
 };
 
 /** Encode a replication request template. */
@@ -2029,6 +2069,8 @@ xrow_encode_replication_request(struct xrow_header *row,
 	size_t size = XROW_BODY_LEN_MAX;
 	if (req->vclock != NULL)
 		size += mp_sizeof_vclock_ignore0(req->vclock);
+	if (req->space_filter != NULL && *req->space_filter != NULL)
+		size += *req->space_filter_end - *req->space_filter;
 	char *buf = xregion_alloc(&fiber()->gc, size);
 	/* Skip one byte for future map header. */
 	char *data = buf + 1;
@@ -2068,6 +2110,28 @@ xrow_encode_replication_request(struct xrow_header *row,
 		data = mp_encode_uint(data, IPROTO_REPLICA_ANON);
 		data = mp_encode_bool(data, *req->is_anon);
 	}
+	if (req->compression_level != NULL && *req->compression_level != 0) {
+		++map_size;
+		data = mp_encode_uint(data, IPROTO_COMPRESSION_LEVEL);
+		data = mp_encode_uint(data, *req->compression_level);
+	}
+	if (req->join_files != NULL && *req->join_files) {
+		++map_size;
+		data = mp_encode_uint(data, IPROTO_JOIN_FILES);
+		data = mp_encode_bool(data, true);
+	}
+	if (req->file_size != NULL) {
+		++map_size;
+		data = mp_encode_uint(data, IPROTO_FILE_SIZE);
+		data = mp_encode_uint(data, *req->file_size);
+	}
+	if (req->space_filter != NULL && *req->space_filter != NULL) {
+		++map_size;
+		size_t len = *req->space_filter_end - *req->space_filter;
+		data = mp_encode_uint(data, IPROTO_SPACE_FILTER);
+		memcpy(data, *req->space_filter, len);
+		data += len;
+	}
 	if (req->id_filter != NULL) {
 		++map_size;
 		uint32_t id_filter = *req->id_filter;
@@ -2182,6 +2246,55 @@ xrow_decode_replication_request(const struct xrow_header *row,
 			}
 			*req->is_anon = mp_decode_bool(&d);
 			break;
+		case IPROTO_COMPRESSION_LEVEL:
+			if (req->compression_level == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid COMPRESSION_LEVEL");
+				return -1;
+			}
+			*req->compression_level = mp_decode_uint(&d);
+			break;
+		case IPROTO_JOIN_FILES:
+			if (req->join_files == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_BOOL) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid JOIN_FILES flag");
+				return -1;
+			}
+			*req->join_files = mp_decode_bool(&d);
+			break;
+		case IPROTO_FILE_SIZE:
+			if (req->file_size == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid FILE_SIZE");
+				return -1;
+			}
+			*req->file_size = mp_decode_uint(&d);
+			break;
+		case IPROTO_SPACE_FILTER: {
+			if (req->space_filter == NULL)
+				goto skip;
+			const char *begin = d;
+			if (mp_typeof(*d) != MP_ARRAY) {
+space_filter_decode_err:	xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid SPACE_FILTER");
+				return -1;
+			}
+			uint32_t len = mp_decode_array(&d);
+			for (uint32_t i = 0; i < len; i++) {
+				if (mp_typeof(*d) != MP_UINT ||
+				    mp_decode_uint(&d) > UINT32_MAX)
+					goto space_filter_decode_err;
+			}
+			*req->space_filter = begin;
+			*req->space_filter_end = d;
+			break;
+		}
 		case IPROTO_ID_FILTER:
 			if (req->id_filter == NULL)
 				goto skip;
@@ -2247,6 +2360,9 @@ xrow_encode_subscribe(struct xrow_header *row,
 		.is_anon = &cast->is_anon,
 		.id_filter = &cast->id_filter,
 		.version_id = &cast->version_id,
+		.compression_level = &cast->compression_level,
+		.space_filter = &cast->space_filter,
+		.space_filter_end = &cast->space_filter_end,
 	};
 	xrow_encode_replication_request(row, &base_req, IPROTO_SUBSCRIBE);
 }
@@ -2265,6 +2381,9 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		.version_id = &req->version_id,
 		.is_anon = &req->is_anon,
 		.id_filter = &req->id_filter,
+		.compression_level = &req->compression_level,
+		.space_filter = &req->space_filter,
+		.space_filter_end = &req->space_filter_end,
 	};
 	return xrow_decode_replication_request(row, &base_req);
 }
@@ -2277,6 +2396,8 @@ xrow_encode_join(struct xrow_header *row, const struct join_request *req)
 		.instance_uuid = &cast->instance_uuid,
 		.instance_name = cast->instance_name,
 		.version_id = &cast->version_id,
+		.compression_level = &cast->compression_level,
+		.join_files = &cast->join_files,
 	};
 	xrow_encode_replication_request(row, &base_req, IPROTO_JOIN);
 }
@@ -2289,6 +2410,30 @@ xrow_decode_join(const struct xrow_header *row, struct join_request *req)
 		.instance_uuid = &req->instance_uuid,
 		.instance_name = req->instance_name,
 		.version_id = &req->version_id,
+		.compression_level = &req->compression_level,
+		.join_files = &req->join_files,
+	};
+	return xrow_decode_replication_request(row, &base_req);
+}
+
+void
+xrow_encode_join_file(struct xrow_header *row, const struct join_file *req)
+{
+	struct join_file *cast = (struct join_file *)req;
+	const struct replication_request base_req = {
+		.vclock = &cast->vclock,
+		.file_size = &cast->size,
+	};
+	xrow_encode_replication_request(row, &base_req, IPROTO_JOIN_FILE);
+}
+
+int
+xrow_decode_join_file(const struct xrow_header *row, struct join_file *req)
+{
+	memset(req, 0, sizeof(*req));
+	struct replication_request base_req = {
+		.vclock = &req->vclock,
+		.file_size = &req->size,
 	};
 	return xrow_decode_replication_request(row, &base_req);
 }
@@ -212,6 +212,15 @@ struct request {
 	const char *after_tuple;
 	/** End of @after_tuple. */
 	const char *after_tuple_end;
+	/** Fields to return instead of whole tuples (IPROTO_FIELDS). */
+	const char *fields;
+	/** End of @fields. */
+	const char *fields_end;
+	/**
+	 * Number of tuples to send in one IPROTO_CHUNK message in reply
+	 * to SELECT (IPROTO_CHUNK_SIZE), 0 if chunks aren't used.
+	 */
+	uint32_t chunk_size;
 	/** Base field offset for UPDATE/UPSERT, e.g. 0 for C and 1 for Lua. */
 	int index_base;
 	/** Send position of last selected tuple in response if true. */
@@ -597,6 +606,15 @@ struct subscribe_request {
 	uint32_t version_id;
 	/** Flag whether the replica is anon. */
 	bool is_anon;
+	/** Requested compression level of the stream, 0 if disabled. */
+	uint32_t compression_level;
+	/**
+	 * MsgPack array of the ids of the user spaces whose rows need
+	 * to be sent or NULL if rows of all spaces need to be sent.
+	 */
+	const char *space_filter;
+	/** End of the space_filter array. */
+	const char *space_filter_end;
 };
 
 /** Encode SUBSCRIBE request. */
@@ -637,6 +655,10 @@ struct join_request {
 	char instance_name[NODE_NAME_SIZE_MAX];
 	/** Replica's version. */
 	uint32_t version_id;
+	/** Requested compression level of the stream, 0 if disabled. */
+	uint32_t compression_level;
+	/** Set if the replica wants to receive checkpoint files. */
+	bool join_files;
 };
 
 /** Encode JOIN request. */
@@ -647,6 +669,25 @@ xrow_encode_join(struct xrow_header *row, const struct join_request *req);
 int
 xrow_decode_join(const struct xrow_header *row, struct join_request *req);
 
+/**
+ * Header of a checkpoint file sent by the master on join. The file data
+ * follows the header in the stream.
+ */
+struct join_file {
+	/** Vclock of the checkpoint the file belongs to. */
+	struct vclock vclock;
+	/** Size of the file data. */
+	uint64_t size;
+};
+
+/** Encode JOIN_FILE header. */
+void
+xrow_encode_join_file(struct xrow_header *row, const struct join_file *req);
+
+/** Decode JOIN_FILE header. */
+int
+xrow_decode_join_file(const struct xrow_header *row, struct join_file *req);
+
 /**
  * Heartbeat from relay to applier. Follows the replication stream. Same
  * direction.
@@ -778,6 +819,17 @@ void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint64_t schema_version, uint32_t count);
 
+/**
+ * Write an IPROTO_CHUNK header of a chunk of a select response
+ * (see IPROTO_CHUNK_SIZE) to a buffer prepared with
+ * iproto_prepare_select(). The body is the same as the body of
+ * the select response: IPROTO_DATA with an array of @a count tuples.
+ */
+void
+iproto_reply_select_chunk(struct obuf *buf, struct obuf_svp *svp,
+			  uint64_t sync, uint64_t schema_version,
+			  uint32_t count);
+
 /**
  * Write extended select header to a preallocated buffer.
  */
@@ -1149,6 +1201,14 @@ xrow_decode_join_xc(const struct xrow_header *row, struct join_request *req)
 		diag_raise();
 }
 
+/** @copydoc xrow_decode_join_file. */
+static inline void
+xrow_decode_join_file_xc(const struct xrow_header *row, struct join_file *req)
+{
+	if (xrow_decode_join_file(row, req) != 0)
+		diag_raise();
+}
+
 /** @copydoc xrow_decode_register. */
 static inline void
 xrow_decode_register_xc(const struct xrow_header *row,
@@ -0,0 +1,320 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "zstd_iostream.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <zstd.h>
+
+#include "diag.h"
+#include "error.h"
+#include "iostream.h"
+#include "trivia/util.h"
+
+/** The first byte of a zstd frame (the magic number is little-endian). */
+static const unsigned char ZSTD_MAGIC_FIRST_BYTE = ZSTD_MAGICNUMBER & 0xff;
+
+/** Mode of the read direction of a zstd stream. */
+enum zstd_iostream_read_mode {
+	/** Nothing has been read yet. */
+	ZSTD_IOSTREAM_READ_UNKNOWN,
+	/** The peer compresses the data. */
+	ZSTD_IOSTREAM_READ_ZSTD,
+	/** The peer doesn't compress the data. */
+	ZSTD_IOSTREAM_READ_PLAIN,
+};
+
+struct zstd_iostream {
+	/** The wrapped stream. */
+	struct iostream inner;
+	/** Compression context or NULL if writes aren't compressed. */
+	ZSTD_CStream *cstream;
+	/** Decompression context or NULL if reads aren't decompressed. */
+	ZSTD_DStream *dstream;
+	/** Compressed output that hasn't been written yet. */
+	char *wbuf;
+	/** Size of the wbuf memory. */
+	size_t wbuf_size;
+	/** Position of the unwritten output in wbuf. */
+	size_t wpos;
+	/** End of the output in wbuf. */
+	size_t wend;
+	/** Size of the input compressed into wbuf. */
+	size_t wsize;
+	/** Input read from the wrapped stream and not processed yet. */
+	char *rbuf;
+	/** Size of the rbuf memory. */
+	size_t rbuf_size;
+	/** Position of the unprocessed input in rbuf. */
+	size_t rpos;
+	/** End of the input in rbuf. */
+	size_t rend;
+	/** Mode of the read direction. */
+	enum zstd_iostream_read_mode read_mode;
+	/** Traffic statistics. */
+	struct zstd_iostream_stat stat;
+};
+
+static const struct iostream_vtab zstd_iostream_vtab;
+
+static void
+zstd_iostream_delete(struct zstd_iostream *stream)
+{
+	ZSTD_freeCStream(stream->cstream);
+	ZSTD_freeDStream(stream->dstream);
+	free(stream->wbuf);
+	free(stream->rbuf);
+	free(stream);
+}
+
+int
+zstd_iostream_wrap(struct iostream *io, int level, bool decompress)
+{
+	assert(iostream_is_initialized(io));
+	assert(!zstd_iostream_is_wrapped(io));
+	struct zstd_iostream *stream = calloc(1, sizeof(*stream));
+	if (stream == NULL) {
+		diag_set(OutOfMemory, sizeof(*stream), "calloc",
+			 "zstd_iostream");
+		return -1;
+	}
+	if (level > 0) {
+		stream->cstream = ZSTD_createCStream();
+		if (stream->cstream == NULL) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 "failed to create context");
+			goto fail;
+		}
+		size_t rc = ZSTD_CCtx_setParameter(stream->cstream,
+						   ZSTD_c_compressionLevel,
+						   level);
+		if (ZSTD_isError(rc)) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 ZSTD_getErrorName(rc));
+			goto fail;
+		}
+	}
+	if (decompress) {
+		stream->dstream = ZSTD_createDStream();
+		if (stream->dstream == NULL) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "failed to create context");
+			goto fail;
+		}
+		ZSTD_initDStream(stream->dstream);
+		stream->rbuf_size = ZSTD_DStreamInSize();
+		stream->rbuf = malloc(stream->rbuf_size);
+		if (stream->rbuf == NULL) {
+			diag_set(OutOfMemory, stream->rbuf_size, "malloc",
+				 "zstd_iostream");
+			goto fail;
+		}
+	}
+	unsigned flags = io->flags;
+	iostream_move(&stream->inner, io);
+	io->vtab = &zstd_iostream_vtab;
+	io->data = stream;
+	io->fd = stream->inner.fd;
+	io->flags = flags;
+	return 0;
+fail:
+	zstd_iostream_delete(stream);
+	return -1;
+}
+
+int
+zstd_iostream_max_level(void)
+{
+	return ZSTD_maxCLevel();
+}
+
+bool
+zstd_iostream_is_wrapped(const struct iostream *io)
+{
+	return io->vtab == &zstd_iostream_vtab;
+}
+
+void
+zstd_iostream_stat(const struct iostream *io, struct zstd_iostream_stat *stat)
+{
+	assert(zstd_iostream_is_wrapped(io));
+	struct zstd_iostream *stream = io->data;
+	*stat = stream->stat;
+}
+
+static void
+zstd_iostream_destroy(struct iostream *io)
+{
+	struct zstd_iostream *stream = io->data;
+	iostream_destroy(&stream->inner);
+	zstd_iostream_delete(stream);
+}
+
+/**
+ * Make sure there's at least @a size bytes of free space after
+ * the output in wbuf.
+ */
+static int
+zstd_iostream_reserve(struct zstd_iostream *stream, size_t size)
+{
+	if (stream->wend + size <= stream->wbuf_size)
+		return 0;
+	size_t new_size = MAX(stream->wbuf_size * 2, stream->wend + size);
+	char *wbuf = realloc(stream->wbuf, new_size);
+	if (wbuf == NULL) {
+		diag_set(OutOfMemory, new_size, "realloc", "zstd_iostream");
+		return -1;
+	}
+	stream->wbuf = wbuf;
+	stream->wbuf_size = new_size;
+	return 0;
+}
+
+/**
+ * Compress @a input into wbuf. With ZSTD_e_flush, the output is flushed
+ * so that the peer can decompress all the data written so far.
+ */
+static int
+zstd_iostream_compress(struct zstd_iostream *stream, ZSTD_inBuffer *input,
+		       ZSTD_EndDirective mode)
+{
+	while (true) {
+		if (zstd_iostream_reserve(stream, ZSTD_CStreamOutSize()) != 0)
+			return -1;
+		ZSTD_outBuffer output = {
+			stream->wbuf, stream->wbuf_size, stream->wend
+		};
+		size_t rc = ZSTD_compressStream2(stream->cstream, &output,
+						 input, mode);
+		if (ZSTD_isError(rc)) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 ZSTD_getErrorName(rc));
+			return -1;
+		}
+		stream->wend = output.pos;
+		if (input->pos == input->size &&
+		    (mode == ZSTD_e_continue || rc == 0))
+			return 0;
+	}
+}
+
+static ssize_t
+zstd_iostream_writev(struct iostream *io, const struct iovec *iov, int iovcnt)
+{
+	struct zstd_iostream *stream = io->data;
+	if (stream->cstream == NULL)
+		return iostream_writev(&stream->inner, iov, iovcnt);
+	if (stream->wpos == stream->wend) {
+		/*
+		 * The previous write is complete, compress the new data.
+		 * Otherwise, this is a retry of the previous write, which
+		 * has already been compressed.
+		 */
+		stream->wpos = 0;
+		stream->wend = 0;
+		stream->wsize = 0;
+		for (int i = 0; i < iovcnt; i++) {
+			ZSTD_inBuffer input = {
+				iov[i].iov_base, iov[i].iov_len, 0
+			};
+			if (zstd_iostream_compress(stream, &input,
+						   ZSTD_e_continue) != 0)
+				return IOSTREAM_ERROR;
+			stream->wsize += iov[i].iov_len;
+		}
+		if (stream->wsize == 0)
+			return 0;
+		ZSTD_inBuffer input = {NULL, 0, 0};
+		if (zstd_iostream_compress(stream, &input, ZSTD_e_flush) != 0)
+			return IOSTREAM_ERROR;
+	}
+	while (stream->wpos < stream->wend) {
+		ssize_t rc = iostream_write(&stream->inner,
+					    stream->wbuf + stream->wpos,
+					    stream->wend - stream->wpos);
+		if (rc < 0)
+			return rc;
+		stream->wpos += rc;
+		stream->stat.compressed += rc;
+	}
+	stream->stat.raw += stream->wsize;
+	return stream->wsize;
+}
+
+static ssize_t
+zstd_iostream_write(struct iostream *io, const void *buf, size_t count)
+{
+	struct iovec iov = {(void *)buf, count};
+	return zstd_iostream_writev(io, &iov, 1);
+}
+
+static ssize_t
+zstd_iostream_read(struct iostream *io, void *buf, size_t count)
+{
+	struct zstd_iostream *stream = io->data;
+	if (stream->dstream == NULL)
+		return iostream_read(&stream->inner, buf, count);
+	ZSTD_outBuffer output = {buf, count, 0};
+	while (true) {
+		size_t size = stream->rend - stream->rpos;
+		if (stream->read_mode == ZSTD_IOSTREAM_READ_UNKNOWN &&
+		    size > 0) {
+			stream->read_mode =
+				(unsigned char)stream->rbuf[stream->rpos] ==
+				ZSTD_MAGIC_FIRST_BYTE ?
+				ZSTD_IOSTREAM_READ_ZSTD :
+				ZSTD_IOSTREAM_READ_PLAIN;
+		}
+		if (stream->read_mode == ZSTD_IOSTREAM_READ_PLAIN &&
+		    size > 0) {
+			size = MIN(size, count);
+			memcpy(buf, stream->rbuf + stream->rpos, size);
+			stream->rpos += size;
+			stream->stat.raw += size;
+			return size;
+		}
+		if (stream->read_mode == ZSTD_IOSTREAM_READ_ZSTD) {
+			/*
+			 * Called even without input, because the context
+			 * may keep output that didn't fit last time.
+			 */
+			ZSTD_inBuffer input = {
+				stream->rbuf + stream->rpos, size, 0
+			};
+			size_t rc = ZSTD_decompressStream(stream->dstream,
+							  &output, &input);
+			if (ZSTD_isError(rc)) {
+				diag_set(ClientError, ER_DECOMPRESSION,
+					 ZSTD_getErrorName(rc));
+				return IOSTREAM_ERROR;
+			}
+			stream->rpos += input.pos;
+			if (output.pos > 0) {
+				stream->stat.raw += output.pos;
+				return output.pos;
+			}
+			if (stream->rpos < stream->rend)
+				continue;
+		}
+		stream->rpos = 0;
+		stream->rend = 0;
+		ssize_t rc = iostream_read(&stream->inner, stream->rbuf,
+					   stream->rbuf_size);
+		if (rc <= 0)
+			return rc;
+		stream->rend = rc;
+		stream->stat.compressed += rc;
+	}
+}
+
+static const struct iostream_vtab zstd_iostream_vtab = {
+	/* .destroy = */ zstd_iostream_destroy,
+	/* .read = */ zstd_iostream_read,
+	/* .write = */ zstd_iostream_write,
+	/* .writev = */ zstd_iostream_writev,
+};
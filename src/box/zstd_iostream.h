@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct iostream;
+
+/** Traffic statistics of a zstd IO stream. */
+struct zstd_iostream_stat {
+	/** Bytes passed to the stream before compression. */
+	uint64_t raw;
+	/** Bytes passed over the wrapped stream after compression. */
+	uint64_t compressed;
+};
+
+/**
+ * Wraps an IO stream in place so that the data written to it is
+ * compressed with zstd and/or the data read from it is decompressed.
+ * The wrapped stream is destroyed together with the wrapper, the fd
+ * stays the same.
+ *
+ * If @a level is positive, writes are compressed with this level,
+ * otherwise they're passed through. A write is reported complete only
+ * after its compressed output has been written to the wrapped stream,
+ * so the caller must retry the same data after IOSTREAM_WANT_READ or
+ * IOSTREAM_WANT_WRITE, like it does for any other stream.
+ *
+ * If @a decompress is set, reads are decompressed. The peer may never
+ * start compression (e.g. if it fails a request before that), so the
+ * first byte read from the stream decides: if it doesn't start a zstd
+ * frame, the rest of the input is passed through as is.
+ *
+ * All writes share one compression context and all reads share one
+ * decompression context, so compression works across message bounds.
+ *
+ * Returns -1 and sets diag on error, in which case the stream isn't
+ * changed.
+ */
+int
+zstd_iostream_wrap(struct iostream *io, int level, bool decompress);
+
+/** Returns the max compression level accepted by zstd_iostream_wrap(). */
+int
+zstd_iostream_max_level(void);
+
+/** Returns true if an IO stream was wrapped with zstd_iostream_wrap(). */
+bool
+zstd_iostream_is_wrapped(const struct iostream *io);
+
+/**
+ * Returns traffic statistics of a stream wrapped with
+ * zstd_iostream_wrap(). Only the compressed directions are accounted.
+ */
+void
+zstd_iostream_stat(const struct iostream *io, struct zstd_iostream_stat *stat);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -114,6 +114,27 @@ sse42_enabled_cpu()
 	return (cx & (1 << 20)) != 0;
 }
 
+bool
+avx2_enabled_cpu()
+{
+	unsigned int ax, bx, cx, dx;
+
+	if (__get_cpuid(1, &ax, &bx, &cx, &dx) == 0)
+		return false;
+	/* The OS must save the YMM registers on context switch. */
+	if ((cx & (1 << 27)) == 0 || (cx & (1 << 28)) == 0)
+		return false;
+	unsigned int xcr0_lo, xcr0_hi;
+	__asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+	if ((xcr0_lo & 0x6) != 0x6)
+		return false;
+
+	if (__get_cpuid_max(0, NULL) < 7)
+		return false;
+	__cpuid_count(7, 0, ax, bx, cx, dx);
+	return (bx & (1 << 5)) != 0;
+}
+
 #else /* !(defined (__x86_64__) || defined (__i386__)) */
 
 bool
@@ -122,4 +143,10 @@ sse42_enabled_cpu()
 	return false;
 }
 
+bool
+avx2_enabled_cpu()
+{
+	return false;
+}
+
 #endif
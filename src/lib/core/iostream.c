@@ -29,6 +29,12 @@ plain_iostream_create(struct iostream *io, int fd)
 	io->fd = fd;
 }
 
+bool
+iostream_is_plain(const struct iostream *io)
+{
+	return io->vtab == &plain_iostream_vtab;
+}
+
 void
 iostream_close(struct iostream *io)
 {
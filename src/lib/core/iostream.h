@@ -169,6 +169,13 @@ iostream_move(struct iostream *dst, struct iostream *src)
 void
 plain_iostream_create(struct iostream *io, int fd);
 
+/**
+ * Returns true if the stream was created with plain_iostream_create(),
+ * i.e. the data can be written directly to its fd.
+ */
+bool
+iostream_is_plain(const struct iostream *io);
+
 /**
  * Destroys a stream and closes its fd. The stream fd is set to -1.
  */
@@ -125,7 +125,7 @@ struct port {
 	 * Implementation dependent content. Needed to declare
 	 * an abstract port instance on stack.
 	 */
-	char pad[68];
+	char pad[76];
 };
 
 /** Is not inlined just to be exported. */
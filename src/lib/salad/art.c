@@ -0,0 +1,1127 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "art.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ART_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define ART_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+enum art_node_type {
+	ART_LEAF,
+	ART_NODE4,
+	ART_NODE16,
+	ART_NODE48,
+	ART_NODE256,
+};
+
+/** Header shared by all node types. */
+struct art_node {
+	/** Node type, see enum art_node_type. */
+	uint8_t type;
+	/** Number of children of an inner node. */
+	uint16_t num_children;
+	/** Prefix length of an inner node or key length of a leaf. */
+	uint32_t len;
+	/**
+	 * Generation of the tree at the time the node was allocated or,
+	 * for a retired node, at the time the node was retired.
+	 */
+	uint32_t gen;
+	/** Link in the list of retired nodes. */
+	struct art_node *next_retired;
+};
+
+struct art_leaf {
+	struct art_node base;
+	void *value;
+	char key[];
+};
+
+/** Inner node with up to 4 children; keys are sorted. */
+struct art_node4 {
+	struct art_node base;
+	uint8_t keys[4];
+	struct art_node *children[4];
+	char prefix[];
+};
+
+/** Inner node with up to 16 children; keys are sorted. */
+struct art_node16 {
+	struct art_node base;
+	uint8_t keys[16];
+	struct art_node *children[16];
+	char prefix[];
+};
+
+/**
+ * Inner node with up to 48 children. A child for byte b is stored
+ * in children[index[b] - 1], zero index means there's no child.
+ */
+struct art_node48 {
+	struct art_node base;
+	uint8_t index[256];
+	struct art_node *children[48];
+	char prefix[];
+};
+
+/** Inner node with a child slot for each byte. */
+struct art_node256 {
+	struct art_node base;
+	struct art_node *children[256];
+	char prefix[];
+};
+
+/** Size of a node without the key or prefix. */
+static size_t
+art_node_base_size(uint8_t type)
+{
+	switch (type) {
+	case ART_LEAF:
+		return sizeof(struct art_leaf);
+	case ART_NODE4:
+		return sizeof(struct art_node4);
+	case ART_NODE16:
+		return sizeof(struct art_node16);
+	case ART_NODE48:
+		return sizeof(struct art_node48);
+	case ART_NODE256:
+		return sizeof(struct art_node256);
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+size_t
+art_node_size_max(uint32_t len)
+{
+	/* A prefix of an inner node is a substring of a stored key. */
+	size_t size = ART_MAX(sizeof(struct art_leaf),
+			      sizeof(struct art_node256));
+	return size + len;
+}
+
+/** Max number of children a node of the given type can have. */
+static int
+art_node_capacity(uint8_t type)
+{
+	switch (type) {
+	case ART_NODE4:
+		return 4;
+	case ART_NODE16:
+		return 16;
+	case ART_NODE48:
+		return 48;
+	case ART_NODE256:
+		return 256;
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+static inline size_t
+art_node_size(const struct art_node *node)
+{
+	return art_node_base_size(node->type) + node->len;
+}
+
+static char *
+art_node_prefix(struct art_node *node)
+{
+	switch (node->type) {
+	case ART_NODE4:
+		return ((struct art_node4 *)node)->prefix;
+	case ART_NODE16:
+		return ((struct art_node16 *)node)->prefix;
+	case ART_NODE48:
+		return ((struct art_node48 *)node)->prefix;
+	case ART_NODE256:
+		return ((struct art_node256 *)node)->prefix;
+	default:
+		assert(false);
+		return NULL;
+	}
+}
+
+/**
+ * Allocate a node of the given type with a key or prefix of the given
+ * length. The node is zeroed, the key or prefix is left uninitialized.
+ */
+static struct art_node *
+art_node_new(struct art_tree *tree, uint8_t type, uint32_t len)
+{
+	size_t base_size = art_node_base_size(type);
+	struct art_node *node = tree->alloc(tree->alloc_ctx, base_size + len);
+	if (node == NULL)
+		return NULL;
+	memset(node, 0, base_size);
+	node->type = type;
+	node->len = len;
+	node->gen = tree->gen;
+	tree->mem_used += base_size + len;
+	return node;
+}
+
+static void
+art_node_free(struct art_tree *tree, struct art_node *node)
+{
+	size_t size = art_node_size(node);
+	assert(tree->mem_used >= size);
+	tree->mem_used -= size;
+	tree->free(tree->alloc_ctx, node, size);
+}
+
+/**
+ * Allocate a copy of a node with a prefix of the given length.
+ * The prefix is left uninitialized.
+ */
+static struct art_node *
+art_node_copy(struct art_tree *tree, struct art_node *node, uint32_t len)
+{
+	size_t base_size = art_node_base_size(node->type);
+	struct art_node *copy = tree->alloc(tree->alloc_ctx, base_size + len);
+	if (copy == NULL)
+		return NULL;
+	memcpy(copy, node, base_size);
+	copy->len = len;
+	copy->gen = tree->gen;
+	copy->next_retired = NULL;
+	tree->mem_used += base_size + len;
+	return copy;
+}
+
+/**
+ * Called when a node is removed from the tree. The node is freed
+ * immediately unless it may be used by a read view, in which case
+ * it's freed when all such read views are closed.
+ */
+static void
+art_node_retire(struct art_tree *tree, struct art_node *node)
+{
+	if (node->gen > tree->view_gen) {
+		art_node_free(tree, node);
+		return;
+	}
+	node->gen = tree->gen;
+	node->next_retired = NULL;
+	if (tree->retired_tail == NULL)
+		tree->retired_head = node;
+	else
+		tree->retired_tail->next_retired = node;
+	tree->retired_tail = node;
+}
+
+/**
+ * Make the node stored at @a ref modifiable in place. If the node may be
+ * used by a read view, it's replaced with a copy.
+ */
+static int
+art_node_make_writable(struct art_tree *tree, struct art_node **ref)
+{
+	struct art_node *node = *ref;
+	if (node->gen > tree->view_gen)
+		return 0;
+	struct art_node *copy = art_node_copy(tree, node, node->len);
+	if (copy == NULL)
+		return -1;
+	if (node->type == ART_LEAF) {
+		memcpy(((struct art_leaf *)copy)->key,
+		       ((struct art_leaf *)node)->key, node->len);
+	} else {
+		memcpy(art_node_prefix(copy), art_node_prefix(node),
+		       node->len);
+	}
+	art_node_retire(tree, node);
+	*ref = copy;
+	return 0;
+}
+
+static struct art_leaf *
+art_leaf_new(struct art_tree *tree, const char *key, uint32_t len,
+	     void *value)
+{
+	struct art_leaf *leaf =
+		(struct art_leaf *)art_node_new(tree, ART_LEAF, len);
+	if (leaf == NULL)
+		return NULL;
+	leaf->value = value;
+	memcpy(leaf->key, key, len);
+	return leaf;
+}
+
+static inline bool
+art_leaf_matches(const struct art_leaf *leaf, const char *key, uint32_t len)
+{
+	return leaf->base.len == len && memcmp(leaf->key, key, len) == 0;
+}
+
+/**
+ * Compare a leaf key with a search key. A leaf key that starts with the
+ * search key is considered equal to it.
+ */
+static int
+art_leaf_compare(const struct art_leaf *leaf, const char *key, uint32_t len)
+{
+	uint32_t leaf_len = leaf->base.len;
+	int rc = memcmp(leaf->key, key, ART_MIN(leaf_len, len));
+	if (rc != 0)
+		return rc < 0 ? -1 : 1;
+	return leaf_len < len ? -1 : 0;
+}
+
+/** Length of the common prefix of two strings. */
+static uint32_t
+art_common_prefix(const char *a, const char *b, uint32_t len)
+{
+	uint32_t i = 0;
+	while (i < len && a[i] == b[i])
+		i++;
+	return i;
+}
+
+static int
+art_sorted_find(const uint8_t *keys, int count, uint8_t byte)
+{
+	for (int i = 0; i < count; i++) {
+		if (keys[i] == byte)
+			return i;
+	}
+	return -1;
+}
+
+static struct art_node *
+art_sorted_next(const uint8_t *keys, struct art_node *const *children,
+		int count, int byte, int dir, uint8_t *found)
+{
+	if (dir > 0) {
+		for (int i = 0; i < count; i++) {
+			if (keys[i] > byte) {
+				*found = keys[i];
+				return children[i];
+			}
+		}
+	} else {
+		for (int i = count - 1; i >= 0; i--) {
+			if (keys[i] < byte) {
+				*found = keys[i];
+				return children[i];
+			}
+		}
+	}
+	return NULL;
+}
+
+static void
+art_sorted_insert(uint8_t *keys, struct art_node **children, int count,
+		  uint8_t byte, struct art_node *child)
+{
+	int i = 0;
+	while (i < count && keys[i] < byte)
+		i++;
+	memmove(keys + i + 1, keys + i, count - i);
+	memmove(children + i + 1, children + i,
+		(count - i) * sizeof(*children));
+	keys[i] = byte;
+	children[i] = child;
+}
+
+static void
+art_sorted_remove(uint8_t *keys, struct art_node **children, int count,
+		  uint8_t byte)
+{
+	int i = art_sorted_find(keys, count, byte);
+	assert(i >= 0);
+	memmove(keys + i, keys + i + 1, count - i - 1);
+	memmove(children + i, children + i + 1,
+		(count - i - 1) * sizeof(*children));
+}
+
+/**
+ * Find the child of an inner node for the given byte. Returns a pointer
+ * to the child slot or NULL if there's no such child.
+ */
+static struct art_node **
+art_node_find_child(struct art_node *node, uint8_t byte)
+{
+	int i;
+	switch (node->type) {
+	case ART_NODE4: {
+		struct art_node4 *n = (struct art_node4 *)node;
+		i = art_sorted_find(n->keys, node->num_children, byte);
+		return i >= 0 ? &n->children[i] : NULL;
+	}
+	case ART_NODE16: {
+		struct art_node16 *n = (struct art_node16 *)node;
+		i = art_sorted_find(n->keys, node->num_children, byte);
+		return i >= 0 ? &n->children[i] : NULL;
+	}
+	case ART_NODE48: {
+		struct art_node48 *n = (struct art_node48 *)node;
+		i = n->index[byte];
+		return i != 0 ? &n->children[i - 1] : NULL;
+	}
+	case ART_NODE256: {
+		struct art_node256 *n = (struct art_node256 *)node;
+		return n->children[byte] != NULL ? &n->children[byte] : NULL;
+	}
+	default:
+		assert(false);
+		return NULL;
+	}
+}
+
+/**
+ * Find the child of an inner node closest to the given byte in the given
+ * direction (1 - forward, -1 - backward), not counting the child for the
+ * byte itself. Pass -1 or 256 to find the first or the last child.
+ * Returns NULL if there's no such child.
+ */
+static struct art_node *
+art_node_next_child(struct art_node *node, int byte, int dir,
+		    uint8_t *found)
+{
+	switch (node->type) {
+	case ART_NODE4: {
+		struct art_node4 *n = (struct art_node4 *)node;
+		return art_sorted_next(n->keys, n->children,
+				       node->num_children, byte, dir, found);
+	}
+	case ART_NODE16: {
+		struct art_node16 *n = (struct art_node16 *)node;
+		return art_sorted_next(n->keys, n->children,
+				       node->num_children, byte, dir, found);
+	}
+	case ART_NODE48: {
+		struct art_node48 *n = (struct art_node48 *)node;
+		for (int b = byte + dir; b >= 0 && b < 256; b += dir) {
+			if (n->index[b] != 0) {
+				*found = b;
+				return n->children[n->index[b] - 1];
+			}
+		}
+		return NULL;
+	}
+	case ART_NODE256: {
+		struct art_node256 *n = (struct art_node256 *)node;
+		for (int b = byte + dir; b >= 0 && b < 256; b += dir) {
+			if (n->children[b] != NULL) {
+				*found = b;
+				return n->children[b];
+			}
+		}
+		return NULL;
+	}
+	default:
+		assert(false);
+		return NULL;
+	}
+}
+
+/** Add a child to an inner node that has a free slot. */
+static void
+art_node_add_child(struct art_node *node, uint8_t byte,
+		   struct art_node *child)
+{
+	assert(node->num_children < art_node_capacity(node->type));
+	switch (node->type) {
+	case ART_NODE4: {
+		struct art_node4 *n = (struct art_node4 *)node;
+		art_sorted_insert(n->keys, n->children, node->num_children,
+				  byte, child);
+		break;
+	}
+	case ART_NODE16: {
+		struct art_node16 *n = (struct art_node16 *)node;
+		art_sorted_insert(n->keys, n->children, node->num_children,
+				  byte, child);
+		break;
+	}
+	case ART_NODE48: {
+		struct art_node48 *n = (struct art_node48 *)node;
+		assert(n->index[byte] == 0);
+		int slot = 0;
+		while (n->children[slot] != NULL)
+			slot++;
+		n->children[slot] = child;
+		n->index[byte] = slot + 1;
+		break;
+	}
+	case ART_NODE256: {
+		struct art_node256 *n = (struct art_node256 *)node;
+		assert(n->children[byte] == NULL);
+		n->children[byte] = child;
+		break;
+	}
+	default:
+		assert(false);
+	}
+	node->num_children++;
+}
+
+/** Remove a child from an inner node. */
+static void
+art_node_remove_child(struct art_node *node, uint8_t byte)
+{
+	switch (node->type) {
+	case ART_NODE4: {
+		struct art_node4 *n = (struct art_node4 *)node;
+		art_sorted_remove(n->keys, n->children, node->num_children,
+				  byte);
+		break;
+	}
+	case ART_NODE16: {
+		struct art_node16 *n = (struct art_node16 *)node;
+		art_sorted_remove(n->keys, n->children, node->num_children,
+				  byte);
+		break;
+	}
+	case ART_NODE48: {
+		struct art_node48 *n = (struct art_node48 *)node;
+		assert(n->index[byte] != 0);
+		n->children[n->index[byte] - 1] = NULL;
+		n->index[byte] = 0;
+		break;
+	}
+	case ART_NODE256: {
+		struct art_node256 *n = (struct art_node256 *)node;
+		assert(n->children[byte] != NULL);
+		n->children[byte] = NULL;
+		break;
+	}
+	default:
+		assert(false);
+	}
+	node->num_children--;
+}
+
+/** Allocate a copy of an inner node of another type. */
+static struct art_node *
+art_node_resize(struct art_tree *tree, struct art_node *node, uint8_t type)
+{
+	assert(node->num_children <= art_node_capacity(type));
+	struct art_node *new_node = art_node_new(tree, type, node->len);
+	if (new_node == NULL)
+		return NULL;
+	memcpy(art_node_prefix(new_node), art_node_prefix(node), node->len);
+	int byte = -1;
+	uint8_t found;
+	struct art_node *child;
+	while ((child = art_node_next_child(node, byte, 1, &found)) != NULL) {
+		art_node_add_child(new_node, found, child);
+		byte = found;
+	}
+	return new_node;
+}
+
+/**
+ * Add a child to the writable inner node stored at @a ref, growing
+ * the node if it's full.
+ */
+static int
+art_node_insert_child(struct art_tree *tree, struct art_node **ref,
+		      uint8_t byte, struct art_node *child)
+{
+	struct art_node *node = *ref;
+	if (node->num_children == art_node_capacity(node->type)) {
+		struct art_node *new_node =
+			art_node_resize(tree, node, node->type + 1);
+		if (new_node == NULL)
+			return -1;
+		art_node_retire(tree, node);
+		*ref = node = new_node;
+	}
+	art_node_add_child(node, byte, child);
+	return 0;
+}
+
+/**
+ * Replace a node4 that has the only child with the child, merging
+ * the prefixes. Returns NULL on memory allocation error.
+ */
+static struct art_node *
+art_node_collapse(struct art_tree *tree, struct art_node *node)
+{
+	assert(node->type == ART_NODE4 && node->num_children == 1);
+	uint8_t byte;
+	struct art_node *child = art_node_next_child(node, -1, 1, &byte);
+	if (child->type == ART_LEAF)
+		return child;
+	struct art_node *new_node =
+		art_node_copy(tree, child, node->len + 1 + child->len);
+	if (new_node == NULL)
+		return NULL;
+	char *prefix = art_node_prefix(new_node);
+	memcpy(prefix, art_node_prefix(node), node->len);
+	prefix[node->len] = byte;
+	memcpy(prefix + node->len + 1, art_node_prefix(child), child->len);
+	art_node_retire(tree, child);
+	return new_node;
+}
+
+/**
+ * Shrink the writable inner node stored at @a ref after a child was
+ * removed from it. Shrinking is an optimization so the node is left as
+ * is if there's not enough memory.
+ */
+static void
+art_node_shrink(struct art_tree *tree, struct art_node **ref)
+{
+	struct art_node *node = *ref;
+	struct art_node *new_node = NULL;
+	switch (node->type) {
+	case ART_NODE4:
+		if (node->num_children == 1)
+			new_node = art_node_collapse(tree, node);
+		break;
+	case ART_NODE16:
+		if (node->num_children <= 3)
+			new_node = art_node_resize(tree, node, ART_NODE4);
+		break;
+	case ART_NODE48:
+		if (node->num_children <= 12)
+			new_node = art_node_resize(tree, node, ART_NODE16);
+		break;
+	case ART_NODE256:
+		if (node->num_children <= 37)
+			new_node = art_node_resize(tree, node, ART_NODE48);
+		break;
+	default:
+		assert(false);
+	}
+	if (new_node == NULL)
+		return;
+	art_node_retire(tree, node);
+	*ref = new_node;
+}
+
+void
+art_create(struct art_tree *tree, art_alloc_f alloc, art_free_f free,
+	   void *alloc_ctx)
+{
+	memset(tree, 0, sizeof(*tree));
+	tree->gen = 1;
+	rlist_create(&tree->views);
+	tree->alloc = alloc;
+	tree->free = free;
+	tree->alloc_ctx = alloc_ctx;
+}
+
+/** Free nodes linked in a list by next_retired and their descendants. */
+static void
+art_free_nodes(struct art_tree *tree, struct art_node *list)
+{
+	while (list != NULL) {
+		struct art_node *node = list;
+		list = node->next_retired;
+		if (node->type != ART_LEAF) {
+			int byte = -1;
+			uint8_t found;
+			struct art_node *child;
+			while ((child = art_node_next_child(node, byte, 1,
+							    &found)) != NULL) {
+				child->next_retired = list;
+				list = child;
+				byte = found;
+			}
+		}
+		art_node_free(tree, node);
+	}
+}
+
+void
+art_destroy(struct art_tree *tree)
+{
+	assert(rlist_empty(&tree->views));
+	if (tree->root != NULL) {
+		tree->root->next_retired = NULL;
+		art_free_nodes(tree, tree->root);
+		tree->root = NULL;
+	}
+	while (tree->retired_head != NULL) {
+		struct art_node *node = tree->retired_head;
+		tree->retired_head = node->next_retired;
+		art_node_free(tree, node);
+	}
+	tree->retired_tail = NULL;
+	tree->size = 0;
+}
+
+int
+art_insert(struct art_tree *tree, const char *key, uint32_t len,
+	   void *value, void **replaced)
+{
+	*replaced = NULL;
+	tree->version++;
+	struct art_node **ref = &tree->root;
+	uint32_t depth = 0;
+	struct art_leaf *leaf;
+	while (true) {
+		struct art_node *node = *ref;
+		if (node == NULL) {
+			leaf = art_leaf_new(tree, key, len, value);
+			if (leaf == NULL)
+				return -1;
+			*ref = &leaf->base;
+			tree->size++;
+			return 0;
+		}
+		if (node->type == ART_LEAF) {
+			struct art_leaf *old = (struct art_leaf *)node;
+			if (art_leaf_matches(old, key, len)) {
+				if (art_node_make_writable(tree, ref) != 0)
+					return -1;
+				old = (struct art_leaf *)*ref;
+				*replaced = old->value;
+				old->value = value;
+				return 0;
+			}
+			/* Split the leaf. */
+			uint32_t max = ART_MIN(len, old->base.len);
+			assert(depth <= max);
+			uint32_t p = depth + art_common_prefix(
+				old->key + depth, key + depth, max - depth);
+			/* Keys must be prefix-free. */
+			assert(p < max);
+			leaf = art_leaf_new(tree, key, len, value);
+			if (leaf == NULL)
+				return -1;
+			struct art_node *new_node =
+				art_node_new(tree, ART_NODE4, p - depth);
+			if (new_node == NULL) {
+				art_node_free(tree, &leaf->base);
+				return -1;
+			}
+			memcpy(art_node_prefix(new_node), key + depth,
+			       p - depth);
+			art_node_add_child(new_node, old->key[p], node);
+			art_node_add_child(new_node, key[p], &leaf->base);
+			*ref = new_node;
+			tree->size++;
+			return 0;
+		}
+		char *prefix = art_node_prefix(node);
+		uint32_t max = ART_MIN(node->len, len - depth);
+		uint32_t p = art_common_prefix(prefix, key + depth, max);
+		if (p < node->len) {
+			/* Split the prefix. */
+			assert(depth + p < len);
+			leaf = art_leaf_new(tree, key, len, value);
+			if (leaf == NULL)
+				return -1;
+			struct art_node *new_node =
+				art_node_new(tree, ART_NODE4, p);
+			if (new_node == NULL) {
+				art_node_free(tree, &leaf->base);
+				return -1;
+			}
+			struct art_node *child =
+				art_node_copy(tree, node, node->len - p - 1);
+			if (child == NULL) {
+				art_node_free(tree, new_node);
+				art_node_free(tree, &leaf->base);
+				return -1;
+			}
+			memcpy(art_node_prefix(new_node), prefix, p);
+			memcpy(art_node_prefix(child), prefix + p + 1,
+			       node->len - p - 1);
+			art_node_add_child(new_node, prefix[p], child);
+			art_node_add_child(new_node, key[depth + p],
+					   &leaf->base);
+			art_node_retire(tree, node);
+			*ref = new_node;
+			tree->size++;
+			return 0;
+		}
+		depth += node->len;
+		/* Keys must be prefix-free. */
+		assert(depth < len);
+		uint8_t byte = key[depth];
+		if (art_node_make_writable(tree, ref) != 0)
+			return -1;
+		node = *ref;
+		struct art_node **child = art_node_find_child(node, byte);
+		if (child != NULL) {
+			ref = child;
+			depth++;
+			continue;
+		}
+		leaf = art_leaf_new(tree, key, len, value);
+		if (leaf == NULL)
+			return -1;
+		if (art_node_insert_child(tree, ref, byte, &leaf->base) != 0) {
+			art_node_free(tree, &leaf->base);
+			return -1;
+		}
+		tree->size++;
+		return 0;
+	}
+}
+
+int
+art_delete(struct art_tree *tree, const char *key, uint32_t len,
+	   void **deleted)
+{
+	*deleted = NULL;
+	/*
+	 * Find the leaf and the lowest node on the path to it that has
+	 * more than one child. All nodes below it have the only child so
+	 * the whole subtree is removed together with the leaf.
+	 */
+	struct art_node *node = tree->root;
+	uint32_t depth = 0;
+	int level = 0;
+	int anchor = -1;
+	while (node != NULL && node->type != ART_LEAF) {
+		if (node->len > len - depth ||
+		    memcmp(art_node_prefix(node), key + depth, node->len) != 0)
+			return 0;
+		depth += node->len;
+		if (depth >= len)
+			return 0;
+		if (node->num_children > 1)
+			anchor = level;
+		struct art_node **child = art_node_find_child(node,
+							      key[depth]);
+		if (child == NULL)
+			return 0;
+		node = *child;
+		depth++;
+		level++;
+	}
+	if (node == NULL || !art_leaf_matches((struct art_leaf *)node,
+					      key, len))
+		return 0;
+	struct art_leaf *leaf = (struct art_leaf *)node;
+	tree->version++;
+	/* Make the path to the anchor node writable. */
+	struct art_node **ref = &tree->root;
+	depth = 0;
+	for (level = 0; level <= anchor; level++) {
+		if (art_node_make_writable(tree, ref) != 0)
+			return -1;
+		node = *ref;
+		depth += node->len;
+		if (level == anchor)
+			break;
+		ref = art_node_find_child(node, key[depth]);
+		depth++;
+	}
+	struct art_node *subtree;
+	if (anchor >= 0) {
+		node = *ref;
+		uint8_t byte = key[depth];
+		subtree = *art_node_find_child(node, byte);
+		art_node_remove_child(node, byte);
+	} else {
+		subtree = tree->root;
+		tree->root = NULL;
+	}
+	*deleted = leaf->value;
+	while (subtree->type != ART_LEAF) {
+		assert(subtree->num_children == 1);
+		uint8_t byte;
+		struct art_node *next = art_node_next_child(subtree, -1, 1,
+							    &byte);
+		art_node_retire(tree, subtree);
+		subtree = next;
+	}
+	assert(subtree == &leaf->base);
+	art_node_retire(tree, subtree);
+	tree->size--;
+	if (anchor >= 0)
+		art_node_shrink(tree, ref);
+	return 0;
+}
+
+void *
+art_find(struct art_node *node, const char *key, uint32_t len)
+{
+	uint32_t depth = 0;
+	while (node != NULL && node->type != ART_LEAF) {
+		if (node->len > len - depth ||
+		    memcmp(art_node_prefix(node), key + depth, node->len) != 0)
+			return NULL;
+		depth += node->len;
+		if (depth >= len)
+			return NULL;
+		struct art_node **child = art_node_find_child(node,
+							      key[depth]);
+		if (child == NULL)
+			return NULL;
+		node = *child;
+		depth++;
+	}
+	if (node == NULL || !art_leaf_matches((struct art_leaf *)node,
+					      key, len))
+		return NULL;
+	return ((struct art_leaf *)node)->value;
+}
+
+void
+art_view_create(struct art_view *view, struct art_tree *tree)
+{
+	view->root = tree->root;
+	view->size = tree->size;
+	view->tree = tree;
+	view->gen = tree->gen;
+	tree->view_gen = tree->gen;
+	tree->gen++;
+	rlist_add_tail_entry(&tree->views, view, in_tree);
+}
+
+void
+art_view_destroy(struct art_view *view)
+{
+	struct art_tree *tree = view->tree;
+	rlist_del_entry(view, in_tree);
+	uint32_t oldest_gen = UINT32_MAX;
+	if (rlist_empty(&tree->views)) {
+		tree->view_gen = 0;
+	} else {
+		tree->view_gen = rlist_last_entry(&tree->views, struct art_view,
+						  in_tree)->gen;
+		oldest_gen = rlist_first_entry(&tree->views, struct art_view,
+					       in_tree)->gen;
+	}
+	/*
+	 * A node retired at generation G may only be used by views
+	 * created before G, i.e. with generation less than G.
+	 */
+	while (tree->retired_head != NULL &&
+	       tree->retired_head->gen <= oldest_gen) {
+		struct art_node *node = tree->retired_head;
+		tree->retired_head = node->next_retired;
+		art_node_free(tree, node);
+	}
+	if (tree->retired_head == NULL)
+		tree->retired_tail = NULL;
+}
+
+static inline void
+art_iterator_reset(struct art_iterator *it)
+{
+	it->leaf = NULL;
+	it->depth = 0;
+	it->overflow = false;
+}
+
+static inline void
+art_iterator_push(struct art_iterator *it, struct art_node *node,
+		  uint8_t byte)
+{
+	if (it->depth < ART_ITERATOR_STACK_SIZE) {
+		it->stack[it->depth].node = node;
+		it->stack[it->depth].byte = byte;
+		it->depth++;
+	} else {
+		it->overflow = true;
+	}
+}
+
+/**
+ * Position an iterator to the first (dir = 1) or the last (dir = -1)
+ * leaf of a subtree.
+ */
+static void
+art_iterator_descend(struct art_iterator *it, struct art_node *node,
+		     int dir)
+{
+	while (node->type != ART_LEAF) {
+		uint8_t byte;
+		struct art_node *child = art_node_next_child(
+			node, dir > 0 ? -1 : 256, dir, &byte);
+		assert(child != NULL);
+		art_iterator_push(it, node, byte);
+		node = child;
+	}
+	it->leaf = (struct art_leaf *)node;
+}
+
+/**
+ * Position an iterator to the leaf following the subtree at the top of
+ * the iterator stack in the given direction.
+ */
+static void
+art_iterator_escape(struct art_iterator *it, int dir)
+{
+	while (it->depth > 0) {
+		struct art_iterator_frame *frame = &it->stack[it->depth - 1];
+		uint8_t byte;
+		struct art_node *child = art_node_next_child(
+			frame->node, frame->byte, dir, &byte);
+		if (child != NULL) {
+			frame->byte = byte;
+			art_iterator_descend(it, child, dir);
+			return;
+		}
+		it->depth--;
+	}
+	it->leaf = NULL;
+}
+
+/**
+ * Position an iterator to the first leaf that compares greater than
+ * (or equal to, if @a inclusive is set) the given key if @a dir is 1 or
+ * to the last leaf that compares less than (or equal to) the key if
+ * @a dir is -1.
+ */
+static void
+art_iterator_seek(struct art_iterator *it, struct art_node *node,
+		  const char *key, uint32_t len, int dir, bool inclusive)
+{
+	art_iterator_reset(it);
+	if (node == NULL)
+		return;
+	/*
+	 * The closest subtree in the search direction that was skipped
+	 * on a level that didn't fit in the iterator stack.
+	 */
+	struct art_node *alt = NULL;
+	uint32_t depth = 0;
+	int cmp;
+	while (true) {
+		if (node->type == ART_LEAF) {
+			cmp = art_leaf_compare((struct art_leaf *)node,
+					       key, len);
+			break;
+		}
+		/*
+		 * If the key ends inside the prefix, all leaves of the
+		 * subtree start with the key and so compare equal to it.
+		 */
+		uint32_t max = ART_MIN(node->len, len - depth);
+		cmp = memcmp(art_node_prefix(node), key + depth, max);
+		if (cmp != 0 || max < node->len)
+			break;
+		depth += node->len;
+		if (depth == len)
+			break;
+		uint8_t byte = key[depth];
+		struct art_node **child = art_node_find_child(node, byte);
+		if (child == NULL) {
+			uint8_t found;
+			struct art_node *next = art_node_next_child(
+				node, byte, dir, &found);
+			if (next == NULL)
+				goto escape;
+			art_iterator_push(it, node, found);
+			art_iterator_descend(it, next, dir);
+			return;
+		}
+		if (it->depth < ART_ITERATOR_STACK_SIZE) {
+			art_iterator_push(it, node, byte);
+		} else {
+			uint8_t found;
+			struct art_node *next = art_node_next_child(
+				node, byte, dir, &found);
+			if (next != NULL)
+				alt = next;
+			it->overflow = true;
+		}
+		node = *child;
+		depth++;
+	}
+	cmp = cmp < 0 ? -1 : cmp > 0 ? 1 : 0;
+	int threshold = inclusive ? 0 : dir;
+	if (dir > 0 ? cmp >= threshold : cmp <= threshold) {
+		art_iterator_descend(it, node, dir);
+		return;
+	}
+escape:
+	if (alt != NULL)
+		art_iterator_descend(it, alt, dir);
+	else
+		art_iterator_escape(it, dir);
+}
+
+static void
+art_iterator_step(struct art_iterator *it, struct art_node *root, int dir)
+{
+	if (it->leaf == NULL)
+		return;
+	if (it->overflow) {
+		struct art_leaf *leaf = it->leaf;
+		art_iterator_seek(it, root, leaf->key, leaf->base.len,
+				  dir, false);
+		return;
+	}
+	art_iterator_escape(it, dir);
+}
+
+void
+art_iterator_first(struct art_iterator *it, struct art_node *root)
+{
+	art_iterator_reset(it);
+	if (root != NULL)
+		art_iterator_descend(it, root, 1);
+}
+
+void
+art_iterator_last(struct art_iterator *it, struct art_node *root)
+{
+	art_iterator_reset(it);
+	if (root != NULL)
+		art_iterator_descend(it, root, -1);
+}
+
+void
+art_iterator_ge(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len)
+{
+	art_iterator_seek(it, root, key, len, 1, true);
+}
+
+void
+art_iterator_gt(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len)
+{
+	art_iterator_seek(it, root, key, len, 1, false);
+}
+
+void
+art_iterator_le(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len)
+{
+	art_iterator_seek(it, root, key, len, -1, true);
+}
+
+void
+art_iterator_lt(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len)
+{
+	art_iterator_seek(it, root, key, len, -1, false);
+}
+
+void
+art_iterator_next(struct art_iterator *it, struct art_node *root)
+{
+	art_iterator_step(it, root, 1);
+}
+
+void
+art_iterator_prev(struct art_iterator *it, struct art_node *root)
+{
+	art_iterator_step(it, root, -1);
+}
+
+void *
+art_iterator_value(const struct art_iterator *it)
+{
+	return it->leaf != NULL ? it->leaf->value : NULL;
+}
+
+const char *
+art_iterator_key(const struct art_iterator *it, uint32_t *len)
+{
+	if (it->leaf == NULL)
+		return NULL;
+	*len = it->leaf->base.len;
+	return it->leaf->key;
+}
@@ -0,0 +1,306 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "small/rlist.h"
+
+/**
+ * Adaptive radix tree (ART) mapping binary keys to opaque values.
+ *
+ * Keys are compared bytewise (as memcmp does, a shorter key is less than
+ * a longer one it is a prefix of). The set of keys stored in one tree must
+ * be prefix-free, i.e. no stored key may be a prefix of another stored key.
+ * This is trivially true for keys of the same fixed length and for keys
+ * that have an unambiguous terminator, which is the case for normalized
+ * index keys.
+ *
+ * Inner nodes adapt their fan-out to the number of children (4, 16, 48 or
+ * 256) and use path compression: a chain of single-child nodes is stored
+ * as a prefix of the first inner node that has more than one child.
+ *
+ * The tree supports cheap consistent read views. Opening a view doesn't
+ * copy anything: after that, modifications of the tree copy the nodes
+ * they touch instead of changing them in place, so the view keeps seeing
+ * the old version of the tree. Nodes that are not needed by any view are
+ * freed as soon as the last view that uses them is closed.
+ */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+enum {
+	/**
+	 * Number of levels an iterator remembers. If a tree is deeper,
+	 * the iterator falls back on a lookup from the root to advance.
+	 */
+	ART_ITERATOR_STACK_SIZE = 32,
+};
+
+/** Allocator used by the tree. Must return NULL on failure. */
+typedef void *
+(*art_alloc_f)(void *ctx, size_t size);
+
+/** Deallocator used by the tree. */
+typedef void
+(*art_free_f)(void *ctx, void *ptr, size_t size);
+
+/** Tree node (opaque). */
+struct art_node;
+
+/** Leaf node: stores a key and the value associated with it. */
+struct art_leaf;
+
+struct art_tree {
+	/** Root node or NULL if the tree is empty. */
+	struct art_node *root;
+	/** Number of keys stored in the tree. */
+	size_t size;
+	/** Number of bytes allocated for nodes, including retired ones. */
+	size_t mem_used;
+	/**
+	 * Incremented on each modification. Used for detecting iterators
+	 * that were invalidated by a modification.
+	 */
+	uint32_t version;
+	/** Generation assigned to newly allocated nodes. */
+	uint32_t gen;
+	/**
+	 * Generation of the most recent open read view or 0 if there are
+	 * no open read views. Nodes of generation less than or equal to
+	 * this one may be used by read views so they can't be modified in
+	 * place.
+	 */
+	uint32_t view_gen;
+	/** List of open read views, linked by art_view::in_tree. */
+	struct rlist views;
+	/**
+	 * List of nodes that were removed from the tree but may still be
+	 * used by read views, linked in the order of removal.
+	 */
+	struct art_node *retired_head;
+	/** Last node in the retired list. */
+	struct art_node *retired_tail;
+	/** Memory allocator. */
+	art_alloc_f alloc;
+	/** Memory deallocator. */
+	art_free_f free;
+	/** Allocator context. */
+	void *alloc_ctx;
+};
+
+/** Frozen consistent snapshot of a tree. */
+struct art_view {
+	/** Root node of the tree at the time the view was created. */
+	struct art_node *root;
+	/** Number of keys in the view. */
+	size_t size;
+	/** Generation of the tree at the time the view was created. */
+	uint32_t gen;
+	/** Tree the view was created from. */
+	struct art_tree *tree;
+	/** Link in art_tree::views. */
+	struct rlist in_tree;
+};
+
+/** Iterator frame: an inner node and the child the iterator went to. */
+struct art_iterator_frame {
+	struct art_node *node;
+	uint8_t byte;
+};
+
+/**
+ * Tree iterator. It may be used with a tree or with a read view.
+ * A tree iterator is invalidated by any modification of the tree,
+ * see art_iterator_is_valid().
+ */
+struct art_iterator {
+	/** Current leaf or NULL if the iterator is exhausted. */
+	struct art_leaf *leaf;
+	/** Number of frames stored in the stack. */
+	uint32_t depth;
+	/**
+	 * Set if the path to the current leaf didn't fit in the stack.
+	 * In this case the iterator advances with a lookup from the root.
+	 */
+	bool overflow;
+	/** Tree version at the time of positioning. */
+	uint32_t version;
+	/** Path from the root to the current leaf. */
+	struct art_iterator_frame stack[ART_ITERATOR_STACK_SIZE];
+};
+
+/**
+ * Initialize an empty tree.
+ * @param tree - tree to initialize
+ * @param alloc - memory allocator
+ * @param free - memory deallocator
+ * @param alloc_ctx - argument passed to the allocator and deallocator
+ */
+void
+art_create(struct art_tree *tree, art_alloc_f alloc, art_free_f free,
+	   void *alloc_ctx);
+
+/**
+ * Free all memory used by a tree. Values are not touched.
+ * All read views must be closed at this point.
+ */
+void
+art_destroy(struct art_tree *tree);
+
+/** Number of keys stored in a tree. */
+static inline size_t
+art_size(const struct art_tree *tree)
+{
+	return tree->size;
+}
+
+/**
+ * Max size of a node allocated by a tree that stores keys not longer
+ * than @a len bytes. The allocator never gets a bigger request.
+ */
+size_t
+art_node_size_max(uint32_t len);
+
+/** Number of bytes used by a tree. */
+static inline size_t
+art_mem_used(const struct art_tree *tree)
+{
+	return tree->mem_used;
+}
+
+/**
+ * Insert a key into a tree. If the key is already present, its value is
+ * replaced.
+ * @param tree - tree
+ * @param key - key
+ * @param len - key length
+ * @param value - value to associate with the key
+ * @param[out] replaced - old value of the key or NULL if the key wasn't
+ *                        present in the tree
+ * @retval 0 success
+ * @retval -1 memory allocation error, the tree is left unchanged
+ */
+int
+art_insert(struct art_tree *tree, const char *key, uint32_t len,
+	   void *value, void **replaced);
+
+/**
+ * Delete a key from a tree.
+ * @param tree - tree
+ * @param key - key
+ * @param len - key length
+ * @param[out] deleted - value of the deleted key or NULL if the key wasn't
+ *                       found
+ * @retval 0 success
+ * @retval -1 memory allocation error, the tree is left unchanged;
+ *            may only happen if there are open read views
+ */
+int
+art_delete(struct art_tree *tree, const char *key, uint32_t len,
+	   void **deleted);
+
+/**
+ * Find the value associated with a key in the tree starting at @a root.
+ * Returns NULL if the key isn't found.
+ */
+void *
+art_find(struct art_node *root, const char *key, uint32_t len);
+
+/**
+ * Open a read view of a tree. The view must be closed with
+ * art_view_destroy() before the tree is destroyed.
+ */
+void
+art_view_create(struct art_view *view, struct art_tree *tree);
+
+/** Close a read view and free the nodes that aren't needed anymore. */
+void
+art_view_destroy(struct art_view *view);
+
+/** Position an iterator to the first key in the tree at @a root. */
+void
+art_iterator_first(struct art_iterator *it, struct art_node *root);
+
+/** Position an iterator to the last key in the tree at @a root. */
+void
+art_iterator_last(struct art_iterator *it, struct art_node *root);
+
+/*
+ * The following functions position an iterator to the key closest to
+ * the given one in the tree at @a root. A stored key that starts with
+ * the given key is considered equal to it so passing a prefix of stored
+ * keys to art_iterator_ge() and art_iterator_le() finds the first and
+ * the last key with this prefix, respectively.
+ */
+
+/** Position an iterator to the first key greater than or equal to @a key. */
+void
+art_iterator_ge(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len);
+
+/** Position an iterator to the first key greater than @a key. */
+void
+art_iterator_gt(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len);
+
+/** Position an iterator to the last key less than or equal to @a key. */
+void
+art_iterator_le(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len);
+
+/** Position an iterator to the last key less than @a key. */
+void
+art_iterator_lt(struct art_iterator *it, struct art_node *root,
+		const char *key, uint32_t len);
+
+/** Advance an iterator to the next key. */
+void
+art_iterator_next(struct art_iterator *it, struct art_node *root);
+
+/** Advance an iterator to the previous key. */
+void
+art_iterator_prev(struct art_iterator *it, struct art_node *root);
+
+/** Value at the iterator position or NULL if the iterator is exhausted. */
+void *
+art_iterator_value(const struct art_iterator *it);
+
+/**
+ * Key at the iterator position or NULL if the iterator is exhausted.
+ * @param[out] len - key length
+ */
+const char *
+art_iterator_key(const struct art_iterator *it, uint32_t *len);
+
+/** Remember the current tree version in an iterator. */
+static inline void
+art_iterator_set_version(struct art_iterator *it,
+			 const struct art_tree *tree)
+{
+	it->version = tree->version;
+}
+
+/**
+ * Check if an iterator positioned in a tree is still valid, i.e. the tree
+ * hasn't been modified since the iterator was positioned and
+ * art_iterator_set_version() was called. Iterators over read views are
+ * never invalidated.
+ */
+static inline bool
+art_iterator_is_valid(const struct art_iterator *it,
+		      const struct art_tree *tree)
+{
+	return it->version == tree->version;
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
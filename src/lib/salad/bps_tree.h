@@ -139,6 +139,7 @@
  * void bps_tree_view_destroy(view);
  * bps_tree_elem_t *bps_tree_find(tree, key);
  * bps_tree_elem_t *bps_tree_view_find(view, key);
+ * void bps_tree_find_many(tree, keys, count, results);
  * int bps_tree_insert(tree, new_elem, replaced_elem, before_elem);
  * int bps_tree_insert_get_iterator(tree, new_elem, replaced_elem,
  * 				    inserted_iterator)
@@ -390,6 +391,8 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_find_impl _bps_tree(find)
 #define bps_tree_find _api_name(find)
 #define bps_tree_view_find _api_name(view_find)
+#define bps_tree_find_many _api_name(find_many)
+#define bps_tree_prefetch_block _bps_tree(prefetch_block)
 #define bps_tree_insert _api_name(insert)
 #define bps_tree_insert_get_iterator _api_name(insert_get_iterator)
 #define bps_tree_delete _api_name(delete)
@@ -696,6 +699,22 @@ bps_tree_find(const struct bps_tree *tree, bps_tree_key_t key);
 static inline bps_tree_elem_t *
 bps_tree_view_find(const struct bps_tree_view *view, bps_tree_key_t key);
 
+/**
+ * @brief Find the first elements that are equal to each of the given keys.
+ * Same as calling bps_tree_find() for each key, but the lookups descend
+ * the tree together level by level, and a block needed by a lookup is
+ * prefetched before the other lookups are advanced, so cache misses of
+ * different lookups overlap.
+ * @param tree - pointer to a tree
+ * @param keys - array of keys
+ * @param count - number of keys
+ * @param results - array of count pointers where found elements (or NULL
+ *  if an element is not found) are stored
+ */
+static inline void
+bps_tree_find_many(const struct bps_tree *tree, const bps_tree_key_t *keys,
+		   size_t count, bps_tree_elem_t **results);
+
 /**
  * @brief Insert an element to the tree or replace an element in the tree
  * In case of replacing, if 'replaced' argument is not null,
@@ -2460,6 +2479,62 @@ bps_tree_view_find(const struct bps_tree_view *view, bps_tree_key_t key)
 	return bps_tree_find_impl(&view->common, key);
 }
 
+/**
+ * @brief Prefetch the part of a block that is accessed first by a binary
+ * search, i.e. the header and the middle of the block.
+ */
+static inline void
+bps_tree_prefetch_block(const struct bps_block *block)
+{
+	__builtin_prefetch(block);
+	__builtin_prefetch((const char *)block + BPS_TREE_BLOCK_SIZE / 2);
+}
+
+static inline void
+bps_tree_find_many(const struct bps_tree *t, const bps_tree_key_t *keys,
+		   size_t count, bps_tree_elem_t **results)
+{
+	const struct bps_tree_common *tree = &t->common;
+	if (tree->root_id == (bps_tree_block_id_t)(-1)) {
+		for (size_t i = 0; i < count; i++)
+			results[i] = NULL;
+		return;
+	}
+	/* Number of lookups that are advanced together. */
+	enum { BATCH_SIZE = 16 };
+	struct bps_block *blocks[BATCH_SIZE];
+	bool exact;
+	for (size_t start = 0; start < count; start += BATCH_SIZE) {
+		size_t n = count - start < BATCH_SIZE ?
+			   count - start : BATCH_SIZE;
+		const bps_tree_key_t *batch_keys = keys + start;
+		for (size_t i = 0; i < n; i++)
+			blocks[i] = bps_tree_root(tree);
+		for (bps_tree_block_id_t d = 0; d < tree->depth - 1; d++) {
+			for (size_t i = 0; i < n; i++) {
+				struct bps_inner *inner =
+					(struct bps_inner *)blocks[i];
+				bps_tree_pos_t pos;
+				pos = bps_tree_find_ins_point_key(
+					tree, inner->elems,
+					inner->header.size - 1,
+					batch_keys[i], &exact);
+				blocks[i] = bps_tree_restore_block(
+					tree, inner->child_ids[pos]);
+				bps_tree_prefetch_block(blocks[i]);
+			}
+		}
+		for (size_t i = 0; i < n; i++) {
+			struct bps_leaf *leaf = (struct bps_leaf *)blocks[i];
+			bps_tree_pos_t pos;
+			pos = bps_tree_find_ins_point_key(tree, leaf->elems,
+							  leaf->header.size,
+							  batch_keys[i], &exact);
+			results[start + i] = exact ? leaf->elems + pos : NULL;
+		}
+	}
+}
+
 /**
  * @brief Add a block to the garbage for future reuse
  */
@@ -6476,6 +6551,8 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_find_impl
 #undef bps_tree_find
 #undef bps_tree_view_find
+#undef bps_tree_find_many
+#undef bps_tree_prefetch_block
 #undef bps_tree_insert
 #undef bps_tree_delete
 #undef bps_tree_delete_value
@@ -297,6 +297,16 @@ static inline uint32_t
 LIGHT(view_find_key)(const struct LIGHT(view) *v, uint32_t hash,
 		     LIGHT_KEY_TYPE data);
 
+/**
+ * @brief Prefetch the hash table slot where a lookup of the given hash
+ * starts. Prefetching slots of several lookups before doing them allows
+ * to overlap their cache misses.
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash that is going to be looked up
+ */
+static inline void
+LIGHT(prefetch)(const struct LIGHT(core) *ht, uint32_t hash);
+
 /**
  * @brief Insert a record with given hash and value
  * @param ht - pointer to a hash table struct
@@ -640,6 +650,16 @@ LIGHT(view_find_key)(const struct LIGHT(view) *v, uint32_t hash,
 	return LIGHT(find_key_impl)(&v->common, hash, key);
 }
 
+static inline void
+LIGHT(prefetch)(const struct LIGHT(core) *ht, uint32_t hash)
+{
+	const struct LIGHT(common) *common = &ht->common;
+	if (common->count == 0)
+		return;
+	__builtin_prefetch(LIGHT(get_record)(common,
+					     LIGHT(slot)(common, hash)));
+}
+
 /**
  * @brief Replace a record with given hash and value
  * @param htab - pointer to a hash table struct
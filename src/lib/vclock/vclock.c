@@ -37,6 +37,26 @@
 #include "diag.h"
 #include "tt_static.h"
 
+int64_t
+vclock_nth_largest(const struct vclock *vclock, int n)
+{
+	assert(n > 0 && n <= VCLOCK_MAX);
+	/* The biggest components sorted in descending order. */
+	int64_t top[VCLOCK_MAX];
+	int count = 0;
+	struct vclock_iterator it;
+	vclock_iterator_init(&it, vclock);
+	vclock_foreach(&it, replica) {
+		if (count == n && replica.lsn <= top[count - 1])
+			continue;
+		int i = count < n ? count++ : count - 1;
+		for (; i > 0 && top[i - 1] < replica.lsn; i--)
+			top[i] = top[i - 1];
+		top[i] = replica.lsn;
+	}
+	return count < n ? 0 : top[n - 1];
+}
+
 int64_t
 vclock_follow(struct vclock *vclock, uint32_t replica_id, int64_t lsn)
 {
@@ -231,6 +231,18 @@ vclock_sum(const struct vclock *vclock)
 	return vclock->signature;
 }
 
+/**
+ * Get the n-th biggest component of a vclock, counting from 1, i.e.
+ * the biggest LSN reached by at least n components.
+ *
+ * @param vclock Vector clock.
+ * @param n Component rank, 1 <= n <= VCLOCK_MAX.
+ * @return the n-th biggest LSN or 0 if there are less than n
+ * non-zero components.
+ */
+int64_t
+vclock_nth_largest(const struct vclock *vclock, int n);
+
 /**
  * Update vclock with the next LSN value for given replica id.
  *
@@ -54,6 +54,7 @@
 #include "cbus.h"
 #include "coio_task.h"
 #include <crc32.h>
+#include "mp_check_fast.h"
 #include "memory.h"
 #include <say.h>
 #include <rmean.h>
@@ -826,6 +827,7 @@ main(int argc, char **argv)
 	random_init();
 
 	crc32_init();
+	mp_check_fast_init();
 	memory_init();
 
 	main_argc = argc;
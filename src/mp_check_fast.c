@@ -0,0 +1,257 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "mp_check_fast.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "trivia/config.h"
+#include "trivia/util.h"
+#include "cpu_feature.h"
+#include "msgpuck.h"
+
+#if defined(HAVE_CPUID) && defined(__x86_64__)
+#define MP_CHECK_FAST_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * Returns true if the byte encodes a complete MsgPack value: positive
+ * or negative fixint, nil, false or true.
+ */
+static inline bool
+mp_is_single_byte(uint8_t c)
+{
+	return c <= 0x7f || c >= 0xe0 || c == 0xc0 || c == 0xc2 || c == 0xc3;
+}
+
+/**
+ * Returns the number of consecutive single-byte values at the
+ * beginning of [p, end). The caller guarantees that p < end and
+ * *p is a single-byte value so the result is never zero.
+ */
+static inline size_t
+mp_single_byte_run_scalar(const char *p, const char *end)
+{
+	const char *begin = p;
+	while (p < end && mp_is_single_byte(*p))
+		p++;
+	return p - begin;
+}
+
+/**
+ * The validator itself. The value tree is walked iteratively with
+ * a single counter of values that are yet to be checked, which is
+ * incremented by the size of every array and map met on the way.
+ * Runs of single-byte values, typical for arrays of small numbers,
+ * are skipped in one step with the help of single_byte_run, the rest
+ * is checked one value at a time. Extensions and reserved codes are
+ * passed to mp_check() so that the extension check hook is honored.
+ *
+ * The function is always inlined so that single_byte_run is inlined
+ * too and compiled for the target of the caller.
+ */
+static inline __attribute__((always_inline)) int
+mp_check_fast_impl(const char **data, const char *end,
+		   size_t (*single_byte_run)(const char *, const char *))
+{
+	const char *p = *data;
+	int64_t k = 1;
+	while (k > 0) {
+		if (unlikely(p >= end))
+			return 1;
+		uint8_t c = *p;
+		if (mp_is_single_byte(c)) {
+			const char *limit = end - p > k ? p + k : end;
+			size_t n = single_byte_run(p, limit);
+			p += n;
+			k -= n;
+			continue;
+		}
+		p++;
+		k--;
+		uint32_t len;
+		if (c >= 0xa0 && c <= 0xbf) {
+			/* fixstr */
+			len = c & 0x1f;
+			goto skip;
+		}
+		if (c >= 0x90 && c <= 0x9f) {
+			/* fixarray */
+			k += c & 0x0f;
+			continue;
+		}
+		if (c >= 0x80 && c <= 0x8f) {
+			/* fixmap */
+			k += 2 * (c & 0x0f);
+			continue;
+		}
+		switch (c) {
+		case 0xcc: /* uint 8 */
+		case 0xd0: /* int 8 */
+			len = 1;
+			goto skip;
+		case 0xcd: /* uint 16 */
+		case 0xd1: /* int 16 */
+			len = 2;
+			goto skip;
+		case 0xca: /* float */
+		case 0xce: /* uint 32 */
+		case 0xd2: /* int 32 */
+			len = 4;
+			goto skip;
+		case 0xcb: /* double */
+		case 0xcf: /* uint 64 */
+		case 0xd3: /* int 64 */
+			len = 8;
+			goto skip;
+		case 0xc4: /* bin 8 */
+		case 0xd9: /* str 8 */
+			if (unlikely(end - p < 1))
+				return 1;
+			len = mp_load_u8(&p);
+			goto skip;
+		case 0xc5: /* bin 16 */
+		case 0xda: /* str 16 */
+			if (unlikely(end - p < 2))
+				return 1;
+			len = mp_load_u16(&p);
+			goto skip;
+		case 0xc6: /* bin 32 */
+		case 0xdb: /* str 32 */
+			if (unlikely(end - p < 4))
+				return 1;
+			len = mp_load_u32(&p);
+			goto skip;
+		case 0xdc: /* array 16 */
+			if (unlikely(end - p < 2))
+				return 1;
+			k += mp_load_u16(&p);
+			continue;
+		case 0xdd: /* array 32 */
+			if (unlikely(end - p < 4))
+				return 1;
+			k += mp_load_u32(&p);
+			continue;
+		case 0xde: /* map 16 */
+			if (unlikely(end - p < 2))
+				return 1;
+			k += 2 * (int64_t)mp_load_u16(&p);
+			continue;
+		case 0xdf: /* map 32 */
+			if (unlikely(end - p < 4))
+				return 1;
+			k += 2 * (int64_t)mp_load_u32(&p);
+			continue;
+		default:
+			/* Extensions and the reserved 0xc1. */
+			p--;
+			if (mp_check(&p, end) != 0)
+				return 1;
+			continue;
+		}
+skip:
+		if (unlikely((size_t)(end - p) < len))
+			return 1;
+		p += len;
+	}
+	*data = p;
+	return 0;
+}
+
+int
+mp_check_fast_scalar(const char **data, const char *end)
+{
+	return mp_check_fast_impl(data, end, mp_single_byte_run_scalar);
+}
+
+#if defined(MP_CHECK_FAST_X86)
+
+/*
+ * Byte classification shared by the vector implementations. A byte
+ * is a fixint if it's greater than -33 as a signed char, nil is 0xc0
+ * and booleans are 0xc2 and 0xc3, i.e. 0xc2 with the lowest bit
+ * masked out.
+ */
+
+__attribute__((target("sse4.2")))
+static inline size_t
+mp_single_byte_run_sse42(const char *p, const char *end)
+{
+	const __m128i fixint = _mm_set1_epi8(-33);
+	const __m128i nil = _mm_set1_epi8((char)0xc0);
+	const __m128i bool_mask = _mm_set1_epi8((char)0xfe);
+	const __m128i bool_val = _mm_set1_epi8((char)0xc2);
+	const char *begin = p;
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		__m128i m = _mm_or_si128(_mm_cmpgt_epi8(v, fixint),
+					 _mm_cmpeq_epi8(v, nil));
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_and_si128(v, bool_mask),
+						   bool_val));
+		uint32_t stop = ~(uint32_t)_mm_movemask_epi8(m) & 0xffff;
+		if (stop != 0)
+			return p - begin + __builtin_ctz(stop);
+		p += 16;
+	}
+	return p - begin + mp_single_byte_run_scalar(p, end);
+}
+
+__attribute__((target("sse4.2")))
+static int
+mp_check_fast_sse42(const char **data, const char *end)
+{
+	return mp_check_fast_impl(data, end, mp_single_byte_run_sse42);
+}
+
+__attribute__((target("avx2")))
+static inline size_t
+mp_single_byte_run_avx2(const char *p, const char *end)
+{
+	const __m256i fixint = _mm256_set1_epi8(-33);
+	const __m256i nil = _mm256_set1_epi8((char)0xc0);
+	const __m256i bool_mask = _mm256_set1_epi8((char)0xfe);
+	const __m256i bool_val = _mm256_set1_epi8((char)0xc2);
+	const char *begin = p;
+	while (end - p >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)p);
+		__m256i m = _mm256_or_si256(_mm256_cmpgt_epi8(v, fixint),
+					    _mm256_cmpeq_epi8(v, nil));
+		m = _mm256_or_si256(m, _mm256_cmpeq_epi8(
+				_mm256_and_si256(v, bool_mask), bool_val));
+		uint32_t stop = ~(uint32_t)_mm256_movemask_epi8(m);
+		if (stop != 0)
+			return p - begin + __builtin_ctz(stop);
+		p += 32;
+	}
+	return p - begin + mp_single_byte_run_sse42(p, end);
+}
+
+__attribute__((target("avx2")))
+static int
+mp_check_fast_avx2(const char **data, const char *end)
+{
+	return mp_check_fast_impl(data, end, mp_single_byte_run_avx2);
+}
+
+#endif /* defined(MP_CHECK_FAST_X86) */
+
+mp_check_fast_func mp_check_fast = mp_check_fast_scalar;
+
+void
+mp_check_fast_init(void)
+{
+#if defined(MP_CHECK_FAST_X86)
+	if (avx2_enabled_cpu())
+		mp_check_fast = mp_check_fast_avx2;
+	else if (sse42_enabled_cpu())
+		mp_check_fast = mp_check_fast_sse42;
+	else
+		mp_check_fast = mp_check_fast_scalar;
+#else
+	mp_check_fast = mp_check_fast_scalar;
+#endif
+}
@@ -0,0 +1,39 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Validates a single MsgPack value starting at *data, the same way
+ * mp_check() from msgpuck does. On success advances *data past the
+ * value and returns 0, otherwise returns 1 (*data is left unchanged).
+ */
+typedef int (*mp_check_fast_func)(const char **data, const char *end);
+
+/**
+ * Pointer to the fastest MsgPack validator supported by the CPU.
+ * Defaults to the scalar implementation until mp_check_fast_init()
+ * is called so it is always safe to use.
+ */
+extern mp_check_fast_func mp_check_fast;
+
+/** Scalar implementation of mp_check_fast(), always available. */
+int
+mp_check_fast_scalar(const char **data, const char *end);
+
+/**
+ * Picks the MsgPack validator implementation (AVX2, SSE4.2 or
+ * scalar) depending on the CPU features.
+ */
+void
+mp_check_fast_init(void);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
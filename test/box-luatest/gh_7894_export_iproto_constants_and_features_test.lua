@@ -84,6 +84,12 @@ local reference_table = {
         INSTANCE_NAME = 0x5d,
         SPACE_NAME = 0x5e,
         INDEX_NAME = 0x5f,
+        FIELDS = 0x60,
+        CHUNK_SIZE = 0x61,
+        COMPRESSION_LEVEL = 0x62,
+        JOIN_FILES = 0x63,
+        FILE_SIZE = 0x64,
+        SPACE_FILTER = 0x65,
     },
 
     -- `iproto_metadata_key` enumeration.
@@ -129,6 +135,8 @@ local reference_table = {
         BEGIN = 14,
         COMMIT = 15,
         ROLLBACK = 16,
+        INSERT_MANY = 17,
+        REPLACE_MANY = 18,
         RAFT = 30,
         RAFT_PROMOTE = 31,
         RAFT_DEMOTE = 32,
@@ -148,6 +156,7 @@ local reference_table = {
         UNWATCH = 75,
         EVENT = 76,
         WATCH_ONCE = 77,
+        JOIN_FILE = 78,
         CHUNK = 128,
         TYPE_ERROR = bit.lshift(1, 15),
         UNKNOWN = -1,
@@ -164,7 +173,7 @@ local reference_table = {
     },
 
     -- `IPROTO_CURRENT_VERSION` constant
-    protocol_version = 6,
+    protocol_version = 9,
 
     -- `feature_id` enumeration
     protocol_features = {
@@ -175,6 +184,9 @@ local reference_table = {
         pagination = true,
         space_and_index_names = true,
         watch_once = true,
+        field_projection = true,
+        select_chunks = true,
+        replication_compression = true,
     },
     feature = {
         streams = 0,
@@ -184,6 +196,9 @@ local reference_table = {
         pagination = 4,
         space_and_index_names = 5,
         watch_once = 6,
+        field_projection = 7,
+        select_chunks = 8,
+        replication_compression = 9,
     },
 }
 
@@ -0,0 +1,117 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('index_get_many', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+    index = {
+        {type = 'tree'},
+        {type = 'hash'},
+        {type = 'tree', hint = false},
+        {type = 'tree', inline_key = true},
+    },
+}))
+
+g.before_all(function(cg)
+    t.skip_if(cg.params.engine == 'vinyl' and
+              (cg.params.index.type ~= 'tree' or
+               cg.params.index.hint == false or cg.params.index.inline_key),
+              'unsupported by vinyl')
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_get_many = function(cg)
+    cg.server:exec(function(engine, opts)
+        local s = box.schema.space.create('test', {engine = engine})
+        opts = table.copy(opts)
+        opts.parts = {{1, 'unsigned'}, {2, 'string'}}
+        s:create_index('pk', opts)
+        for i = 1, 1000 do
+            s:insert({i, tostring(i), i * 2})
+        end
+        t.assert_equals(s:get_many({}), {})
+        local keys = {}
+        local expected = {}
+        for i = 1, 100 do
+            local id = i * 13 % 1100
+            keys[i] = {id, tostring(id)}
+            expected[i] = s:get(keys[i])
+        end
+        local res = s:get_many(keys)
+        t.assert_equals(table.maxn(res), table.maxn(expected))
+        for i = 1, 100 do
+            t.assert_equals(res[i], expected[i], keys[i])
+        end
+        t.assert_equals(s.index.pk:get_many({{1, '1'}, {1, '2'}, {2, '2'}}),
+                        {[1] = {1, '1', 2}, [3] = {2, '2', 4}})
+    end, {cg.params.engine, cg.params.index})
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function(engine, opts)
+        local s = box.schema.space.create('test', {engine = engine})
+        opts = table.copy(opts)
+        opts.parts = {{1, 'unsigned'}}
+        s:create_index('pk', opts)
+        s:create_index('sk', {parts = {{2, 'unsigned'}}, unique = false})
+        s:insert({1, 1})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, Usage: index:get_many({key1, key2, ...})",
+            s.get_many, s, 1)
+        t.assert_error_msg_content_equals(
+            "Invalid key part count in an exact match (expected 1, got 0)",
+            s.get_many, s, {{1}, {}})
+        t.assert_error_msg_content_equals(
+            "Supplied key type of part 0 does not match index part type: " ..
+            "expected unsigned",
+            s.get_many, s, {{1}, {'a'}})
+        t.assert_error_msg_content_equals(
+            "Get() doesn't support partial keys and non-unique indexes",
+            s.index.sk.get_many, s.index.sk, {{1}})
+        t.assert_equals(s:get_many({1, {1}, 2}), {{1, 1}, {1, 1}})
+    end, {cg.params.engine, cg.params.index})
+end
+
+g.test_mvcc = function(cg)
+    t.skip_if(cg.params.engine ~= 'memtx')
+    cg.server:exec(function(opts)
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', opts)
+        s:insert({1})
+        s:insert({2})
+        box.begin()
+        t.assert_equals(s:get_many({{1}, {2}, {3}}), {{1}, {2}})
+        local f = fiber.new(function()
+            s:replace({3})
+            s:delete({1})
+        end)
+        f:set_joinable(true)
+        t.assert_equals({f:join()}, {true})
+        -- The transaction was sent to a read view.
+        t.assert_equals(s:get_many({{1}, {2}, {3}}), {{1}, {2}})
+        t.assert_not(pcall(function()
+            s:replace({4})
+            box.commit()
+        end))
+        box.rollback()
+        t.assert_equals(s:get_many({{1}, {2}, {3}}), {[2] = {2}, [3] = {3}})
+    end, {cg.params.index})
+end
@@ -0,0 +1,140 @@
+local msgpack = require('msgpack')
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'super', nil, nil,
+                              {if_not_exists = true})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+local function inject_many(c, request, space, tuples)
+    local header = msgpack.encode({
+        [box.iproto.key.REQUEST_TYPE] = box.iproto.type[request],
+        [box.iproto.key.SYNC] = c:_next_sync(),
+        [box.iproto.key.STREAM_ID] = c._stream_id or 0,
+    })
+    local body = msgpack.encode({
+        [box.iproto.key.SPACE_ID] = type(space) == 'number' and space or nil,
+        [box.iproto.key.SPACE_NAME] = type(space) == 'string' and space or nil,
+        [box.iproto.key.TUPLE] = setmetatable(tuples, {__serialize = 'array'}),
+    })
+    local size = msgpack.encode(#header + #body)
+    return c:_inject(size .. header .. body)
+end
+
+g.test_iproto = function(cg)
+    local c = net.connect(cg.server.net_box_uri)
+    local id = cg.server:exec(function() return box.space.test.id end)
+    local lsn = cg.server:exec(function() return box.info.lsn end)
+    local stat = cg.server:exec(function() return box.stat().INSERT.total end)
+    inject_many(c, 'INSERT_MANY', id, {{1, 'a'}, {2, 'b'}, {3, 'c'}})
+    inject_many(c, 'INSERT_MANY', 'test', {})
+    inject_many(c, 'REPLACE_MANY', 'test', {{2, 'x'}, {4, 'y'}})
+    cg.server:exec(function(lsn, stat)
+        t.assert_equals(box.space.test:select(),
+                        {{1, 'a'}, {2, 'x'}, {3, 'c'}, {4, 'y'}})
+        -- Every tuple is written as a separate row.
+        t.assert_equals(box.info.lsn, lsn + 5)
+        t.assert_equals(box.stat().INSERT.total, stat + 3)
+    end, {lsn, stat})
+
+    -- A failed batch is rolled back as a whole.
+    t.assert_error_msg_content_equals(
+        'Duplicate key exists in unique index "pk" in space "test" with ' ..
+        'old tuple - [1, "a"] and new tuple - [1, "z"]',
+        inject_many, c, 'INSERT_MANY', id, {{5, 'z'}, {1, 'z'}})
+    t.assert_error_msg_content_equals(
+        'Tuple/Key must be MsgPack array',
+        inject_many, c, 'REPLACE_MANY', id, {{5, 'z'}, 5})
+    t.assert_error_msg_content_equals(
+        "Space '999' does not exist",
+        inject_many, c, 'INSERT_MANY', 999, {{5}})
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:get(5), nil)
+    end)
+    c:close()
+end
+
+g.test_iproto_stream = function(cg)
+    local c = net.connect(cg.server.net_box_uri)
+    local stream = c:new_stream()
+    stream:begin()
+    stream.space.test:insert({1})
+    inject_many(stream, 'INSERT_MANY', 'test', {{2}, {3}})
+    t.assert_error_msg_content_equals(
+        'Duplicate key exists in unique index "pk" in space "test" with ' ..
+        'old tuple - [1] and new tuple - [1]',
+        inject_many, stream, 'INSERT_MANY', 'test', {{4}, {1}})
+    t.assert_equals(stream.space.test:select(), {{1}, {2}, {3}})
+    stream:commit()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:select(), {{1}, {2}, {3}})
+    end)
+    c:close()
+end
+
+g.test_c_api = function(cg)
+    cg.server:exec(function()
+        local ffi = require('ffi')
+        local msgpack = require('msgpack')
+        ffi.cdef([[
+            int box_insert_many(uint32_t space_id, const char *tuples,
+                                const char *tuples_end);
+            int box_replace_many(uint32_t space_id, const char *tuples,
+                                 const char *tuples_end);
+        ]])
+        local function call(func, tuples)
+            local data = msgpack.encode(tuples)
+            if ffi.C[func](box.space.test.id, data, data + #data) ~= 0 then
+                box.error()
+            end
+        end
+        local s = box.space.test
+        call('box_insert_many', {{1}, {2}})
+        call('box_replace_many', {{2, 2}, {3, 3}})
+        t.assert_equals(s:select(), {{1}, {2, 2}, {3, 3}})
+        box.begin()
+        s:delete(1)
+        t.assert_error_msg_content_equals(
+            'Duplicate key exists in unique index "pk" in space "test" ' ..
+            'with old tuple - [3, 3] and new tuple - [3]',
+            call, 'box_insert_many', {{4}, {3}})
+        t.assert_equals(s:select(), {{2, 2}, {3, 3}})
+        box.commit()
+        t.assert_equals(s:select(), {{2, 2}, {3, 3}})
+        box.schema.user.create('guest2')
+        box.session.su('guest2', function()
+            t.assert_error_msg_content_equals(
+                "Write access to space 'test' is denied for user 'guest2'",
+                call, 'box_insert_many', {{5}})
+        end)
+        box.schema.user.drop('guest2')
+    end)
+end
@@ -0,0 +1,90 @@
+local fiber = require('fiber')
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, 1000 do
+            s:insert({i, string.rep(string.char(65 + i % 26), i % 100)})
+        end
+        box.commit()
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.conn = net.connect(cg.server.net_box_uri)
+end)
+
+g.after_each(function(cg)
+    cg.conn:close()
+end)
+
+local function expected(cg, ...)
+    return cg.server:exec(function(...)
+        return box.space.test:select(...)
+    end, {...})
+end
+
+-- Large responses are copied to the output buffer by the iproto thread.
+g.test_large = function(cg)
+    local s = cg.conn.space.test
+    t.assert_equals(s:select(), expected(cg))
+    t.assert_equals(s:select({500}, {iterator = 'ge'}),
+                    expected(cg, {500}, {iterator = 'ge'}))
+    local res, pos = s:select({}, {limit = 900, fetch_pos = true})
+    t.assert_equals(res, expected(cg, {}, {limit = 900}))
+    t.assert_equals(s:select({}, {after = pos}),
+                    expected(cg, {}, {offset = 900}))
+    -- Chunks are encoded by tx, the final batch may be copied by iproto.
+    local chunks = {}
+    res = s:select({}, {chunk_size = 600, on_push = function(ctx, chunk)
+        table.insert(ctx, chunk)
+    end, on_push_ctx = chunks})
+    t.assert_equals(#chunks, 1)
+    t.assert_equals(chunks[1], expected(cg, {}, {limit = 600}))
+    t.assert_equals(res, expected(cg, {}, {offset = 600}))
+    -- Projections are encoded by tx.
+    t.assert_equals(s:select({}, {fields = {1}}), cg.server:exec(function()
+        return box.space.test:select({}, {fields = {1}})
+    end))
+end
+
+-- Responses to concurrent requests are not mixed up.
+g.test_concurrent = function(cg)
+    local s = cg.conn.space.test
+    local all = expected(cg)
+    local fibers = {}
+    for i = 1, 20 do
+        local f = fiber.new(function()
+            if i % 2 == 0 then
+                return s:select()
+            else
+                return s:get(i)
+            end
+        end)
+        f:set_joinable(true)
+        fibers[i] = f
+    end
+    for i = 1, 20 do
+        local ok, res = fibers[i]:join()
+        t.assert(ok)
+        if i % 2 == 0 then
+            t.assert_equals(res, all)
+        else
+            t.assert_equals(res, all[i])
+        end
+    end
+end
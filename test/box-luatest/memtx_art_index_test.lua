@@ -0,0 +1,408 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        -- Checks that the ART index returns the same results as a TREE
+        -- index with the same definition for all iterator types.
+        rawset(_G, 'check_same', function(s, keys)
+            local tree = s.index.tree
+            local art = s.index.art
+            t.assert_equals(art:len(), tree:len())
+            t.assert_equals(art:select(), tree:select())
+            t.assert_equals(art:select({}, {iterator = 'le'}),
+                            tree:select({}, {iterator = 'le'}))
+            t.assert_equals(art:min(), tree:min())
+            t.assert_equals(art:max(), tree:max())
+            for _, key in ipairs(keys) do
+                for _, it in ipairs({'eq', 'req', 'ge', 'gt', 'le', 'lt'}) do
+                    local opts = {iterator = it}
+                    t.assert_equals(art:select(key, opts),
+                                    tree:select(key, opts),
+                                    {key = key, iterator = it})
+                    t.assert_equals(art:count(key, opts),
+                                    tree:count(key, opts))
+                end
+            end
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_unsupported = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local function check(parts, err)
+            t.assert_error_msg_content_equals(err, s.create_index, s, 'sk',
+                                              {type = 'art', parts = parts})
+        end
+        local msg = "Can't create or modify index 'sk' in space 'test': " ..
+                    "ART index field type must be unsigned, integer, " ..
+                    "string, varbinary, boolean or uuid"
+        check({{2, 'number'}}, msg)
+        check({{2, 'double'}}, msg)
+        check({{2, 'scalar'}}, msg)
+        check({{2, 'decimal'}}, msg)
+        check({{2, 'string', collation = 'unicode_ci'}},
+              "Can't create or modify index 'sk' in space 'test': " ..
+              "ART index does not support collations")
+        check({{'[2][*]', 'unsigned'}},
+              "Can't create or modify index 'sk' in space 'test': " ..
+              "ART index cannot be multikey")
+        -- The primary key is appended to a secondary index so it must be
+        -- normalizable, too.
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk', {parts = {{1, 'number'}}})
+        t.assert_error_msg_contains("ART index field type must be",
+                                    s2.create_index, s2, 'sk',
+                                    {type = 'art', unique = false,
+                                     parts = {{2, 'unsigned'}}})
+        s2:drop()
+    end)
+end
+
+g.test_integer_keys = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art', parts = {{1, 'integer'}}})
+        s:create_index('tree', {parts = {{2, 'unsigned'}, {3, 'integer'}},
+                                unique = false})
+        s:create_index('art', {type = 'art', unique = false,
+                               parts = {{2, 'unsigned'}, {3, 'integer'}}})
+        local min = -9223372036854775808LL
+        local max = 9223372036854775807LL
+        local umax = 18446744073709551615ULL
+        local values = {min, -1000, -1, 0, 1, 255, 256, 2^32, max}
+        local id = 0
+        for _, a in ipairs({0, 1, 1000, umax}) do
+            for _, b in ipairs(values) do
+                id = id + 1
+                s:insert({id, a, b})
+                id = id + 1
+                s:insert({-id, a, b})
+            end
+        end
+        local keys = {{}, {0}, {1}, {2}, {umax}}
+        for _, a in ipairs({0, 1, 5}) do
+            for _, b in ipairs({min, -1, 0, 2, max}) do
+                table.insert(keys, {a, b})
+            end
+        end
+        _G.check_same(s, keys)
+        -- Delete every other tuple and check again.
+        for i = 1, id, 2 do
+            s:delete(i)
+        end
+        _G.check_same(s, keys)
+        t.assert_equals(s.index.pk:get(-2), {-2, 0, min})
+        t.assert_equals(s.index.pk:get(3), nil)
+        t.assert_equals(s.index.pk:select({-4}), {{-4, 0, -1000}})
+    end)
+end
+
+g.test_string_keys = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art', parts = {{1, 'string'}}})
+        s:create_index('pk_tree', {parts = {{1, 'string'}}})
+        s:create_index('tree', {parts = {{2, 'varbinary'}, {3, 'boolean'}},
+                                unique = false})
+        s:create_index('art', {type = 'art', unique = false,
+                               parts = {{2, 'varbinary'}, {3, 'boolean'}}})
+        local strs = {'', '\0', '\0\0', '\0\1', '\1', 'a', 'a\0', 'a\0b',
+                      'ab', 'abc', 'abd', 'b', '\255', '\255\255'}
+        local varbinary = require('varbinary')
+        for i, str in ipairs(strs) do
+            s:insert({str, varbinary.new(str), i % 2 == 0})
+            s:insert({str .. '!', varbinary.new(str), i % 3 == 0})
+        end
+        -- Keys sharing long prefixes make the tree deep.
+        for i = 1, 100 do
+            s:insert({string.rep('x', i), varbinary.new(string.rep('x', i)),
+                      false})
+        end
+        local keys = {{}}
+        for _, str in ipairs(strs) do
+            table.insert(keys, {varbinary.new(str)})
+            table.insert(keys, {varbinary.new(str), true})
+            table.insert(keys, {varbinary.new(str), false})
+        end
+        table.insert(keys, {varbinary.new(string.rep('x', 50))})
+        _G.check_same(s, keys)
+        local pk_keys = {}
+        for _, str in ipairs(strs) do
+            table.insert(pk_keys, {str})
+        end
+        for _, key in ipairs(pk_keys) do
+            for _, it in ipairs({'ge', 'gt', 'le', 'lt'}) do
+                local opts = {iterator = it}
+                t.assert_equals(s.index.pk:select(key, opts),
+                                s.index.pk_tree:select(key, opts))
+            end
+        end
+        t.assert_equals(s.index.pk:get('a\0b')[3], true)
+        t.assert_equals(s.index.pk:get('a\0c'), nil)
+    end)
+end
+
+g.test_uuid_keys = function(cg)
+    cg.server:exec(function()
+        local uuid = require('uuid')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art', parts = {{1, 'uuid'}}})
+        s:create_index('tree', {parts = {{2, 'uuid'}}, unique = false})
+        s:create_index('art', {type = 'art', parts = {{2, 'uuid'}},
+                               unique = false})
+        local keys = {{}, {uuid.NULL}}
+        for i = 1, 100 do
+            local u = uuid.new()
+            s:insert({u, i % 10 == 0 and uuid.NULL or u})
+            table.insert(keys, {u})
+        end
+        _G.check_same(s, keys)
+    end)
+end
+
+g.test_unique = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('art', {type = 'art', parts = {{2, 'string'}}})
+        s:insert({1, 'a'})
+        s:insert({2, 'ab'})
+        t.assert_error_msg_content_equals(
+            'Duplicate key exists in unique index "art" in space "test" ' ..
+            'with old tuple - [1, "a"] and new tuple - [3, "a"]',
+            s.insert, s, {3, 'a'})
+        -- The failed insertion must leave the index unchanged.
+        t.assert_equals(s.index.art:select(), {{1, 'a'}, {2, 'ab'}})
+        s:replace({1, 'b'})
+        t.assert_equals(s.index.art:select(), {{2, 'ab'}, {1, 'b'}})
+        t.assert_equals(s.index.art:get('a'), nil)
+        t.assert_equals(s.index.art:get('b'), {1, 'b'})
+        s:update(2, {{'=', 2, 'a'}})
+        t.assert_equals(s.index.art:select(), {{2, 'a'}, {1, 'b'}})
+        s:delete(2)
+        t.assert_equals(s.index.art:select(), {{1, 'b'}})
+        t.assert_equals(s.index.art:len(), 1)
+        t.assert(s.index.art:bsize() > 0)
+    end)
+end
+
+g.test_nullable = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local parts = {{2, 'unsigned', is_nullable = true},
+                       {3, 'string', is_nullable = true}}
+        s:create_index('tree', {parts = parts})
+        s:create_index('art', {type = 'art', parts = parts})
+        local id = 0
+        for _, a in ipairs({box.NULL, 1, 2}) do
+            for _, b in ipairs({box.NULL, 'a', 'b'}) do
+                id = id + 1
+                s:insert({id, a, b})
+                -- A unique nullable index can store multiple NULLs.
+                if a == nil or b == nil then
+                    id = id + 1
+                    s:insert({id, a, b})
+                end
+            end
+        end
+        -- Absent optional field.
+        id = id + 1
+        s:insert({id, 3})
+        _G.check_same(s, {{}, {box.NULL}, {1}, {box.NULL, box.NULL},
+                       {1, box.NULL}, {2, 'a'}, {3}, {3, box.NULL}})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {100, 1, 'a'})
+    end)
+end
+
+g.test_pagination = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art'})
+        s:create_index('sk', {type = 'art', parts = {{2, 'unsigned'}},
+                              unique = false})
+        for i = 1, 20 do
+            s:insert({i, i % 4})
+        end
+        for _, it in ipairs({'ge', 'gt', 'le', 'lt', 'eq', 'req'}) do
+            for _, idx in ipairs({s.index.pk, s.index.sk}) do
+                local key = it:find('e') and {2} or {1}
+                local expected = idx:select(key, {iterator = it})
+                local res = {}
+                local pos
+                repeat
+                    local page
+                    page, pos = idx:select(key, {iterator = it, limit = 3,
+                                                 fetch_pos = true,
+                                                 after = pos})
+                    for _, tuple in ipairs(page) do
+                        table.insert(res, tuple)
+                    end
+                until #page == 0
+                t.assert_equals(res, expected, {idx = idx.name, it = it})
+            end
+        end
+    end)
+end
+
+g.test_iterator_stability = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art'})
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        local res = {}
+        for _, tuple in s:pairs() do
+            table.insert(res, tuple[1])
+            s:delete(tuple[1])
+            s:insert({tuple[1] + 1000})
+            if #res == 50 then
+                break
+            end
+        end
+        for i = 1, 50 do
+            t.assert_equals(res[i], i)
+        end
+        res = {}
+        for _, tuple in s:pairs({1000}, {iterator = 'lt'}) do
+            table.insert(res, tuple[1])
+            s:delete(tuple[1])
+        end
+        t.assert_equals(#res, 50)
+        t.assert_equals(res[1], 100)
+        t.assert_equals(res[50], 51)
+    end)
+end
+
+g.test_mvcc = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art'})
+        s:insert({1})
+        s:insert({3})
+        -- A reader doesn't see uncommitted changes.
+        local f = fiber.create(function()
+            box.begin()
+            s:insert({2})
+            fiber.sleep(1000)
+        end)
+        t.assert_equals(s:select(), {{1}, {3}})
+        f:cancel()
+        -- A gap read conflicts with a concurrent insertion into the gap.
+        box.begin()
+        t.assert_equals(s:select({1}, {iterator = 'gt'}), {{3}})
+        f = fiber.new(function() s:insert({2}) end)
+        f:set_joinable(true)
+        t.assert_equals({f:join()}, {true})
+        t.assert_error_msg_content_equals(
+            'Transaction has been aborted by conflict', s.replace, s, {4})
+        box.rollback()
+        t.assert_equals(s:select(), {{1}, {2}, {3}})
+    end)
+end
+
+g.test_read_view = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art'})
+        for i = 1, 10 do
+            s:insert({i})
+        end
+        -- Snapshot uses a read view of the primary index.
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test.index.pk.type, 'ART')
+        t.assert_equals(box.space.test:len(), 10)
+        t.assert_equals(box.space.test:select({5}, {iterator = 'ge'}),
+                        {{5}, {6}, {7}, {8}, {9}, {10}})
+    end)
+end
+
+g.test_memory = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art'})
+        local sk = s:create_index('sk', {type = 'art',
+                                         parts = {{2, 'string'}}})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100) .. i})
+        end
+        t.assert_error_msg_contains('Key part is too long',
+                                    s.insert, s, {0, string.rep('x', 10000)})
+        t.assert_equals(s:len(), 1000)
+        -- Tree nodes are allocated from memtx index extents.
+        local bsize = sk:bsize()
+        t.assert_gt(bsize, 100 * 1000)
+        local mem = box.info.memory().index
+        sk:drop()
+        -- Dropping the index also changes system space indexes.
+        t.assert_almost_equals(box.info.memory().index, mem - bsize,
+                               4 * 16384)
+    end)
+end
+
+-- Rollback of changes doesn't fail if a read view is opened while the
+-- changes wait for WAL so tree nodes have to be copied.
+g.test_rollback_read_view = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art'})
+        for i = 1, 100, 2 do
+            s:insert({i})
+        end
+        local expected = s:select()
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local f = fiber.new(function()
+            box.begin()
+            for i = 1, 100 do
+                s:replace({i})
+            end
+            for i = 1, 100, 4 do
+                s:delete(i)
+            end
+            box.commit()
+        end)
+        f:set_joinable(true)
+        fiber.yield()
+        local rv = box.read_view.open()
+        box.error.injection.set('ERRINJ_WAL_IO', true)
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        local ok, err = f:join()
+        box.error.injection.set('ERRINJ_WAL_IO', false)
+        t.assert_not(ok)
+        t.assert_equals(err.message, 'Failed to write to disk')
+        t.assert_equals(s:select(), expected)
+        t.assert_equals(rv.space.test.index.pk:select(), expected)
+        rv:close()
+        t.assert_equals(s:select(), expected)
+    end)
+end
@@ -0,0 +1,192 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+    cg.server:exec(function()
+        -- Checks that an index with hash_func = 'xxh3' returns the same
+        -- results as a regular HASH index with the same definition.
+        rawset(_G, 'check_same', function(s, keys)
+            local murmur = s.index.murmur
+            local xxh3 = s.index.xxh3
+            t.assert_equals(xxh3:len(), murmur:len())
+            for _, key in ipairs(keys) do
+                t.assert_equals(xxh3:get(key), murmur:get(key), {key = key})
+                t.assert_equals(xxh3:select(key), murmur:select(key),
+                                {key = key})
+            end
+            local count = 0
+            for _, tuple in murmur:pairs() do
+                local key = murmur:extract_key(tuple)
+                t.assert_equals(xxh3:get(key), tuple)
+                count = count + 1
+            end
+            t.assert_equals(count, murmur:len())
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_unsupported = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "hash_func is only reasonable with memtx hash index",
+            s.create_index, s, 'sk', {hash_func = 'xxh3'})
+        t.assert_error_msg_content_equals(
+            "Wrong index options: hash_func must be either 'murmur3' " ..
+            "or 'xxh3'",
+            s.create_index, s, 'sk', {type = 'hash', hash_func = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "hash_func is only supported for HASH index",
+            box.space._index.insert, box.space._index,
+            {s.id, 1, 'sk', 'tree', {hash_func = 'xxh3'}, {{1, 'unsigned'}}})
+
+        local v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test_vinyl': " ..
+            "hash_func is only reasonable with memtx hash index",
+            v.create_index, v, 'pk', {hash_func = 'xxh3'})
+        v:drop()
+    end)
+end)
+
+g.test_option = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', hash_func = 'xxh3'})
+        s:create_index('sk', {type = 'hash', parts = {{2, 'string'}}})
+        s:create_index('tree', {parts = {{2, 'string'}}})
+        t.assert_equals(s.index.pk.hash_func, 'XXH3')
+        t.assert_equals(s.index.sk.hash_func, nil)
+        t.assert_equals(s.index.tree.hash_func, nil)
+        for i = 1, 100 do
+            s:insert({i, 'v' .. i})
+        end
+        s.index.sk:alter({hash_func = 'XXH3'})
+        t.assert_equals(s.index.sk.hash_func, 'XXH3')
+        t.assert_equals(s.index.sk:get({'v10'}), {10, 'v10'})
+        s.index.pk:alter({hash_func = 'murmur3'})
+        t.assert_equals(s.index.pk.hash_func, nil)
+        t.assert_equals(s.index.pk:get({10}), {10, 'v10'})
+        t.assert_equals(s.index.pk:len(), 100)
+    end)
+end)
+
+g.test_types = function(cg)
+    cg.server:exec(function()
+        local parts = {
+            {{2, 'unsigned'}},
+            {{2, 'string'}},
+            {{2, 'string', collation = 'unicode_ci'}},
+            {{2, 'double'}},
+            {{2, 'number'}},
+            {{2, 'scalar'}},
+            {{2, 'integer'}, {3, 'string'}},
+            {{3, 'string'}, {2, 'integer'}},
+        }
+        local values = {
+            unsigned = function(i) return i * 2^40 end,
+            string = function(i) return string.rep('x', i % 300) .. i end,
+            double = function(i) return i / 4 end,
+            number = function(i) return i % 2 == 0 and i or i + 0.5 end,
+            scalar = function(i) return i % 2 == 0 and i or tostring(i) end,
+            integer = function(i) return i % 2 == 0 and i or -i end,
+        }
+        for _, p in ipairs(parts) do
+            local s = box.schema.space.create('test')
+            s:create_index('pk')
+            s:create_index('murmur', {type = 'hash', parts = p})
+            s:create_index('xxh3', {type = 'hash', parts = p,
+                                    hash_func = 'xxh3'})
+            local keys = {}
+            for i = 1, 500 do
+                local tuple = {i, 0, ''}
+                local key = {}
+                for j, part in ipairs(p) do
+                    local v = values[part[2]](i)
+                    tuple[part[1]] = v
+                    key[j] = v
+                end
+                s:insert(tuple)
+                table.insert(keys, key)
+            end
+            table.insert(keys, p[1][2] == 'string' and {'foo'} or {0})
+            check_same(s, keys)
+            for i = 1, 500, 7 do
+                s:delete({i})
+            end
+            check_same(s, keys)
+            s:drop()
+        end
+    end)
+end)
+
+g.test_normalization = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('xxh3', {type = 'hash', parts = {{2, 'number'}},
+                                hash_func = 'xxh3'})
+        s:create_index('double', {type = 'hash', parts = {{3, 'double'}},
+                                  hash_func = 'xxh3'})
+        s:create_index('ci', {type = 'hash', hash_func = 'xxh3',
+                              parts = {{4, 'string',
+                                        collation = 'unicode_ci'}}})
+        s:insert({1, 10, 1.5, 'Foo'})
+        s:insert({2, 2.5, 2, 'bar'})
+        t.assert_equals(s.index.xxh3:get({10.0}), {1, 10, 1.5, 'Foo'})
+        t.assert_equals(s.index.xxh3:get({2.5}), {2, 2.5, 2, 'bar'})
+        t.assert_equals(s.index.double:get({2}), {2, 2.5, 2, 'bar'})
+        t.assert_equals(s.index.double:get({2.0}), {2, 2.5, 2, 'bar'})
+        t.assert_equals(s.index.ci:get({'FOO'}), {1, 10, 1.5, 'Foo'})
+        t.assert_equals(s.index.ci:get({'Bar'}), {2, 2.5, 2, 'bar'})
+        t.assert_error_msg_contains(
+            'Duplicate key exists in unique index "ci"',
+            s.insert, s, {3, 3, 3, 'fOo'})
+    end)
+end)
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', hash_func = 'xxh3'})
+        s:create_index('sk', {type = 'hash', parts = {{2, 'string'}},
+                              hash_func = 'xxh3'})
+        for i = 1, 1000 do
+            s:insert({i, 'v' .. i})
+        end
+        box.snapshot()
+        for i = 1001, 1100 do
+            s:insert({i, 'v' .. i})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.pk.hash_func, 'XXH3')
+        t.assert_equals(s.index.sk.hash_func, 'XXH3')
+        t.assert_equals(s.index.pk:len(), 1100)
+        for i = 1, 1100 do
+            t.assert_equals(s.index.pk:get({i}), {i, 'v' .. i})
+            t.assert_equals(s.index.sk:get({'v' .. i}), {i, 'v' .. i})
+        end
+    end)
+end
@@ -0,0 +1,228 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+    cg.server:exec(function()
+        -- Checks that an index with inline_key returns the same results
+        -- as a regular TREE index with the same definition.
+        rawset(_G, 'check_same', function(s, keys)
+            local plain = s.index.plain
+            local inline = s.index.inline
+            t.assert_equals(inline:len(), plain:len())
+            t.assert_equals(inline:select(), plain:select())
+            t.assert_equals(inline:select({}, {iterator = 'le'}),
+                            plain:select({}, {iterator = 'le'}))
+            for _, key in ipairs(keys) do
+                for _, it in ipairs({'eq', 'req', 'ge', 'gt', 'le', 'lt'}) do
+                    local opts = {iterator = it}
+                    t.assert_equals(inline:select(key, opts),
+                                    plain:select(key, opts),
+                                    {key = key, iterator = it})
+                end
+            end
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_unsupported = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local function check(opts, err)
+            opts.inline_key = true
+            t.assert_error_msg_content_equals(
+                "Can't create or modify index 'sk' in space 'test': " .. err,
+                s.create_index, s, 'sk', opts)
+        end
+        check({type = 'hash'},
+              "inline_key is only reasonable with memtx tree index")
+        check({hint = true}, "index can't use both hints and inline_key")
+        check({parts = {{'[2][*]', 'unsigned'}}, unique = false},
+              "multikey index can't use inline_key")
+        local msg = "inline_key is only supported for unsigned, integer, " ..
+                    "string without collation, varbinary, boolean and " ..
+                    "uuid parts"
+        check({parts = {{2, 'double'}}}, msg)
+        check({parts = {{2, 'string', collation = 'unicode_ci'}}}, msg)
+        check({parts = {{2, 'scalar'}}}, msg)
+
+        local v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test_vinyl': " ..
+            "inline_key is only reasonable with memtx tree index",
+            v.create_index, v, 'pk', {inline_key = true})
+        v:drop()
+    end)
+end)
+
+g.test_option = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {inline_key = true})
+        s:create_index('sk', {parts = {{2, 'string'}}})
+        t.assert_equals(s.index.pk.inline_key, true)
+        t.assert_equals(s.index.sk.inline_key, nil)
+        t.assert_equals(s.index.sk.hint, true)
+        s:insert({1, 'a'})
+        s.index.sk:alter({inline_key = true})
+        t.assert_equals(s.index.sk.inline_key, true)
+        t.assert_equals(s.index.sk:select(), {{1, 'a'}})
+        s.index.pk:alter({inline_key = false})
+        t.assert_equals(s.index.pk.inline_key, nil)
+        t.assert_equals(s.index.pk:select(), {{1, 'a'}})
+    end)
+end)
+
+g.test_unsigned = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local parts = {{2, 'unsigned'}, {3, 'unsigned'}}
+        s:create_index('plain', {parts = parts, unique = false})
+        s:create_index('inline', {parts = parts, unique = false,
+                                  inline_key = true})
+        for i = 1, 500 do
+            s:insert({i, i % 7, i % 13 * 2^40})
+        end
+        local keys = {{}, {0}, {3}, {6}, {7}, {3, 0}, {3, 2^40},
+                      {3, 3 * 2^40}, {3, 5}, {0xFFFFFFFFFFFFFFFFULL}}
+        check_same(s, keys)
+        s:delete({7})
+        s:replace({8, 3, 2^40})
+        check_same(s, keys)
+    end)
+end)
+
+g.test_string = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local parts = {{2, 'string'}, {3, 'integer'}}
+        s:create_index('plain', {parts = parts})
+        s:create_index('inline', {parts = parts, inline_key = true})
+        -- Strings with common prefixes longer than the inlined part of
+        -- the key and strings with zero bytes.
+        local prefix = 'https://example.com/'
+        local keys = {{}, {''}, {prefix}, {'\0'}, {'\0\0'}}
+        for i = 1, 300 do
+            local str = i % 3 == 0 and prefix .. i or
+                        i % 3 == 1 and ('\0'):rep(i % 5) or tostring(i % 17)
+            s:insert({i, str, i % 2 == 0 and -i or i})
+            table.insert(keys, {str})
+            table.insert(keys, {str, -i})
+            table.insert(keys, {str .. '\0'})
+        end
+        check_same(s, keys)
+    end)
+end)
+
+g.test_nullable = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local parts = {{2, 'integer', is_nullable = true},
+                       {3, 'boolean', is_nullable = true}}
+        s:create_index('plain', {parts = parts, unique = false})
+        s:create_index('inline', {parts = parts, unique = false,
+                                  inline_key = true})
+        for i = 1, 200 do
+            local a = i % 5 ~= 0 and i % 11 - 5 or nil
+            local b = i % 3 == 0 and box.NULL or i % 3 == 1
+            s:insert({i, a, b})
+        end
+        check_same(s, {{}, {box.NULL}, {box.NULL, true}, {-5}, {0},
+                       {0, box.NULL}, {0, false}, {5, true}})
+    end)
+end)
+
+g.test_build = function(cg)
+    cg.server:exec(function()
+        local uuid = require('uuid')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 1000 do
+            s:insert({i, tostring(i):rep(3), uuid.new()})
+        end
+        local parts = {{2, 'string'}, {3, 'uuid'}}
+        s:create_index('plain', {parts = parts})
+        s:create_index('inline', {parts = parts, inline_key = true})
+        check_same(s, {{'1'}, {'111'}, {'500500500'}, {'999'}})
+    end)
+end)
+
+g.test_pagination = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {inline_key = true})
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        local res, pos = s:select({}, {limit = 10, fetch_pos = true})
+        t.assert_equals(res[10], {10})
+        res = s:select({}, {limit = 10, after = pos})
+        t.assert_equals(res[1], {11})
+        res = s:select({50}, {iterator = 'lt', limit = 2, after = {40}})
+        t.assert_equals(res, {{39}, {38}})
+        local cnt = 0
+        for _, tuple in s:pairs({20}, {iterator = 'ge'}) do
+            cnt = cnt + 1
+            s:delete({tuple[1] + 1})
+        end
+        t.assert_equals(cnt, 41)
+    end)
+end)
+
+g.test_sql = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'ID', 'integer'}, {'V', 'string'}},
+        })
+        s:create_index('pk', {inline_key = true})
+        for i = -5, 5 do
+            s:insert({i, tostring(i)})
+        end
+        local res = box.execute([[SELECT ID FROM "test" WHERE ID > 1.5;]])
+        t.assert_equals(res.rows, {{2}, {3}, {4}, {5}})
+        res = box.execute([[SELECT ID FROM "test" WHERE ID <= -2.5;]])
+        t.assert_equals(res.rows, {{-5}, {-4}, {-3}})
+    end)
+end)
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {parts = {{1, 'string'}}, inline_key = true})
+        for i = 1, 100 do
+            s:insert({('key%05d'):format(i)})
+        end
+        box.snapshot()
+        for i = 101, 200 do
+            s:insert({('key%05d'):format(i)})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.pk.inline_key, true)
+        t.assert_equals(s:len(), 200)
+        t.assert_equals(s:get({'key00150'}), {'key00150'})
+        t.assert_equals(s:select({'key00100'}, {iterator = 'gt', limit = 1}),
+                        {{'key00101'}})
+    end)
+end)
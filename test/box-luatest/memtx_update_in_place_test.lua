@@ -0,0 +1,236 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'id', 'unsigned'}, {'name', 'string'},
+                      {'counter', 'unsigned'}},
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {'name'}})
+        s:insert({1, 'a', 10})
+        s:insert({2, 'b', 20})
+
+        local ffi = require('ffi')
+        -- Returns the address of the tuple with the given key. The tuple
+        -- isn't referenced from Lua after the call.
+        rawset(_G, 'tuple_addr', function(key)
+            local tuple = box.space.test:get(key)
+            local addr = tonumber(ffi.cast('uintptr_t',
+                                           ffi.cast('void *', tuple)))
+            tuple = nil -- luacheck: ignore
+            collectgarbage()
+            return addr
+        end)
+        -- Updates a tuple without keeping the result referenced.
+        rawset(_G, 'update', function(key, ops)
+            box.space.test:update(key, ops)
+            collectgarbage()
+        end)
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_in_place = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        _G.update(1, {{'+', 'counter', 1}})
+        t.assert_equals(s:get(1), {1, 'a', 11})
+        t.assert_equals(_G.tuple_addr(1), addr)
+        _G.update({1}, {{'=', 3, 100}, {'-', 3, 50}})
+        t.assert_equals(s:get(1), {1, 'a', 50})
+        t.assert_equals(_G.tuple_addr(1), addr)
+        t.assert_equals(s.index.sk:get('a'), {1, 'a', 50})
+        local msgpack = require('msgpack')
+        t.assert_equals(s:bsize(), 2 * #msgpack.encode({1, 'a', 10}))
+
+        -- The data size changes.
+        _G.update(1, {{'=', 3, 1000}})
+        t.assert_equals(s:get(1), {1, 'a', 1000})
+        t.assert_not_equals(_G.tuple_addr(1), addr)
+
+        -- An indexed field changes.
+        addr = _G.tuple_addr(2)
+        _G.update(2, {{'=', 'name', 'c'}})
+        t.assert_equals(s.index.sk:get('c'), {2, 'c', 20})
+        t.assert_equals(s.index.sk:get('b'), nil)
+        t.assert_not_equals(_G.tuple_addr(2), addr)
+
+        -- Invalid update.
+        t.assert_error_msg_contains("expected unsigned, got string",
+                                    s.update, s, 2, {{'=', 3, 'x'}})
+        t.assert_equals(s:get(2), {2, 'c', 20})
+    end)
+end
+
+g.test_referenced = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        local tuple = s:get(1)
+        _G.update(1, {{'+', 3, 1}})
+        t.assert_equals(tuple, {1, 'a', 10})
+        t.assert_equals(s:get(1), {1, 'a', 11})
+        t.assert_not_equals(_G.tuple_addr(1), addr)
+    end)
+end
+
+g.test_rollback = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        box.begin()
+        _G.update(1, {{'+', 3, 1}})
+        local svp = box.savepoint()
+        _G.update(1, {{'+', 3, 1}})
+        t.assert_equals(s:get(1), {1, 'a', 12})
+        box.rollback_to_savepoint(svp)
+        t.assert_equals(s:get(1), {1, 'a', 11})
+        _G.update(1, {{'+', 3, 5}})
+        t.assert_equals(s:get(1), {1, 'a', 16})
+        box.rollback()
+        t.assert_equals(s:get(1), {1, 'a', 10})
+        t.assert_equals(_G.tuple_addr(1), addr)
+    end)
+end
+
+g.test_wal_error = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local s = box.space.test
+        box.error.injection.set('ERRINJ_WAL_WRITE', true)
+        t.assert_error_msg_content_equals(
+            "Failed to write to disk", s.update, s, 1, {{'+', 3, 1}})
+        box.error.injection.set('ERRINJ_WAL_WRITE', false)
+        t.assert_equals(s:get(1), {1, 'a', 10})
+    end)
+end
+
+-- A tuple referenced while the update waits for WAL stays the same
+-- when the update is rolled back.
+g.test_wal_error_referenced = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local f = fiber.new(_G.update, 1, {{'+', 3, 1}})
+        f:set_joinable(true)
+        fiber.yield()
+        t.assert_equals(_G.tuple_addr(1), addr)
+        local tuple = s:get(1)
+        t.assert_equals(tuple, {1, 'a', 11})
+        box.error.injection.set('ERRINJ_WAL_IO', true)
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        local ok, err = f:join()
+        box.error.injection.set('ERRINJ_WAL_IO', false)
+        t.assert_not(ok)
+        t.assert_equals(err.message, 'Failed to write to disk')
+        t.assert_equals(tuple, {1, 'a', 11})
+        t.assert_equals(s:get(1), {1, 'a', 10})
+        t.assert_equals(s.index.sk:get('a'), {1, 'a', 10})
+        t.assert_not_equals(_G.tuple_addr(1), addr)
+    end)
+end
+
+-- A tuple visible in a read view opened while the update waits for WAL
+-- stays the same when the update is rolled back.
+g.test_wal_error_read_view = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local f = fiber.new(_G.update, 1, {{'+', 3, 1}})
+        f:set_joinable(true)
+        fiber.yield()
+        t.assert_equals(_G.tuple_addr(1), addr)
+        local rv = box.read_view.open()
+        t.assert_equals(rv.space.test.index.pk:select()[1], {1, 'a', 11})
+        box.error.injection.set('ERRINJ_WAL_IO', true)
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        local ok, err = f:join()
+        box.error.injection.set('ERRINJ_WAL_IO', false)
+        t.assert_not(ok)
+        t.assert_equals(err.message, 'Failed to write to disk')
+        t.assert_equals(rv.space.test.index.pk:select()[1], {1, 'a', 11})
+        t.assert_equals(s:get(1), {1, 'a', 10})
+        t.assert_not_equals(_G.tuple_addr(1), addr)
+        rv:close()
+    end)
+end
+
+-- Statements of a multi-statement transaction may be observed by the
+-- user, so the old tuple isn't updated in place.
+g.test_multi_statement = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        local log = {}
+        box.begin()
+        _G.update(1, {{'+', 3, 1}})
+        box.on_commit(function(iterator)
+            for _, old, new in iterator() do
+                table.insert(log, {old, new})
+            end
+        end)
+        box.commit()
+        t.assert_equals(log, {{{1, 'a', 10}, {1, 'a', 11}}})
+        t.assert_equals(s:get(1), {1, 'a', 11})
+        t.assert_not_equals(_G.tuple_addr(1), addr)
+    end)
+end
+
+-- Tuples created with an older format aren't updated in place.
+g.test_old_format = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        s:format({{'id', 'unsigned'}, {'name', 'string'},
+                  {'counter', 'unsigned'}, {'extra', 'any',
+                                            is_nullable = true}})
+        _G.update(1, {{'+', 3, 1}})
+        t.assert_equals(s:get(1), {1, 'a', 11})
+        t.assert_not_equals(_G.tuple_addr(1), addr)
+        addr = _G.tuple_addr(1)
+        _G.update(1, {{'+', 3, 1}})
+        t.assert_equals(s:get(1), {1, 'a', 12})
+        t.assert_equals(_G.tuple_addr(1), addr)
+    end)
+end
+
+g.test_triggers = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local addr = _G.tuple_addr(1)
+        local log = {}
+        local function trigger(old, new)
+            table.insert(log, {old, new})
+        end
+        s:on_replace(trigger)
+        _G.update(1, {{'+', 3, 1}})
+        s:on_replace(nil, trigger)
+        t.assert_equals(log, {{{1, 'a', 10}, {1, 'a', 11}}})
+        t.assert_not_equals(_G.tuple_addr(1), addr)
+    end)
+end
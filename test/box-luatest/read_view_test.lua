@@ -4,19 +4,218 @@ local t = require('luatest')
 local g = t.group()
 
 g.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
     cg.server = server:new({alias = 'master'})
     cg.server:start()
 end)
 
 g.after_all(function(cg)
-    cg.server:stop()
+    if cg.server ~= nil then
+        cg.server:stop()
+    end
 end)
 
-g.test_read_view = function(cg)
-    t.tarantool.skip_if_enterprise()
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'id', 'unsigned'}, {'val', 'string'}},
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'val'}}, unique = false})
+        for i = 1, 10 do
+            s:insert({i, 'v' .. i % 3})
+        end
+    end)
+end)
+
+g.after_each(function(cg)
     cg.server:exec(function()
+        for _, rv in ipairs(box.read_view.list()) do
+            if not rv.is_system and rv.status == 'open' then
+                rv:close()
+            end
+        end
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        collectgarbage()
+    end)
+end)
+
+g.test_open = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Illegal parameters, options should be a table",
+            box.read_view.open, 'foo')
+        t.assert_error_msg_equals(
+            "Illegal parameters, name should be a string",
+            box.read_view.open, {name = 1})
+
+        local rv = box.read_view.open({name = 'test_rv'})
+        t.assert_equals(rv.name, 'test_rv')
+        t.assert_equals(rv.is_system, false)
+        t.assert_equals(rv.status, 'open')
+        t.assert_equals(rv.signature, box.info.signature)
+        t.assert_is(box.read_view.list()[1], rv)
+        t.assert_equals(box.read_view.open().name, 'unknown')
+
+        local s = rv.space.test
+        t.assert_is(rv.space[box.space.test.id], s)
+        t.assert_equals(s.name, 'test')
+        t.assert_is(s.index[0], s.index.pk)
+        t.assert_is(s.index[1], s.index.sk)
+        t.assert_equals(s.index.sk.name, 'sk')
+        t.assert_is_not(rv.space._space, nil)
+
+        -- Temporary and vinyl spaces aren't included in read views.
+        box.schema.space.create('test_temp', {type = 'temporary'})
+        box.space.test_temp:create_index('pk')
+        box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+        box.space.test_vinyl:create_index('pk')
+        local rv2 = box.read_view.open()
+        t.assert_equals(rv2.space.test_temp, nil)
+        t.assert_equals(rv2.space.test_vinyl, nil)
+        rv2:close()
+        box.space.test_temp:drop()
+        box.space.test_vinyl:drop()
+    end)
+end
+
+g.test_consistency = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local expected = s:select()
+        local rv = box.read_view.open()
+        s:delete({1})
+        s:replace({2, 'new'})
+        s:insert({11, 'v2'})
+        s:truncate()
+        s:insert({100, 'v100'})
+
+        local pk = rv.space.test.index.pk
+        local sk = rv.space.test.index.sk
+        t.assert_equals(pk:select(), expected)
+        t.assert_equals(pk:select()[1].val, 'v1')
+        t.assert_equals(pk:select({}, {limit = 2, offset = 1}),
+                        {{2, 'v2'}, {3, 'v0'}})
+        t.assert_equals(pk:select(nil, {iterator = 'all', limit = 1}),
+                        {{1, 'v1'}})
+        t.assert_equals(sk:select(),
+                        {{3, 'v0'}, {6, 'v0'}, {9, 'v0'},
+                         {1, 'v1'}, {4, 'v1'}, {7, 'v1'}, {10, 'v1'},
+                         {2, 'v2'}, {5, 'v2'}, {8, 'v2'}})
+        t.assert_equals(s:select(), {{100, 'v100'}})
+
+        -- Only full scans are supported.
+        t.assert_error_msg_equals(
+            'Read view does not support get()', pk.get, pk, {1})
+        t.assert_error_msg_equals(
+            'Read view does not support iterator type EQ',
+            pk.select, pk, {5})
         t.assert_error_msg_equals(
-            "Community edition does not support read view",
-            function() box.read_view.open() end)
+            'Read view does not support iterator type GE',
+            pk.select, pk, {5}, {iterator = 'ge'})
+        t.assert_error_msg_equals(
+            'Read view does not support iterator type REQ',
+            pk.select, pk, {}, {iterator = 'req'})
+        t.assert_error_msg_equals(
+            'Read view does not support iteration by key',
+            pk.select, pk, {5}, {iterator = 'all'})
+        t.assert_error_msg_equals(
+            "Use index:select(...) instead of index.select(...)",
+            pk.select)
+    end)
+end
+
+g.test_pairs = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local rv = box.read_view.open()
+        local pk = rv.space.test.index.pk
+
+        t.assert_error_msg_equals(
+            'Read view does not support iterator type GT',
+            pk.pairs, pk, {3}, {iterator = 'gt'})
+        t.assert_error_msg_equals(
+            'Read view does not support iteration by key',
+            pk.pairs, pk, {3}, {iterator = 'all'})
+        t.assert_equals(pk:pairs():map(function(tuple) return tuple[1] end)
+                          :totable(),
+                        {1, 2, 3, 4, 5, 6, 7, 8, 9, 10})
+
+        -- The iterator survives yields and concurrent modifications.
+        local result = {}
+        local f = fiber.new(function()
+            for _, tuple in pk:pairs() do
+                table.insert(result, tuple[1])
+                fiber.sleep(0.001)
+            end
+        end)
+        f:set_joinable(true)
+        for i = 1, 10 do
+            s:delete({i})
+            s:insert({i + 100, 'x'})
+            fiber.yield()
+        end
+        t.assert_equals({f:join()}, {true})
+        t.assert_equals(result, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10})
+
+        -- Closing the read view aborts its iterators.
+        local gen, param, state = pk:pairs()
+        t.assert_equals(select(2, gen(param, state)), {1, 'v1'})
+        rv:close()
+        t.assert_error_msg_equals('read view is closed', gen, param, state)
+        t.assert_error_msg_equals('read view is closed', pk.select, pk)
+    end)
+end
+
+g.test_close = function(cg)
+    cg.server:exec(function()
+        local rv = box.read_view.open()
+        local id = rv.id
+        rv:close()
+        t.assert_equals(rv.status, 'closed')
+        t.assert_error_msg_equals('read view is closed', rv.close, rv)
+        for _, v in ipairs(box.read_view.list()) do
+            t.assert_not_equals(v.id, id)
+        end
+
+        -- A read view is closed when the last reference to it is dropped.
+        rv = box.read_view.open()
+        t.assert_equals(#box.read_view.list(), 1)
+        rv = nil -- luacheck: ignore
+        collectgarbage()
+        collectgarbage()
+        t.assert_equals(box.read_view.list(), {})
+
+        -- An iterator pins the read view.
+        local gen, param, state = box.read_view.open().space.test.index.pk
+                                  :pairs()
+        collectgarbage()
+        collectgarbage()
+        t.assert_equals(#box.read_view.list(), 1)
+        t.assert_equals(select(2, gen(param, state)), {1, 'v1'})
+    end)
+end
+
+g.test_memory = function(cg)
+    cg.server:exec(function()
+        -- Frees tuples referenced from Lua.
+        local function gc()
+            box.tuple.new()
+            collectgarbage('collect')
+        end
+        local s = box.space.test
+        gc()
+        t.assert_equals(box.stat.memtx().data.read_view, 0)
+        local rv = box.read_view.open()
+        for i = 1, 10 do
+            s:replace({i, string.rep('x', 1000)})
+        end
+        gc()
+        t.assert_gt(box.stat.memtx().data.read_view, 0)
+        rv:close()
+        t.assert_equals(box.stat.memtx().data.read_view, 0)
     end)
 end
@@ -0,0 +1,188 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('select_chunks', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'default',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {
+            engine = engine,
+            format = {{'id', 'unsigned'}, {'name', 'string'}},
+        })
+        s:create_index('pk')
+        for i = 1, 10 do
+            s:insert({i, 'name' .. i})
+        end
+        if engine == 'memtx' then
+            s:create_index('hash', {type = 'hash'})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end, {cg.params.engine})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.conn = net.connect(cg.server.net_box_uri)
+end)
+
+g.after_each(function(cg)
+    cg.conn:close()
+end)
+
+local function tuples(from, to)
+    local res = {}
+    for i = from, to do
+        table.insert(res, {i, 'name' .. i})
+    end
+    return res
+end
+
+g.test_on_push = function(cg)
+    local s = cg.conn.space.test
+    t.assert(cg.conn.peer_protocol_features.select_chunks)
+    local chunks = {}
+    local function on_push(ctx, chunk)
+        table.insert(ctx, chunk)
+    end
+    local res = s:select({}, {chunk_size = 3, on_push = on_push,
+                              on_push_ctx = chunks})
+    t.assert_equals(chunks, {tuples(1, 3), tuples(4, 6), tuples(7, 9)})
+    t.assert_equals(res, tuples(10, 10))
+    -- Chunks are decoded with the space format.
+    t.assert_equals(chunks[1][1].name, 'name1')
+
+    -- The result size is a multiple of the chunk size.
+    chunks = {}
+    res = s:select({}, {chunk_size = 5, on_push = on_push,
+                        on_push_ctx = chunks})
+    t.assert_equals(chunks, {tuples(1, 5), tuples(6, 10)})
+    t.assert_equals(res, {})
+
+    -- The result fits in one chunk.
+    chunks = {}
+    res = s:select({}, {chunk_size = 100, on_push = on_push,
+                        on_push_ctx = chunks})
+    t.assert_equals(chunks, {})
+    t.assert_equals(res, tuples(1, 10))
+
+    -- Key, iterator, offset, and limit.
+    chunks = {}
+    res = s:select({8}, {iterator = 'lt', offset = 1, limit = 5,
+                         chunk_size = 2, on_push = on_push,
+                         on_push_ctx = chunks})
+    t.assert_equals(chunks, {{{6, 'name6'}, {5, 'name5'}},
+                             {{4, 'name4'}, {3, 'name3'}}})
+    t.assert_equals(res, {{2, 'name2'}})
+
+    chunks = {}
+    res = s:select({}, {fields = {2}, limit = 3, chunk_size = 2,
+                        on_push = on_push, on_push_ctx = chunks})
+    t.assert_equals(chunks, {{{'name1'}, {'name2'}}})
+    t.assert_equals(res, {{'name3'}})
+end
+
+g.test_async = function(cg)
+    local s = cg.conn.space.test
+    local future = s:select({}, {chunk_size = 4, is_async = true})
+    local chunks = {}
+    for i, chunk in future:pairs() do
+        chunks[i] = chunk
+    end
+    t.assert_equals(chunks, {tuples(1, 4), tuples(5, 8), tuples(9, 10)})
+    t.assert_equals(future:wait_result(), tuples(9, 10))
+end
+
+g.test_fetch_pos = function(cg)
+    local s = cg.conn.space.test
+    local count = 0
+    local res, pos = s:select({}, {chunk_size = 4, fetch_pos = true,
+                                   on_push = function() count = count + 1 end})
+    t.assert_equals(count, 2)
+    t.assert_equals(res, tuples(9, 10))
+    local _, expected = s:select({}, {limit = 10, fetch_pos = true})
+    t.assert_equals(pos, expected)
+
+    count = 0
+    res, pos = s:select({}, {chunk_size = 4, fetch_pos = true,
+                             after = pos,
+                             on_push = function() count = count + 1 end})
+    t.assert_equals(count, 0)
+    t.assert_equals(res, {})
+    t.assert_equals(pos, nil)
+end
+
+g.test_large = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('large')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.commit()
+        box.schema.user.grant('guest', 'read', 'space', 'large')
+    end)
+    cg.conn:reload_schema()
+    local next_id = 1
+    local function check(chunk)
+        t.assert_equals(chunk[1][1], next_id)
+        next_id = next_id + #chunk
+    end
+    local res = cg.conn.space.large:select({}, {chunk_size = 100,
+                                                on_push = check})
+    check(res)
+    t.assert_equals(next_id, 10001)
+    cg.server:exec(function()
+        box.space.large:drop()
+    end)
+end
+
+g.test_errors = function(cg)
+    local s = cg.conn.space.test
+    local on_push = function() end
+    t.assert_error_msg_equals(
+        "Illegal parameters, chunk_size requires on_push, is_async or buffer",
+        s.select, s, {}, {chunk_size = 1})
+    t.assert_error_msg_equals(
+        "Illegal parameters, chunk_size must be a positive integer",
+        s.select, s, {}, {chunk_size = 0, on_push = on_push})
+    t.assert_error_msg_equals(
+        "Illegal parameters, chunk_size must be a positive integer",
+        s.select, s, {}, {chunk_size = 1.5, on_push = on_push})
+    t.assert_error_msg_content_equals(
+        "Illegal parameters, options parameter 'chunk_size' should be of " ..
+        "type number",
+        s.select, s, {}, {chunk_size = 'a', on_push = on_push})
+end
+
+g.test_txn = function(cg)
+    local stream = cg.conn:new_stream()
+    local s = stream.space.test
+    stream:begin()
+    t.assert_error_msg_equals(
+        "Chunked select does not support transactions",
+        s.select, s, {}, {chunk_size = 2, on_push = function() end})
+    -- The transaction isn't aborted.
+    t.assert_equals(s:select({}, {limit = 2}), tuples(1, 2))
+    stream:commit()
+end
+
+g.test_hash = function(cg)
+    t.skip_if(cg.params.engine ~= 'memtx', 'HASH is memtx only')
+    local s = cg.conn.space.test
+    t.assert_error_msg_contains(
+        "does not support pagination",
+        s.index.hash.select, s.index.hash, {},
+        {chunk_size = 2, on_push = function() end})
+end
@@ -0,0 +1,104 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('select_fields', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {
+            engine = engine,
+            format = {{'id', 'unsigned'}, {'name', 'string'},
+                      {'data', 'map', is_nullable = true}},
+        })
+        s:create_index('pk')
+        s:insert({1, 'a', {x = 10, y = {1, 2, 3}}, 'extra'})
+        s:insert({2, 'b', {x = 20}})
+        s:insert({3, 'c'})
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end, {cg.params.engine})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Projection and the expected result of selecting all tuples with it.
+local FIELDS = {4, 'name', '[1]', 'data.x', 'data.y[2]', 10}
+local EXPECTED = {
+    {'extra', 'a', 1, 10, 2, box.NULL},
+    {box.NULL, 'b', 2, 20, box.NULL, box.NULL},
+    {box.NULL, 'c', 3, box.NULL, box.NULL, box.NULL},
+}
+
+g.test_local = function(cg)
+    cg.server:exec(function(fields, expected)
+        local s = box.space.test
+        local res = s:select({}, {fields = fields})
+        t.assert_equals(#res, #expected)
+        for i, tuple in ipairs(res) do
+            t.assert(box.tuple.is(tuple))
+            t.assert_equals(tuple:totable(), expected[i])
+            -- Projected tuples have no format.
+            t.assert_equals(tuple.name, nil)
+        end
+        t.assert_equals(s.index.pk:select({2}, {fields = {2}}), {{'b'}})
+        t.assert_equals(s:select({}, {fields = {}, limit = 1}), {{}})
+
+        local res, pos = s:select({}, {fields = {1}, limit = 1,
+                                       fetch_pos = true})
+        t.assert_equals(res, {{1}})
+        t.assert_equals(s:select({}, {fields = {1}, after = pos}),
+                        {{2}, {3}})
+    end, {FIELDS, EXPECTED})
+end
+
+g.test_local_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_equals(
+            "Illegal parameters, fields must be a table",
+            s.select, s, {}, {fields = 1})
+        t.assert_error_msg_equals(
+            "Illegal parameters, invalid field number 0 in fields",
+            s.select, s, {}, {fields = {0}})
+        t.assert_error_msg_equals(
+            "Illegal parameters, invalid field path 'data[' in fields",
+            s.select, s, {}, {fields = {'data['}})
+        t.assert_error_msg_equals(
+            "Illegal parameters, fields must contain field numbers or paths",
+            s.select, s, {}, {fields = {{1}}})
+    end)
+end
+
+g.test_net_box = function(cg)
+    local c = net.connect(cg.server.net_box_uri)
+    t.assert(c.peer_protocol_features.field_projection)
+    local s = c.space.test
+    local res = s:select({}, {fields = FIELDS})
+    t.assert_equals(#res, #EXPECTED)
+    for i, tuple in ipairs(res) do
+        t.assert_equals(tuple:totable(), EXPECTED[i])
+        t.assert_equals(tuple.name, nil)
+    end
+    t.assert_equals(s.index.pk:select({1}, {fields = {'name', 1}}),
+                    {{'a', 1}})
+    -- Without projection tuples still have the space format.
+    t.assert_equals(s:select({1})[1].name, 'a')
+
+    local future = s:select({}, {fields = {2}, is_async = true})
+    t.assert_equals(future:wait_result(), {{'a'}, {'b'}, {'c'}})
+
+    t.assert_error_msg_equals(
+        "Illegal parameters, invalid field number 0 in fields",
+        s.select, s, {}, {fields = {0}})
+    t.assert_error_msg_content_equals(
+        "Illegal parameters, options parameter 'fields' should be of " ..
+        "type table",
+        s.select, s, {}, {fields = 'name'})
+    c:close()
+end
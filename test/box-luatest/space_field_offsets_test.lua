@@ -0,0 +1,137 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_option = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'field_offsets' " ..
+            "should be of type number",
+            box.schema.space.create, 'test', {field_offsets = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Failed to create space 'test': field_offsets must be less " ..
+            "than or equal to 8191",
+            box.schema.space.create, 'test', {field_offsets = 8192})
+
+        local s = box.schema.space.create('test', {field_offsets = 10})
+        t.assert_equals(s.field_offsets, 10)
+        t.assert_equals(box.space._space:get(s.id).flags,
+                        {field_offsets = 10})
+        s:alter({field_offsets = 0})
+        t.assert_equals(s.field_offsets, nil)
+        t.assert_equals(box.space._space:get(s.id).flags, {})
+        s:alter({field_offsets = 5})
+        t.assert_equals(s.field_offsets, 5)
+    end)
+end
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        t.assert_equals(s:stat(), {
+            field_offsets = {count = 0, tuple_size = 0, size = 0},
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{3, 'unsigned'}}})
+        s:alter({field_offsets = 5})
+        for i = 1, 10 do
+            s:insert({i, i, i, i, i})
+        end
+        -- Fields 2, 4, 5 get offset slots, field 3 is indexed
+        -- and has one already.
+        t.assert_equals(s:stat(), {
+            field_offsets = {count = 5, tuple_size = 12, size = 120},
+        })
+        t.assert_error_msg_content_equals(
+            "Use space:stat(...) instead of space.stat(...)", s.stat)
+    end)
+end
+
+g.test_access = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            field_offsets = 6,
+            format = {{'a', 'unsigned'}, {'b', 'string'},
+                      {'c', 'any', is_nullable = true}},
+        })
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'[4].x', 'unsigned'}},
+                              unique = false})
+
+        -- Fields past the space format are optional.
+        s:insert({1, 'a', nil, {x = 1}})
+        s:insert({2, 'b', {1, 2}, {x = 2}, 'e', 'f', 'g'})
+        s:insert({3, 'c', 3, {x = 3}, box.NULL})
+        t.assert_error_msg_content_equals(
+            "Tuple field 4 required by space format is missing",
+            s.insert, s, {4, 'd'})
+
+        local t1 = s:get(1)
+        t.assert_equals({t1[1], t1[2], t1[3], t1[4], t1[5], t1[6]},
+                        {1, 'a', nil, {x = 1}, nil, nil})
+        local t2 = s:get(2)
+        t.assert_equals({t2[2], t2[3], t2[4], t2[5], t2[6], t2[7], t2[8]},
+                        {'b', {1, 2}, {x = 2}, 'e', 'f', 'g', nil})
+        t.assert_equals(t2.c, {1, 2})
+        t.assert_equals(t2['[4].x'], 2)
+        t.assert_equals(s:get(3)[5], box.NULL)
+        t.assert_equals(s.index.sk:select({2}), {t2})
+
+        -- Tuples inserted before the option was changed keep working.
+        s:alter({field_offsets = 0})
+        s:replace({1, 'x', 5, {x = 1}, 'y'})
+        t.assert_equals(s:get(1)[5], 'y')
+        t.assert_equals(s:get(2)[6], 'f')
+        s:alter({field_offsets = 3})
+        t.assert_equals(s:get(1):totable(), {1, 'x', 5, {x = 1}, 'y'})
+        t.assert_equals(s:get(2):update({{'=', 6, 'z'}}):totable(),
+                        {2, 'b', {1, 2}, {x = 2}, 'e', 'z', 'g'})
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {field_offsets = 20})
+        s:create_index('pk')
+        for i = 1, 100 do
+            local tuple = {i}
+            for j = 2, i % 30 + 1 do
+                tuple[j] = i * j
+            end
+            s:insert(tuple)
+        end
+        box.snapshot()
+        s:insert({101, 202})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.field_offsets, 20)
+        t.assert_equals(s:stat().field_offsets.size, 101 * 19 * 4)
+        for i = 1, 100 do
+            local tuple = s:get(i)
+            for j = 2, 31 do
+                t.assert_equals(tuple[j], j <= i % 30 + 1 and i * j or nil)
+            end
+        end
+        t.assert_equals(s:get(101)[2], 202)
+    end)
+end
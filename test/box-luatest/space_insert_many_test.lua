@@ -0,0 +1,149 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('space_insert_many', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'default'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {
+            engine = engine,
+            format = {{'id', 'unsigned'}, {'value', 'string'}},
+        })
+        s:create_index('pk')
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_insert_many = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local lsn = box.info.lsn
+        local count, errors = s:insert_many({
+            {1, 'a'}, box.tuple.new({2, 'b'}), {3, 'c'},
+        })
+        t.assert_equals(count, 3)
+        t.assert_equals(errors, {})
+        t.assert_equals(s:select(), {{1, 'a'}, {2, 'b'}, {3, 'c'}})
+        -- The batch is committed by one journal entry.
+        t.assert_equals(box.info.lsn, lsn + 3)
+
+        count, errors = s:insert_many({})
+        t.assert_equals(count, 0)
+        t.assert_equals(errors, {})
+
+        -- Failed tuples don't stop the batch.
+        count, errors = s:insert_many({
+            {4, 'd'}, {1, 'x'}, {5, 5}, 6, {6, 'f'},
+        })
+        t.assert_equals(count, 2)
+        t.assert_equals(errors[1], nil)
+        t.assert_equals(errors[2].type, 'ClientError')
+        t.assert_equals(errors[2].code, box.error.TUPLE_FOUND)
+        t.assert_equals(errors[3].code, box.error.FIELD_TYPE)
+        t.assert_equals(errors[4].code, box.error.TUPLE_NOT_ARRAY)
+        t.assert_equals(errors[5], nil)
+        t.assert_equals(s:select(), {
+            {1, 'a'}, {2, 'b'}, {3, 'c'}, {4, 'd'}, {6, 'f'},
+        })
+
+        count, errors = s:replace_many({{1, 'x'}, {7, 'g'}})
+        t.assert_equals(count, 2)
+        t.assert_equals(errors, {})
+        t.assert_equals(s:get(1), {1, 'x'})
+        t.assert_equals(s:get(7), {7, 'g'})
+    end)
+end
+
+g.test_msgpack = function(cg)
+    cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local s = box.space.test
+        local data = msgpack.encode({{1, 'a'}, {2, 'b'}})
+        t.assert_equals({s:insert_many(data)}, {2, {}})
+        local obj = msgpack.object({{3, 'c'}, {1, 'x'}})
+        local count, errors = s:replace_many(obj)
+        t.assert_equals(count, 2)
+        t.assert_equals(errors, {})
+        t.assert_equals(s:select(), {{1, 'x'}, {2, 'b'}, {3, 'c'}})
+
+        t.assert_error_msg_equals(
+            "Invalid MsgPack - tuples",
+            s.insert_many, s, data:sub(1, -2))
+        t.assert_error_msg_equals(
+            "Tuple/Key must be MsgPack array",
+            s.insert_many, s, msgpack.encode(1))
+    end)
+end
+
+g.test_transaction = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin()
+        s:insert({1, 'a'})
+        local count, errors = s:insert_many({{1, 'x'}, {2, 'b'}})
+        t.assert_equals(count, 1)
+        t.assert_equals(errors[1].code, box.error.TUPLE_FOUND)
+        t.assert_equals(s:select(), {{1, 'a'}, {2, 'b'}})
+        box.rollback()
+        t.assert_equals(s:select(), {})
+
+        box.begin()
+        s:insert_many({{1, 'a'}, {2, 'b'}})
+        box.commit()
+        t.assert_equals(s:select(), {{1, 'a'}, {2, 'b'}})
+    end)
+end
+
+g.test_triggers = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local function trigger(_, new)
+            if new ~= nil and new[2] == 'bad' then
+                error('bad tuple')
+            end
+        end
+        s:before_replace(trigger)
+        local count, errors = s:insert_many({{1, 'a'}, {2, 'bad'}, {3, 'c'}})
+        s:before_replace(nil, trigger)
+        t.assert_equals(count, 2)
+        t.assert_str_contains(errors[2].message, 'bad tuple')
+        t.assert_equals(s:select(), {{1, 'a'}, {3, 'c'}})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_content_equals(
+            "Use space:insert_many(...) instead of space.insert_many(...)",
+            s.insert_many, {1})
+        t.assert_error_msg_equals(
+            "Tuple/Key must be MsgPack array",
+            s.insert_many, s, 1)
+        t.assert_error_msg_equals(
+            "Tuple/Key must be MsgPack array",
+            s.replace_many, s, {a = 1})
+        local id = s.id
+        s:drop()
+        t.assert_error_msg_equals(
+            string.format("Space '%d' does not exist", id),
+            s.insert_many, s, {{1, 'a'}})
+        box.schema.space.create('test'):create_index('pk')
+    end)
+end
@@ -6,7 +6,7 @@ local socket = require('socket')
 local fio = require('fio')
 local uuid = require('uuid')
 local msgpack = require('msgpack')
-test:plan(111)
+test:plan(112)
 
 --------------------------------------------------------------------------------
 -- Invalid values
@@ -49,6 +49,7 @@ invalid('vinyl_run_size_ratio', 1)
 invalid('vinyl_bloom_fpr', 0)
 invalid('vinyl_bloom_fpr', 1.1)
 invalid('wal_queue_max_size', -1)
+invalid('wal_tail_size', -1)
 invalid('memtx_sort_threads', 'all')
 invalid('memtx_sort_threads', -1)
 invalid('memtx_sort_threads', 0)
@@ -200,6 +200,7 @@ g.test_defaults = function()
             failover = 'off',
             anon = false,
             threads = 1,
+            relay_threads = 0,
             timeout = 1,
             synchro_timeout = 5,
             connect_timeout = 30,
@@ -207,6 +208,10 @@ g.test_defaults = function()
             sync_lag = 10,
             synchro_quorum = 'N / 2 + 1',
             skip_conflict = false,
+            compression_level = 0,
+            join_files = false,
+            spaces = box.NULL,
+            txn_group_size = 1,
             election_mode = box.NULL,
             election_timeout = 5,
             election_fencing_mode = 'soft',
@@ -218,6 +223,7 @@ g.test_defaults = function()
             max_size = 268435456,
             dir_rescan_delay = 2,
             queue_max_size = 16777216,
+            tail_size = 16777216,
             cleanup_delay = 14400,
         },
         console = {
@@ -778,6 +778,7 @@ g.test_wal = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            tail_size = 1,
             cleanup_delay = 1,
         },
     }
@@ -790,6 +791,7 @@ g.test_wal = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        tail_size = 16777216,
         cleanup_delay = 14400,
     }
     local res = instance_config:apply_default({}).wal
@@ -805,6 +807,7 @@ g.test_wal_enterprise = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            tail_size = 1,
             cleanup_delay = 1,
             ext = {
                 old = true,
@@ -827,6 +830,7 @@ g.test_wal_enterprise = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        tail_size = 16777216,
         cleanup_delay = 14400,
     }
     local res = instance_config:apply_default({}).wal
@@ -868,6 +872,7 @@ g.test_replication = function()
             peers = {'one', 'two'},
             anon = true,
             threads = 1,
+            relay_threads = 2,
             timeout = 1,
             synchro_timeout = 1,
             connect_timeout = 1,
@@ -875,6 +880,10 @@ g.test_replication = function()
             sync_lag = 1,
             synchro_quorum = 1,
             skip_conflict = true,
+            compression_level = 1,
+            join_files = true,
+            spaces = {512, 513},
+            txn_group_size = 100,
             election_mode = 'off',
             election_timeout = 1,
             election_fencing_mode = 'off',
@@ -889,6 +898,7 @@ g.test_replication = function()
         failover = 'off',
         anon = false,
         threads = 1,
+        relay_threads = 0,
         timeout = 1,
         synchro_timeout = 5,
         connect_timeout = 30,
@@ -896,6 +906,10 @@ g.test_replication = function()
         sync_lag = 10,
         synchro_quorum = 'N / 2 + 1',
         skip_conflict = false,
+        compression_level = 0,
+        join_files = false,
+        spaces = box.NULL,
+        txn_group_size = 1,
         election_mode = box.NULL,
         election_timeout = 5,
         election_fencing_mode = 'soft',
@@ -0,0 +1,445 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s = box.schema.space.create('unique', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+    end)
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function check_data(cg)
+    local data = cg.master:exec(function()
+        return {box.space.test:select(), box.space.unique:select()}
+    end)
+    cg.replica:exec(function(data)
+        t.assert_equals({box.space.test:select(),
+                         box.space.unique:select()}, data)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end, {data})
+end
+
+-- Transactions modifying the same keys are applied in order.
+g.test_conflicts = function(cg)
+    cg.master:exec(function()
+        local s = box.space.test
+        for i = 1, 1000 do
+            s:replace({i % 100, i})
+        end
+        for i = 1, 100, 2 do
+            s:delete(i)
+        end
+        for i = 0, 99, 3 do
+            s:update(i, {{'+', 2, 1}})
+        end
+        -- The rows conflict in the secondary index only.
+        s = box.space.unique
+        for i = 1, 100 do
+            s:insert({i, i})
+            s:delete(i)
+            s:insert({i + 1000, i})
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    check_data(cg)
+end
+
+-- A transaction waits for a transaction reading the disk if they
+-- modify the same key.
+g.test_disk_read_conflict = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.master:exec(function()
+        box.space.test:replace({3001, 0})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        box.snapshot()
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', true)
+    end)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        -- Write the transactions at once to receive them in one batch.
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local f1 = fiber.new(box.space.test.update, box.space.test, 3001,
+                             {{'=', 2, 1}})
+        local f2 = fiber.new(box.space.test.update, box.space.test, 3001,
+                             {{'+', 2, 10}})
+        local f3 = fiber.new(box.space.test.replace, box.space.test,
+                             {3002, 2})
+        f1:set_joinable(true)
+        f2:set_joinable(true)
+        f3:set_joinable(true)
+        fiber.yield()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        t.assert((f1:join()))
+        t.assert((f2:join()))
+        t.assert((f3:join()))
+    end)
+    cg.replica:exec(function()
+        -- The second update doesn't start until the first one is
+        -- submitted.
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().tx.transactions, 2)
+        end)
+        require('fiber').sleep(0.1)
+        t.assert_equals(box.stat.vinyl().tx.transactions, 2)
+        t.assert_equals(box.space.test:get(3001), {3001, 0})
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', false)
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:get(3001), {3001, 11})
+        t.assert_equals(box.space.test:get(3002), {3002, 2})
+    end)
+    check_data(cg)
+end
+
+-- A transaction doesn't wait for a transaction reading the disk
+-- if they modify different keys.
+g.test_disk_read = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.master:exec(function()
+        box.space.test:replace({2001, 0})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        box.snapshot()
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', true)
+    end)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        -- Write the transactions at once to receive them in one batch.
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local f1 = fiber.new(box.space.test.update, box.space.test, 2001,
+                             {{'=', 2, 1}})
+        local f2 = fiber.new(box.space.test.replace, box.space.test,
+                             {2002, 2})
+        f1:set_joinable(true)
+        f2:set_joinable(true)
+        fiber.yield()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        t.assert((f1:join()))
+        t.assert((f2:join()))
+    end)
+    cg.replica:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().tx.transactions, 2)
+        end)
+        -- The transactions are committed in the order of receipt.
+        t.assert_equals(box.space.test:get(2002), nil)
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', false)
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:get(2001), {2001, 1})
+        t.assert_equals(box.space.test:get(2002), {2002, 2})
+    end)
+    check_data(cg)
+end
+
+-- A transaction aborted by a conflict with a transaction received before
+-- it is applied once more after that transaction is submitted.
+g.test_retry_conflict = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.master:exec(function()
+        box.space.test:replace({4001, 0})
+        box.space.test:replace({4002, 0})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        box.snapshot()
+        -- Put the second key to the cache, so it's read without
+        -- reading the disk.
+        t.assert_equals(box.space.test:get(4002), {4002, 0})
+        -- The trigger reads a key modified by the first transaction
+        -- while the first transaction waits for the disk.
+        rawset(_G, 'log', {})
+        rawset(_G, 'trigger', function(_, new)
+            if new ~= nil and new[1] == 4003 then
+                table.insert(_G.log,
+                             box.space.test:get(4002):totable())
+            end
+        end)
+        box.space.test:before_replace(_G.trigger)
+        rawset(_G, 'conflict', box.stat.vinyl().tx.conflict)
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', true)
+    end)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        -- Write the transactions at once to receive them in one batch.
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local f1 = fiber.new(function()
+            box.begin()
+            s:update(4001, {{'=', 2, 1}})
+            s:replace({4002, 1})
+            box.commit()
+        end)
+        local f2 = fiber.new(s.replace, s, {4003, 2})
+        f1:set_joinable(true)
+        f2:set_joinable(true)
+        fiber.yield()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        t.assert((f1:join()))
+        t.assert((f2:join()))
+    end)
+    cg.replica:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_equals(_G.log, {{4002, 0}})
+        end)
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', false)
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(_G.log, {{4002, 0}, {4002, 1}})
+        t.assert_equals(box.stat.vinyl().tx.conflict, _G.conflict + 1)
+        box.space.test:before_replace(nil, _G.trigger)
+        t.assert_equals(box.space.test:get(4003), {4003, 2})
+    end)
+    check_data(cg)
+end
+
+local g_error = t.group('applier_concurrent_apply_error')
+
+g_error.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+    end)
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+        },
+    })
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g_error.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+-- A failed transaction stops applying of the transactions received
+-- after it. The transactions received before it are committed.
+g_error.test_apply_error = function(cg)
+    cg.replica:exec(function()
+        box.space.test:insert({5, 0})
+    end)
+    local lsn = cg.master:exec(function()
+        local lsn = box.info.lsn
+        for i = 1, 10 do
+            box.space.test:insert({i, i})
+        end
+        return lsn
+    end)
+    cg.replica:exec(function(lsn)
+        t.helpers.retrying({}, function()
+            local upstream = box.info.replication[1].upstream
+            t.assert_equals(upstream.status, 'stopped')
+            t.assert_str_contains(upstream.message, 'Duplicate key exists')
+        end)
+        t.assert_equals(box.info.vclock[1], lsn + 4)
+        t.assert_equals(box.space.test:select(),
+                        {{1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 0}})
+    end, {lsn})
+end
+
+local g_mesh = t.group('applier_concurrent_apply_mesh')
+
+g_mesh.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    local replication = {
+        server.build_listen_uri('master1', cg.replica_set.id),
+        server.build_listen_uri('master2', cg.replica_set.id),
+    }
+    cg.master1 = cg.replica_set:build_and_add_server({
+        alias = 'master1',
+        box_cfg = {
+            replication = replication,
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master2 = cg.replica_set:build_and_add_server({
+        alias = 'master2',
+        box_cfg = {
+            replication = replication,
+            replication_timeout = 0.1,
+        },
+    })
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = replication,
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.replica_set:start()
+    cg.replica_set:wait_for_fullmesh()
+    cg.master1:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+    end)
+    cg.master2:wait_for_vclock_of(cg.master1)
+    cg.replica:wait_for_vclock_of(cg.master1)
+end)
+
+g_mesh.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+-- The rows of both masters arrive to the replica via both appliers.
+-- The order latch of each origin passes between the appliers, so each
+-- row is applied once and the appliers don't block each other.
+g_mesh.test_latch = function(cg)
+    -- Write on both masters at the same time.
+    for i, master in ipairs({cg.master1, cg.master2}) do
+        master:exec(function(base)
+            local fiber = require('fiber')
+            fiber.new(function()
+                for i = 1, 1000 do
+                    box.space.test:replace({base + i, i})
+                end
+            end)
+        end, {i * 100000})
+    end
+    for _, master in ipairs({cg.master1, cg.master2}) do
+        master:exec(function()
+            t.helpers.retrying({}, function()
+                t.assert_equals(box.space.test:count(), 2000)
+            end)
+        end)
+    end
+    cg.replica:wait_for_vclock_of(cg.master1)
+    cg.replica:wait_for_vclock_of(cg.master2)
+    local data = cg.master1:exec(function()
+        return box.space.test:select()
+    end)
+    cg.replica:exec(function(data)
+        t.assert_equals(box.space.test:select(), data)
+        for id, r in pairs(box.info.replication) do
+            if id ~= box.info.id then
+                t.assert_equals(r.upstream.status, 'follow')
+            end
+        end
+    end, {data})
+end
+
+-- An applier waiting for the order latch held by another applier gets it
+-- after the transactions in flight of the other applier are submitted,
+-- without waiting for the rest of the other applier's batch.
+g_mesh.test_latch_release = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.master1:exec(function()
+        box.space.test:replace({1001, 0})
+    end)
+    cg.master2:wait_for_vclock_of(cg.master1)
+    cg.replica:wait_for_vclock_of(cg.master1)
+    cg.replica:exec(function()
+        box.snapshot()
+        -- Log the session of the applier that applies each row.
+        rawset(_G, 'log', {})
+        rawset(_G, 'trigger', function(_, new)
+            if new ~= nil then
+                _G.log[new[1]] = box.session.id()
+            end
+        end)
+        box.space.test:before_replace(_G.trigger)
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', true)
+    end)
+    -- The rows of the first master reach the replica via the second
+    -- master only when all of them are there.
+    cg.master2:exec(function()
+        box.error.injection.set('ERRINJ_RELAY_SEND_DELAY', true)
+    end)
+    local id, lsn = cg.master1:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        -- Write the transactions at once to receive them in one batch.
+        -- The first one waits for the disk on the replica. The second
+        -- one modifies a system space, so it waits for the first one.
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local fibers = {
+            fiber.new(s.update, s, 1001, {{'=', 2, 1}}),
+            fiber.new(box.space._schema.replace, box.space._schema,
+                      {'test_latch'}),
+            fiber.new(s.replace, s, {1002, 2}),
+        }
+        for _, f in ipairs(fibers) do
+            f:set_joinable(true)
+        end
+        fiber.yield()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        for _, f in ipairs(fibers) do
+            t.assert((f:join()))
+        end
+        return box.info.id, box.info.lsn
+    end)
+    cg.master2:exec(function(id, lsn)
+        t.helpers.retrying({}, function()
+            t.assert_ge(box.info.vclock[id], lsn)
+        end)
+        box.error.injection.set('ERRINJ_RELAY_SEND_DELAY', false)
+    end, {id, lsn})
+    cg.replica:exec(function()
+        -- Let the second applier wait for the latch.
+        require('fiber').sleep(0.1)
+        t.assert_equals(box.space.test:get(1002), nil)
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_DELAY', false)
+    end)
+    cg.replica:wait_for_vclock_of(cg.master1)
+    cg.replica:exec(function()
+        box.space.test:before_replace(nil, _G.trigger)
+        t.assert_equals(box.space.test:get(1001), {1001, 1})
+        t.assert_equals(box.space.test:get(1002), {1002, 2})
+        -- The row received after the row that modifies the system space
+        -- is applied by the other applier.
+        t.assert_not_equals(_G.log[1002], nil)
+        t.assert_not_equals(_G.log[1002], _G.log[1001])
+    end)
+    cg.master1:exec(function()
+        box.space._schema:delete('test_latch')
+        box.space.test:delete(1001)
+        box.space.test:delete(1002)
+    end)
+end
@@ -0,0 +1,137 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+        box.schema.space.create('vinyl', {engine = 'vinyl'})
+        box.space.vinyl:create_index('pk')
+    end)
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            replication_txn_group_size = 100,
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function disconnect(cg)
+    return cg.replica:exec(function()
+        local replication = box.cfg.replication
+        box.cfg{replication = {}}
+        return replication
+    end)
+end
+
+local function reconnect(cg, replication)
+    cg.replica:exec(function(replication)
+        box.cfg{replication = replication}
+    end, {replication})
+end
+
+local function check_data(cg)
+    local data = cg.master:exec(function()
+        return {box.space.test:select(), box.space.vinyl:select()}
+    end)
+    cg.replica:exec(function(data)
+        t.assert_equals({box.space.test:select(),
+                         box.space.vinyl:select()}, data)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end, {data})
+end
+
+-- The transactions received while catching up are written to WAL in
+-- a few journal entries.
+g.test_group = function(cg)
+    local replication = disconnect(cg)
+    cg.master:exec(function()
+        for i = 1, 100 do
+            box.space.test:replace({i})
+        end
+        for i = 1, 10 do
+            box.space.vinyl:replace({i})
+        end
+        box.space.test:delete(50)
+    end)
+    local count = cg.replica:exec(function()
+        return box.error.injection.get('ERRINJ_WAL_WRITE_COUNT')
+    end)
+    reconnect(cg, replication)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function(count)
+        local new_count = box.error.injection.get('ERRINJ_WAL_WRITE_COUNT')
+        t.assert_lt(new_count - count, 20)
+    end, {count})
+    check_data(cg)
+end
+
+-- The transactions preceding a failed one are committed.
+g.test_conflict = function(cg)
+    local replication = disconnect(cg)
+    cg.replica:exec(function()
+        box.cfg{read_only = false}
+        box.space.test:insert({1005})
+        box.cfg{read_only = true}
+    end)
+    local lsn = cg.master:exec(function()
+        local lsn
+        for i = 1001, 1010 do
+            box.space.test:insert({i})
+            if i == 1004 then
+                lsn = box.info.lsn
+            end
+        end
+        return lsn
+    end)
+    reconnect(cg, replication)
+    cg.replica:exec(function(lsn)
+        t.helpers.retrying({}, function()
+            local upstream = box.info.replication[1].upstream
+            t.assert_equals(upstream.status, 'stopped')
+            t.assert_str_contains(upstream.message, 'Duplicate key')
+        end)
+        t.assert_equals(box.info.vclock[1], lsn)
+        t.assert_equals(box.space.test:get(1004), {1004})
+        t.assert_equals(box.space.test:get(1006), nil)
+        box.cfg{read_only = false}
+        box.space.test:delete(1005)
+        box.cfg{read_only = true}
+    end, {lsn})
+    disconnect(cg)
+    reconnect(cg, replication)
+    cg.replica:wait_for_vclock_of(cg.master)
+    check_data(cg)
+end
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_txn_group_size': " ..
+            "must be greater than 0",
+            box.cfg, {replication_txn_group_size = 0})
+        t.assert_equals(box.cfg.replication_txn_group_size, 100)
+    end)
+end
@@ -0,0 +1,92 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+-- A lagging replica gets the rows read from WAL files.
+g.test_catch_up = function(cg)
+    cg.replica:stop()
+    cg.master:exec(function()
+        box.begin()
+        for i = 1, 10 do
+            box.space.test:insert({i, string.rep('x', 1000)})
+        end
+        box.commit()
+        for i = 11, 10000 do
+            box.space.test:insert({i, string.rep('x', 100)})
+        end
+        -- The rows must be read from the files.
+        box.snapshot()
+    end)
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:count(), 10000)
+        t.assert_equals(box.space.test:get(10), {10, string.rep('x', 1000)})
+        t.assert_equals(box.space.test:get(10000),
+                        {10000, string.rep('x', 100)})
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            local downstream = box.info.replication[2].downstream
+            t.assert_equals(downstream.status, 'follow')
+            local stat = downstream.throughput
+            t.assert_ge(stat.rows, 10000)
+            t.assert_gt(stat.bytes, 10000 * 100)
+            t.assert_ge(stat.rows_per_sec, 0)
+            t.assert_ge(stat.bytes_per_sec, 0)
+        end)
+    end)
+end
+
+-- The rows written while the replica is in sync are sent immediately.
+g.test_follow = function(cg)
+    local rows = cg.master:exec(function()
+        return box.info.replication[2].downstream.throughput.rows
+    end)
+    cg.master:exec(function()
+        box.space.test:replace({1, 'y'})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:get(1), {1, 'y'})
+    end)
+    cg.master:exec(function(rows)
+        t.helpers.retrying({}, function()
+            local stat = box.info.replication[2].downstream.throughput
+            t.assert_ge(stat.rows, rows + 1)
+        end)
+    end, {rows})
+end
@@ -0,0 +1,111 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+local REPLICA_COUNT = 3
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+            replication_relay_threads = 2,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replicas = {}
+    for i = 1, REPLICA_COUNT do
+        local replica = cg.replica_set:build_and_add_server({
+            alias = 'replica' .. i,
+            box_cfg = {
+                replication = server.build_listen_uri('master',
+                                                      cg.replica_set.id),
+                replication_timeout = 0.1,
+                replication_anon = i == REPLICA_COUNT,
+                read_only = true,
+            },
+        })
+        replica:start()
+        table.insert(cg.replicas, replica)
+    end
+    for _, replica in ipairs(cg.replicas) do
+        replica:wait_for_vclock_of(cg.master)
+    end
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function check_replicas(cg, count)
+    for _, replica in ipairs(cg.replicas) do
+        replica:wait_for_vclock_of(cg.master)
+        replica:exec(function(count)
+            t.assert_equals(box.space.test:count(), count)
+            t.assert_equals(box.info.replication[1].upstream.status,
+                            'follow')
+        end, {count})
+    end
+end
+
+-- The relays running in the thread pool send the rows to all replicas.
+g.test_replication = function(cg)
+    cg.master:exec(function()
+        for i = 1, 1000 do
+            box.space.test:replace({i})
+        end
+    end)
+    check_replicas(cg, 1000)
+    cg.master:exec(function()
+        t.assert_equals(box.cfg.replication_relay_threads, 2)
+        t.helpers.retrying({}, function()
+            local count = 0
+            for _, r in pairs(box.info.replication) do
+                if r.downstream ~= nil then
+                    t.assert_equals(r.downstream.status, 'follow')
+                    count = count + 1
+                end
+            end
+            t.assert_equals(count, 2)
+            t.assert_equals(box.info.replication_anon.count, 1)
+        end)
+    end)
+end
+
+-- A replica reconnects to a relay started in the thread pool.
+g.test_reconnect = function(cg)
+    local replica = cg.replicas[1]
+    replica:stop()
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.info.replication[2].downstream.status,
+                            'stopped')
+        end)
+        for i = 1001, 1100 do
+            box.space.test:replace({i})
+        end
+    end)
+    replica:start()
+    check_replicas(cg, 1100)
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.info.replication[2].downstream.status,
+                            'follow')
+        end)
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.master:exec(function()
+        t.assert_error_msg_content_equals(
+            "Can't set option 'replication_relay_threads' dynamically",
+            box.cfg, {replication_relay_threads = 1})
+    end)
+end
@@ -0,0 +1,110 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+        for i = 1, 100 do
+            box.space.test:insert({i, string.rep('x', 1000)})
+        end
+    end)
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            replication_compression_level = 3,
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+-- The data is compressed on join and subscribe.
+g.test_compression = function(cg)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:count(), 100)
+    end)
+    cg.master:exec(function()
+        for i = 101, 200 do
+            box.space.test:insert({i, string.rep('y', 1000)})
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:count(), 200)
+        local upstream = box.info.replication[1].upstream
+        t.assert_equals(upstream.status, 'follow')
+        local stat = upstream.compression
+        t.assert_gt(stat.raw, 200 * 1000)
+        t.assert_lt(stat.compressed, stat.raw / 10)
+    end)
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            local downstream = box.info.replication[2].downstream
+            t.assert_equals(downstream.status, 'follow')
+            local stat = downstream.compression
+            t.assert_gt(stat.raw, 100 * 1000)
+            t.assert_lt(stat.compressed, stat.raw / 10)
+        end)
+    end)
+end
+
+-- The level applies to new connections.
+g.test_disable = function(cg)
+    cg.replica:exec(function()
+        local replication = box.cfg.replication
+        box.cfg{replication_compression_level = 0, replication = {}}
+        box.cfg{replication = replication}
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.master:exec(function()
+        box.space.test:replace({1})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:get(1), {1})
+        t.assert_equals(box.info.replication[1].upstream.compression, nil)
+        box.cfg{replication_compression_level = 3}
+    end)
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            local downstream = box.info.replication[2].downstream
+            t.assert_equals(downstream.status, 'follow')
+            t.assert_equals(downstream.compression, nil)
+        end)
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        local level = box.cfg.replication_compression_level
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_compression_level': " ..
+            "must be greater than or equal to 0, less than or equal to 22",
+            box.cfg, {replication_compression_level = 23})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_compression_level': " ..
+            "must be greater than or equal to 0, less than or equal to 22",
+            box.cfg, {replication_compression_level = -1})
+        t.assert_equals(box.cfg.replication_compression_level, level)
+    end)
+end
@@ -0,0 +1,99 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_each(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+        box.space.test:create_index('sk', {parts = {2, 'unsigned'}})
+        for i = 1, 100 do
+            box.space.test:insert({i, i * 10})
+        end
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function start_replica(cg)
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            replication_join_files = true,
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+end
+
+local function check_replica(cg, count)
+    cg.replica:exec(function(count)
+        local s = box.space.test
+        t.assert_equals(s:count(), count)
+        t.assert_equals(s.index.sk:count(), count)
+        t.assert_equals(s:get(count), {count, count * 10})
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end, {count})
+end
+
+-- The checkpoint file is sent and the rows written after the checkpoint
+-- are sent from WAL.
+g.test_join_files = function(cg)
+    cg.master:exec(function()
+        box.snapshot()
+        for i = 101, 200 do
+            box.space.test:insert({i, i * 10})
+        end
+    end)
+    start_replica(cg)
+    check_replica(cg, 200)
+    t.assert(cg.master:grep_log('sending .*%.snap'))
+    t.assert(cg.replica:grep_log('receiving .*%.snap%.inprogress'))
+
+    -- The received file is removed, the replica has own checkpoint.
+    cg.replica:exec(function()
+        local fio = require('fio')
+        local files = fio.glob(fio.pathjoin(box.cfg.memtx_dir, '*.snap*'))
+        t.assert_equals(#files, 1)
+        t.assert_str_matches(fio.basename(files[1]), '%d+%.snap')
+    end)
+
+    cg.master:exec(function()
+        box.space.test:insert({201, 2010})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    check_replica(cg, 201)
+end
+
+-- Vinyl data isn't stored in the snapshot file, so a read view is sent.
+g.test_vinyl = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('vinyl', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:insert({1})
+        box.snapshot()
+    end)
+    start_replica(cg)
+    check_replica(cg, 100)
+    t.assert(cg.master:grep_log("can't send checkpoint files"))
+    t.assert_not(cg.master:grep_log('sending .*%.snap'))
+    cg.replica:exec(function()
+        t.assert_equals(box.space.vinyl:select(), {{1}})
+    end)
+end
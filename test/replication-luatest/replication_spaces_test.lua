@@ -0,0 +1,101 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            replication_spaces = {512},
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+-- Only the rows of the requested spaces are sent, the schema changes
+-- are always sent.
+g.test_filter = function(cg)
+    cg.master:exec(function()
+        box.schema.space.create('a', {id = 512})
+        box.space.a:create_index('pk')
+        box.schema.space.create('b', {id = 513})
+        box.space.b:create_index('pk')
+        for i = 1, 10 do
+            box.space.a:insert({i})
+            box.space.b:insert({i})
+        end
+        box.atomic(function()
+            box.space.b:insert({11})
+            box.space.a:insert({11})
+            box.space.b:insert({12})
+        end)
+        box.atomic(function()
+            box.space.b:insert({13})
+            box.space.b:insert({14})
+        end)
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.a:count(), 11)
+        t.assert_equals(box.space.a:get(11), {11})
+        t.assert_equals(box.space.b:count(), 0)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            local downstream = box.info.replication[2].downstream
+            t.assert_equals(downstream.status, 'follow')
+            t.assert_equals(downstream.vclock, box.info.vclock)
+        end)
+    end)
+end
+
+-- The filter applies to new connections.
+g.test_reset = function(cg)
+    cg.replica:exec(function()
+        local replication = box.cfg.replication
+        box.cfg{replication_spaces = box.NULL, replication = {}}
+        box.cfg{replication = replication}
+    end)
+    cg.master:exec(function()
+        box.space.b:insert({100})
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.b:select(), {{100}})
+        box.cfg{replication_spaces = {512}}
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        local spaces = box.cfg.replication_spaces
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_spaces': " ..
+            "must be an array of space ids",
+            box.cfg, {replication_spaces = {'abc'}})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_spaces': " ..
+            "must be an array of space ids",
+            box.cfg, {replication_spaces = {-1}})
+        t.assert_equals(box.cfg.replication_spaces, spaces)
+    end)
+end
@@ -0,0 +1,100 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.master:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+-- Percentiles of the collected values are reported.
+g.test_stat = function(cg)
+    cg.master:exec(function()
+        for i = 1, 100 do
+            box.space.test:insert({i, string.rep('x', 1000)})
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        local function check_pct(stat)
+            t.assert_ge(stat.p50, 0)
+            t.assert_ge(stat.p75, stat.p50)
+            t.assert_ge(stat.p90, stat.p75)
+            t.assert_ge(stat.p95, stat.p90)
+            t.assert_ge(stat.p99, stat.p95)
+        end
+        t.helpers.retrying({}, function()
+            local stat = box.stat.replication()
+            t.assert_equals(stat[1].downstream, nil)
+            local upstream = stat[1].upstream
+            check_pct(upstream.lag)
+            check_pct(upstream.apply_latency)
+            check_pct(upstream.bytes_per_sec)
+            t.assert_gt(upstream.apply_latency.p99, 0)
+            t.assert_gt(upstream.bytes_per_sec.p99, 0)
+        end)
+
+        box.stat.reset()
+        local upstream = box.stat.replication()[1].upstream
+        t.assert_le(upstream.apply_latency.p99, 1e-6)
+        t.assert_equals(upstream.bytes_per_sec.p99, 0)
+    end)
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            local stat = box.stat.replication()
+            t.assert_equals(stat[1], {})
+            t.assert_equals(stat[2].upstream, nil)
+            local downstream = stat[2].downstream
+            t.assert_gt(downstream.lag.p99, 0)
+            t.assert_gt(downstream.ack_rtt.p99, 0)
+            t.assert_gt(downstream.bytes_per_sec.p99, 0)
+        end)
+    end)
+end
+
+-- The throughput is sampled every second, including idle intervals.
+g.test_bytes_per_sec_idle = function(cg)
+    cg.replica:exec(function()
+        box.stat.reset()
+    end)
+    cg.master:exec(function()
+        for i = 101, 200 do
+            box.space.test:insert({i, string.rep('x', 1000)})
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.helpers.retrying({timeout = 10}, function()
+            local stat = box.stat.replication()[1].upstream.bytes_per_sec
+            t.assert_gt(stat.p99, 0)
+            t.assert_equals(stat.p50, 0)
+        end)
+    end)
+end
@@ -0,0 +1,115 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new({})
+    cg.master = cg.replica_set:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    })
+    cg.replica = cg.replica_set:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = server.build_listen_uri('master',
+                                                  cg.replica_set.id),
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.replica_set:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function insert(cg, from, to, size)
+    cg.master:exec(function(from, to, size)
+        for i = from, to do
+            box.space.test:insert({i, string.rep('x', size)})
+        end
+    end, {from, to, size})
+end
+
+local function check_replica(cg, count)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function(count)
+        local s = box.space.test
+        t.assert_equals(s:count(), count)
+        t.assert_equals(s:min()[1], 1)
+        t.assert_equals(s:max()[1], count)
+    end, {count})
+end
+
+-- Rows are sent from the WAL tail buffer and from WAL files if the
+-- replica lags behind the buffer.
+g.test_lag = function(cg)
+    insert(cg, 1, 100, 10)
+    check_replica(cg, 100)
+
+    -- The replica lags behind the buffer (16 MB) on restart.
+    cg.replica:stop()
+    insert(cg, 101, 200, 100 * 1024)
+    cg.master:exec(function() box.snapshot() end)
+    insert(cg, 201, 300, 100 * 1024)
+    cg.replica:start()
+    check_replica(cg, 300)
+
+    insert(cg, 301, 400, 10)
+    check_replica(cg, 400)
+end
+
+-- WAL files sent from the buffer are garbage collected.
+g.test_gc = function(cg)
+    insert(cg, 1001, 1010, 10)
+    cg.replica:wait_for_vclock_of(cg.master)
+    local signature = cg.master:exec(function()
+        box.snapshot()
+        box.space.test:insert({2000})
+        return box.info.signature
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.master:exec(function(signature)
+        t.helpers.retrying({}, function()
+            local consumers = box.info.gc().consumers
+            t.assert_equals(#consumers, 1)
+            t.assert_ge(consumers[1].signature, signature - 1)
+        end)
+    end, {signature})
+end
+
+-- The buffer size may be changed at runtime, zero disables the buffer.
+g.test_size = function(cg)
+    for i, size in ipairs({0, 4096, 16 * 1024 * 1024}) do
+        cg.master:exec(function(size)
+            box.cfg({wal_tail_size = size})
+            t.assert_equals(box.cfg.wal_tail_size, size)
+        end, {size})
+        local from = 3000 + i * 100
+        insert(cg, from, from + 99, 1024)
+        cg.replica:wait_for_vclock_of(cg.master)
+        cg.replica:exec(function(from)
+            local s = box.space.test
+            t.assert_equals(s:count({from}, {iterator = 'ge'}), 100)
+            t.assert_equals(box.info.replication[1].upstream.status,
+                            'follow')
+        end, {from})
+    end
+    cg.master:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_tail_size': " ..
+            "the value must be >= 0",
+            box.cfg, {wal_tail_size = -1})
+        t.assert_equals(box.cfg.wal_tail_size, 16 * 1024 * 1024)
+    end)
+end
@@ -0,0 +1,439 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "salad/art.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+enum {
+	/** Max length of a raw key. */
+	RAW_KEY_MAX = 96,
+	/** Max length of an encoded key. */
+	KEY_MAX = 2 * RAW_KEY_MAX + 2,
+	/** Number of distinct keys used by tests. */
+	KEY_COUNT = 3000,
+};
+
+struct test_key {
+	char data[KEY_MAX];
+	uint32_t len;
+	/** Set if the key is stored in the tree. */
+	bool is_present;
+};
+
+static struct test_key keys[KEY_COUNT];
+
+/** Number of allocations left before the allocator starts failing. */
+static int alloc_budget = -1;
+
+static void *
+test_alloc(void *ctx, size_t size)
+{
+	(void)ctx;
+	if (alloc_budget == 0)
+		return NULL;
+	if (alloc_budget > 0)
+		alloc_budget--;
+	return malloc(size);
+}
+
+static void
+test_free(void *ctx, void *ptr, size_t size)
+{
+	(void)ctx;
+	(void)size;
+	free(ptr);
+}
+
+/**
+ * Encode a string so that the set of encoded strings is prefix-free and
+ * ordered the same way as the original strings.
+ */
+static uint32_t
+encode(const char *raw, uint32_t raw_len, char *buf)
+{
+	char *p = buf;
+	for (uint32_t i = 0; i < raw_len; i++) {
+		*p++ = raw[i];
+		if (raw[i] == 0)
+			*p++ = (char)0xff;
+	}
+	*p++ = 0;
+	*p++ = 0;
+	return p - buf;
+}
+
+/** Generate a random key. */
+static void
+random_key(struct test_key *key)
+{
+	static const char alphabet[] = {0, 'a', 'b', 'c'};
+	char raw[RAW_KEY_MAX];
+	uint32_t raw_len = rand() % RAW_KEY_MAX;
+	for (uint32_t i = 0; i < raw_len; i++)
+		raw[i] = alphabet[rand() % (i < 40 ? 2 : 4)];
+	key->len = encode(raw, raw_len, key->data);
+	key->is_present = false;
+}
+
+static void
+generate_keys(void)
+{
+	/*
+	 * Keys "", "a", "aa", ... form a path that has a branch on each
+	 * level so the tree is deeper than the iterator stack.
+	 */
+	char raw[RAW_KEY_MAX];
+	memset(raw, 'a', sizeof(raw));
+	for (int i = 0; i < RAW_KEY_MAX; i++)
+		keys[i].len = encode(raw, i, keys[i].data);
+	for (int i = RAW_KEY_MAX; i < KEY_COUNT; i++) {
+again:
+		random_key(&keys[i]);
+		for (int j = 0; j < i; j++) {
+			if (keys[j].len == keys[i].len &&
+			    memcmp(keys[j].data, keys[i].data,
+				   keys[i].len) == 0)
+				goto again;
+		}
+	}
+}
+
+static inline void *
+key_value(int i)
+{
+	return (void *)(uintptr_t)(i + 1);
+}
+
+static int
+key_compare(const char *a, uint32_t a_len, const char *b, uint32_t b_len)
+{
+	int rc = memcmp(a, b, a_len < b_len ? a_len : b_len);
+	if (rc != 0)
+		return rc < 0 ? -1 : 1;
+	return a_len < b_len ? -1 : a_len > b_len;
+}
+
+static int
+key_index_compare(const void *a, const void *b)
+{
+	const struct test_key *ka = &keys[*(const int *)a];
+	const struct test_key *kb = &keys[*(const int *)b];
+	return key_compare(ka->data, ka->len, kb->data, kb->len);
+}
+
+/** Fill an array with indexes of present keys in sorted order. */
+static int
+sorted_keys(int *out)
+{
+	int count = 0;
+	for (int i = 0; i < KEY_COUNT; i++) {
+		if (keys[i].is_present)
+			out[count++] = i;
+	}
+	qsort(out, count, sizeof(*out), key_index_compare);
+	return count;
+}
+
+/**
+ * Compare a stored key with a search key the way the tree does it:
+ * a stored key that starts with the search key is equal to it.
+ */
+static int
+search_compare(const struct test_key *key, const char *search, uint32_t len)
+{
+	int rc = key_compare(key->data, key->len < len ? key->len : len,
+			     search, len);
+	if (rc != 0)
+		return rc;
+	return key->len < len ? -1 : 0;
+}
+
+/** Check that an iterator visits the given keys in the given order. */
+static bool
+check_iteration(struct art_iterator *it, struct art_node *root,
+		const int *sorted, int count, int dir)
+{
+	if (dir > 0)
+		art_iterator_first(it, root);
+	else
+		art_iterator_last(it, root);
+	for (int i = 0; i < count; i++) {
+		int k = dir > 0 ? sorted[i] : sorted[count - i - 1];
+		if (art_iterator_value(it) != key_value(k))
+			return false;
+		uint32_t len;
+		const char *data = art_iterator_key(it, &len);
+		if (len != keys[k].len || memcmp(data, keys[k].data, len) != 0)
+			return false;
+		if (dir > 0)
+			art_iterator_next(it, root);
+		else
+			art_iterator_prev(it, root);
+	}
+	return art_iterator_value(it) == NULL;
+}
+
+static void
+tree_insert(struct art_tree *tree, int i)
+{
+	void *replaced;
+	fail_if(art_insert(tree, keys[i].data, keys[i].len,
+			   key_value(i), &replaced) != 0);
+	fail_if(replaced != (keys[i].is_present ? key_value(i) : NULL));
+	keys[i].is_present = true;
+}
+
+static void
+tree_delete(struct art_tree *tree, int i)
+{
+	void *deleted;
+	fail_if(art_delete(tree, keys[i].data, keys[i].len, &deleted) != 0);
+	fail_if(deleted != (keys[i].is_present ? key_value(i) : NULL));
+	keys[i].is_present = false;
+}
+
+static void
+reset_keys(void)
+{
+	for (int i = 0; i < KEY_COUNT; i++)
+		keys[i].is_present = false;
+}
+
+static void
+test_insert_delete(void)
+{
+	plan(5);
+	header();
+
+	struct art_tree tree;
+	art_create(&tree, test_alloc, test_free, NULL);
+	reset_keys();
+	for (int i = 0; i < KEY_COUNT; i++)
+		tree_insert(&tree, i);
+	is(art_size(&tree), KEY_COUNT, "size after insertion");
+
+	bool success = true;
+	for (int i = 0; i < KEY_COUNT; i++) {
+		if (art_find(tree.root, keys[i].data,
+			     keys[i].len) != key_value(i))
+			success = false;
+	}
+	ok(success, "all keys found");
+
+	for (int i = 0; i < KEY_COUNT; i += 2)
+		tree_delete(&tree, i);
+	for (int i = 0; i < KEY_COUNT; i += 3)
+		tree_insert(&tree, i);
+	success = true;
+	for (int i = 0; i < KEY_COUNT; i++) {
+		void *value = art_find(tree.root, keys[i].data, keys[i].len);
+		if (value != (keys[i].is_present ? key_value(i) : NULL))
+			success = false;
+	}
+	ok(success, "found keys match after deletion");
+
+	for (int i = 0; i < KEY_COUNT; i++)
+		tree_delete(&tree, i);
+	is(art_size(&tree), 0, "size after deletion");
+	is(art_mem_used(&tree), 0, "memory is freed after deletion");
+	art_destroy(&tree);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_iterator(void)
+{
+	plan(7);
+	header();
+
+	struct art_tree tree;
+	art_create(&tree, test_alloc, test_free, NULL);
+	reset_keys();
+	for (int i = 0; i < KEY_COUNT; i++) {
+		if (rand() % 2 == 0)
+			tree_insert(&tree, i);
+	}
+	static int sorted[KEY_COUNT];
+	int count = sorted_keys(sorted);
+	static struct art_iterator it;
+	ok(check_iteration(&it, tree.root, sorted, count, 1),
+	   "forward iteration");
+	ok(check_iteration(&it, tree.root, sorted, count, -1),
+	   "backward iteration");
+
+	/*
+	 * Search for every key, present or not, and for a prefix of it.
+	 * Expected results are found with a linear scan.
+	 */
+	bool success[4] = {true, true, true, true};
+	for (int i = 0; i < 2 * KEY_COUNT; i++) {
+		const char *search = keys[i / 2].data;
+		uint32_t len = keys[i / 2].len;
+		if (i % 2 != 0)
+			len = rand() % (len + 1);
+		int ge = count, gt = count, le = -1, lt = -1;
+		for (int j = 0; j < count; j++) {
+			int rc = search_compare(&keys[sorted[j]], search, len);
+			if (rc >= 0 && ge == count)
+				ge = j;
+			if (rc > 0 && gt == count)
+				gt = j;
+			if (rc <= 0)
+				le = j;
+			if (rc < 0)
+				lt = j;
+		}
+		void *expected[4] = {
+			ge < count ? key_value(sorted[ge]) : NULL,
+			gt < count ? key_value(sorted[gt]) : NULL,
+			le >= 0 ? key_value(sorted[le]) : NULL,
+			lt >= 0 ? key_value(sorted[lt]) : NULL,
+		};
+		art_iterator_ge(&it, tree.root, search, len);
+		if (art_iterator_value(&it) != expected[0])
+			success[0] = false;
+		art_iterator_gt(&it, tree.root, search, len);
+		if (art_iterator_value(&it) != expected[1])
+			success[1] = false;
+		art_iterator_le(&it, tree.root, search, len);
+		if (art_iterator_value(&it) != expected[2])
+			success[2] = false;
+		art_iterator_lt(&it, tree.root, search, len);
+		if (art_iterator_value(&it) != expected[3])
+			success[3] = false;
+		/* Step from the found position. */
+		if (lt >= 0) {
+			art_iterator_next(&it, tree.root);
+			void *next = lt + 1 < count ?
+				     key_value(sorted[lt + 1]) : NULL;
+			if (art_iterator_value(&it) != next)
+				success[3] = false;
+		}
+	}
+	ok(success[0], "ge search");
+	ok(success[1], "gt search");
+	ok(success[2], "le search");
+	ok(success[3], "lt search");
+
+	art_destroy(&tree);
+	is(art_mem_used(&tree), 0, "memory is freed");
+
+	footer();
+	check_plan();
+}
+
+static void
+test_view(void)
+{
+	plan(5);
+	header();
+
+	struct art_tree tree;
+	art_create(&tree, test_alloc, test_free, NULL);
+	reset_keys();
+	for (int i = 0; i < KEY_COUNT; i++) {
+		if (i % 2 == 0)
+			tree_insert(&tree, i);
+	}
+	static int sorted[KEY_COUNT];
+	int count = sorted_keys(sorted);
+	size_t mem_used = art_mem_used(&tree);
+
+	struct art_view view1, view2;
+	art_view_create(&view1, &tree);
+	for (int i = 0; i < KEY_COUNT; i++) {
+		if (i % 3 == 0)
+			tree_delete(&tree, i);
+		else
+			tree_insert(&tree, i);
+	}
+	static int sorted2[KEY_COUNT];
+	int count2 = sorted_keys(sorted2);
+	art_view_create(&view2, &tree);
+	for (int i = 0; i < KEY_COUNT; i++)
+		tree_delete(&tree, i);
+
+	static struct art_iterator it;
+	ok(check_iteration(&it, view1.root, sorted, count, 1),
+	   "first view is consistent");
+	ok(check_iteration(&it, view2.root, sorted2, count2, -1),
+	   "second view is consistent");
+	ok(art_mem_used(&tree) > mem_used, "views hold memory");
+	art_view_destroy(&view1);
+	art_view_destroy(&view2);
+	is(art_mem_used(&tree), 0, "memory is freed after closing views");
+	is(art_size(&tree), 0, "tree is empty");
+	art_destroy(&tree);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_alloc_failure(void)
+{
+	plan(2);
+	header();
+
+	struct art_tree tree;
+	art_create(&tree, test_alloc, test_free, NULL);
+	reset_keys();
+	struct art_view view;
+	art_view_create(&view, &tree);
+	int failed = 0;
+	for (int i = 0; i < KEY_COUNT; i++) {
+		alloc_budget = rand() % 4;
+		void *old;
+		if (art_insert(&tree, keys[i].data, keys[i].len,
+			       key_value(i), &old) == 0)
+			keys[i].is_present = true;
+		else
+			failed++;
+		if (i % 5 == 0) {
+			art_view_destroy(&view);
+			art_view_create(&view, &tree);
+		}
+		int k = rand() % (i + 1);
+		if (art_delete(&tree, keys[k].data, keys[k].len, &old) == 0)
+			keys[k].is_present = false;
+		else
+			failed++;
+	}
+	alloc_budget = -1;
+	art_view_destroy(&view);
+
+	static int sorted[KEY_COUNT];
+	int count = sorted_keys(sorted);
+	static struct art_iterator it;
+	ok(failed > 0, "some operations failed");
+	ok(check_iteration(&it, tree.root, sorted, count, 1),
+	   "tree is consistent");
+	art_destroy(&tree);
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	plan(4);
+	header();
+
+	srand(42);
+	generate_keys();
+	test_insert_delete();
+	test_iterator();
+	test_view();
+	test_alloc_failure();
+
+	footer();
+	return check_plan();
+}
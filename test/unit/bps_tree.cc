@@ -925,6 +925,46 @@ insert_successor_test()
 	footer();
 }
 
+static void
+find_many_test()
+{
+	header();
+	test tree;
+	test_create(&tree, 0, extent_alloc, extent_free, &extents_count,
+		    NULL);
+
+	const size_t count = 1000;
+	type_t keys[count];
+	type_t *results[count];
+
+	/* Empty tree. */
+	for (size_t i = 0; i < count; i++)
+		keys[i] = i;
+	test_find_many(&tree, keys, count, results);
+	for (size_t i = 0; i < count; i++)
+		fail_unless(results[i] == NULL);
+
+	/* Insert even numbers, look up both even and odd ones. */
+	for (type_t v = 0; v < 20000; v += 2)
+		test_insert(&tree, v, NULL, NULL);
+	for (size_t i = 0; i < count; i++)
+		keys[i] = rand() % 20010;
+	test_find_many(&tree, keys, count, results);
+	for (size_t i = 0; i < count; i++) {
+		fail_unless(results[i] == test_find(&tree, keys[i]));
+		fail_unless(results[i] == NULL || *results[i] == keys[i]);
+	}
+
+	/* Counts that are not a multiple of the batch size. */
+	for (size_t n = 0; n < 40; n++) {
+		test_find_many(&tree, keys, n, results);
+		for (size_t i = 0; i < n; i++)
+			fail_unless(results[i] == test_find(&tree, keys[i]));
+	}
+
+	test_destroy(&tree);
+	footer();
+}
 
 int
 main(void)
@@ -942,4 +982,5 @@ main(void)
 	insert_get_iterator();
 	delete_value_check();
 	insert_successor_test();
+	find_many_test();
 }
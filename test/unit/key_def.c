@@ -5,6 +5,7 @@
 #include "fiber.h"
 #include "key_def.h"
 #include "memory.h"
+#include "mp_uuid.h"
 #include "msgpuck.h"
 #include "small/region.h"
 #include "trivia/util.h"
@@ -457,16 +458,229 @@ test_tuple_validate_key_parts_raw(void)
 	check_plan();
 }
 
+/** Types of fields of tuples generated by test_tuple_new_random(). */
+enum test_field {
+	TEST_FIELD_UNSIGNED,
+	TEST_FIELD_INTEGER,
+	TEST_FIELD_INTEGER_NULLABLE,
+	TEST_FIELD_DOUBLE,
+	TEST_FIELD_UUID,
+};
+
+/**
+ * Creates a tuple with random fields of the given types. Values are taken
+ * from a small range so that generated tuples have equal fields.
+ */
+static struct tuple *
+test_tuple_new_random(const enum test_field *fields, uint32_t field_count)
+{
+	char data[256];
+	char *data_end = mp_encode_array(data, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		int64_t val = rand() % 5 - 2;
+		switch (fields[i]) {
+		case TEST_FIELD_UNSIGNED:
+			data_end = mp_encode_uint(data_end, val + 2);
+			break;
+		case TEST_FIELD_INTEGER_NULLABLE:
+			if (rand() % 3 == 0) {
+				data_end = mp_encode_nil(data_end);
+				break;
+			}
+			FALLTHROUGH;
+		case TEST_FIELD_INTEGER:
+			if (val < 0)
+				data_end = mp_encode_int(data_end, val << 40);
+			else
+				data_end = mp_encode_uint(data_end, val << 40);
+			break;
+		case TEST_FIELD_DOUBLE:
+			data_end = mp_encode_double(data_end, val * 0.5);
+			break;
+		case TEST_FIELD_UUID: {
+			struct tt_uuid uuid;
+			memset(&uuid, 0, sizeof(uuid));
+			uuid.time_low = val + 2;
+			uuid.node[5] = rand() % 2;
+			data_end = mp_encode_uuid(data_end, &uuid);
+			break;
+		}
+		default:
+			unreachable();
+		}
+	}
+	fail_if(data_end > data + sizeof(data));
+	struct tuple *tuple = tuple_new(tuple_format_runtime, data, data_end);
+	fail_if(tuple == NULL);
+	return tuple;
+}
+
+/**
+ * Reference implementation of tuple comparison: compares the first
+ * part_count key parts one by one with tuple_compare_field().
+ */
+static int
+test_tuple_compare_model(struct tuple *tuple_a, struct tuple *tuple_b,
+			 uint32_t part_count, struct key_def *def)
+{
+	for (uint32_t i = 0; i < part_count; i++) {
+		struct key_part *part = &def->parts[i];
+		const char *field_a = tuple_field_by_part(tuple_a, part,
+							  MULTIKEY_NONE);
+		const char *field_b = tuple_field_by_part(tuple_b, part,
+							  MULTIKEY_NONE);
+		bool a_is_null = field_a == NULL ||
+				 mp_typeof(*field_a) == MP_NIL;
+		bool b_is_null = field_b == NULL ||
+				 mp_typeof(*field_b) == MP_NIL;
+		int rc;
+		if (a_is_null || b_is_null)
+			rc = (int)b_is_null - (int)a_is_null;
+		else
+			rc = tuple_compare_field(field_a, field_b, part->type,
+						 part->coll);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+static int
+test_sign(int rc)
+{
+	return (rc > 0) - (rc < 0);
+}
+
+/**
+ * Checks that tuple_compare() and tuple_compare_with_key() set for the given
+ * key definition agree with test_tuple_compare_model() on random tuples.
+ */
+static void
+test_check_tuple_compare_random(size_t case_no, struct key_def *def,
+				const enum test_field *fields,
+				uint32_t field_count)
+{
+	enum { TUPLE_COUNT = 40 };
+	struct tuple *tuples[TUPLE_COUNT];
+	for (int i = 0; i < TUPLE_COUNT; i++)
+		tuples[i] = test_tuple_new_random(fields, field_count);
+	int errors = 0;
+	size_t region_svp = region_used(&fiber()->gc);
+	for (int i = 0; i < TUPLE_COUNT; i++) {
+		for (int j = 0; j < TUPLE_COUNT; j++) {
+			struct tuple *a = tuples[i];
+			struct tuple *b = tuples[j];
+			int expected = test_tuple_compare_model(
+				a, b, def->part_count, def);
+			int rc = tuple_compare(a, HINT_NONE, b, HINT_NONE, def);
+			if (test_sign(rc) != test_sign(expected))
+				errors++;
+			const char *key = tuple_extract_key(b, def,
+							    MULTIKEY_NONE,
+							    NULL);
+			fail_if(key == NULL);
+			mp_decode_array(&key);
+			for (uint32_t k = 1; k <= def->part_count; k++) {
+				expected = test_tuple_compare_model(a, b, k,
+								    def);
+				rc = tuple_compare_with_key(a, HINT_NONE, key,
+							    k, HINT_NONE, def);
+				if (test_sign(rc) != test_sign(expected))
+					errors++;
+			}
+		}
+	}
+	region_truncate(&fiber()->gc, region_svp);
+	for (int i = 0; i < TUPLE_COUNT; i++)
+		tuple_delete(tuples[i]);
+	is(errors, 0, "tuple_compare case %zu", case_no);
+}
+
+static void
+test_tuple_compare_specialized(void)
+{
+	plan(10);
+	header();
+
+	const enum test_field int_uuid[] = {
+		TEST_FIELD_INTEGER, TEST_FIELD_UUID,
+	};
+	const enum test_field int_int[] = {
+		TEST_FIELD_INTEGER, TEST_FIELD_INTEGER,
+	};
+	const enum test_field double_int[] = {
+		TEST_FIELD_DOUBLE, TEST_FIELD_INTEGER,
+	};
+	const enum test_field int_nullable_int[] = {
+		TEST_FIELD_INTEGER, TEST_FIELD_INTEGER_NULLABLE,
+	};
+	const enum test_field uuid_nullable_int[] = {
+		TEST_FIELD_UUID, TEST_FIELD_INTEGER_NULLABLE,
+	};
+	const enum test_field unsigned_nullable_int[] = {
+		TEST_FIELD_UNSIGNED, TEST_FIELD_INTEGER_NULLABLE,
+	};
+	struct {
+		struct key_def *def;
+		const enum test_field *fields;
+	} cases[] = {
+		{test_key_def_new("[{%s%u%s%s}]",
+				  "field", 0, "type", "integer"), int_int},
+		{test_key_def_new("[{%s%u%s%s}{%s%u%s%s}]",
+				  "field", 0, "type", "integer",
+				  "field", 1, "type", "integer"), int_int},
+		{test_key_def_new("[{%s%u%s%s}{%s%u%s%s}]",
+				  "field", 0, "type", "integer",
+				  "field", 1, "type", "uuid"), int_uuid},
+		{test_key_def_new("[{%s%u%s%s}{%s%u%s%s}]",
+				  "field", 1, "type", "uuid",
+				  "field", 0, "type", "integer"), int_uuid},
+		{test_key_def_new("[{%s%u%s%s}]",
+				  "field", 0, "type", "double"), double_int},
+		{test_key_def_new("[{%s%u%s%s}{%s%u%s%s}]",
+				  "field", 1, "type", "integer",
+				  "field", 0, "type", "double"), double_int},
+		{test_key_def_new("[{%s%u%s%s%s%b}]",
+				  "field", 1, "type", "integer",
+				  "is_nullable", 1), int_nullable_int},
+		{test_key_def_new("[{%s%u%s%s%s%b}{%s%u%s%s}]",
+				  "field", 1, "type", "integer",
+				  "is_nullable", 1,
+				  "field", 0, "type", "integer"),
+		 int_nullable_int},
+		{test_key_def_new("[{%s%u%s%s%s%b}{%s%u%s%s}]",
+				  "field", 1, "type", "integer",
+				  "is_nullable", 1,
+				  "field", 0, "type", "uuid"),
+		 uuid_nullable_int},
+		{test_key_def_new("[{%s%u%s%s%s%b}{%s%u%s%s}]",
+				  "field", 1, "type", "integer",
+				  "is_nullable", 1,
+				  "field", 0, "type", "unsigned"),
+		 unsigned_nullable_int},
+	};
+	srand(42);
+	for (size_t i = 0; i < lengthof(cases); i++) {
+		test_check_tuple_compare_random(i, cases[i].def,
+						cases[i].fields, 2);
+		key_def_delete(cases[i].def);
+	}
+
+	footer();
+	check_plan();
+}
+
 static int
 test_main(void)
 {
-	plan(4);
+	plan(5);
 	header();
 
 	test_func_compare();
 	test_func_compare_with_key();
 	test_tuple_extract_key_raw_slowpath_nullable();
 	test_tuple_validate_key_parts_raw();
+	test_tuple_compare_specialized();
 
 	footer();
 	return check_plan();
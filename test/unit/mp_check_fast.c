@@ -0,0 +1,183 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mp_check_fast.h"
+#include "msgpuck.h"
+#include "trivia/util.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+enum {
+	BUF_SIZE = 256 * 1024,
+	/** Enough for any scalar value and the rest of containers. */
+	BUF_RESERVE = 4096,
+	ITERATIONS = 2000,
+};
+
+static char buf[BUF_SIZE];
+
+/** Encodes a random MsgPack value, favoring runs of small integers. */
+static char *
+gen_value(char *pos, int depth)
+{
+	if (buf + BUF_SIZE - pos < BUF_RESERVE)
+		return mp_encode_uint(pos, 1);
+	int kind = rand() % (depth > 3 ? 8 : 10);
+	switch (kind) {
+	case 0:
+	case 1:
+	case 2:
+		return mp_encode_uint(pos, rand() % 128);
+	case 3:
+		return mp_encode_int(pos, -(rand() % 32) - 1);
+	case 4: {
+		static const uint64_t values[] = {
+			0, 200, 60000, 4000000000ULL, 1ULL << 40,
+		};
+		return mp_encode_uint(pos, values[rand() % lengthof(values)]);
+	}
+	case 5:
+		switch (rand() % 4) {
+		case 0:
+			return mp_encode_nil(pos);
+		case 1:
+			return mp_encode_bool(pos, rand() % 2);
+		case 2:
+			return mp_encode_double(pos, 1.5);
+		default:
+			return mp_encode_float(pos, 2.5);
+		}
+	case 6: {
+		static const uint32_t lens[] = {0, 3, 31, 32, 255, 256, 1000};
+		uint32_t len = lens[rand() % lengthof(lens)];
+		char str[1000];
+		memset(str, 'x', len);
+		return rand() % 2 == 0 ? mp_encode_str(pos, str, len) :
+					 mp_encode_bin(pos, str, len);
+	}
+	case 7:
+		return mp_encode_array(pos, 0);
+	case 8: {
+		uint32_t size = rand() % (rand() % 4 == 0 ? 300 : 16);
+		pos = mp_encode_array(pos, size);
+		for (uint32_t i = 0; i < size; i++)
+			pos = gen_value(pos, depth + 1);
+		return pos;
+	}
+	default: {
+		uint32_t size = rand() % (rand() % 4 == 0 ? 40 : 16);
+		pos = mp_encode_map(pos, size);
+		for (uint32_t i = 0; i < 2 * size; i++)
+			pos = gen_value(pos, depth + 1);
+		return pos;
+	}
+	}
+}
+
+/**
+ * Checks that mp_check_fast() agrees with mp_check() on the given
+ * data. Returns true on match.
+ */
+static bool
+check_same(const char *data, const char *end)
+{
+	const char *pos1 = data;
+	const char *pos2 = data;
+	const char *pos3 = data;
+	int rc1 = mp_check(&pos1, end);
+	int rc2 = mp_check_fast(&pos2, end);
+	int rc3 = mp_check_fast_scalar(&pos3, end);
+	if (rc1 != rc2 || rc1 != rc3)
+		return false;
+	return rc1 != 0 || (pos1 == pos2 && pos1 == pos3);
+}
+
+static void
+test_valid(void)
+{
+	plan(1);
+	header();
+
+	bool success = true;
+	for (int i = 0; i < ITERATIONS && success; i++) {
+		char *end = gen_value(buf, 0);
+		/* Trailing data must not be consumed. */
+		char *tail = end;
+		for (int j = rand() % 64; j > 0; j--)
+			tail = mp_encode_uint(tail, 1);
+		const char *pos = buf;
+		success = mp_check_fast(&pos, tail) == 0 && pos == end &&
+			  check_same(buf, tail);
+	}
+	ok(success, "valid data");
+
+	footer();
+	check_plan();
+}
+
+static void
+test_truncated(void)
+{
+	plan(1);
+	header();
+
+	bool success = true;
+	for (int i = 0; i < ITERATIONS && success; i++) {
+		char *end = gen_value(buf, 0);
+		const char *cut = buf + rand() % (end - buf);
+		const char *pos = buf;
+		success = mp_check_fast(&pos, cut) != 0 &&
+			  check_same(buf, cut);
+	}
+	ok(success, "truncated data");
+
+	footer();
+	check_plan();
+}
+
+static void
+test_garbage(void)
+{
+	plan(1);
+	header();
+
+	bool success = true;
+	for (int i = 0; i < ITERATIONS * 10 && success; i++) {
+		size_t size = rand() % 256 + 1;
+		for (size_t j = 0; j < size; j++) {
+			/* Mostly single-byte values to get deeper. */
+			int r = rand() % 10;
+			buf[j] = r < 5 ? rand() % 128 :
+				 r < 7 ? 0x90 + rand() % 16 : rand() % 256;
+		}
+		success = check_same(buf, buf + size);
+	}
+	ok(success, "random data");
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	mp_check_fast_init();
+	srand(time(NULL));
+
+	plan(3);
+	header();
+
+	test_valid();
+	test_truncated();
+	test_garbage();
+
+	footer();
+	return check_plan();
+}
@@ -33,6 +33,7 @@ extern "C" {
 } /* extern "C" */
 
 #include <stdarg.h>
+#include <stdlib.h>
 
 #include "vclock/vclock.h"
 
@@ -438,10 +439,93 @@ test_minmax_ignore0(void)
 
 #undef test
 
+#define test(vc, n, exp) ({						\
+	struct vclock v;						\
+	vclock_create(&v);						\
+	vclock_from_string(&v, (vc));					\
+	is(vclock_nth_largest(&v, (n)), (exp),				\
+	   "%d-th largest of %s is %d", (n), (vc), (exp));		\
+})
+
+#define ack(id, lsn, quorum, exp) ({					\
+	vclock_reset(&vclock, (id), (lsn));				\
+	is(vclock_nth_largest(&vclock, (quorum)), (exp),		\
+	   "ACK %d from %d, quorum %d => %d",				\
+	   (lsn), (id), (quorum), (exp));				\
+})
+
+/**
+ * The synchro queue confirms the biggest LSN ACKed by a quorum of
+ * replicas, which is the k-th largest ACK, where k is the quorum.
+ * Check it with ACKs coming out of order, going backwards, and with
+ * the quorum changing between ACKs.
+ */
+int
+test_nth_largest(void)
+{
+	plan(17);
+	header();
+
+	test("{}", 1, 0);
+	test("{1: 10}", 1, 10);
+	test("{1: 10}", 2, 0);
+	test("{1: 10, 2: 30, 3: 20}", 1, 30);
+	test("{1: 10, 2: 30, 3: 20}", 2, 20);
+	test("{1: 10, 2: 30, 3: 20}", 3, 10);
+	test("{1: 10, 2: 30, 3: 20}", 4, 0);
+	test("{1: 5, 2: 7, 3: 5, 4: 5}", 3, 5);
+	test("{0: 100, 1: 1, 31: 50}", 2, 50);
+
+	struct vclock vclock;
+	vclock_create(&vclock);
+	ack(2, 20, 3, 0);
+	ack(4, 40, 3, 0);
+	ack(1, 10, 3, 10);
+	ack(3, 30, 3, 20);
+	/* The replica lost its data. */
+	ack(4, 5, 3, 10);
+	ack(4, 0, 3, 10);
+	/* The quorum is decreased. */
+	ack(1, 15, 2, 20);
+
+	/*
+	 * Random ACKs checked against a brute-force count of replicas
+	 * that ACKed each LSN.
+	 */
+	enum { REPLICA_COUNT = 8, LSN_MAX = 100 };
+	int64_t acks[REPLICA_COUNT + 1] = {0};
+	vclock_create(&vclock);
+	srand(1);
+	bool is_ok = true;
+	for (int i = 0; i < 10000 && is_ok; i++) {
+		int quorum = 1 + rand() % (REPLICA_COUNT + 1);
+		int id = 1 + rand() % REPLICA_COUNT;
+		int64_t lsn = rand() % LSN_MAX;
+		acks[id] = lsn;
+		vclock_reset(&vclock, id, lsn);
+		int64_t expected = 0;
+		for (int64_t l = LSN_MAX; l > 0 && expected == 0; l--) {
+			int count = 0;
+			for (int j = 1; j <= REPLICA_COUNT; j++)
+				count += acks[j] >= l;
+			if (count >= quorum)
+				expected = l;
+		}
+		is_ok = vclock_nth_largest(&vclock, quorum) == expected;
+	}
+	ok(is_ok, "random ACKs");
+
+	footer();
+	return check_plan();
+}
+
+#undef ack
+#undef test
+
 int
 main(void)
 {
-	plan(6);
+	plan(7);
 
 	test_compare();
 	test_isearch();
@@ -449,6 +533,7 @@ main(void)
 	test_fromstring();
 	test_fromstring_invalid();
 	test_minmax_ignore0();
+	test_nth_largest();
 
 	return check_plan();
 }
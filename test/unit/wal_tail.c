@@ -0,0 +1,246 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "box/iproto_constants.h"
+#include "box/wal_tail.h"
+#include "box/xrow.h"
+#include "fiber.h"
+#include "memory.h"
+#include "msgpuck.h"
+#include "small/ibuf.h"
+#include "trivia/util.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+enum {
+	/** Buffer capacity used by the tests. */
+	TAIL_SIZE = 4096,
+	/** Replica id of the appended rows. */
+	REPLICA_ID = 1,
+};
+
+static char body_buf[2 * TAIL_SIZE];
+
+/** Appends a row with the given LSN and body size to the buffer. */
+static void
+append_row(struct wal_tail *tail, int64_t lsn, uint32_t body_size)
+{
+	char *end = mp_encode_array(body_buf, 2);
+	end = mp_encode_uint(end, lsn);
+	char *str = mp_encode_strl(end, body_size);
+	memset(str, 'x', body_size);
+	end = str + body_size;
+
+	struct xrow_header row;
+	memset(&row, 0, sizeof(row));
+	row.type = IPROTO_INSERT;
+	row.replica_id = REPLICA_ID;
+	row.lsn = lsn;
+	row.is_commit = true;
+	row.bodycnt = 1;
+	row.body[0].iov_base = body_buf;
+	row.body[0].iov_len = end - body_buf;
+	struct xrow_header *rows[] = {&row};
+	wal_tail_append(tail, rows, 1);
+}
+
+/**
+ * Reads rows from the buffer and checks that they have consecutive
+ * LSNs starting from @a lsn. Returns the number of read rows.
+ */
+static int
+read_rows(struct wal_tail *tail, struct wal_tail_cursor *cursor,
+	  const struct vclock *vclock, size_t max_size, int64_t lsn)
+{
+	struct ibuf buf;
+	ibuf_create(&buf, &cord()->slabc, 1024);
+	int count = wal_tail_read(tail, cursor, vclock, &buf, max_size);
+	const char *pos = buf.rpos;
+	for (int i = 0; i < count; i++) {
+		struct xrow_header row;
+		if (wal_tail_decode_row(&pos, &row) != 0 ||
+		    row.lsn != lsn + i || row.replica_id != REPLICA_ID ||
+		    row.type != IPROTO_INSERT || row.bodycnt != 1) {
+			count = -2;
+			break;
+		}
+		const char *data = row.body[0].iov_base;
+		if (mp_decode_array(&data) != 2 ||
+		    (int64_t)mp_decode_uint(&data) != lsn + i) {
+			count = -2;
+			break;
+		}
+	}
+	ibuf_destroy(&buf);
+	return count;
+}
+
+static void
+test_read(void)
+{
+	plan(9);
+	header();
+
+	struct wal_tail tail;
+	wal_tail_create(&tail, TAIL_SIZE);
+	struct wal_tail_cursor cursor = {.is_open = false};
+	struct vclock vclock;
+	vclock_create(&vclock);
+	vclock_follow(&vclock, REPLICA_ID, 10);
+
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 11), -1,
+	   "not started");
+	fail_if(wal_tail_start(&tail, &vclock) != 0);
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 11), 0, "empty");
+	ok(cursor.is_open, "cursor is open");
+	for (int64_t lsn = 11; lsn <= 20; lsn++)
+		append_row(&tail, lsn, 10);
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 11), 10, "all rows");
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 21), 0, "no new rows");
+	append_row(&tail, 21, 10);
+	append_row(&tail, 22, 10);
+	is(read_rows(&tail, &cursor, &vclock, 1, 21), 1, "limited by size");
+	is(read_rows(&tail, &cursor, &vclock, 1, 22), 1, "the rest");
+
+	struct wal_tail_cursor lagging = {.is_open = false};
+	struct vclock old_vclock;
+	vclock_create(&old_vclock);
+	vclock_follow(&old_vclock, REPLICA_ID, 5);
+	is(read_rows(&tail, &lagging, &old_vclock, SIZE_MAX, 11), -1,
+	   "reader lags behind the buffer");
+
+	wal_tail_stop(&tail);
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 23), -1, "stopped");
+
+	wal_tail_destroy(&tail);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_evict(void)
+{
+	plan(7);
+	header();
+
+	struct wal_tail tail;
+	wal_tail_create(&tail, TAIL_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	fail_if(wal_tail_start(&tail, &vclock) != 0);
+	struct wal_tail_cursor cursor = {.is_open = false};
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 1), 0, "empty");
+
+	/* Rows of different sizes to check wrapping. */
+	for (int64_t lsn = 1; lsn <= 1000; lsn++)
+		append_row(&tail, lsn, lsn % 100);
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 1), -1,
+	   "cursor is overwritten");
+	ok(!cursor.is_open, "cursor is closed");
+
+	int64_t first = vclock_get(&tail.vclock, REPLICA_ID) + 1;
+	ok(first > 1 && first < 1000, "buffer vclock is advanced");
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, first), -1,
+	   "reader lags behind the buffer");
+
+	struct vclock reader_vclock;
+	vclock_copy(&reader_vclock, &tail.vclock);
+	is(read_rows(&tail, &cursor, &reader_vclock, SIZE_MAX, first),
+	   1000 - first + 1, "reader at the oldest row");
+
+	/* A row that doesn't fit invalidates all cursors. */
+	append_row(&tail, 1001, TAIL_SIZE);
+	append_row(&tail, 1002, 10);
+	is(read_rows(&tail, &cursor, &reader_vclock, SIZE_MAX, 1002), -1,
+	   "big row is dropped");
+
+	wal_tail_destroy(&tail);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_big_row(void)
+{
+	plan(2);
+	header();
+
+	struct wal_tail tail;
+	wal_tail_create(&tail, TAIL_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	fail_if(wal_tail_start(&tail, &vclock) != 0);
+
+	append_row(&tail, 1, TAIL_SIZE);
+	append_row(&tail, 2, 10);
+	is(vclock_get(&tail.vclock, REPLICA_ID), 1, "big row is followed");
+	struct wal_tail_cursor cursor = {.is_open = false};
+	vclock_follow(&vclock, REPLICA_ID, 1);
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 2), 1,
+	   "rows after the big row");
+
+	wal_tail_destroy(&tail);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_set_capacity(void)
+{
+	plan(4);
+	header();
+
+	struct wal_tail tail;
+	wal_tail_create(&tail, TAIL_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	fail_if(wal_tail_start(&tail, &vclock) != 0);
+	append_row(&tail, 1, 10);
+	struct wal_tail_cursor cursor = {.is_open = false};
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 1), 1, "started");
+
+	wal_tail_set_capacity(&tail, 2 * TAIL_SIZE);
+	ok(!wal_tail_is_started(&tail), "stopped on resize");
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 2), -1,
+	   "cursor is invalidated");
+
+	vclock_follow(&vclock, REPLICA_ID, 1);
+	fail_if(wal_tail_start(&tail, &vclock) != 0);
+	for (int64_t lsn = 2; lsn <= 100; lsn++)
+		append_row(&tail, lsn, 40);
+	is(read_rows(&tail, &cursor, &vclock, SIZE_MAX, 2), 99,
+	   "rows fit the new size");
+
+	wal_tail_destroy(&tail);
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	plan(4);
+	header();
+
+	test_read();
+	test_evict();
+	test_big_row();
+	test_set_capacity();
+
+	footer();
+	fiber_free();
+	memory_free();
+	return check_plan();
+}
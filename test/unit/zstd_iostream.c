@@ -0,0 +1,197 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2023, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "box/zstd_iostream.h"
+#include "coio.h"
+#include "fiber.h"
+#include "iostream.h"
+#include "memory.h"
+#include "trivia/util.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+enum {
+	/** Size of the data sent in a test. */
+	DATA_SIZE = 4 * 1024 * 1024,
+	/** Size of one write. */
+	CHUNK_SIZE = 1000,
+};
+
+static char *send_buf;
+static char *recv_buf;
+
+/** A real return value of main_f(). */
+static int test_result = 1;
+
+/** Creates a pair of connected non-blocking plain streams. */
+static void
+create_streams(struct iostream *io1, struct iostream *io2)
+{
+	int fds[2];
+	fail_if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0);
+	for (int i = 0; i < 2; i++)
+		fail_if(fcntl(fds[i], F_SETFL, O_NONBLOCK) != 0);
+	plain_iostream_create(io1, fds[0]);
+	plain_iostream_create(io2, fds[1]);
+}
+
+struct write_arg {
+	struct iostream *io;
+	size_t chunk_size;
+};
+
+static int
+write_f(va_list ap)
+{
+	struct write_arg *arg = va_arg(ap, struct write_arg *);
+	for (size_t pos = 0; pos < DATA_SIZE; pos += arg->chunk_size) {
+		size_t size = MIN(arg->chunk_size, DATA_SIZE - pos);
+		if (coio_write(arg->io, send_buf + pos, size) < 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Sends the data from one stream to the other in chunks of the given
+ * size and checks that the received data is the same.
+ */
+static void
+transfer(struct iostream *out, struct iostream *in, size_t chunk_size)
+{
+	struct write_arg arg = {out, chunk_size};
+	struct fiber *f = fiber_new("writer", write_f);
+	fail_if(f == NULL);
+	fiber_set_joinable(f, true);
+	fiber_start(f, &arg);
+	memset(recv_buf, 0, DATA_SIZE);
+	is(coio_readn(in, recv_buf, DATA_SIZE), DATA_SIZE, "data is read");
+	is(fiber_join(f), 0, "data is written");
+	ok(memcmp(send_buf, recv_buf, DATA_SIZE) == 0, "data is the same");
+}
+
+static void
+test_compressible(void)
+{
+	plan(7);
+	header();
+
+	for (size_t i = 0; i < DATA_SIZE; i++)
+		send_buf[i] = 'a' + i % 100 / 10;
+	struct iostream out, in;
+	create_streams(&out, &in);
+	fail_if(zstd_iostream_wrap(&out, 3, false) != 0);
+	fail_if(zstd_iostream_wrap(&in, 0, true) != 0);
+	ok(zstd_iostream_is_wrapped(&out) && zstd_iostream_is_wrapped(&in),
+	   "streams are wrapped");
+	transfer(&out, &in, CHUNK_SIZE);
+
+	struct zstd_iostream_stat out_stat, in_stat;
+	zstd_iostream_stat(&out, &out_stat);
+	zstd_iostream_stat(&in, &in_stat);
+	is(out_stat.raw, DATA_SIZE, "raw bytes written");
+	ok(out_stat.compressed < DATA_SIZE / 10, "data is compressed");
+	ok(in_stat.raw == out_stat.raw &&
+	   in_stat.compressed <= out_stat.compressed, "read statistics");
+
+	iostream_close(&out);
+	iostream_close(&in);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_incompressible(void)
+{
+	plan(3);
+	header();
+
+	/*
+	 * One big write doesn't fit in the socket buffer, so it's
+	 * retried until the compressed output is written.
+	 */
+	for (size_t i = 0; i < DATA_SIZE; i++)
+		send_buf[i] = rand();
+	struct iostream out, in;
+	create_streams(&out, &in);
+	fail_if(zstd_iostream_wrap(&out, 1, false) != 0);
+	fail_if(zstd_iostream_wrap(&in, 0, true) != 0);
+	transfer(&out, &in, DATA_SIZE);
+	iostream_close(&out);
+	iostream_close(&in);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_plain_peer(void)
+{
+	plan(5);
+	header();
+
+	for (size_t i = 0; i < DATA_SIZE; i++)
+		send_buf[i] = rand();
+	/* An IPROTO packet starts with MP_UINT32 packet length. */
+	send_buf[0] = (char)0xce;
+	struct iostream out, in;
+	create_streams(&out, &in);
+	fail_if(zstd_iostream_wrap(&in, 0, true) != 0);
+	transfer(&out, &in, CHUNK_SIZE);
+
+	struct zstd_iostream_stat stat;
+	zstd_iostream_stat(&in, &stat);
+	is(stat.raw, DATA_SIZE, "raw bytes read");
+	is(stat.compressed, DATA_SIZE, "data isn't decompressed");
+	iostream_close(&out);
+	iostream_close(&in);
+
+	footer();
+	check_plan();
+}
+
+static int
+main_f(va_list ap)
+{
+	(void)ap;
+	plan(3);
+	header();
+
+	test_compressible();
+	test_incompressible();
+	test_plain_peer();
+
+	ev_break(loop(), EVBREAK_ALL);
+
+	footer();
+	test_result = check_plan();
+	return 0;
+}
+
+int
+main(void)
+{
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	send_buf = xmalloc(DATA_SIZE);
+	recv_buf = xmalloc(DATA_SIZE);
+	struct fiber *test = fiber_new("main", main_f);
+	fail_if(test == NULL);
+	fiber_wakeup(test);
+	ev_run(loop(), 0);
+	free(send_buf);
+	free(recv_buf);
+	fiber_free();
+	memory_free();
+	return test_result;
+}